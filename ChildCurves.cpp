@@ -23,6 +23,16 @@
 #include "handleLogData.h"
 #include "curveStatsChildParam.h"
 
+// Runs the queued jobs of a single child curve on a thread pool thread.
+class childCurveJobRunner : public QRunnable
+{
+public:
+   childCurveJobRunner(ChildCurve* childCurve): m_childCurve(childCurve){}
+   void run(){m_childCurve->runQueuedJobs();}
+private:
+   ChildCurve* m_childCurve;
+};
+
 ChildCurve::ChildCurve( CurveCommander* curveCmdr,
                         QString plotName,
                         QString curveName,
@@ -39,9 +49,13 @@ ChildCurve::ChildCurve( CurveCommander* curveCmdr,
    m_forceContiguousParentPoints(forceContiguousParentPoints),
    m_startChildInScrollMode(startChildInScrollMode),
    m_curveStatsChildSize(100),
-   m_curveStatsChildPointIndex(0)
+   m_curveStatsChildPointIndex(0),
+   m_numJobsQueued(0),
+   m_jobRunning(false),
+   m_destroying(false)
 {
    m_fft_parentChunksProcessedInCurGroupMsg.reserve(2); // Typically the max number of duplicate parent chunks will be 2 (when the parent fills in the end and starts over at the beginning).
+   QObject::connect(this, SIGNAL(jobFinishedSignal()), this, SLOT(jobFinishedSlot()), Qt::QueuedConnection);
    updateCurve(false, true);
 }
 
@@ -63,12 +77,47 @@ ChildCurve::ChildCurve( CurveCommander* curveCmdr,
    m_forceContiguousParentPoints(forceContiguousParentPoints),
    m_startChildInScrollMode(startChildInScrollMode),
    m_curveStatsChildSize(0), // Don't care, this is not valid for 2D
-   m_curveStatsChildPointIndex(0)
+   m_curveStatsChildPointIndex(0),
+   m_numJobsQueued(0),
+   m_jobRunning(false),
+   m_destroying(false)
 {
    m_fft_parentChunksProcessedInCurGroupMsg.reserve(2); // Typically the max number of duplicate parent chunks will be 2 (when the parent fills in the end and starts over at the beginning).
+   QObject::connect(this, SIGNAL(jobFinishedSignal()), this, SLOT(jobFinishedSlot()), Qt::QueuedConnection);
    updateCurve(true, true);
 }
 
+ChildCurve::~ChildCurve()
+{
+   // Wait for the job that is running on the worker thread (if any) to finish. Then throw away
+   // all the jobs that haven't been plotted yet.
+   std::list<tChildCurveJob*> unfinishedJobs;
+   m_jobMutex.lock();
+   m_destroying = true;
+   while(m_jobRunning)
+   {
+      m_jobRunningCond.wait(&m_jobMutex);
+   }
+   unfinishedJobs.splice(unfinishedJobs.end(), m_queuedJobs);
+   unfinishedJobs.splice(unfinishedJobs.end(), m_finishedJobs);
+   m_jobMutex.unlock();
+
+   // The Curve Commander is waiting on these jobs before sending out child plot messages. Let it know they are never going to finish.
+   tParentMsgIdGroup parentMsgIds;
+   for(std::list<tChildCurveJob*>::iterator iter = unfinishedJobs.begin(); iter != unfinishedJobs.end(); ++iter)
+   {
+      if((*iter)->parentCurveMsgId != PLOT_MSG_ID_TYPE_NO_PARENT_MSG)
+      {
+         parentMsgIds.push_back((*iter)->parentCurveMsgId);
+      }
+      delete *iter;
+   }
+   if(parentMsgIds.size() > 0)
+   {
+      m_curveCmdr->childCurveJobsAbandoned(parentMsgIds);
+   }
+}
+
 void ChildCurve::anotherCurveChanged( QString plotName,
                                       QString curveName,
                                       unsigned int parentStartIndex,
@@ -520,6 +569,10 @@ void ChildCurve::updateCurve( bool xParentChanged,
    CurveData* childCurve    = m_curveCmdr->getCurveData(m_plotName, m_curveName);
    bool childIsInScrollMode = childCurve != NULL ? childCurve->getScrollMode() : m_startChildInScrollMode; // This value only applies to non-FFT children.
 
+   // Child plot types that do processing on the parent samples grab the parent samples here and then
+   // do the processing on a worker thread.
+   tChildCurveJob* job = NULL;
+
    switch(m_plotType)
    {
       case E_PLOT_TYPE_1D:
@@ -542,70 +595,38 @@ void ChildCurve::updateCurve( bool xParentChanged,
       }
       break;
       case E_PLOT_TYPE_REAL_FFT:
-      {
-         dubVect realFFTOut;
-
-         getDataForFft(m_plotType, parentGroupMsgId, xParentChanged, yParentChanged, parentStartIndex, parentStopIndex);
-
-         if(m_yAxis.windowFFT == true)
-         {
-            unsigned int dataSize = m_ySrcData.size();
-            if(m_prevInfo.size() != dataSize)
-            {
-               m_prevInfo.resize(dataSize);
-               genWindowCoef(&m_prevInfo[0], dataSize, m_yAxis.scaleFftWindow);
-            }
-            m_realFFT.run(m_ySrcData, realFFTOut, &m_prevInfo[0]);
-         }
-         else
-         {
-            m_realFFT.run(m_ySrcData, realFFTOut);
-         }
-
-         update1dChildCurve(m_curveName, m_plotType, 0, realFFTOut, parentCurveMsgId);
-      }
-      break;
       case E_PLOT_TYPE_COMPLEX_FFT:
+      case E_PLOT_TYPE_DB_POWER_FFT_REAL:
+      case E_PLOT_TYPE_DB_POWER_FFT_COMPLEX:
       {
-         dubVect realFFTOut;
-         dubVect imagFFTOut;
-
          getDataForFft(m_plotType, parentGroupMsgId, xParentChanged, yParentChanged, parentStartIndex, parentStopIndex);
 
-         if(m_yAxis.windowFFT == true)
-         {
-            unsigned int dataSize = std::min(m_ySrcData.size(), m_xSrcData.size());
-            if(m_prevInfo.size() != dataSize)
-            {
-               m_prevInfo.resize(dataSize);
-               genWindowCoef(&m_prevInfo[0], dataSize, m_yAxis.scaleFftWindow);
-            }
-            m_complexFFT.run(m_xSrcData, m_ySrcData, realFFTOut, imagFFTOut, &m_prevInfo[0]);
-         }
-         else
-         {
-            m_complexFFT.run(m_xSrcData, m_ySrcData, realFFTOut, imagFFTOut);
-         }
-
-
-         update1dChildCurve(m_curveName + COMPLEX_FFT_REAL_APPEND, m_plotType, 0, realFFTOut, parentCurveMsgId);
-         update1dChildCurve(m_curveName + COMPLEX_FFT_IMAG_APPEND, m_plotType, 0, imagFFTOut, parentCurveMsgId);
+         // The FFT source samples are kept around (new parent samples may only update part of them), so give the job a copy.
+         job = new tChildCurveJob();
+         job->plotType = m_plotType;
+         job->offset = 0;
+         job->xSrcData = m_xSrcData;
+         job->ySrcData = m_ySrcData;
+         job->recalcsAllPoints = true;
       }
       break;
       case E_PLOT_TYPE_AM_DEMOD:
+      case E_PLOT_TYPE_MATH_BETWEEN_CURVES:
       {
-         dubVect demodOut;
          unsigned int offset = getDataFromParent2D( xParentChanged,
                                                     yParentChanged,
                                                     parentStartIndex,
                                                     parentStopIndex );
-         AmDemod(m_xSrcData, m_ySrcData, demodOut);
-         update1dChildCurve(m_curveName, m_plotType, offset, demodOut, parentCurveMsgId);
+         job = new tChildCurveJob();
+         job->plotType = m_plotType;
+         job->offset = offset;
+         job->xSrcData.swap(m_xSrcData);
+         job->ySrcData.swap(m_ySrcData);
       }
       break;
       case E_PLOT_TYPE_FM_DEMOD:
+      case E_PLOT_TYPE_PM_DEMOD:
       {
-         dubVect fmDemod;
          unsigned int offset = getDataFromParent2D( xParentChanged,
                                                     yParentChanged,
                                                     parentStartIndex,
@@ -626,163 +647,382 @@ void ChildCurve::updateCurve( bool xParentChanged,
          int dataSize = std::min(m_xSrcData.size(), m_ySrcData.size());
          if(dataSize > 0 && uniqueInputData)
          {
-            int pmDemodSize = m_prevInfo.size();
+            job = new tChildCurveJob();
+            job->plotType = m_plotType;
+            job->offset = offset;
+            job->childIsInScrollMode = childIsInScrollMode;
+            job->xSrcData.swap(m_xSrcData);
+            job->ySrcData.swap(m_ySrcData);
+         }
+      }
+      break;
+      case E_PLOT_TYPE_AVERAGE:
+      case E_PLOT_TYPE_DELTA:
+      case E_PLOT_TYPE_SUM:
+      {
+         ePlotType childCurvePlotType = determineChildPlotTypeFor1D(m_yAxis, m_plotType);
+         unsigned int offset = getDataFromParent1D(parentStartIndex, parentStopIndex);
 
-            // Get index, make sure it is valid.
-            int prevPhaseIndex = (int)offset - 1;
-            if(prevPhaseIndex < 0)
-            {
-               prevPhaseIndex = pmDemodSize - 1;
-            }
+         // If Child is in scroll mode, only need to keep track of the most recent samples.
+         if(childIsInScrollMode)
+            offset = 0;
+
+         if(m_ySrcData.size() > 0)
+         {
+            job = new tChildCurveJob();
+            job->plotType = childCurvePlotType;
+            job->offset = offset;
+            job->childIsInScrollMode = childIsInScrollMode;
+            job->ySrcData.swap(m_ySrcData);
+         }
+      }
+      break;
+      case E_PLOT_TYPE_FFT_MEASUREMENT:
+      case E_PLOT_TYPE_CURVE_STATS:
+      {
+         MainWindow* parentPlot = m_curveCmdr->getMainPlot(m_yAxis.dataSrc.plotName);
 
-            // If the prev info array size is 0, can't read from it.
-            double prevPhase = pmDemodSize <= 0 ? 0.0 : m_prevInfo[prevPhaseIndex];
+         bool valid = (m_plotType != E_PLOT_TYPE_FFT_MEASUREMENT || parentPlot->areFftMeasurementsVisible()); // Only plot FFT Measurement if the measurement are visible on the parent.
 
-            // Resize if needed to allow room for new samples.
-            if(pmDemodSize < ((int)offset + dataSize))
+         if(parentPlot != NULL && valid)
+         {
+            m_ySrcData.clear(); // Clear out previous values, only sending 1 point.
+            if(m_plotType == E_PLOT_TYPE_FFT_MEASUREMENT)
             {
-               m_prevInfo.resize(offset + dataSize);
+               m_ySrcData.push_back(parentPlot->getFftMeasurement(m_yAxis.fftMeasurementType)); // Grab the FFT Meaurement value to be plotted.
             }
-            else if(childIsInScrollMode)
+            else
             {
-               m_prevInfo.resize(dataSize); // Just need to store the new data off.
+               m_ySrcData.push_back(parentPlot->getCurveStat(m_yAxis.dataSrc.curveName, m_yAxis.curveStatType));
             }
 
-            FmPmDemod(m_xSrcData, m_ySrcData, fmDemod, &m_prevInfo[offset], prevPhase);
-
-            // The very first point has no previous point to take a delta against.
-            // So, set the very first delta to 'Not a Number'.
-            if(pmDemodSize == 0)
+            // Set the FFT Measurement Child Plot Size.
+            if(m_curveStatsChildSize != m_yAxis.curveStatstPlotSize && m_yAxis.curveStatstPlotSize > 0)
             {
-               fmDemod[0] = NAN; // Set very first phase delta to 'Not a Number'
+               m_curveStatsChildSize = m_yAxis.curveStatstPlotSize;
             }
 
-            update1dChildCurve(m_curveName, m_plotType, offset, fmDemod, parentCurveMsgId);
+            // Check if we need to use a previous sibling curve point index value.
+            curveStatsChildParam_getIndex( m_yAxis.dataSrc.plotName,
+                                           m_plotName,
+                                           m_curveName,
+                                           parentGroupMsgId,
+                                           m_curveStatsChildSize,
+                                           m_curveStatsChildPointIndex );
+
+            // Update the Child Plot with the new FFT Measurement value.
+            update1dChildCurve(m_curveName, m_plotType, m_curveStatsChildPointIndex, m_ySrcData, parentCurveMsgId);
+
+            if(++m_curveStatsChildPointIndex >= m_curveStatsChildSize)
+            {
+               m_curveStatsChildPointIndex = 0;
+            }
          }
       }
       break;
-      case E_PLOT_TYPE_PM_DEMOD:
+      default:
+         // TODO should I do something here???
+      break;
+   }
+
+   if(job != NULL)
+   {
+      job->parentCurveMsgId = parentCurveMsgId;
+      queueJob(job);
+   }
+
+   setToParentsSampleRate();
+
+   m_lastGroupMsgId = parentGroupMsgId;
+}
+
+void ChildCurve::queueJob(tChildCurveJob* job)
+{
+   // Let the Curve Commander know not to send out the child plot messages for the parent message group
+   // until this job is done.
+   if(job->parentCurveMsgId != PLOT_MSG_ID_TYPE_NO_PARENT_MSG)
+   {
+      m_curveCmdr->childCurveJobQueued(job->parentCurveMsgId);
+   }
+
+   job->jobNum = ++m_numJobsQueued;
+
+   m_jobMutex.lock();
+   m_queuedJobs.push_back(job);
+   if(!m_jobRunning)
+   {
+      // Jobs for a single child curve are run one at a time, in order (processing of some child plot
+      // types depends on the previous samples). Jobs for different child curves can run in parallel.
+      m_jobRunning = true;
+      QThreadPool::globalInstance()->start(new childCurveJobRunner(this));
+   }
+   m_jobMutex.unlock();
+}
+
+void ChildCurve::runQueuedJobs()
+{
+   m_jobMutex.lock();
+   while(m_queuedJobs.size() > 0 && !m_destroying)
+   {
+      tChildCurveJob* job = m_queuedJobs.front();
+      m_queuedJobs.pop_front();
+
+      // If a newer job that will recalculate all the points is already queued, don't bother processing this one.
+      job->superseded = job->recalcsAllPoints && m_queuedJobs.size() > 0;
+      m_jobMutex.unlock();
+
+      if(!job->superseded)
       {
-         dubVect pmDemod;
-         unsigned int offset = getDataFromParent2D( xParentChanged,
-                                                    yParentChanged,
-                                                    parentStartIndex,
-                                                    parentStopIndex );
+         processJob(job);
+      }
 
-         // If Child is in scroll mode, only need to keep track of the most recent samples.
-         if(childIsInScrollMode)
-            offset = 0;
+      m_jobMutex.lock();
+      m_finishedJobs.push_back(job);
+      emit jobFinishedSignal();
+   }
+   m_jobRunning = false;
+   m_jobRunningCond.wakeAll();
+   m_jobMutex.unlock();
+}
 
-         // For plots with 2D inputs, this function will be called for both axes. Only need to update the first time.
-         bool uniqueInputData = !handleDuplicate2DParentChunks( parentGroupMsgId,
-                                                                xParentChanged,
-                                                                yParentChanged,
-                                                                parentStartIndex,
-                                                                parentStopIndex,
-                                                                childIsInScrollMode );
+void ChildCurve::jobFinishedSlot()
+{
+   std::list<tChildCurveJob*> finishedJobs;
+   m_jobMutex.lock();
+   finishedJobs.swap(m_finishedJobs);
+   m_jobMutex.unlock();
 
-         int dataSize = std::min(m_xSrcData.size(), m_ySrcData.size());
-         if(dataSize > 0 && uniqueInputData)
+   for(std::list<tChildCurveJob*>::iterator iter = finishedJobs.begin(); iter != finishedJobs.end(); ++iter)
+   {
+      tChildCurveJob* job = *iter;
+
+      // If a newer job will recalculate all the points, drop this job's result instead of plotting it.
+      bool superseded = job->superseded || (job->recalcsAllPoints && job->jobNum != m_numJobsQueued);
+      if(!superseded)
+      {
+         for(std::list<tChildCurveJobResult>::iterator result = job->results.begin(); result != job->results.end(); ++result)
          {
-            int pmDemodSize = m_prevInfo.size();
+            update1dChildCurve(result->curveName, result->plotType, result->sampleStartIndex, result->yPoints, job->parentCurveMsgId);
+         }
+      }
 
-            // Get index, make sure it is valid.
-            int prevPhaseIndex = (int)offset - 1;
-            if(prevPhaseIndex < 0)
-            {
-               prevPhaseIndex = pmDemodSize - 1;
-            }
+      if(job->parentCurveMsgId != PLOT_MSG_ID_TYPE_NO_PARENT_MSG)
+      {
+         m_curveCmdr->childCurveJobDone(job->parentCurveMsgId);
+      }
+      delete job;
+   }
+
+   if(finishedJobs.size() > 0)
+   {
+      setToParentsSampleRate();
+   }
+}
+
+void ChildCurve::addJobResult(tChildCurveJob* job, const QString& curveName, unsigned int sampleStartIndex, dubVect& yPoints)
+{
+   tChildCurveJobResult result;
+   job->results.push_back(result);
+   job->results.back().curveName = curveName;
+   job->results.back().plotType = job->plotType;
+   job->results.back().sampleStartIndex = sampleStartIndex;
+   job->results.back().yPoints.swap(yPoints);
+}
 
-            // If the prev info array size is 0, can't read from it.
-            double prevPhase = pmDemodSize <= 0 ? 0.0 : m_prevInfo[prevPhaseIndex];
+// Note: this is run on a worker thread. It can only use the job and the members that are only
+// used by the worker thread (m_prevInfo, m_realFFT, m_complexFFT) or never change (m_yAxis, m_plotType, etc).
+void ChildCurve::processJob(tChildCurveJob* job)
+{
+   dubVect& xSrcData = job->xSrcData;
+   dubVect& ySrcData = job->ySrcData;
+   unsigned int offset = job->offset;
+   bool childIsInScrollMode = job->childIsInScrollMode;
+
+   switch(m_plotType)
+   {
+      case E_PLOT_TYPE_REAL_FFT:
+      {
+         dubVect realFFTOut;
 
-            // Resize if needed to allow room for new samples.
-            if(pmDemodSize < ((int)offset + dataSize))
+         if(m_yAxis.windowFFT == true)
+         {
+            unsigned int dataSize = ySrcData.size();
+            if(m_prevInfo.size() != dataSize)
             {
-               m_prevInfo.resize(offset + dataSize);
+               m_prevInfo.resize(dataSize);
+               genWindowCoef(&m_prevInfo[0], dataSize, m_yAxis.scaleFftWindow);
             }
-            else if(childIsInScrollMode)
+            m_realFFT.run(ySrcData, realFFTOut, &m_prevInfo[0]);
+         }
+         else
+         {
+            m_realFFT.run(ySrcData, realFFTOut);
+         }
+
+         addJobResult(job, m_curveName, 0, realFFTOut);
+      }
+      break;
+      case E_PLOT_TYPE_COMPLEX_FFT:
+      {
+         dubVect realFFTOut;
+         dubVect imagFFTOut;
+
+         if(m_yAxis.windowFFT == true)
+         {
+            unsigned int dataSize = std::min(ySrcData.size(), xSrcData.size());
+            if(m_prevInfo.size() != dataSize)
             {
-               m_prevInfo.resize(dataSize); // Just need to store the new data off.
+               m_prevInfo.resize(dataSize);
+               genWindowCoef(&m_prevInfo[0], dataSize, m_yAxis.scaleFftWindow);
             }
+            m_complexFFT.run(xSrcData, ySrcData, realFFTOut, imagFFTOut, &m_prevInfo[0]);
+         }
+         else
+         {
+            m_complexFFT.run(xSrcData, ySrcData, realFFTOut, imagFFTOut);
+         }
+
+
+         addJobResult(job, m_curveName + COMPLEX_FFT_REAL_APPEND, 0, realFFTOut);
+         addJobResult(job, m_curveName + COMPLEX_FFT_IMAG_APPEND, 0, imagFFTOut);
+      }
+      break;
+      case E_PLOT_TYPE_AM_DEMOD:
+      {
+         dubVect demodOut;
+         AmDemod(xSrcData, ySrcData, demodOut);
+         addJobResult(job, m_curveName, offset, demodOut);
+      }
+      break;
+      case E_PLOT_TYPE_FM_DEMOD:
+      {
+         dubVect fmDemod;
+         int dataSize = std::min(xSrcData.size(), ySrcData.size());
+         int pmDemodSize = m_prevInfo.size();
 
-            PmDemod(m_xSrcData, m_ySrcData, &m_prevInfo[offset], prevPhase);
-            pmDemod.assign(&m_prevInfo[offset], (&m_prevInfo[offset])+dataSize);
-            update1dChildCurve(m_curveName, m_plotType, offset, pmDemod, parentCurveMsgId);
+         // Get index, make sure it is valid.
+         int prevPhaseIndex = (int)offset - 1;
+         if(prevPhaseIndex < 0)
+         {
+            prevPhaseIndex = pmDemodSize - 1;
+         }
+
+         // If the prev info array size is 0, can't read from it.
+         double prevPhase = pmDemodSize <= 0 ? 0.0 : m_prevInfo[prevPhaseIndex];
+
+         // Resize if needed to allow room for new samples.
+         if(pmDemodSize < ((int)offset + dataSize))
+         {
+            m_prevInfo.resize(offset + dataSize);
          }
+         else if(childIsInScrollMode)
+         {
+            m_prevInfo.resize(dataSize); // Just need to store the new data off.
+         }
+
+         FmPmDemod(xSrcData, ySrcData, fmDemod, &m_prevInfo[offset], prevPhase);
+
+         // The very first point has no previous point to take a delta against.
+         // So, set the very first delta to 'Not a Number'.
+         if(pmDemodSize == 0)
+         {
+            fmDemod[0] = NAN; // Set very first phase delta to 'Not a Number'
+         }
+
+         addJobResult(job, m_curveName, offset, fmDemod);
       }
       break;
-      case E_PLOT_TYPE_AVERAGE:
+      case E_PLOT_TYPE_PM_DEMOD:
       {
-         ePlotType childCurvePlotType = determineChildPlotTypeFor1D(m_yAxis, m_plotType);
-         unsigned int offset = getDataFromParent1D(parentStartIndex, parentStopIndex);
+         dubVect pmDemod;
+         int dataSize = std::min(xSrcData.size(), ySrcData.size());
+         int pmDemodSize = m_prevInfo.size();
 
-         // If Child is in scroll mode, only need to keep track of the most recent samples.
-         if(childIsInScrollMode)
-            offset = 0;
+         // Get index, make sure it is valid.
+         int prevPhaseIndex = (int)offset - 1;
+         if(prevPhaseIndex < 0)
+         {
+            prevPhaseIndex = pmDemodSize - 1;
+         }
 
-         int dataSize = m_ySrcData.size();
-         if(dataSize > 0)
+         // If the prev info array size is 0, can't read from it.
+         double prevPhase = pmDemodSize <= 0 ? 0.0 : m_prevInfo[prevPhaseIndex];
+
+         // Resize if needed to allow room for new samples.
+         if(pmDemodSize < ((int)offset + dataSize))
+         {
+            m_prevInfo.resize(offset + dataSize);
+         }
+         else if(childIsInScrollMode)
          {
-            int prevAvgSize = m_prevInfo.size();
+            m_prevInfo.resize(dataSize); // Just need to store the new data off.
+         }
 
-            // Get index, make sure it is valid.
-            int prevAvgIndex = (int)offset - 1;
-            if(prevAvgIndex < 0)
-            {
-               prevAvgIndex = prevAvgSize - 1;
-            }
+         PmDemod(xSrcData, ySrcData, &m_prevInfo[offset], prevPhase);
+         pmDemod.assign(&m_prevInfo[offset], (&m_prevInfo[offset])+dataSize);
+         addJobResult(job, m_curveName, offset, pmDemod);
+      }
+      break;
+      case E_PLOT_TYPE_AVERAGE:
+      {
+         int dataSize = ySrcData.size();
+         int prevAvgSize = m_prevInfo.size();
 
-            // If the prev info array size is 0, can't read from it.
-            double prevAvg = prevAvgSize <= 0 ? 0.0 : m_prevInfo[prevAvgIndex];
+         // Get index, make sure it is valid.
+         int prevAvgIndex = (int)offset - 1;
+         if(prevAvgIndex < 0)
+         {
+            prevAvgIndex = prevAvgSize - 1;
+         }
 
-            // Resize if needed to allow room for new samples.
-            if(prevAvgSize < ((int)offset + dataSize))
-            {
-               m_prevInfo.resize(offset + dataSize);
-            }
-            else if(childIsInScrollMode)
+         // If the prev info array size is 0, can't read from it.
+         double prevAvg = prevAvgSize <= 0 ? 0.0 : m_prevInfo[prevAvgIndex];
+
+         // Resize if needed to allow room for new samples.
+         if(prevAvgSize < ((int)offset + dataSize))
+         {
+            m_prevInfo.resize(offset + dataSize);
+         }
+         else if(childIsInScrollMode)
+         {
+            m_prevInfo.resize(dataSize); // Just need to store the new data off.
+         }
+
+         double avgKeepAmount = 1.0 - m_yAxis.avgAmount;
+         for(int i = 0; i < dataSize; ++i)
+         {
+            if(isDoubleValid(ySrcData[i]))
             {
-               m_prevInfo.resize(dataSize); // Just need to store the new data off.
+               prevAvg = ySrcData[i] = m_prevInfo[offset + i] =
+                     (m_yAxis.avgAmount * prevAvg) + (avgKeepAmount * ySrcData[i]);
             }
-
-            double avgKeepAmount = 1.0 - m_yAxis.avgAmount;
-            for(int i = 0; i < dataSize; ++i)
+            else
             {
-               if(isDoubleValid(m_ySrcData[i]))
-               {
-                  prevAvg = m_ySrcData[i] = m_prevInfo[offset + i] =
-                        (m_yAxis.avgAmount * prevAvg) + (avgKeepAmount * m_ySrcData[i]);
-               }
-               else
-               {
-                  m_ySrcData[i] = m_prevInfo[offset + i] = prevAvg;
-               }
+               ySrcData[i] = m_prevInfo[offset + i] = prevAvg;
             }
+         }
 
 
-            update1dChildCurve(m_curveName, childCurvePlotType, offset, m_ySrcData, parentCurveMsgId);
-         }
+         addJobResult(job, m_curveName, offset, ySrcData);
       }
       break;
       case E_PLOT_TYPE_DB_POWER_FFT_REAL:
       {
          dubVect realFFTOut;
-         getDataForFft(m_plotType, parentGroupMsgId, xParentChanged, yParentChanged, parentStartIndex, parentStopIndex);
 
          if(m_yAxis.windowFFT == true)
          {
-            unsigned int dataSize = m_ySrcData.size();
+            unsigned int dataSize = ySrcData.size();
             if(m_prevInfo.size() != dataSize)
             {
                m_prevInfo.resize(dataSize);
                genWindowCoef(&m_prevInfo[0], dataSize, m_yAxis.scaleFftWindow);
             }
-            m_realFFT.run(m_ySrcData, realFFTOut, &m_prevInfo[0]);
+            m_realFFT.run(ySrcData, realFFTOut, &m_prevInfo[0]);
          }
          else
          {
-            m_realFFT.run(m_ySrcData, realFFTOut);
+            m_realFFT.run(ySrcData, realFFTOut);
          }
 
          unsigned int fftSize = realFFTOut.size();
@@ -793,7 +1033,7 @@ void ChildCurve::updateCurve( bool xParentChanged,
 
          handleLogData(&realFFTOut[0], fftSize);
 
-         update1dChildCurve(m_curveName, m_plotType, 0, realFFTOut, parentCurveMsgId);
+         addJobResult(job, m_curveName, 0, realFFTOut);
       }
       break;
       case E_PLOT_TYPE_DB_POWER_FFT_COMPLEX:
@@ -801,20 +1041,19 @@ void ChildCurve::updateCurve( bool xParentChanged,
          dubVect realFFTOut;
          dubVect imagFFTOut;
 
-         getDataForFft(m_plotType, parentGroupMsgId, xParentChanged, yParentChanged, parentStartIndex, parentStopIndex);
          if(m_yAxis.windowFFT == true)
          {
-            unsigned int dataSize = std::min(m_ySrcData.size(), m_xSrcData.size());
+            unsigned int dataSize = std::min(ySrcData.size(), xSrcData.size());
             if(m_prevInfo.size() != dataSize)
             {
                m_prevInfo.resize(dataSize);
                genWindowCoef(&m_prevInfo[0], dataSize, m_yAxis.scaleFftWindow);
             }
-            m_complexFFT.run(m_xSrcData, m_ySrcData, realFFTOut, imagFFTOut, &m_prevInfo[0]);
+            m_complexFFT.run(xSrcData, ySrcData, realFFTOut, imagFFTOut, &m_prevInfo[0]);
          }
          else
          {
-            m_complexFFT.run(m_xSrcData, m_ySrcData, realFFTOut, imagFFTOut);
+            m_complexFFT.run(xSrcData, ySrcData, realFFTOut, imagFFTOut);
          }
 
          unsigned int fftSize = realFFTOut.size();
@@ -825,169 +1064,106 @@ void ChildCurve::updateCurve( bool xParentChanged,
 
          handleLogData(&realFFTOut[0], fftSize);
 
-         update1dChildCurve(m_curveName, m_plotType, 0, realFFTOut, parentCurveMsgId);
+         addJobResult(job, m_curveName, 0, realFFTOut);
       }
       break;
       case E_PLOT_TYPE_DELTA:
       case E_PLOT_TYPE_SUM:
       {
-         ePlotType childCurvePlotType = determineChildPlotTypeFor1D(m_yAxis, m_plotType);
-         unsigned int offset = getDataFromParent1D(parentStartIndex, parentStopIndex);
-
-         // If Child is in scroll mode, only need to keep track of the most recent samples.
-         if(childIsInScrollMode)
-            offset = 0;
+         int dataSize = ySrcData.size();
+         int prevSize = m_prevInfo.size();
 
-         int dataSize = m_ySrcData.size();
-         if(dataSize > 0)
+         // Get index, make sure it is valid.
+         int prevIndex = (int)offset - 1;
+         if(prevIndex < 0)
          {
-            int prevSize = m_prevInfo.size();
+            prevIndex = prevSize - 1;
+         }
 
-            // Get index, make sure it is valid.
-            int prevIndex = (int)offset - 1;
-            if(prevIndex < 0)
-            {
-               prevIndex = prevSize - 1;
-            }
+         // If the prev info array size is 0, can't read from it.
+         double prevVal = prevSize <= 0 ? 0.0 : m_prevInfo[prevIndex];
 
-            // If the prev info array size is 0, can't read from it.
-            double prevVal = prevSize <= 0 ? 0.0 : m_prevInfo[prevIndex];
+         // Resize if needed to allow room for new samples.
+         if(prevSize < ((int)offset + dataSize))
+         {
+            m_prevInfo.resize(offset + dataSize);
+         }
+         else if(childIsInScrollMode)
+         {
+            m_prevInfo.resize(dataSize); // Just need to store the new data off.
+         }
 
-            // Resize if needed to allow room for new samples.
-            if(prevSize < ((int)offset + dataSize))
+         if(m_plotType == E_PLOT_TYPE_DELTA)
+         {
+            for(int i = 0; i < dataSize; ++i)
             {
-               m_prevInfo.resize(offset + dataSize);
+               m_prevInfo[offset + i] = ySrcData[i];
+               ySrcData[i] -= prevVal;
+               prevVal = m_prevInfo[offset + i];
             }
-            else if(childIsInScrollMode)
+
+            // The very first point has no previous point to take a delta against.
+            // So, set the very first delta to 'Not a Number'.
+            if(prevSize == 0)
             {
-               m_prevInfo.resize(dataSize); // Just need to store the new data off.
+               ySrcData[0] = NAN; // Set very first delta to 'Not a Number'
             }
-
-            if(m_plotType == E_PLOT_TYPE_DELTA)
+         }
+         else // Must be E_PLOT_TYPE_SUM
+         {
+            for(int i = 0; i < dataSize; ++i)
             {
-               for(int i = 0; i < dataSize; ++i)
+               if(isDoubleValid(ySrcData[i]))
                {
-                  m_prevInfo[offset + i] = m_ySrcData[i];
-                  m_ySrcData[i] -= prevVal;
+                  ySrcData[i] = m_prevInfo[offset + i] = prevVal + ySrcData[i];
                   prevVal = m_prevInfo[offset + i];
                }
-
-               // The very first point has no previous point to take a delta against.
-               // So, set the very first delta to 'Not a Number'.
-               if(prevSize == 0)
-               {
-                  m_ySrcData[0] = NAN; // Set very first delta to 'Not a Number'
-               }
-            }
-            else // Must be E_PLOT_TYPE_SUM
-            {
-               for(int i = 0; i < dataSize; ++i)
+               else
                {
-                  if(isDoubleValid(m_ySrcData[i]))
-                  {
-                     m_ySrcData[i] = m_prevInfo[offset + i] = prevVal + m_ySrcData[i];
-                     prevVal = m_prevInfo[offset + i];
-                  }
-                  else
-                  {
-                     m_ySrcData[i] = m_prevInfo[offset + i] = prevVal;
-                  }
+                  ySrcData[i] = m_prevInfo[offset + i] = prevVal;
                }
             }
-
-            update1dChildCurve(m_curveName, childCurvePlotType, offset, m_ySrcData, parentCurveMsgId);
          }
+
+         addJobResult(job, m_curveName, offset, ySrcData);
       }
       break;
       case E_PLOT_TYPE_MATH_BETWEEN_CURVES:
       {
          dubVect mathOut;
-         unsigned int offset = getDataFromParent2D( xParentChanged,
-                                                    yParentChanged,
-                                                    parentStartIndex,
-                                                    parentStopIndex );
-
-         unsigned int outSize = std::min(m_xSrcData.size(), m_ySrcData.size());
+         unsigned int outSize = std::min(xSrcData.size(), ySrcData.size());
          mathOut.resize(outSize);
          switch(m_yAxis.mathBetweenCurvesOperator)
          {
             default:
             case E_MATH_BETWEEN_CURVES_ADD:
                for(unsigned int i = 0; i < outSize; ++i)
-                  mathOut[i] = m_xSrcData[i] + m_ySrcData[i];
+                  mathOut[i] = xSrcData[i] + ySrcData[i];
             break;
             case E_MATH_BETWEEN_CURVES_SUBTRACT:
                for(unsigned int i = 0; i < outSize; ++i)
-                  mathOut[i] = m_xSrcData[i] - m_ySrcData[i];
+                  mathOut[i] = xSrcData[i] - ySrcData[i];
             break;
             case E_MATH_BETWEEN_CURVES_MULTILPY:
                for(unsigned int i = 0; i < outSize; ++i)
-                  mathOut[i] = m_xSrcData[i] * m_ySrcData[i];
+                  mathOut[i] = xSrcData[i] * ySrcData[i];
             break;
             case E_MATH_BETWEEN_CURVES_DIVIDE:
                for(unsigned int i = 0; i < outSize; ++i)
-                  mathOut[i] = m_xSrcData[i] / m_ySrcData[i];
+                  mathOut[i] = xSrcData[i] / ySrcData[i];
             break;
             case E_MATH_BETWEEN_CURVES_ARCTAN2:
                for(unsigned int i = 0; i < outSize; ++i)
-                  mathOut[i] = atan2(m_ySrcData[i], m_xSrcData[i]);
+                  mathOut[i] = atan2(ySrcData[i], xSrcData[i]);
             break;
          }
 
-         update1dChildCurve(m_curveName, m_plotType, offset, mathOut, parentCurveMsgId);
-      }
-      break;
-      case E_PLOT_TYPE_FFT_MEASUREMENT:
-      case E_PLOT_TYPE_CURVE_STATS:
-      {
-         MainWindow* parentPlot = m_curveCmdr->getMainPlot(m_yAxis.dataSrc.plotName);
-
-         bool valid = (m_plotType != E_PLOT_TYPE_FFT_MEASUREMENT || parentPlot->areFftMeasurementsVisible()); // Only plot FFT Measurement if the measurement are visible on the parent.
-
-         if(parentPlot != NULL && valid)
-         {
-            m_ySrcData.clear(); // Clear out previous values, only sending 1 point.
-            if(m_plotType == E_PLOT_TYPE_FFT_MEASUREMENT)
-            {
-               m_ySrcData.push_back(parentPlot->getFftMeasurement(m_yAxis.fftMeasurementType)); // Grab the FFT Meaurement value to be plotted.
-            }
-            else
-            {
-               m_ySrcData.push_back(parentPlot->getCurveStat(m_yAxis.dataSrc.curveName, m_yAxis.curveStatType));
-            }
-
-            // Set the FFT Measurement Child Plot Size.
-            if(m_curveStatsChildSize != m_yAxis.curveStatstPlotSize && m_yAxis.curveStatstPlotSize > 0)
-            {
-               m_curveStatsChildSize = m_yAxis.curveStatstPlotSize;
-            }
-
-            // Check if we need to use a previous sibling curve point index value.
-            curveStatsChildParam_getIndex( m_yAxis.dataSrc.plotName,
-                                           m_plotName,
-                                           m_curveName,
-                                           parentGroupMsgId,
-                                           m_curveStatsChildSize,
-                                           m_curveStatsChildPointIndex );
-
-            // Update the Child Plot with the new FFT Measurement value.
-            update1dChildCurve(m_curveName, m_plotType, m_curveStatsChildPointIndex, m_ySrcData, parentCurveMsgId);
-
-            if(++m_curveStatsChildPointIndex >= m_curveStatsChildSize)
-            {
-               m_curveStatsChildPointIndex = 0;
-            }
-         }
+         addJobResult(job, m_curveName, offset, mathOut);
       }
       break;
       default:
-         // TODO should I do something here???
       break;
    }
-
-   setToParentsSampleRate();
-
-   m_lastGroupMsgId = parentGroupMsgId;
 }
 
 void ChildCurve::setToParentsSampleRate()
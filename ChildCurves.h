@@ -19,9 +19,14 @@
 #ifndef ChildCurves_h
 #define ChildCurves_h
 
+#include <list>
 #include <QWidget>
 #include <QString>
 #include <QVector>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThreadPool>
+#include <QRunnable>
 #include <PlotHelperTypes.h>
 #include "CurveData.h"
 #include "fftHelper.h"
@@ -49,6 +54,8 @@ public:
                tParentCurveInfo xAxis,
                tParentCurveInfo yAxis);
 
+   ~ChildCurve();
+
    void anotherCurveChanged( QString plotName,
                              QString curveName,
                              unsigned int parentStartIndex,
@@ -62,6 +69,9 @@ public:
    QString getPlotName(){return m_plotName;}
    QString getCurveName(){return m_curveName;}
 
+   // Called from a worker thread. Processes this child curve's queued jobs, one at a time.
+   void runQueuedJobs();
+
 private:
 
    // Types
@@ -73,6 +83,30 @@ private:
       unsigned int parentStopIndex;
    }tParentUpdateChunk;
 
+   typedef struct
+   {
+      QString curveName;
+      ePlotType plotType;
+      unsigned int sampleStartIndex;
+      dubVect yPoints;
+   }tChildCurveJobResult;
+
+   // The samples grabbed from the parent curve(s) on the GUI thread that need to be processed
+   // on a worker thread to generate the child curve samples.
+   typedef struct
+   {
+      PlotMsgIdType parentCurveMsgId;
+      unsigned int jobNum;
+      ePlotType plotType; // The plot type of the generated child curve.
+      unsigned int offset;
+      bool childIsInScrollMode;
+      bool recalcsAllPoints; // Each job generates all the child points (i.e. FFT). Older jobs can be dropped.
+      bool superseded;
+      dubVect xSrcData;
+      dubVect ySrcData;
+      std::list<tChildCurveJobResult> results;
+   }tChildCurveJob;
+
    // Eliminate default, copy, assign
    ChildCurve();
    ChildCurve(ChildCurve const&);
@@ -122,6 +156,10 @@ private:
                      unsigned int parentStartIndex = 0,
                      unsigned int parentStopIndex = 0);
 
+   void queueJob(tChildCurveJob* job);
+   void processJob(tChildCurveJob* job);
+   void addJobResult(tChildCurveJob* job, const QString& curveName, unsigned int sampleStartIndex, dubVect& yPoints);
+
    CurveCommander* m_curveCmdr;
    QString m_plotName;
    QString m_curveName;
@@ -145,6 +183,22 @@ private:
    
    complexFFT m_complexFFT; // Class for doing Complex FFTs
    realFFT m_realFFT; // Class for doing Real FFTs
+
+   // Worker thread job handling. m_numJobsQueued is only accessed from the GUI thread,
+   // the job lists and flags are protected by m_jobMutex.
+   unsigned int m_numJobsQueued;
+   QMutex m_jobMutex;
+   QWaitCondition m_jobRunningCond;
+   std::list<tChildCurveJob*> m_queuedJobs;
+   std::list<tChildCurveJob*> m_finishedJobs;
+   bool m_jobRunning;
+   bool m_destroying;
+
+private slots:
+   void jobFinishedSlot();
+
+signals:
+   void jobFinishedSignal();
 };
 
 #endif
@@ -85,9 +85,6 @@ double Cursor::determineClosestPointIndex(QPointF pos, maxMinXY maxMin, double d
    double xPos = pos.x();
    double yPos = pos.y();
 
-   const double* xPoints = m_parentCurve->isXNormalized() ? m_parentCurve->getNormXPoints() : m_parentCurve->getXPoints();
-   const double* yPoints = m_parentCurve->isYNormalized() ? m_parentCurve->getNormYPoints() : m_parentCurve->getYPoints();
-
    // The data will not be displayed on the plot 1:1, need to adjust
    // delta calculation to make the x and y delta ratio 1:1
    double width = (maxMin.maxX - maxMin.minX);
@@ -116,8 +113,8 @@ double Cursor::determineClosestPointIndex(QPointF pos, maxMinXY maxMin, double d
          minPointIndex = m_parentCurve->getNumPoints() - 1;
    }
 
-   double xDelta = fabs(xPoints[minPointIndex] - xPos)*inverseWidth;
-   double yDelta = fabs(yPoints[minPointIndex] - yPos)*inverseHeight;
+   double xDelta = fabs(m_parentCurve->getGuiXPoint(minPointIndex) - xPos)*inverseWidth;
+   double yDelta = fabs(m_parentCurve->getGuiYPoint(minPointIndex) - yPos)*inverseHeight;
    double minDist = std::numeric_limits<double>::max(); // Initialize to maximum possible double value.
    bool validMinDist = isDoubleValid(xDelta) && isDoubleValid(yDelta);
 
@@ -148,8 +145,8 @@ double Cursor::determineClosestPointIndex(QPointF pos, maxMinXY maxMin, double d
 
    for(int i = startIndex; i < endIndex; ++i)
    {
-      xDelta = fabs(xPoints[i] - xPos)*inverseWidth;
-      yDelta = fabs(yPoints[i] - yPos)*inverseHeight;
+      xDelta = fabs(m_parentCurve->getGuiXPoint(i) - xPos)*inverseWidth;
+      yDelta = fabs(m_parentCurve->getGuiYPoint(i) - yPos)*inverseHeight;
 
       // For 2D plots, never select 'Not a Number' points (only need to do this for 2D because the extra 1D specific code
       // above seems to work pretty well with invalid points).
@@ -194,26 +191,26 @@ bool Cursor::peakSearch(maxMinXY searchWindow)
 
    if(m_parentCurve != NULL)
    {
-      const double* xPoints = m_parentCurve->isXNormalized() ? m_parentCurve->getNormXPoints() : m_parentCurve->getXPoints();
-      const double* yPoints = m_parentCurve->isYNormalized() ? m_parentCurve->getNormYPoints() : m_parentCurve->getYPoints();
       int numPoints = (int)m_parentCurve->getNumPoints();
 
       for(int i = 0; i < numPoints; ++i)
       {
+         double yPoint = m_parentCurve->getGuiYPoint(i);
+
          // Check if the point is within the search window (search window is probably the current zoom).
-         if( yPoints[i] <= searchWindow.maxY && yPoints[i] >= searchWindow.minY &&
-             xPoints[i] <= searchWindow.maxX && xPoints[i] >= searchWindow.minX )
+         if( yPoint <= searchWindow.maxY && yPoint >= searchWindow.minY &&
+             m_parentCurve->getGuiXPoint(i) <= searchWindow.maxX && m_parentCurve->getGuiXPoint(i) >= searchWindow.minX )
          {
             if(!validPeakFound)
             {
                validPeakFound = true;
                peakIndex = i;
-               maxValue = yPoints[i];
+               maxValue = yPoint;
             }
-            else if(yPoints[i] > maxValue)
+            else if(yPoint > maxValue)
             {
                peakIndex = i;
-               maxValue = yPoints[i];
+               maxValue = yPoint;
             }
          }
       }
@@ -232,11 +229,11 @@ void Cursor::showCursor()
    if(m_pointIndex < m_parentCurve->getNumPoints())
    {
       // Make sure to check if cursor point needs to account for normalization.
-      const double* xPoints = m_parentCurve->isXNormalized() ? m_parentCurve->getNormXPoints() : m_parentCurve->getXPoints();
-      const double* yPoints = m_parentCurve->isYNormalized() ? m_parentCurve->getNormYPoints() : m_parentCurve->getYPoints();
+      double xPoint = m_parentCurve->getGuiXPoint(m_pointIndex);
+      double yPoint = m_parentCurve->getGuiYPoint(m_pointIndex);
 
       // Store off the non-normalized seleted point.
-      m_xPoint = m_parentCurve->getXPoints()[m_pointIndex];
+      m_xPoint = m_parentCurve->getXPoint(m_pointIndex);
       m_yPoint = m_parentCurve->getYPoints()[m_pointIndex];
 
       // QwtPlotCurve wants to be called with new and deletes the symbol on its own.
@@ -245,7 +242,7 @@ void Cursor::showCursor()
                                          QPen( Qt::black, 1),
                                          QSize(9, 9) ) );
 
-      m_curve->setSamples( &xPoints[m_pointIndex], &yPoints[m_pointIndex], 1);
+      m_curve->setSamples( &xPoint, &yPoint, 1);
 
       outOfRange = false;
 
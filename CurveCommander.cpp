@@ -16,7 +16,11 @@
  * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
  * DEALINGS IN THE SOFTWARE.
  */
+#include <algorithm>
+#include <functional>
 #include <QFileDialog>
+#include <QThreadPool>
+#include <QRunnable>
 #include "CurveCommander.h"
 #include "plotguimain.h"
 #include "curveproperties.h"
@@ -29,11 +33,15 @@
 #include "FileSystemOperations.h"
 
 #define MAX_NUM_STORED_CURVES (1000)
+#define MEMORY_BUDGET_CHECK_PERIOD_MS (1000)
+
+extern size_t g_memoryBudget;
 
 CurveCommander::CurveCommander(plotGuiMain *parent):
    m_plotGuiMain(parent),
    m_curvePropGui(NULL),
-   m_createPlotFromDataGui(NULL)
+   m_createPlotFromDataGui(NULL),
+   m_storedMsgsNumBytes(0)
 {
    QObject::connect(this, SIGNAL(plotWindowCloseSignal(QString)),
                     this, SLOT(plotWindowCloseSlot(QString)), Qt::QueuedConnection);
@@ -41,6 +49,18 @@ CurveCommander::CurveCommander(plotGuiMain *parent):
                     this, SLOT(curvePropertiesGuiCloseSlot()), Qt::QueuedConnection);
    QObject::connect(this, SIGNAL(createPlotFromDataGuiCloseSignal()),
                     this, SLOT(createPlotFromDataGuiCloseSlot()), Qt::QueuedConnection);
+   QObject::connect(this, SIGNAL(childCurveJobsAbandonedSignal()),
+                    this, SLOT(childCurveJobsAbandonedSlot()), Qt::QueuedConnection);
+   QObject::connect(this, SIGNAL(outOfCoreIndexBuildDoneSignal()),
+                    this, SLOT(outOfCoreIndexBuildDoneSlot()), Qt::QueuedConnection);
+   QObject::connect(this, SIGNAL(outOfCoreZoomChangedSignal(QString)),
+                    this, SLOT(outOfCoreZoomChangedSlot(QString)), Qt::QueuedConnection);
+
+   if(g_memoryBudget > 0)
+   {
+      connect(&m_memoryBudgetTimer, SIGNAL(timeout()), this, SLOT(memoryBudgetTimerSlot()));
+      m_memoryBudgetTimer.start(MEMORY_BUDGET_CHECK_PERIOD_MS);
+   }
 }
 
 CurveCommander::~CurveCommander()
@@ -54,6 +74,9 @@ CurveCommander::~CurveCommander()
       delete *iter;
    }
 
+   // Index builds that haven't started are dropped, wait for the running ones since they call back into this object.
+   m_outOfCoreIndexThreadPool.clear();
+   m_outOfCoreIndexThreadPool.waitForDone();
 }
 
 void CurveCommander::curveUpdated( plotMsgGroup* groupMsg,
@@ -170,6 +193,7 @@ bool CurveCommander::removePlot(QString plotName, bool safeRemove)
    if(plotWasRemoved)
    {
       removeOrphanedChildCurves();
+      removeOrphanedOutOfCoreCurves();
       curveStatsChildParam_plotRemoved(plotName);
 
       // Update Curve Properties GUI
@@ -300,7 +324,7 @@ void CurveCommander::readPlotMsg(UnpackMultiPlotMsg* plotMsg)
    }
 }
 
-void CurveCommander::create1dCurve(QString plotName, QString curveName, ePlotType plotType, dubVect& yPoints, tCurveMathProperties* mathProps)
+void CurveCommander::create1dCurve(QString plotName, QString curveName, ePlotType plotType, dubVect& yPoints, tCurveMathProperties* mathProps, ePlotDataTypes yAxisDataType)
 {
    createPlot(plotName);
 
@@ -309,6 +333,7 @@ void CurveCommander::create1dCurve(QString plotName, QString curveName, ePlotTyp
    plotMsg->m_plotName = plotName.toStdString();
    plotMsg->m_curveName = curveName.toStdString();
    plotMsg->m_plotType = plotType;
+   plotMsg->m_yAxisDataType = yAxisDataType;
    plotMsg->m_yAxisValues = yPoints;
    if(mathProps != NULL)
    {
@@ -662,39 +687,261 @@ void CurveCommander::createPlotFromDataGuiCloseSlot()
    }
 }
 
-void CurveCommander::storePlotMsg(const char* msgPtr, unsigned int msgSize, QString& plotName, QString& curveName)
+void CurveCommander::storePlotMsg(tPlotMsgBuffPtr msgBuff, const char* msgPtr, unsigned int msgSize, QString& plotName, QString& curveName)
 {
+   if(msgBuff == nullptr)
+   {
+      return; // Nothing is keeping the message memory valid, don't store it.
+   }
+
    tStoredMsg newMsg;
    newMsg.msgTime = QDateTime::currentDateTime();
    newMsg.name.curve = curveName;
    newMsg.name.plot = plotName;
    newMsg.msgPtr = msgPtr;
    newMsg.msgSize = msgSize;
+   newMsg.msgBuff = msgBuff; // The stored message keeps the buffer alive.
+
+   QMutexLocker ml(&m_storedMsgsMutex); // lock until end of function.
+
+   m_storedMsgs.push_back(newMsg);
+   m_storedMsgsNumBytes += msgSize;
+
+   // Limit the number of stored messages and the memory they hold on to. The byte limit matches the
+   // size of the old circular copy buffer. Always keep the newest message.
+   while( m_storedMsgs.size() > 1 &&
+          (m_storedMsgs.size() > MAX_NUM_STORED_CURVES || m_storedMsgsNumBytes > g_maxTcpPlotMsgSize) )
+   {
+      m_storedMsgsNumBytes -= m_storedMsgs.front().msgSize;
+      m_storedMsgs.pop_front();
+   }
+}
+
+// Keeps the curve samples and stored plot messages within the memory budget. Plots that are shown have
+// their samples brought back into RAM. When over budget, the samples of the biggest plots in hidden /
+// minimized windows are spilled to memory mapped temp files first, then the oldest stored plot messages
+// are dropped.
+void CurveCommander::memoryBudgetTimerSlot()
+{
+   typedef std::pair<size_t, MainWindow*> tPlotBytes;
+   std::vector<tPlotBytes> coldPlots;
+
+   m_storedMsgsMutex.lock();
+   size_t totalBytes = m_storedMsgsNumBytes;
+   m_storedMsgsMutex.unlock();
 
-   const char* msgEndPtr = msgPtr + msgSize;
+   foreach(QString key, m_allCurves.keys())
+   {
+      MainWindow* plotGui = m_allCurves[key].plotGui;
+      if(plotGui != NULL)
+      {
+         bool cold = plotGui->isHidden() || plotGui->isMinimized();
+         if(!cold)
+         {
+            plotGui->unspillCurveSamples();
+         }
+
+         size_t plotBytes = plotGui->getCurvesResidentBytes();
+         totalBytes += plotBytes;
+         if(cold && plotBytes > 0)
+         {
+            coldPlots.push_back(tPlotBytes(plotBytes, plotGui));
+         }
+      }
+   }
+
+   if(totalBytes <= g_memoryBudget)
+   {
+      return;
+   }
+
+   // Spill the biggest plots first.
+   std::sort(coldPlots.begin(), coldPlots.end(), std::greater<tPlotBytes>());
+   for(size_t i = 0; i < coldPlots.size() && totalBytes > g_memoryBudget; ++i)
+   {
+      coldPlots[i].second->spillCurveSamples();
+      totalBytes -= coldPlots[i].first - coldPlots[i].second->getCurvesResidentBytes();
+   }
 
    QMutexLocker ml(&m_storedMsgsMutex); // lock until end of function.
+   while(totalBytes > g_memoryBudget && m_storedMsgs.size() > 0)
+   {
+      totalBytes -= m_storedMsgs.front().msgSize;
+      m_storedMsgsNumBytes -= m_storedMsgs.front().msgSize;
+      m_storedMsgs.pop_front();
+   }
+}
 
-   std::list<tStoredMsg>::iterator iter = m_storedMsgs.begin();
-   while(iter != m_storedMsgs.end()) // Iterate over all stored msgs
+// Builds the index of an out of core raw file on a m_outOfCoreIndexThreadPool thread.
+class outOfCoreIndexRunner : public QRunnable
+{
+public:
+   outOfCoreIndexRunner(CurveCommander* curveCmdr, QSharedPointer<outOfCoreRawFile> file): m_curveCmdr(curveCmdr), m_file(file){}
+   void run(){m_file->buildIndex(); m_curveCmdr->outOfCoreIndexBuildDone();}
+private:
+   CurveCommander* m_curveCmdr;
+   QSharedPointer<outOfCoreRawFile> m_file;
+};
+
+void CurveCommander::openOutOfCoreRawFile( QString plotName,
+                                           QString curveName1,
+                                           QString curveName2,
+                                           QString filePath,
+                                           eRawTypes rawType,
+                                           int64_t byteOffset,
+                                           int64_t numBytes,
+                                           tCurveMathProperties* mathProps )
+{
+   QSharedPointer<outOfCoreRawFile> file(new outOfCoreRawFile(filePath, rawType, byteOffset, numBytes));
+   if(file->getNumSamples() <= 0)
    {
-      // If start of old message falls within the new message memory
-      // it has been overwritten.
-      if((*iter).msgPtr >= msgPtr && (*iter).msgPtr < msgEndPtr)
+      return;
+   }
+
+   for(int channel = 0; channel < file->getNumChannels(); ++channel)
+   {
+      // If this curve was already showing an out of core file, the new file replaces it.
+      QString curveName = channel == 0 ? curveName1 : curveName2;
+      std::list<tOutOfCoreCurve>::iterator iter = m_outOfCoreCurves.begin();
+      while(iter != m_outOfCoreCurves.end())
       {
-         // Data has been invalided by new msg, remove from list.
-         m_storedMsgs.erase(iter++);
+         if(iter->plotName == plotName && iter->curveName == curveName)
+            m_outOfCoreCurves.erase(iter++);
+         else
+            ++iter;
+      }
+
+      tOutOfCoreCurve newCurve;
+      newCurve.plotName = plotName;
+      newCurve.curveName = curveName;
+      newCurve.channel = channel;
+      newCurve.file = file;
+      newCurve.useMathProps = mathProps != NULL;
+      if(mathProps != NULL)
+         newCurve.mathProps = *mathProps;
+      newCurve.curveCreated = false;
+      newCurve.viewPending = false;
+      m_outOfCoreCurves.push_back(newCurve);
+   }
+
+   if(file->loadIndex())
+   {
+      // The index was built the last time this file was opened.
+      createOutOfCoreCurves();
+   }
+   else
+   {
+      // The curves will be created when the index is done.
+      m_outOfCoreIndexThreadPool.start(new outOfCoreIndexRunner(this, file));
+   }
+}
+
+void CurveCommander::outOfCoreIndexBuildDoneSlot()
+{
+   createOutOfCoreCurves();
+}
+
+// Creates the curves for the out of core files whose index is ready. The curves start out with the whole file in view.
+void CurveCommander::createOutOfCoreCurves()
+{
+   std::list<tOutOfCoreCurve>::iterator iter = m_outOfCoreCurves.begin();
+   while(iter != m_outOfCoreCurves.end())
+   {
+      if(!iter->curveCreated && iter->file->isIndexReady())
+      {
+         dubVect yPoints;
+         tLinear sourceIndex;
+         iter->view = iter->file->getView(0, iter->file->getNumSamples());
+         if(iter->file->readView(iter->view, iter->channel, yPoints, sourceIndex))
+         {
+            iter->curveCreated = true;
+            iter->viewPending = true;
+            create1dCurve( iter->plotName, iter->curveName, E_PLOT_TYPE_1D, yPoints,
+                           iter->useMathProps ? &iter->mathProps : NULL, iter->file->getDataType() );
+            ++iter;
+         }
+         else
+         {
+            m_outOfCoreCurves.erase(iter++);
+         }
+      }
+      else if(!iter->curveCreated && iter->file->isIndexBuildDone())
+      {
+         // Failed to build the index.
+         m_outOfCoreCurves.erase(iter++);
       }
       else
       {
          ++iter;
       }
    }
-   m_storedMsgs.push_back(newMsg);
+}
 
-   while(m_storedMsgs.size() > MAX_NUM_STORED_CURVES)
+void CurveCommander::initOutOfCoreCurve(const QString& plotName, const QString& curveName, CurveData* curve)
+{
+   for(std::list<tOutOfCoreCurve>::iterator iter = m_outOfCoreCurves.begin(); iter != m_outOfCoreCurves.end(); ++iter)
    {
-      m_storedMsgs.pop_front();
+      if(iter->viewPending && iter->plotName == plotName && iter->curveName == curveName)
+      {
+         // The curve was created with the samples of the initial view, but it doesn't know where they are in the file yet.
+         dubVect yPoints;
+         tLinear sourceIndex;
+         if(iter->file->readView(iter->view, iter->channel, yPoints, sourceIndex))
+         {
+            curve->setOutOfCoreView(yPoints, sourceIndex, iter->file->getNumSamples());
+         }
+         iter->viewPending = false;
+         break;
+      }
+   }
+}
+
+// Loads the part of the out of core files that is in view.
+void CurveCommander::outOfCoreZoomChangedSlot(QString plotName)
+{
+   MainWindow* plotGui = getMainPlot(plotName);
+   if(plotGui == NULL)
+   {
+      return;
+   }
+
+   for(std::list<tOutOfCoreCurve>::iterator iter = m_outOfCoreCurves.begin(); iter != m_outOfCoreCurves.end(); ++iter)
+   {
+      long long startIndex = 0;
+      long long stopIndex = 0;
+      if( iter->plotName != plotName || !iter->curveCreated || iter->viewPending ||
+          !plotGui->getOutOfCoreSourceRange(iter->curveName, startIndex, stopIndex) )
+      {
+         continue;
+      }
+
+      tOutOfCoreView view = iter->file->getView(startIndex, stopIndex);
+      if(!outOfCoreRawFile::viewContains(iter->view, view))
+      {
+         dubVect yPoints;
+         tLinear sourceIndex;
+         if(iter->file->readView(view, iter->channel, yPoints, sourceIndex))
+         {
+            plotGui->setOutOfCoreView(iter->curveName, yPoints, sourceIndex, iter->file->getNumSamples());
+            iter->view = view;
+         }
+      }
+   }
+}
+
+void CurveCommander::removeOrphanedOutOfCoreCurves()
+{
+   std::list<tOutOfCoreCurve>::iterator iter = m_outOfCoreCurves.begin();
+   while(iter != m_outOfCoreCurves.end())
+   {
+      if(iter->curveCreated && !iter->viewPending && !validCurve(iter->plotName, iter->curveName))
+      {
+         m_outOfCoreCurves.erase(iter++);
+      }
+      else
+      {
+         ++iter;
+      }
    }
 }
 
@@ -726,7 +973,7 @@ void CurveCommander::restorePlotMsg(tStoredMsg msgToRestore, tPlotCurveName plot
    }
    if(validInput)
    {
-      m_plotGuiMain->restorePlotMsg(msgToRestore.msgPtr, msgToRestore.msgSize, plotCurveName);
+      m_plotGuiMain->restorePlotMsg(msgToRestore.msgBuff, msgToRestore.msgPtr, msgToRestore.msgSize, plotCurveName);
    }
 }
 
@@ -746,6 +993,7 @@ void CurveCommander::removeCurve(const QString& plotName, const QString& curveNa
          m_allCurves[plotName].curves.remove(curveName);
 
          removeOrphanedChildCurves();
+         removeOrphanedOutOfCoreCurves();
 
          // Update Curve Properties GUI
          if(m_curvePropGui != NULL)
@@ -904,6 +1152,17 @@ bool CurveCommander::childPlots_haveAllMsgsBeenProcessed(PlotMsgIdType parentMsg
          {
             return false;
          }
+
+         // Child curve jobs that are still being processed on a worker thread also need to finish.
+         for( tParentMsgIdGroup::iterator pendingParentMsgId = m_pendingChildJobParentMsgIDs.begin();
+              pendingParentMsgId != m_pendingChildJobParentMsgIDs.end();
+              ++pendingParentMsgId )
+         {
+            if((*pendingParentMsgId) == (*curParentMsgId))
+            {
+               return false;
+            }
+         }
       }
       return true;
    }
@@ -948,6 +1207,65 @@ void CurveCommander::childPlots_addMsgGroupToParentMsgIdProcessedList(plotMsgGro
    }
 }
 
+bool CurveCommander::childPlots_removePendingChildJob(PlotMsgIdType parentMsgID)
+{
+   for(tParentMsgIdGroup::iterator iter = m_pendingChildJobParentMsgIDs.begin(); iter != m_pendingChildJobParentMsgIDs.end(); ++iter)
+   {
+      if((*iter) == parentMsgID)
+      {
+         m_pendingChildJobParentMsgIDs.erase(iter); // Only remove 1 entry, there might be other jobs for this parent message.
+         return true;
+      }
+   }
+   return false;
+}
+
+void CurveCommander::childCurveJobQueued(PlotMsgIdType parentMsgID)
+{
+   m_childPlots_mutex.lock();
+   m_pendingChildJobParentMsgIDs.push_back(parentMsgID);
+   m_childPlots_mutex.unlock();
+}
+
+void CurveCommander::childCurveJobDone(PlotMsgIdType parentMsgID)
+{
+   m_childPlots_mutex.lock();
+   if(childPlots_removePendingChildJob(parentMsgID))
+   {
+      // If this was the last thing the parent message group was waiting on, the child plot messages will be sent out now.
+      childPlots_plot(parentMsgID);
+   }
+   m_childPlots_mutex.unlock();
+}
+
+void CurveCommander::childCurveJobsAbandoned(const tParentMsgIdGroup& parentMsgIDs)
+{
+   // This is called when a child curve is being deleted, which might be in the middle of Curve Commander
+   // processing. Check the parent message groups later, from the event loop.
+   m_childPlots_mutex.lock();
+   for(tParentMsgIdGroup::const_iterator iter = parentMsgIDs.begin(); iter != parentMsgIDs.end(); ++iter)
+   {
+      if(childPlots_removePendingChildJob(*iter))
+      {
+         m_abandonedChildJobParentMsgIDs.push_back(*iter);
+      }
+   }
+   m_childPlots_mutex.unlock();
+   emit childCurveJobsAbandonedSignal();
+}
+
+void CurveCommander::childCurveJobsAbandonedSlot()
+{
+   m_childPlots_mutex.lock();
+   tParentMsgIdGroup parentMsgIDs;
+   parentMsgIDs.swap(m_abandonedChildJobParentMsgIDs);
+   for(tParentMsgIdGroup::iterator iter = parentMsgIDs.begin(); iter != parentMsgIDs.end(); ++iter)
+   {
+      childPlots_plot(*iter);
+   }
+   m_childPlots_mutex.unlock();
+}
+
 void CurveCommander::childPlots_addChildUpdateToList(tChildAndParentID childAndParentID)
 {
    m_childPlots_mutex.lock();
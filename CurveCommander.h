@@ -25,9 +25,12 @@
 #include <QMutex>
 #include <list>
 #include <QSharedPointer>
+#include <QTimer>
+#include <QThreadPool>
 #include "CurveData.h"
 #include "mainwindow.h"
 #include "ipBlocker.h"
+#include "outOfCoreRawFile.h"
 
 // Debug Defines
 //#define CHILD_MSG_GROUPING_DEBUG
@@ -43,6 +46,19 @@ typedef QMap<QString, tPlotGuiCurveInfo> tCurveCommanderInfo;
 typedef std::list<PlotMsgIdType> tParentMsgIdGroup;
 typedef struct{PlotMsgIdType parentMsgID; UnpackPlotMsg* childMsg;}tChildAndParentID;
 
+typedef struct
+{
+   QString plotName;
+   QString curveName;
+   int channel; // Interleaved raw files have 2 channels.
+   QSharedPointer<outOfCoreRawFile> file;
+   bool useMathProps;
+   tCurveMathProperties mathProps;
+   bool curveCreated;
+   bool viewPending; // The curve has been created, but the initial view hasn't been set yet.
+   tOutOfCoreView view; // What is loaded in the curve.
+}tOutOfCoreCurve;
+
 
 class plotGuiMain;
 class curveProperties;
@@ -82,7 +98,7 @@ public:
 
     void readPlotMsg(UnpackMultiPlotMsg* plotMsg);
 
-    void create1dCurve(QString plotName, QString curveName, ePlotType plotType, dubVect& yPoints, tCurveMathProperties* mathProps = NULL);
+    void create1dCurve(QString plotName, QString curveName, ePlotType plotType, dubVect& yPoints, tCurveMathProperties* mathProps = NULL, ePlotDataTypes yAxisDataType = E_FLOAT_64);
     void create2dCurve(QString plotName, QString curveName, dubVect& xPoints, dubVect& yPoints, tCurveMathProperties* mathProps = NULL);
 
     void update1dChildCurve( QString& plotName, 
@@ -133,7 +149,7 @@ public:
     QString getOpenSavePath(QString fileName);
     void setOpenSavePath(QString path);
 
-    void storePlotMsg(const char *msgPtr, unsigned int msgSize, QString& plotName, QString& curveName);
+    void storePlotMsg(tPlotMsgBuffPtr msgBuff, const char *msgPtr, unsigned int msgSize, QString& plotName, QString& curveName);
     void getStoredPlotMsgs(QVector<tStoredMsg> &storedMsgs);
 
     void restorePlotMsg(tStoredMsg msgToRestore, tPlotCurveName plotCurveName);
@@ -149,7 +165,27 @@ public:
 
     ipBlocker* getIpBlocker(){return &m_ipBlocker;}
 
+    // Child curves that process samples on a worker thread use these to keep the child plot messages
+    // for a parent message group from being sent out until the worker thread jobs are done.
+    void childCurveJobQueued(PlotMsgIdType parentMsgID);
+    void childCurveJobDone(PlotMsgIdType parentMsgID);
+    void childCurveJobsAbandoned(const tParentMsgIdGroup& parentMsgIDs);
+
     void clearAllPlotCurves();
+
+    // Large raw files that can't be loaded into memory. Only the part of the file that is in view is loaded.
+    void openOutOfCoreRawFile( QString plotName,
+                               QString curveName1,
+                               QString curveName2,
+                               QString filePath,
+                               eRawTypes rawType,
+                               int64_t byteOffset,
+                               int64_t numBytes,
+                               tCurveMathProperties* mathProps = NULL );
+    void outOfCoreIndexBuildDone(){emit outOfCoreIndexBuildDoneSignal();} // Called from the index build thread.
+    void outOfCoreZoomChanged(QString plotName){emit outOfCoreZoomChangedSignal(plotName);}
+    // This function should be called after a curve has been created / reset in MainWindow.
+    void initOutOfCoreCurve(const QString& plotName, const QString& curveName, CurveData* curve);
 private:
     CurveCommander();
 
@@ -161,9 +197,12 @@ private:
                                           PlotMsgIdType parentGroupMsgId,
                                           PlotMsgIdType parentCurveMsgId );
     void removeOrphanedChildCurves();
+    void removeOrphanedOutOfCoreCurves();
+    void createOutOfCoreCurves();
 
     std::list<tParentMsgIdGroup>::iterator childPlots_getParentMsgIdGroupIter(PlotMsgIdType parentMsgID);
     bool childPlots_haveAllMsgsBeenProcessed(PlotMsgIdType parentMsgID);
+    bool childPlots_removePendingChildJob(PlotMsgIdType parentMsgID);
     void childPlots_eraseParentIdsFromProcessedList(std::list<tParentMsgIdGroup>::iterator& parentMsgIdGroup);
     void childPlots_createParentMsgIdGroup(plotMsgGroup* group);
     void childPlots_createParentMsgIdGroup(UnpackMultiPlotMsg* plotMsg);
@@ -190,24 +229,42 @@ private:
     std::list<ChildCurve*> m_childCurves;
 
     std::list<tStoredMsg> m_storedMsgs;
+    size_t m_storedMsgsNumBytes;
     QMutex m_storedMsgsMutex;
 
     QMutex m_childPlots_mutex;
     std::list<tParentMsgIdGroup> m_parentMsgIdGroups;
     tParentMsgIdGroup m_processedParentMsgIDs;
     std::list<tChildAndParentID> m_queuedChildCurveMsgs;
+    tParentMsgIdGroup m_pendingChildJobParentMsgIDs; // One entry per child curve job that hasn't finished yet.
+    tParentMsgIdGroup m_abandonedChildJobParentMsgIDs;
 
     ipBlocker m_ipBlocker;
 
+    QTimer m_memoryBudgetTimer;
+
+    std::list<tOutOfCoreCurve> m_outOfCoreCurves;
+
+    // Building an out of core file's index reads the whole file. The builds get their own
+    // thread pool so they don't hold up the short jobs on the global thread pool.
+    QThreadPool m_outOfCoreIndexThreadPool;
+
 public slots:
     void plotWindowCloseSlot(QString plotName);
     void curvePropertiesGuiCloseSlot();
     void createPlotFromDataGuiCloseSlot();
+    void childCurveJobsAbandonedSlot();
+    void memoryBudgetTimerSlot();
+    void outOfCoreIndexBuildDoneSlot();
+    void outOfCoreZoomChangedSlot(QString plotName);
 
 signals:
     void plotWindowCloseSignal(QString plotName);
     void curvePropertiesGuiCloseSignal();
     void createPlotFromDataGuiCloseSignal();
+    void childCurveJobsAbandonedSignal();
+    void outOfCoreIndexBuildDoneSignal();
+    void outOfCoreZoomChangedSignal(QString plotName);
 };
 
 
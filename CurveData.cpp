@@ -1,4 +1,4 @@
-/* Copyright 2013 - 2025 Dan Williams. All Rights Reserved.
+/* Copyright 2013 - 2026 Dan Williams. All Rights Reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of this
  * software and associated documentation files (the "Software"), to deal in the Software
@@ -17,6 +17,7 @@
  * DEALINGS IN THE SOFTWARE.
  */
 #include <limits>       // std::numeric_limits
+#include <QAtomicInt>
 #include "CurveData.h"
 #include "fftHelper.h"
 #include "AmFmPmDemod.h"
@@ -31,18 +32,15 @@
 ///////////////////////////////////////////
 // Constants
 ///////////////////////////////////////////
-#define MIN_SAMPLE_PER_MAXMIN_SEGMENT (250)
-#define MAX_SAMPLE_PER_MAXMIN_SEGMENT (1000)
+#define SAMPLES_PER_MAXMIN_LEAF (256)
 
 
 CurveData::CurveData( QwtPlot* parentPlot,
                       const CurveAppearance &curveAppearance,
                       const UnpackPlotMsg *data):
    m_parentPlot(parentPlot),
-   xOrigPoints(data->m_xAxisValues),
-   yOrigPoints(data->m_yAxisValues),
-   smartMaxMinXPoints(&xPoints, MIN_SAMPLE_PER_MAXMIN_SEGMENT, MAX_SAMPLE_PER_MAXMIN_SEGMENT),
-   smartMaxMinYPoints(&yPoints, MIN_SAMPLE_PER_MAXMIN_SEGMENT, MAX_SAMPLE_PER_MAXMIN_SEGMENT),
+   smartMaxMinXPoints(&xPoints, SAMPLES_PER_MAXMIN_LEAF),
+   smartMaxMinYPoints(&yPoints, SAMPLES_PER_MAXMIN_LEAF),
    plotDim(plotActionToPlotDim(data->m_plotAction)),
    plotType(data->m_plotType),
    appearance(curveAppearance),
@@ -55,8 +53,13 @@ CurveData::CurveData( QwtPlot* parentPlot,
    fftSpecAn(data->m_plotType)
 {
    init();
+   yOrigPoints.assign(data->m_yAxisValues, data->m_yAxisDataType);
    if(plotDim != E_PLOT_DIM_1D)
    {
+      xOrigPoints.assign(data->m_xAxisValues, data->m_xAxisDataType);
+      xOrigPointsLinear.m = NAN; // xOrigPoints aren't generated.
+      xOrigPointsLinear.b = NAN;
+
       // Make sure the number of points are the same for x and y.
       if(xOrigPoints.size() > yOrigPoints.size())
          xOrigPoints.resize(yOrigPoints.size());
@@ -82,6 +85,42 @@ CurveData::CurveData( QwtPlot* parentPlot,
    plotSize_nonScrollModeVersion = std::max(plotSize_nonScrollModeVersion, oldestPoint_nonScrollModeVersion);
 }
 
+CurveData::CurveData(CurveData* frontCurve):
+   m_parentPlot(frontCurve->m_parentPlot),
+   smartMaxMinXPoints(&xPoints, SAMPLES_PER_MAXMIN_LEAF),
+   smartMaxMinYPoints(&yPoints, SAMPLES_PER_MAXMIN_LEAF),
+   plotDim(frontCurve->plotDim),
+   plotType(frontCurve->plotType),
+   appearance(frontCurve->appearance),
+   curve(NULL),
+   lastMsgIpAddr(0),
+   lastMsgXAxisType(E_INVALID_DATA_TYPE),
+   lastMsgYAxisType(E_INVALID_DATA_TYPE),
+   maxNumPointsFromPlotMsg(0),
+   fftSpecAnTraceType(frontCurve->fftSpecAnTraceType),
+   fftSpecAn(frontCurve->plotType)
+{
+   init();
+   guiPointsDeferred = true; // Back buffers never hand points to the GUI.
+   this->frontCurve = frontCurve;
+   frontSampleStateVersion = frontCurve->sampleStateVersion;
+
+   // The settings the new samples are processed with.
+   scrollMode = frontCurve->scrollMode;
+   normFactor = frontCurve->normFactor;
+   xNormalized = frontCurve->xNormalized;
+   yNormalized = frontCurve->yNormalized;
+   sampleRate = frontCurve->sampleRate;
+   samplePeriod = frontCurve->samplePeriod;
+   sampleRateIsUserSpecified = frontCurve->sampleRateIsUserSpecified;
+   mathOpsXAxis = frontCurve->mathOpsXAxis;
+   mathOpsYAxis = frontCurve->mathOpsYAxis;
+   fusedMathOpsXAxis = frontCurve->fusedMathOpsXAxis;
+   fusedMathOpsYAxis = frontCurve->fusedMathOpsYAxis;
+
+   copySampleState(frontCurve, false);
+}
+
 CurveData::~CurveData()
 {
    if(curve != NULL)
@@ -117,6 +156,26 @@ void CurveData::init()
    visible = false;
    hidden = false;
    scrollMode = false;
+   guiPointsDeferred = false;
+
+   implicitXPoints = false;
+   xOrigPointsLinear.m = 1.0;
+   xOrigPointsLinear.b = 0.0;
+   xPointsLinear = xOrigPointsLinear;
+   materializedXPointsLinear.m = NAN; // Nothing has been generated yet.
+   materializedXPointsLinear.b = NAN;
+
+   outOfCoreSourceIndex.m = 1.0;
+   outOfCoreSourceIndex.b = 0.0;
+   outOfCoreNumSamples = 0;
+
+   sampleStateChanged();
+   frontCurve = NULL;
+   frontSampleStateVersion = 0;
+
+   numGuiPoints = 0;
+   guiPointsBytesAllocated_lastRedraw = 0;
+   guiPointsBytesAllocated_total = 0;
 
    oldestPoint_nonScrollModeVersion = 0;
    plotSize_nonScrollModeVersion = 0;
@@ -140,7 +199,12 @@ void CurveData::initCurve()
 
 void CurveData::fill1DxPoints()
 {
-   xOrigPoints.resize(yOrigPoints.size());
+   unsigned int xPointSize = yOrigPoints.size();
+
+   // The 1D X axis points are evenly spaced, x[i] = (m * i) + b.
+   tLinear xAxis;
+   xAxis.m = 1.0;
+   xAxis.b = 0.0;
    switch(plotType)
    {
       case E_PLOT_TYPE_1D:
@@ -153,65 +217,136 @@ void CurveData::fill1DxPoints()
       case E_PLOT_TYPE_MATH_BETWEEN_CURVES:
       case E_PLOT_TYPE_FFT_MEASUREMENT:
       case E_PLOT_TYPE_CURVE_STATS:
-      {
-         unsigned int xPointSize = xOrigPoints.size();
-         if(samplePeriod == 0.0 || samplePeriod == 1.0)
-         {
-             for(unsigned int i = 0; i < xPointSize; ++i)
-             {
-                xOrigPoints[i] = (double)i;
-             }
-         }
-         else
+         if(samplePeriod != 0.0 && samplePeriod != 1.0)
          {
-             for(unsigned int i = 0; i < xPointSize; ++i)
-             {
-                xOrigPoints[i] = (double)i * samplePeriod;
-             }
+            xAxis.m = samplePeriod;
          }
-         maxMin_1dXPoints.minX = xOrigPoints[0];
-         maxMin_1dXPoints.maxX = xOrigPoints[xPointSize-1];
-      }
       break;
 
       case E_PLOT_TYPE_REAL_FFT:
       case E_PLOT_TYPE_DB_POWER_FFT_REAL:
-      {
-         getFFTXAxisValues_real( xOrigPoints,
-                                 xOrigPoints.size(),
-                                 maxMin_1dXPoints.minX,
-                                 maxMin_1dXPoints.maxX,
-                                 sampleRate);
-      }
+         // Same as getFFTXAxisValues_real, Real FFTs go from 0 to Fs/2.
+         if(sampleRate != 0.0 && xPointSize > 0)
+         {
+            xAxis.m = sampleRate / ((double)xPointSize * (double)2.0);
+         }
       break;
 
       case E_PLOT_TYPE_COMPLEX_FFT:
       case E_PLOT_TYPE_DB_POWER_FFT_COMPLEX:
-      {
-         getFFTXAxisValues_complex( xOrigPoints,
-                                    xOrigPoints.size(),
-                                    maxMin_1dXPoints.minX,
-                                    maxMin_1dXPoints.maxX,
-                                    sampleRate);
-      }
+         // Same as getFFTXAxisValues_complex, Complex FFTs go from -Fs/2 to Fs/2.
+         xAxis.b = -(double)(xPointSize >> 1);
+         if(sampleRate != 0.0 && xPointSize > 0)
+         {
+            xAxis.m = sampleRate / (double)xPointSize;
+            xAxis.b *= xAxis.m;
+         }
       break;
 
       case E_PLOT_TYPE_2D:
       default:
          // Do nothing.
+         return;
       break;
    }
+
+   if(isOutOfCore())
+   {
+      // Only part of the source is loaded, but the X extent covers the whole source.
+      maxMin_1dXPoints.minX = xAxis.b;
+      maxMin_1dXPoints.maxX = (xAxis.m * (double)(outOfCoreNumSamples-1)) + xAxis.b;
+      xAxis.b += xAxis.m * outOfCoreSourceIndex.b;
+      xAxis.m *= outOfCoreSourceIndex.m;
+   }
+   else
+   {
+      maxMin_1dXPoints.minX = xAxis.b;
+      maxMin_1dXPoints.maxX = xPointSize > 0 ? (xAxis.m * (double)(xPointSize-1)) + xAxis.b : xAxis.b;
+   }
+
+   tLinear prevXAxis = xOrigPointsLinear;
+   xOrigPointsLinear = xAxis;
+
+   // If the X axis math ops are linear, the X points can be generated on the fly from the sample index.
+   tLinear mathOpsLinear;
+   bool wasImplicit = implicitXPoints;
+   implicitXPoints = fusedMathOpsXAxis.getAffine(mathOpsLinear);
+   if(implicitXPoints)
+   {
+      if(!wasImplicit)
+      {
+         xOrigPoints.release();
+         xPoints.release();
+         materializedXPointsLinear.m = NAN;
+         materializedXPointsLinear.b = NAN;
+      }
+   }
+   else
+   {
+      // If the generator hasn't changed (i.e. the curve just grew) only the new X points need to be generated.
+      unsigned int numToKeep = 0;
+      if(!wasImplicit && prevXAxis.m == xAxis.m && prevXAxis.b == xAxis.b)
+      {
+         numToKeep = std::min((unsigned int)xOrigPoints.size(), xPointSize);
+      }
+
+      dubVect newXPoints(xPointSize - numToKeep);
+      for(unsigned int i = numToKeep; i < xPointSize; ++i)
+      {
+         newXPoints[i - numToKeep] = (xAxis.m * (double)i) + xAxis.b;
+      }
+
+      if(numToKeep == 0)
+      {
+         xOrigPoints.assign(newXPoints, E_FLOAT_64);
+      }
+      else
+      {
+         xOrigPoints.resize(xPointSize);
+         if(newXPoints.size() > 0)
+            xOrigPoints.set(numToKeep, &newXPoints[0], newXPoints.size());
+      }
+   }
 }
 
 
 const double* CurveData::getXPoints()
 {
-   return &xPoints[0];
+   if(implicitXPoints)
+   {
+      // Something wants all the X points in an array. Generate them (they are kept until the X axis changes).
+      size_t numXPoints = getNumXPoints();
+      if( xPoints.size() != numXPoints ||
+          materializedXPointsLinear.m != xPointsLinear.m ||
+          materializedXPointsLinear.b != xPointsLinear.b )
+      {
+         xPoints.resize(numXPoints);
+         for(size_t i = 0; i < numXPoints; ++i)
+         {
+            xPoints[i] = getXPoint(i);
+         }
+         materializedXPointsLinear = xPointsLinear;
+      }
+   }
+   return xPoints.constData();
 }
 
 const double* CurveData::getYPoints()
 {
-   return &yPoints[0];
+   return yPoints.constData();
+}
+
+void CurveData::getPointsSnapshot(eAxis axis, sampleVect& snapshot)
+{
+   if(axis == E_X_AXIS)
+   {
+      getXPoints(); // Make sure implicit X points have been generated.
+      snapshot = xPoints;
+   }
+   else
+   {
+      snapshot = yPoints;
+   }
 }
 
 tLinearXYAxis CurveData::getNormFactor()
@@ -221,29 +356,41 @@ tLinearXYAxis CurveData::getNormFactor()
 
 void CurveData::getXPoints(dubVect& ioXPoints)
 {
-   ioXPoints = xPoints;
+   getXPoints(ioXPoints, 0, getNumXPoints());
 }
 void CurveData::getYPoints(dubVect& ioYPoints)
 {
-   ioYPoints = yPoints;
+   ioYPoints.assign(yPoints.constData(), yPoints.constData() + yPoints.size());
 }
 
 void CurveData::getXPoints(dubVect& ioXPoints, int startIndex, int stopIndex)
 {
    ioXPoints.clear();
+   int numXPoints = getNumXPoints();
    if(startIndex < 0)
       startIndex = 0;
-   else if(startIndex >= (int)xPoints.size())
+   else if(startIndex >= numXPoints)
       return;
 
-   if(stopIndex > (int)xPoints.size())
-      stopIndex = xPoints.size();
+   if(stopIndex > numXPoints)
+      stopIndex = numXPoints;
    else if(stopIndex < 0)
       return;
 
    if(stopIndex > startIndex)
    {
-      ioXPoints.assign(&xPoints[startIndex], &xPoints[stopIndex]);
+      if(implicitXPoints)
+      {
+         ioXPoints.resize(stopIndex - startIndex);
+         for(int i = startIndex; i < stopIndex; ++i)
+         {
+            ioXPoints[i - startIndex] = getXPoint(i);
+         }
+      }
+      else
+      {
+         ioXPoints.assign(xPoints.constData() + startIndex, xPoints.constData() + stopIndex);
+      }
    }
 }
 void CurveData::getYPoints(dubVect& ioYPoints, int startIndex, int stopIndex)
@@ -261,7 +408,7 @@ void CurveData::getYPoints(dubVect& ioYPoints, int startIndex, int stopIndex)
 
    if(stopIndex > startIndex)
    {
-      ioYPoints.assign(&yPoints[startIndex], &yPoints[stopIndex]);
+      ioYPoints.assign(yPoints.constData() + startIndex, yPoints.constData() + stopIndex);
    }
 }
 
@@ -282,6 +429,7 @@ unsigned int CurveData::getNumPoints()
 
 void CurveData::setNumPoints(unsigned int newNumPointsSize)
 {
+   sampleStateChanged();
    bool addingPoints = numPoints < newNumPointsSize;
    if(scrollMode)
    {
@@ -293,20 +441,20 @@ void CurveData::setNumPoints(unsigned int newNumPointsSize)
          // Increasing curve size, add "Fill in Point" values to beginning.
          if(plotDim == E_PLOT_DIM_2D)
          {
-            yOrigPoints.insert(yOrigPoints.begin(), delta, FILL_IN_POINT_2D);
-            xOrigPoints.insert(xOrigPoints.begin(), delta, FILL_IN_POINT_2D);
+            yOrigPoints.insertAtBeginning(delta, FILL_IN_POINT_2D);
+            xOrigPoints.insertAtBeginning(delta, FILL_IN_POINT_2D);
          }
          else
          {
-            yOrigPoints.insert(yOrigPoints.begin(), delta, FILL_IN_POINT_1D);
+            yOrigPoints.insertAtBeginning(delta, FILL_IN_POINT_1D);
          }
       }
       else
       {
          // Decreasing curve size, remove samples from beginning.
-         yOrigPoints.erase(yOrigPoints.begin(), yOrigPoints.begin()+delta);
+         yOrigPoints.eraseFromBeginning(delta);
          if(plotDim == E_PLOT_DIM_2D)
-            xOrigPoints.erase(xOrigPoints.begin(), xOrigPoints.begin()+delta);
+            xOrigPoints.eraseFromBeginning(delta);
       }
    }
    else
@@ -348,7 +496,7 @@ void CurveData::setNumPoints(unsigned int newNumPointsSize)
 // Find the max and min in the vector, but only allow real numbers to be used
 // to determine the max and min (ingore values that are not real, i.e 'Not a Number'
 // and Positive Infinity or Negative Inifinty)
-void CurveData::findRealMaxMin(const dubVect& inPoints, double& max, double& min)
+void CurveData::findRealMaxMin(const sampleVect& inPoints, double& max, double& min)
 {
    // Initialize max and min to +/- 1 just in case all the input points are not real numbers.
    max = 1;
@@ -473,8 +621,8 @@ void CurveData::findMaxMin()
    if(plotDim == E_PLOT_DIM_1D)
    {
       // X points will be in order, use the first/last values for min/max.
-      newMaxMin.minX = xPoints[0];
-      newMaxMin.maxX = xPoints[vectSize-1];
+      newMaxMin.minX = getXPoint(0);
+      newMaxMin.maxX = getXPoint(vectSize-1);
 
       smartMaxMinYPoints.getMaxMin(newMaxMin.maxY, newMaxMin.minY, newMaxMin.realY);
 
@@ -584,7 +732,7 @@ void CurveData::resetNormalizeFactor()
 // xEndIndex is a return value, exclusive.
 // sampPerPixel is a return value.
 // The member variable numPoints must be 2 or greater.
-void CurveData::getSamplesToSendToGui_1D(dubVect* xPointsForGui, int& xStartIndex, int& xEndIndex, unsigned int& sampPerPixel, bool addMargin)
+void CurveData::getSamplesToSendToGui_1D(int& xStartIndex, int& xEndIndex, unsigned int& sampPerPixel, bool addMargin)
 {
    xStartIndex = 0;
    xEndIndex = numPoints;
@@ -596,8 +744,8 @@ void CurveData::getSamplesToSendToGui_1D(dubVect* xPointsForGui, int& xStartInde
       double zoomMin = plotZoomWidthDim.lowerBound();
       double zoomMax = plotZoomWidthDim.upperBound();
       double zoomWidth = zoomMax - zoomMin;
-      double initialXPoint = (*xPointsForGui)[0];
-      double finalXPoint = (*xPointsForGui)[numPoints-1];
+      double initialXPoint = getGuiXPoint(0);
+      double finalXPoint = getGuiXPoint(numPoints-1);
       double distBetweenSamples = (finalXPoint - initialXPoint) / (double)(numPoints-1);
 
       double sampPerPixel_float = zoomWidth / ((double)windowWidthPixels * distBetweenSamples);
@@ -608,8 +756,8 @@ void CurveData::getSamplesToSendToGui_1D(dubVect* xPointsForGui, int& xStartInde
       double xEndIndex_guess   = (zoomMax - initialXPoint) / distBetweenSamples;
 
       // Find the actual points that map to the zoom start / stop (use educated guess as a starting point).
-      double xStartIndex_float = findFirstSampleGreaterThan(xPointsForGui, xStartIndex_guess, zoomMin) - 1;
-      double xEndIndex_float = findFirstSampleGreaterThan(xPointsForGui, xEndIndex_guess, zoomMax);
+      double xStartIndex_float = findFirstSampleGreaterThan(xStartIndex_guess, zoomMin) - 1;
+      double xEndIndex_float = findFirstSampleGreaterThan(xEndIndex_guess, zoomMax);
 
       if(addMargin)
       {
@@ -670,13 +818,11 @@ maxMinXY CurveData::get1dDisplayedIndexes()
 
    if(plotDim == E_PLOT_DIM_1D && numPoints > 1)
    {
-      dubVect* xPointsForGui = xNormalized ? &normX : &xPoints;
-
       unsigned int sampPerPixel = 0;
       int xStartIndex = 0;
       int xEndIndex = numPoints;
 
-      getSamplesToSendToGui_1D(xPointsForGui, xStartIndex, xEndIndex, sampPerPixel, false);
+      getSamplesToSendToGui_1D(xStartIndex, xEndIndex, sampPerPixel, false);
 
       retVal.minX = xStartIndex;
       retVal.maxX = xEndIndex;
@@ -693,9 +839,6 @@ maxMinXY CurveData::get2dDisplayedIndexes(unsigned &numNonContiguousSamples)
 
    if(plotDim == E_PLOT_DIM_2D && numPoints > 1)
    {
-      dubVect& xPointsForGui = xNormalized ? normX : xPoints;
-      dubVect& yPointsForGui = yNormalized ? normY : yPoints;
-
       maxMinXY zoomDim;
       QwtScaleDiv plotZoomWidthDim = m_parentPlot->axisScaleDiv(QwtPlot::xBottom); // Get plot zoom dimensions.
       QwtScaleDiv plotZoomHeightDim = m_parentPlot->axisScaleDiv(QwtPlot::yLeft); // Get plot zoom dimensions.
@@ -707,8 +850,10 @@ maxMinXY CurveData::get2dDisplayedIndexes(unsigned &numNonContiguousSamples)
       bool pointInZoomWindowFound = false;
       for(unsigned i = 0; i < numPoints; ++i)
       {
-         if( (xPointsForGui[i] >= zoomDim.minX && xPointsForGui[i] <= zoomDim.maxX) &&
-             (yPointsForGui[i] >= zoomDim.minY && yPointsForGui[i] <= zoomDim.maxY) )
+         double xPointForGui = getGuiXPoint(i);
+         double yPointForGui = getGuiYPoint(i);
+         if( (xPointForGui >= zoomDim.minX && xPointForGui <= zoomDim.maxX) &&
+             (yPointForGui >= zoomDim.minY && yPointForGui <= zoomDim.maxY) )
          {
             // The point is being displayed.
             if(!pointInZoomWindowFound)
@@ -743,9 +888,6 @@ void CurveData::get2dDisplayedPoints(dubVect& xAxis, dubVect& yAxis)
 
    if(plotDim == E_PLOT_DIM_2D)
    {
-      dubVect& xPointsForGui = xNormalized ? normX : xPoints;
-      dubVect& yPointsForGui = yNormalized ? normY : yPoints;
-
       maxMinXY zoomDim;
       QwtScaleDiv plotZoomWidthDim = m_parentPlot->axisScaleDiv(QwtPlot::xBottom); // Get plot zoom dimensions.
       QwtScaleDiv plotZoomHeightDim = m_parentPlot->axisScaleDiv(QwtPlot::yLeft); // Get plot zoom dimensions.
@@ -760,19 +902,25 @@ void CurveData::get2dDisplayedPoints(dubVect& xAxis, dubVect& yAxis)
 
       for(unsigned i = 0; i < numPoints; ++i)
       {
-         if( (xPointsForGui[i] >= zoomDim.minX && xPointsForGui[i] <= zoomDim.maxX) &&
-             (yPointsForGui[i] >= zoomDim.minY && yPointsForGui[i] <= zoomDim.maxY) )
+         double xPointForGui = getGuiXPoint(i);
+         double yPointForGui = getGuiYPoint(i);
+         if( (xPointForGui >= zoomDim.minX && xPointForGui <= zoomDim.maxX) &&
+             (yPointForGui >= zoomDim.minY && yPointForGui <= zoomDim.maxY) )
          {
             // The point is being displayed.
-            xAxis.push_back(xPoints[i]);
-            yAxis.push_back(yPoints[i]);
+            xAxis.push_back(xPoints.constData()[i]);
+            yAxis.push_back(yPoints.constData()[i]);
          }
       }
    }
 }
 
+// Like setPointValue, 'val' is written to the original samples and then the math ops are applied
+// to it. xPoints / yPoints can share their memory with the original samples, so writing to them
+// directly would change the original samples without going through the math ops or max / min.
 void CurveData::setDisplayedPoints(double val)
 {
+   sampleStateChanged();
    if(plotDim == E_PLOT_DIM_1D && numPoints > 1)
    {
       maxMinXY indexes = get1dDisplayedIndexes();
@@ -781,17 +929,18 @@ void CurveData::setDisplayedPoints(double val)
       indexes.minX = std::max(indexes.minX, double(0));
       indexes.maxX = std::min(indexes.maxX, double(numPoints));
 
-      for(unsigned i = indexes.minX; i < indexes.maxX; ++i)
+      if(indexes.maxX > indexes.minX)
       {
-         yPoints[i] = val;
+         unsigned int startIndex = indexes.minX;
+         unsigned int numToSet = (unsigned int)indexes.maxX - startIndex;
+         dubVect newPoints(numToSet, val);
+         yOrigPoints.set(startIndex, newPoints.data(), numToSet);
+         performMathOnPoints(startIndex, numToSet);
       }
    }
    else if(plotDim == E_PLOT_DIM_2D && numPoints > 1)
    {
       // Not sure how useful this is. (i.e. why would I want to set both x and y axes to the same value?)
-      dubVect& xPointsForGui = xNormalized ? normX : xPoints;
-      dubVect& yPointsForGui = yNormalized ? normY : yPoints;
-
       maxMinXY zoomDim;
       QwtScaleDiv plotZoomWidthDim = m_parentPlot->axisScaleDiv(QwtPlot::xBottom); // Get plot zoom dimensions.
       QwtScaleDiv plotZoomHeightDim = m_parentPlot->axisScaleDiv(QwtPlot::yLeft); // Get plot zoom dimensions.
@@ -800,24 +949,37 @@ void CurveData::setDisplayedPoints(double val)
       zoomDim.minY = plotZoomHeightDim.lowerBound();
       zoomDim.maxY = plotZoomHeightDim.upperBound();
 
+      // The displayed points are scattered around, redo the math ops over the range that was changed.
+      unsigned int firstSet = numPoints;
+      unsigned int lastSet = 0;
       for(unsigned i = 0; i < numPoints; ++i)
       {
-         if( (xPointsForGui[i] >= zoomDim.minX && xPointsForGui[i] <= zoomDim.maxX) &&
-             (yPointsForGui[i] >= zoomDim.minY && yPointsForGui[i] <= zoomDim.maxY) )
+         double xPointForGui = getGuiXPoint(i);
+         double yPointForGui = getGuiYPoint(i);
+         if( (xPointForGui >= zoomDim.minX && xPointForGui <= zoomDim.maxX) &&
+             (yPointForGui >= zoomDim.minY && yPointForGui <= zoomDim.maxY) )
          {
             // The point is being displayed.
-            xPoints[i] = val;
-            yPoints[i] = val;
+            xOrigPoints.set(i, &val, 1);
+            yOrigPoints.set(i, &val, 1);
+            firstSet = std::min(firstSet, i);
+            lastSet = i;
          }
       }
+      if(firstSet <= lastSet)
+      {
+         performMathOnPoints(firstSet, lastSet - firstSet + 1);
+      }
    }
 }
 
-int CurveData::findFirstSampleGreaterThan(dubVect* xPointsForGui, double startSearchIndex, double compareValue)
+// For evenly spaced X points (i.e. all 1D curves without non-linear X axis math ops) the
+// start search index is exact, so this only ever needs to check a couple of samples.
+int CurveData::findFirstSampleGreaterThan(double startSearchIndex, double compareValue)
 {
-   if((*xPointsForGui)[0] > compareValue)
+   if(getGuiXPoint(0) > compareValue)
       return 0;
-   if((*xPointsForGui)[numPoints - 1] <= compareValue)
+   if(getGuiXPoint(numPoints - 1) <= compareValue)
       return numPoints;
 
    int retVal = -1;
@@ -846,13 +1008,13 @@ int CurveData::findFirstSampleGreaterThan(dubVect* xPointsForGui, double startSe
       else
          endIndex = (int)std::ceil(endIndex_float);
 
-      bool startIsLessOrEqual = (*xPointsForGui)[startIndex] <= compareValue;
-      bool endIsGreater = (*xPointsForGui)[endIndex-1] > compareValue;
+      bool startIsLessOrEqual = getGuiXPoint(startIndex) <= compareValue;
+      bool endIsGreater = getGuiXPoint(endIndex-1) > compareValue;
       if(startIsLessOrEqual && endIsGreater)
       {
          for(int i = startIndex; i < endIndex && retVal < 0; ++i)
          {
-            if((*xPointsForGui)[i] > compareValue)
+            if(getGuiXPoint(i) > compareValue)
             {
                retVal = i;
             }
@@ -875,16 +1037,70 @@ int CurveData::findFirstSampleGreaterThan(dubVect* xPointsForGui, double startSe
    return retVal;
 }
 
-void CurveData::setCurveDataGuiPoints(bool onlyNeedToUpdate1D)
+// Hand a range of the samples to the curve. Generated / normalized points only need to exist for the
+// range being handed over.
+void CurveData::setGuiSamples(int startIndex, int numSamples)
+{
+   resizeGuiPoints(numSamples);
+   double* xPtr = guiXPoints.data();
+   double* yPtr = guiYPoints.data();
+   if(implicitXPoints || xNormalized)
+   {
+      for(int i = 0; i < numSamples; ++i)
+      {
+         xPtr[i] = getGuiXPoint(startIndex + i);
+      }
+   }
+   else
+   {
+      memcpy(xPtr, xPoints.constData() + startIndex, sizeof(double) * numSamples);
+   }
+   if(yNormalized)
+   {
+      for(int i = 0; i < numSamples; ++i)
+      {
+         yPtr[i] = getNormYPoint(startIndex + i);
+      }
+   }
+   else
+   {
+      memcpy(yPtr, yPoints.constData() + startIndex, sizeof(double) * numSamples);
+   }
+   setGuiRawSamples(numSamples);
+}
+
+// Make sure the GUI points can hold 'numPoints' points. They are reallocated if they are too small or
+// much bigger than needed (e.g. after zooming in on a large 2D curve).
+void CurveData::resizeGuiPoints(size_t numPoints)
 {
-   dubVect* xPointsForGui = xNormalized ? &normX : &xPoints;
-   dubVect* yPointsForGui = yNormalized ? &normY : &yPoints; // fastMonotonicMaxMin works today because it uses yPoints for max/min then redoes the normalization. If a change brings in more difference between yPoints and yPointsForGui that might break fastMonotonicMaxMin.
+   if(guiXPoints.size() < numPoints || guiXPoints.size() > (2 * numPoints))
+   {
+      size_t origBytes = guiXPoints.getResidentBytes() + guiYPoints.getResidentBytes();
+      guiXPoints.release();
+      guiYPoints.release();
+      guiXPoints.resize(numPoints);
+      guiYPoints.resize(numPoints);
+      size_t newBytes = guiXPoints.getResidentBytes() + guiYPoints.getResidentBytes();
+      guiPointsBytesAllocated_lastRedraw = newBytes > origBytes ? newBytes - origBytes : 0;
+   }
+}
+
+// Point the curve at the first 'numPoints' GUI points. Needs to be redone whenever the GUI points move.
+void CurveData::setGuiRawSamples(size_t numPoints)
+{
+   numGuiPoints = numPoints;
+   curve->setRawSamples(guiXPoints.constData(), guiYPoints.constData(), (int)numPoints);
+}
 
+void CurveData::setCurveDataGuiPoints(bool onlyNeedToUpdate1D)
+{
    if(numPoints <= 0)
    {
       return;
    }
 
+   guiPointsBytesAllocated_lastRedraw = 0;
+
    // For now, I don't know how to reduce 2D plots, so just plot all samples in that case.
    // 1D sample reduce only works if there is more than 1 sample, so just plot all samples if there is only 1 sample.
    // Also, 1D sample reduce can cause confusion when using the Dots Curve Style, don't use the 1D reduce for Dots.
@@ -892,9 +1108,8 @@ void CurveData::setCurveDataGuiPoints(bool onlyNeedToUpdate1D)
    {
       if(onlyNeedToUpdate1D == false)
       {
-         curve->setSamples( &(*xPointsForGui)[0],
-                            &(*yPointsForGui)[0],
-                            numPoints);
+         setGuiSamples(0, numPoints);
+         guiPointsBytesAllocated_total += guiPointsBytesAllocated_lastRedraw;
       }
       return;
    }
@@ -909,7 +1124,7 @@ void CurveData::setCurveDataGuiPoints(bool onlyNeedToUpdate1D)
    int xEndIndex = numPoints;
 
    // Calculate xStartIndex, xEndIndex, sampPerPixel values.
-   getSamplesToSendToGui_1D(xPointsForGui, xStartIndex, xEndIndex, sampPerPixel, true);
+   getSamplesToSendToGui_1D(xStartIndex, xEndIndex, sampPerPixel, true);
 
    // Don't plot NAN points at the beginning / end of curve data.
    {
@@ -928,28 +1143,30 @@ void CurveData::setCurveDataGuiPoints(bool onlyNeedToUpdate1D)
    if( (sampPerPixel <= 3) ||
        (numPoints < (sampPerPixel+2)) )
    {
-      curve->setSamples( &(*xPointsForGui)[xStartIndex],
-                         &(*yPointsForGui)[xStartIndex],
-                         xEndIndex-xStartIndex);
+      setGuiSamples(xStartIndex, xEndIndex-xStartIndex);
    }
    else
    {
-      // TODO should be able to predict how large this needs to be, rather than just setting it to the max.
-      reducedXPoints.resize(xPointsForGui->size());
-      reducedYPoints.resize(yPointsForGui->size());
-      fastMonotonicMaxMin fastMinMax(smartMaxMinYPoints);
+      // At most 2 points for each group of sampPerPixel samples (i.e. each pixel column), plus the first and last point.
+      int numSampsToGroup = (xEndIndex-1) - (xStartIndex+1);
+      size_t numGroups = numSampsToGroup > 0 ? (numSampsToGroup + sampPerPixel - 1) / sampPerPixel : 0;
+      size_t maxReducedPoints = 2 * numGroups + 2;
+      resizeGuiPoints(maxReducedPoints);
+      double* reducedXPoints = guiXPoints.data();
+      double* reducedYPoints = guiYPoints.data();
 
       unsigned int sampCount = 0;
 
-      reducedXPoints[sampCount] = (*xPointsForGui)[xStartIndex];
-      reducedYPoints[sampCount] = (*yPointsForGui)[xStartIndex];
+      reducedXPoints[sampCount] = getGuiXPoint(xStartIndex);
+      reducedYPoints[sampCount] = getGuiYPoint(xStartIndex);
       sampCount++;
 
       for(int i = (xStartIndex+1); i < (xEndIndex-1); i += sampPerPixel)
       {
          unsigned int sampToProcess = std::min((int)sampPerPixel, (xEndIndex-1) - i);
-         tMaxMinSegment maxMin = fastMinMax.getMinMaxInRange(i, sampToProcess);
+         tMaxMinSegment maxMin = smartMaxMinYPoints.getMinMaxOfSubrange(i, sampToProcess);
 
+         // Normalization is applied after the max/min search (yPoints isn't normalized).
          if(yNormalized)
          {
             maxMin.maxValue = (normFactor.yAxis.m * maxMin.maxValue) + normFactor.yAxis.b;
@@ -958,44 +1175,43 @@ void CurveData::setCurveDataGuiPoints(bool onlyNeedToUpdate1D)
 
          if(!maxMin.realPoints)
          {
-            reducedXPoints[sampCount] = (*xPointsForGui)[i]; // No valid points, set to start index in the range.
+            reducedXPoints[sampCount] = getGuiXPoint(i); // No valid points, set to start index in the range.
             reducedYPoints[sampCount] = NAN;
             sampCount++;
          }
          else if(maxMin.minIndex < maxMin.maxIndex)
          {
-            reducedXPoints[sampCount] = (*xPointsForGui)[maxMin.minIndex];
+            reducedXPoints[sampCount] = getGuiXPoint(maxMin.minIndex);
             reducedYPoints[sampCount] = maxMin.minValue;
             sampCount++;
-            reducedXPoints[sampCount] = (*xPointsForGui)[maxMin.maxIndex];
+            reducedXPoints[sampCount] = getGuiXPoint(maxMin.maxIndex);
             reducedYPoints[sampCount] = maxMin.maxValue;
             sampCount++;
          }
          else if(maxMin.minIndex > maxMin.maxIndex)
          {
-            reducedXPoints[sampCount] = (*xPointsForGui)[maxMin.maxIndex];
+            reducedXPoints[sampCount] = getGuiXPoint(maxMin.maxIndex);
             reducedYPoints[sampCount] = maxMin.maxValue;
             sampCount++;
-            reducedXPoints[sampCount] = (*xPointsForGui)[maxMin.minIndex];
+            reducedXPoints[sampCount] = getGuiXPoint(maxMin.minIndex);
             reducedYPoints[sampCount] = maxMin.minValue;
             sampCount++;
          }
          else
          {
-            reducedXPoints[sampCount] = (*xPointsForGui)[maxMin.maxIndex];
+            reducedXPoints[sampCount] = getGuiXPoint(maxMin.maxIndex);
             reducedYPoints[sampCount] = maxMin.maxValue;
             sampCount++;
          }
       }
 
-      reducedXPoints[sampCount] = (*xPointsForGui)[xEndIndex-1];
-      reducedYPoints[sampCount] = (*yPointsForGui)[xEndIndex-1];
+      reducedXPoints[sampCount] = getGuiXPoint(xEndIndex-1);
+      reducedYPoints[sampCount] = getGuiYPoint(xEndIndex-1);
       sampCount++;
 
-      curve->setSamples( &reducedXPoints[0],
-                         &reducedYPoints[0],
-                         sampCount);
+      setGuiRawSamples(sampCount);
    }
+   guiPointsBytesAllocated_total += guiPointsBytesAllocated_lastRedraw;
 }
 
 void CurveData::setCurveSamples()
@@ -1018,50 +1234,51 @@ void CurveData::setCurveSamples()
       finalMaxMin.realX = maxMin_beforeScale.realX;
    }
 
+   // The normalized points aren't stored, they are generated when they are handed to the GUI.
    if(xNormalized)
    {
-      normX.resize(numPoints);
-      for(unsigned int i = 0; i < numPoints; ++i)
-      {
-         normX[i] = (normFactor.xAxis.m * xPoints[i]) + normFactor.xAxis.b;
-      }
-
       // To save on processing, calculate final max/min.
       finalMaxMin.minX = (normFactor.xAxis.m * finalMaxMin.minX) + normFactor.xAxis.b;
       finalMaxMin.maxX = (normFactor.xAxis.m * finalMaxMin.maxX) + normFactor.xAxis.b;
    }
    if(yNormalized)
    {
-      normY.resize(numPoints);
-      for(unsigned int i = 0; i < numPoints; ++i)
-      {
-         normY[i] = (normFactor.yAxis.m * yPoints[i]) + normFactor.yAxis.b;
-      }
-
       // To save on processing, calculate final max/min.
       finalMaxMin.minY = (normFactor.yAxis.m * finalMaxMin.minY) + normFactor.yAxis.b;
       finalMaxMin.maxY = (normFactor.yAxis.m * finalMaxMin.maxY) + normFactor.yAxis.b;
    }
 
-   setCurveDataGuiPoints(false); // Need to set GUI points regardless of 1D vs 2D.
+   if(guiPointsDeferred == false)
+   {
+      setCurveDataGuiPoints(false); // Need to set GUI points regardless of 1D vs 2D.
+   }
 
    maxMin_finalSamples = finalMaxMin;
 }
 
 void CurveData::ResetCurveSamples(const UnpackPlotMsg* data)
 {
+   sampleStateChanged();
    plotDim = plotActionToPlotDim(data->m_plotAction);
 
+   // New samples replace the out of core view.
+   outOfCoreSourceIndex.m = 1.0;
+   outOfCoreSourceIndex.b = 0.0;
+   outOfCoreNumSamples = 0;
+
    if(plotDim == E_PLOT_DIM_1D)
    {
-      yOrigPoints = data->m_yAxisValues;
+      yOrigPoints.assign(data->m_yAxisValues, data->m_yAxisDataType);
       numPoints = yOrigPoints.size();
       fill1DxPoints();
    }
    else
    {
-      xOrigPoints = data->m_xAxisValues;
-      yOrigPoints = data->m_yAxisValues;
+      implicitXPoints = false;
+      xOrigPointsLinear.m = NAN; // xOrigPoints aren't generated.
+      xOrigPointsLinear.b = NAN;
+      xOrigPoints.assign(data->m_xAxisValues, data->m_xAxisDataType);
+      yOrigPoints.assign(data->m_yAxisValues, data->m_yAxisDataType);
       numPoints = std::min(xOrigPoints.size(), yOrigPoints.size());
       if(xOrigPoints.size() > numPoints)
          xOrigPoints.resize(numPoints);
@@ -1076,8 +1293,79 @@ void CurveData::ResetCurveSamples(const UnpackPlotMsg* data)
    storeLastMsgStats(data);
 }
 
+void CurveData::sampleStateChanged()
+{
+   static QAtomicInt nextSampleStateVersion;
+   sampleStateVersion = (unsigned int)nextSampleStateVersion.fetchAndAddRelaxed(1);
+}
 
-void CurveData::swapSamples(dubVect& samples, int swapIndex)
+CurveData* CurveData::createBackBuffer()
+{
+   return new CurveData(this);
+}
+
+bool CurveData::swapInBackBuffer(CurveData* backBuffer)
+{
+   if(backBuffer->frontCurve != this || backBuffer->frontSampleStateVersion != sampleStateVersion)
+   {
+      return false; // The curve changed since the back buffer was created.
+   }
+   copySampleState(backBuffer, true);
+   for(size_t i = 0; i < backBuffer->backBufferNewSampleMsgs.size(); ++i)
+   {
+      sampleRateCalculator.newSamples(backBuffer->backBufferNewSampleMsgs[i]);
+   }
+   return true;
+}
+
+// Everything ResetCurveSamples / UpdateCurveSamples change. The samples are copy on write, so copying
+// them is O(1). The max / min pyramids and spectrum analyzer state are swapped rather than copied
+// when 'takeFromSrc' is true ('src' is a back buffer that is being swapped in).
+void CurveData::copySampleState(CurveData* src, bool takeFromSrc)
+{
+   plotDim = src->plotDim;
+   numPoints = src->numPoints;
+
+   xPoints = src->xPoints;
+   yPoints = src->yPoints;
+   xOrigPoints.copy(src->xOrigPoints, &xPoints);
+   yOrigPoints.copy(src->yOrigPoints, &yPoints);
+
+   implicitXPoints = src->implicitXPoints;
+   xOrigPointsLinear = src->xOrigPointsLinear;
+   xPointsLinear = src->xPointsLinear;
+   materializedXPointsLinear = src->materializedXPointsLinear;
+   outOfCoreSourceIndex = src->outOfCoreSourceIndex;
+   outOfCoreNumSamples = src->outOfCoreNumSamples;
+
+   if(takeFromSrc)
+   {
+      smartMaxMinXPoints.swap(src->smartMaxMinXPoints);
+      smartMaxMinYPoints.swap(src->smartMaxMinYPoints);
+      fftSpecAn.swap(src->fftSpecAn);
+   }
+   else
+   {
+      smartMaxMinXPoints.copyFrom(src->smartMaxMinXPoints);
+      smartMaxMinYPoints.copyFrom(src->smartMaxMinYPoints);
+      fftSpecAn.copyFrom(src->fftSpecAn);
+   }
+   maxMin_beforeScale = src->maxMin_beforeScale;
+   maxMin_1dXPoints = src->maxMin_1dXPoints;
+   maxMin_finalSamples = src->maxMin_finalSamples;
+   linearXAxisCorrection = src->linearXAxisCorrection;
+
+   oldestPoint_nonScrollModeVersion = src->oldestPoint_nonScrollModeVersion;
+   plotSize_nonScrollModeVersion = src->plotSize_nonScrollModeVersion;
+   maxNumPointsFromPlotMsg = src->maxNumPointsFromPlotMsg;
+
+   lastMsgIpAddr = src->lastMsgIpAddr;
+   lastMsgXAxisType = src->lastMsgXAxisType;
+   lastMsgYAxisType = src->lastMsgYAxisType;
+}
+
+
+void CurveData::swapSamples(sampleVect& samples, int swapIndex)
 {
    int numPointsAtEnd = numPoints - swapIndex;
    int numPointsAtBeg = numPoints - numPointsAtEnd;
@@ -1096,8 +1384,17 @@ void CurveData::swapSamples(dubVect& samples, int swapIndex)
    }
 }
 
+void CurveData::swapSamples(typedSampleVect& samples, int swapIndex)
+{
+   if(swapIndex > 0 && swapIndex < (int)numPoints)
+   {
+      samples.rotate(swapIndex);
+   }
+}
+
 void CurveData::handleScrollModeTransitions(bool plotScrollMode)
 {
+   sampleStateChanged();
    if(plotScrollMode != scrollMode)
    {
       if(!plotScrollMode)
@@ -1112,12 +1409,14 @@ void CurveData::handleScrollModeTransitions(bool plotScrollMode)
       int swapPoint = plotScrollMode ? oldestPoint_nonScrollModeVersion : numPoints - oldestPoint_nonScrollModeVersion;
 
       swapSamples(yOrigPoints, swapPoint);
-      swapSamples(yPoints,     swapPoint);
+      if(!yOrigPoints.isShared())
+         swapSamples(yPoints, swapPoint);
       smartMaxMinYPoints.updateMaxMin(0, yOrigPoints.size());
       if(plotDim == E_PLOT_DIM_2D)
       {
          swapSamples(xOrigPoints, swapPoint);
-         swapSamples(xPoints,     swapPoint);
+         if(!xOrigPoints.isShared())
+            swapSamples(xPoints, swapPoint);
          smartMaxMinXPoints.updateMaxMin(0, xOrigPoints.size());
       }
       scrollMode = plotScrollMode; // Store off Scroll Mode state.
@@ -1126,6 +1425,7 @@ void CurveData::handleScrollModeTransitions(bool plotScrollMode)
 
 void CurveData::UpdateCurveSamples(const UnpackPlotMsg* data)
 {
+   sampleStateChanged();
    if(plotDim == plotActionToPlotDim(data->m_plotAction))
    {
       if(plotDim == E_PLOT_DIM_1D)
@@ -1183,7 +1483,7 @@ void CurveData::UpdateCurveSamples(const dubVect& newYPoints, unsigned int sampl
             resized = true;
             yOrigPoints.resize(sampleStartIndex + newPointsSize);
          }
-         memcpy(&yOrigPoints[sampleStartIndex], &(*newPointsToUse)[0], sizeof(yOrigPoints[0]) * newPointsSize);
+         yOrigPoints.set(sampleStartIndex, &(*newPointsToUse)[0], newPointsSize);
       }
       else
       {
@@ -1195,19 +1495,16 @@ void CurveData::UpdateCurveSamples(const dubVect& newYPoints, unsigned int sampl
             // Current scroll mode curve size is less than the number of samples in this new curve data message.
             // Resize the curve to fit all the new data.
             resized = true;
-            yOrigPoints = (*newPointsToUse);
+            yOrigPoints.assign(&(*newPointsToUse)[0], newPointsSize);
          }
          else
          {
-            int numOrigPointsToKeep = yOrigPoints.size() - newPointsSize;
-
-            // Move old Y Points to their new position.
-            memmove(&yOrigPoints[0], &yOrigPoints[newPointsSize], sizeof(yOrigPoints[0]) * numOrigPointsToKeep);
-            memmove(&yPoints[0], &yPoints[newPointsSize], sizeof(yPoints[0]) * numOrigPointsToKeep);
+            // Drop the oldest Y Points and add the new Y Points to the end. The new yPoints values
+            // are filled in by performMathOnPoints below.
+            yOrigPoints.scroll(&(*newPointsToUse)[0], newPointsSize);
+            if(!yOrigPoints.isShared())
+               yPoints.scroll(NULL, newPointsSize);
             smartMaxMinYPoints.scrollModeShift(newPointsSize);
-
-            // Copy new Y Points in.
-            memcpy(&yOrigPoints[numOrigPointsToKeep], &(*newPointsToUse)[0], sizeof(yOrigPoints[0]) * newPointsSize);
          }
       }
 
@@ -1260,8 +1557,8 @@ void CurveData::UpdateCurveSamples(const dubVect& newXPoints, const dubVect& new
             yOrigPoints.resize(sampleStartIndex + newPointsSize, NAN);
          }
 
-         memcpy(&xOrigPoints[sampleStartIndex], &newXPoints[0], sizeof(newXPoints[0]) * newPointsSize);
-         memcpy(&yOrigPoints[sampleStartIndex], &newYPoints[0], sizeof(newYPoints[0]) * newPointsSize);
+         xOrigPoints.set(sampleStartIndex, &newXPoints[0], newPointsSize);
+         yOrigPoints.set(sampleStartIndex, &newYPoints[0], newPointsSize);
       }
       else
       {
@@ -1272,27 +1569,21 @@ void CurveData::UpdateCurveSamples(const dubVect& newXPoints, const dubVect& new
          {
             // Current scroll mode curve size is less than the number of samples in this new curve data message.
             // Resize the curve to fit all the new data.
-            xOrigPoints.resize(newPointsSize);
-            yOrigPoints.resize(newPointsSize);
-            memcpy(&xOrigPoints[0], &newXPoints[0], sizeof(newXPoints[0]) * newPointsSize);
-            memcpy(&yOrigPoints[0], &newYPoints[0], sizeof(newYPoints[0]) * newPointsSize);
+            xOrigPoints.assign(&newXPoints[0], newPointsSize);
+            yOrigPoints.assign(&newYPoints[0], newPointsSize);
          }
          else
          {
-            int numOrigPoints = yOrigPoints.size(); // Assume num X points and Y points are equal.
-            int numOrigPointsToKeep = numOrigPoints - newPointsSize;
-
-            // Move old Points to their new position.
-            memmove(&xOrigPoints[0], &xOrigPoints[newPointsSize], sizeof(newXPoints[0]) * numOrigPointsToKeep);
-            memmove(&xPoints[0],     &xPoints[newPointsSize],     sizeof(newXPoints[0]) * numOrigPointsToKeep);
-            memmove(&yOrigPoints[0], &yOrigPoints[newPointsSize], sizeof(newYPoints[0]) * numOrigPointsToKeep);
-            memmove(&yPoints[0],     &yPoints[newPointsSize],     sizeof(newYPoints[0]) * numOrigPointsToKeep);
+            // Drop the oldest Points and add the new Points to the end. The new xPoints / yPoints
+            // values are filled in by performMathOnPoints below.
+            xOrigPoints.scroll(&newXPoints[0], newPointsSize);
+            if(!xOrigPoints.isShared())
+               xPoints.scroll(NULL, newPointsSize);
+            yOrigPoints.scroll(&newYPoints[0], newPointsSize);
+            if(!yOrigPoints.isShared())
+               yPoints.scroll(NULL, newPointsSize);
             smartMaxMinXPoints.scrollModeShift(newPointsSize);
             smartMaxMinYPoints.scrollModeShift(newPointsSize);
-
-            // Copy new Points in.
-            memcpy(&xOrigPoints[numOrigPointsToKeep], &newXPoints[0], sizeof(newXPoints[0]) * newPointsSize);
-            memcpy(&yOrigPoints[numOrigPointsToKeep], &newYPoints[0], sizeof(newYPoints[0]) * newPointsSize);
          }
       }
 
@@ -1319,6 +1610,7 @@ void CurveData::UpdateCurveSamples(const dubVect& newXPoints, const dubVect& new
 
 bool CurveData::setSampleRate(double inSampleRate, bool userSpecified)
 {
+   sampleStateChanged();
    bool changed = false;
 
    // Do not overwrite the sample rate if the user has already specified the sample rate via the GUI
@@ -1353,12 +1645,20 @@ bool CurveData::setSampleRate(double inSampleRate, bool userSpecified)
 
 bool CurveData::setMathOps(tMathOpList& mathOpsIn, eAxis axis)
 {
+   sampleStateChanged();
    bool changed = false;
    tMathOpList* axisMathOps;
+   fusedMathOps* axisFusedMathOps;
    if(axis == E_X_AXIS)
+   {
       axisMathOps = &mathOpsXAxis;
+      axisFusedMathOps = &fusedMathOpsXAxis;
+   }
    else
+   {
       axisMathOps = &mathOpsYAxis;
+      axisFusedMathOps = &fusedMathOpsYAxis;
+   }
 
    if(mathOpsIn.size() == axisMathOps->size())
    {
@@ -1387,6 +1687,11 @@ bool CurveData::setMathOps(tMathOpList& mathOpsIn, eAxis axis)
    if(changed)
    {
       *axisMathOps = mathOpsIn;
+      axisFusedMathOps->compile(mathOpsIn);
+      if(axis == E_X_AXIS && plotDim == E_PLOT_DIM_1D)
+      {
+         fill1DxPoints(); // Whether the X points can be generated on the fly depends on the X axis math ops.
+      }
       performMathOnPoints();
       setCurveSamples();
    }
@@ -1404,34 +1709,66 @@ tMathOpList CurveData::getMathOps(eAxis axis)
 
 void CurveData::performMathOnPoints()
 {
+   updateSampleSharing();
    performMathOnPoints(0, yOrigPoints.size());
 }
 
+// When an axis has nothing to transform its samples, the math ops output would be an exact copy of the
+// original samples. Keep a single copy in that case (the original samples are stored in xPoints / yPoints).
+// This needs to be called before the transform has been applied to xPoints / yPoints.
+void CurveData::updateSampleSharing()
+{
+   bool shareX = plotDim == E_PLOT_DIM_2D && fusedMathOpsXAxis.empty();
+   bool shareY = fusedMathOpsYAxis.empty() && !(plotType == E_PLOT_TYPE_FM_DEMOD && sampleRate != 0.0);
+
+   if(shareX)
+      xOrigPoints.share(&xPoints);
+   else
+      xOrigPoints.unshare();
+
+   if(shareY)
+      yOrigPoints.share(&yPoints);
+   else
+      yOrigPoints.unshare();
+}
+
 void CurveData::performMathOnPoints(unsigned int sampleStartIndex, unsigned int numSamples)
 {
    unsigned int finalNewSampPosition = sampleStartIndex + numSamples;
 
-   unsigned int origXSize = xPoints.size();
-
-   // Copy new samples.
-   if(xPoints.size() < finalNewSampPosition)
+   if(implicitXPoints)
    {
-      xPoints.resize(finalNewSampPosition, NAN);
+      // The X points are generated from the sample index. Just apply the math ops to the generator.
+      tLinear mathOpsLinear;
+      fusedMathOpsXAxis.getAffine(mathOpsLinear);
+      xPointsLinear.m = xOrigPointsLinear.m * mathOpsLinear.m;
+      xPointsLinear.b = (xOrigPointsLinear.b * mathOpsLinear.m) + mathOpsLinear.b;
    }
-   if(yPoints.size() < finalNewSampPosition)
+   else
    {
-      yPoints.resize(finalNewSampPosition, NAN);
+      unsigned int origXSize = xPoints.size();
+
+      // Copy new samples.
+      if(xPoints.size() < finalNewSampPosition)
+      {
+         xPoints.resize(finalNewSampPosition, NAN);
+      }
+      xOrigPoints.get(sampleStartIndex, &xPoints[sampleStartIndex], numSamples);
+
+      // Make sure the generated X axis points are kept up to date.
+      if(plotDim == E_PLOT_DIM_1D && origXSize < sampleStartIndex)
+      {
+         // There is a gap between last old sample and the first new sample. Make sure to copy the
+         // generated 1D X axis points in between.
+         xOrigPoints.get(origXSize, &xPoints[origXSize], sampleStartIndex - origXSize);
+      }
    }
-   memcpy(&xPoints[sampleStartIndex], &xOrigPoints[sampleStartIndex], sizeof(xOrigPoints[0]) * numSamples);
-   memcpy(&yPoints[sampleStartIndex], &yOrigPoints[sampleStartIndex], sizeof(yOrigPoints[0]) * numSamples);
 
-   // Make sure the generated X axis points are kept up to date.
-   if(plotDim == E_PLOT_DIM_1D && origXSize < sampleStartIndex)
+   if(yPoints.size() < finalNewSampPosition)
    {
-      // There is a gap between last old sample and the first new sample. Make sure to copy the
-      // generated 1D X axis points in between.
-      memcpy(&xPoints[origXSize], &xOrigPoints[origXSize], sizeof(xOrigPoints[0]) * (sampleStartIndex - origXSize));
+      yPoints.resize(finalNewSampPosition, NAN);
    }
+   yOrigPoints.get(sampleStartIndex, &yPoints[sampleStartIndex], numSamples);
 
    // If FM demod and sample rate is specified, convert phase delta to frequency (Hz)
    if(plotType == E_PLOT_TYPE_FM_DEMOD && sampleRate != 0.0)
@@ -1449,8 +1786,11 @@ void CurveData::performMathOnPoints(unsigned int sampleStartIndex, unsigned int
       }
    }
 
-   doMathOnCurve(xPoints, mathOpsXAxis, sampleStartIndex, numSamples);
-   doMathOnCurve(yPoints, mathOpsYAxis, sampleStartIndex, numSamples);
+   if(!implicitXPoints)
+   {
+      doMathOnCurve(xPoints, fusedMathOpsXAxis, sampleStartIndex, numSamples);
+   }
+   doMathOnCurve(yPoints, fusedMathOpsYAxis, sampleStartIndex, numSamples);
 
    if(plotDim == E_PLOT_DIM_1D)
    {
@@ -1472,137 +1812,12 @@ void CurveData::performMathOnPoints(unsigned int sampleStartIndex, unsigned int
    }
 }
 
-void CurveData::doMathOnCurve(dubVect& data, tMathOpList& mathOp, unsigned int sampleStartIndex, unsigned int numSamples)
+void CurveData::doMathOnCurve(sampleVect& data, const fusedMathOps& mathOps, unsigned int sampleStartIndex, unsigned int numSamples)
 {
-   double* dataBasePtr = &data[sampleStartIndex];
-   if(mathOp.size() > 0)
+   if(!mathOps.empty() && numSamples > 0)
    {
-      tMathOpList::iterator mathIter;
-      for(unsigned int i = 0; i < numSamples; ++i)
-      {
-         double* dataIter = &dataBasePtr[i];
-         for(mathIter = mathOp.begin(); mathIter != mathOp.end(); ++mathIter)
-         {
-            switch(mathIter->op)
-            {
-               case E_ADD:
-                  (*dataIter) += mathIter->num;
-               break;
-               case E_MULTIPLY:
-                  (*dataIter) *= mathIter->num;
-               break;
-               case E_DIVIDE:
-                  (*dataIter) /= mathIter->num;
-               break;
-               case E_SHIFT_UP:
-                  (*dataIter) = ldexp((*dataIter), (int)mathIter->num);
-               break;
-               case E_SHIFT_DOWN:
-                  (*dataIter) = ldexp((*dataIter), -(int)mathIter->num);
-               break;
-               case E_POWER:
-                  (*dataIter) = pow((*dataIter), mathIter->num);
-               break;
-               case E_LOG:
-                  (*dataIter) = log(*dataIter) / mathIter->helperNum;
-               break;
-               case E_ALOG:
-                  (*dataIter) = pow(mathIter->num, *dataIter);
-               break;
-               case E_MOD:
-                  (*dataIter) = fmod(*dataIter, mathIter->num);
-                  if((*dataIter) < 0)
-                     (*dataIter) += mathIter->num;
-               break;
-               case E_ABS:
-                  (*dataIter) = fabs((*dataIter));
-               break;
-               case E_ROUND:
-                  if(mathIter->num == 0)
-                  {
-                     // Most of the time this will be just a round to whole integer number, in that case use the fast math.
-                     (*dataIter) = round((*dataIter));
-                  }
-                  else
-                  {
-                     // Rounding to not an integer, use the slower math.
-                     double decimal = pow(10, mathIter->num);
-                     (*dataIter) = round((*dataIter) * decimal) / decimal;
-                  }
-               break;
-               case E_ROUND_UP:
-                  if(mathIter->num == 0)
-                  {
-                     // Most of the time this will be just a round to whole integer number, in that case use the fast math.
-                     (*dataIter) = ceil((*dataIter));
-                  }
-                  else
-                  {
-                     // Rounding to not an integer, use the slower math.
-                     double decimal = pow(10, mathIter->num);
-                     (*dataIter) = ceil((*dataIter) * decimal) / decimal;
-                  }
-               break;
-               case E_ROUND_DOWN:
-                  if(mathIter->num == 0)
-                  {
-                     // Most of the time this will be just a round to whole integer number, in that case use the fast math.
-                     (*dataIter) = floor((*dataIter));
-                  }
-                  else
-                  {
-                     // Rounding to not an integer, use the slower math.
-                     double decimal = pow(10, mathIter->num);
-                     (*dataIter) = floor((*dataIter) * decimal) / decimal;
-                  }
-               break;
-               case E_LIMIT_UPPER:
-                  if((*dataIter) > mathIter->num)
-                  {
-                     (*dataIter) = mathIter->num;
-                  }
-               break;
-               case E_LIMIT_LOWER:
-                  if((*dataIter) < mathIter->num)
-                  {
-                     (*dataIter) = mathIter->num;
-                  }
-               break;
-               case E_SIN:
-                  (*dataIter) = sin((*dataIter));
-               break;
-               case E_COS:
-                  (*dataIter) = cos((*dataIter));
-               break;
-               case E_TAN:
-                  (*dataIter) = tan((*dataIter));
-               break;
-               case E_ASIN:
-                  (*dataIter) = asin((*dataIter));
-               break;
-               case E_ACOS:
-                  (*dataIter) = acos((*dataIter));
-               break;
-               case E_ATAN:
-                  (*dataIter) = atan((*dataIter));
-               break;
-               case E_SIGN:
-                  (*dataIter) = (0.0 < (*dataIter)) - ((*dataIter) < 0.0); // always return +1, 0, or -1
-               break;
-               case E_FLOAT_SIGN_BIT:
-                  (*dataIter) = std::signbit((*dataIter));
-               break;
-               case E_FLOAT_IS_NAN:
-                  (*dataIter) = std::isnan((*dataIter));
-               break;
-               case E_FLOAT_IS_INF:
-                  (*dataIter) = std::isinf((*dataIter));
-               break;
-            }
-         }
-      }
+      mathOps.apply(&data[sampleStartIndex], numSamples);
    }
-
 }
 
 
@@ -1705,7 +1920,10 @@ void CurveData::storeLastMsgStats(const UnpackPlotMsg* data)
 void CurveData::handleNewSampleMsg(unsigned int sampleStartIndex, unsigned int numSamples)
 {
    maxNumPointsFromPlotMsg = std::max(maxNumPointsFromPlotMsg, sampleStartIndex + numSamples);
-   sampleRateCalculator.newSamples(numSamples);
+   if(frontCurve != NULL)
+      backBufferNewSampleMsgs.push_back(numSamples);
+   else
+      sampleRateCalculator.newSamples(numSamples);
 }
 
 void CurveData::setPointValue(unsigned int index, double value)
@@ -1715,6 +1933,7 @@ void CurveData::setPointValue(unsigned int index, double value)
 
 void CurveData::setPointValue(unsigned int index, double xValue, double yValue)
 {
+   sampleStateChanged();
    if(index < getNumPoints())
    {
       if(plotDim == E_PLOT_DIM_1D)
@@ -1734,13 +1953,95 @@ void CurveData::setPointValue(unsigned int index, double xValue, double yValue)
    }
 }
 
+void CurveData::setOutOfCoreView(const dubVect& yPoints, tLinear sourceIndex, unsigned long long sourceNumSamples)
+{
+   sampleStateChanged();
+   if(plotDim != E_PLOT_DIM_1D || yPoints.size() <= 0)
+      return;
+
+   outOfCoreSourceIndex = sourceIndex;
+   outOfCoreNumSamples = sourceNumSamples;
+
+   // Keeps the storage type the curve was created with (i.e. the raw file type).
+   yOrigPoints.assign(&yPoints[0], yPoints.size());
+   numPoints = yOrigPoints.size();
+   oldestPoint_nonScrollModeVersion = numPoints;
+   plotSize_nonScrollModeVersion = numPoints;
+
+   fill1DxPoints();
+   performMathOnPoints();
+   setCurveSamples();
+}
+
+// Converts an X axis range (in GUI coordinates) to the out of core source samples in that range.
+bool CurveData::getOutOfCoreSourceRange(double startX, double stopX, long long& startIndex, long long& stopIndex)
+{
+   if(!isOutOfCore() || !implicitXPoints || xPointsLinear.m == 0.0)
+      return false;
+
+   if(xNormalized)
+   {
+      startX = (startX - normFactor.xAxis.b) / normFactor.xAxis.m;
+      stopX  = (stopX  - normFactor.xAxis.b) / normFactor.xAxis.m;
+   }
+
+   // X -> curve sample index -> source sample index.
+   double start = (((startX - xPointsLinear.b) / xPointsLinear.m) * outOfCoreSourceIndex.m) + outOfCoreSourceIndex.b;
+   double stop  = (((stopX  - xPointsLinear.b) / xPointsLinear.m) * outOfCoreSourceIndex.m) + outOfCoreSourceIndex.b;
+   if(start > stop)
+      std::swap(start, stop);
+
+   double numSamples = (double)outOfCoreNumSamples;
+   start = std::max(std::min(std::floor(start), numSamples), 0.0);
+   stop  = std::max(std::min(std::ceil(stop) + 1.0, numSamples), 0.0);
+   startIndex = (long long)start;
+   stopIndex = (long long)stop;
+   return stopIndex > startIndex;
+}
+
+size_t CurveData::getResidentBytes()
+{
+   return xOrigPoints.getResidentBytes() + yOrigPoints.getResidentBytes() +
+          xPoints.getResidentBytes() + yPoints.getResidentBytes() +
+          smartMaxMinXPoints.getNumBytes() + smartMaxMinYPoints.getNumBytes() +
+          guiXPoints.getResidentBytes() + guiYPoints.getResidentBytes();
+}
+
+void CurveData::spillSamples()
+{
+   xOrigPoints.spill();
+   yOrigPoints.spill();
+   xPoints.spill();
+   yPoints.spill();
+   bool guiXPointsSpilled = guiXPoints.spill();
+   bool guiYPointsSpilled = guiYPoints.spill();
+   if(guiXPointsSpilled || guiYPointsSpilled)
+      setGuiRawSamples(numGuiPoints); // The GUI points moved.
+}
+
+void CurveData::unspillSamples()
+{
+   xOrigPoints.unspill();
+   yOrigPoints.unspill();
+   xPoints.unspill();
+   yPoints.unspill();
+   if(guiXPoints.isSpilled() || guiYPoints.isSpilled())
+   {
+      guiXPoints.unspill();
+      guiYPoints.unspill();
+      setGuiRawSamples(numGuiPoints); // The GUI points moved.
+   }
+}
+
 void CurveData::specAn_reset()
 {
+   sampleStateChanged();
    fftSpecAn.reset();
 }
 
 void CurveData::specAn_setTraceType(fftSpecAnFunc::eFftSpecAnTraceType newTraceType)
 {
+   sampleStateChanged();
    if(newTraceType != fftSpecAnTraceType)
    {
       specAn_reset();
@@ -1750,5 +2051,6 @@ void CurveData::specAn_setTraceType(fftSpecAnFunc::eFftSpecAnTraceType newTraceT
 
 void CurveData::specAn_setAvgSize(int newAvgSize)
 {
+   sampleStateChanged();
    fftSpecAn.setAvgSize(newAvgSize);
 }
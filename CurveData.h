@@ -1,4 +1,4 @@
-/* Copyright 2013 - 2024 Dan Williams. All Rights Reserved.
+/* Copyright 2013 - 2026 Dan Williams. All Rights Reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of this
  * software and associated documentation files (the "Software"), to deal in the Software
@@ -31,7 +31,10 @@
 #include "PlotHelperTypes.h"
 #include "PackUnpackPlotMsg.h"
 
+#include "sampleVect.h"
+#include "typedSampleVect.h"
 #include "smartMaxMin.h"
+#include "fusedMathOps.h"
 #include "sampleRateCalculator.h"
 
 #include "fftSpectrumAnalyzerFunctions.h"
@@ -87,13 +90,31 @@ public:
    void getXPoints(dubVect& ioXPoints, int startIndex, int stopIndex);
    void getYPoints(dubVect& ioYPoints, int startIndex, int stopIndex);
 
-   const double* getOrigXPoints(){return &xOrigPoints[0];}
-   const double* getOrigYPoints(){return &yOrigPoints[0];}
-   void getOrigXPoints(dubVect& ioXPoints){ioXPoints = xOrigPoints;}
-   void getOrigYPoints(dubVect& ioYPoints){ioYPoints = yOrigPoints;}
+   // Bytes of sample memory this curve has in RAM (spilled samples don't count).
+   size_t getResidentBytes();
+   // Move the samples out to memory mapped temp files / back into RAM. Spilled samples
+   // can be accessed as normal, they are paged in from the temp files as needed.
+   void spillSamples();
+   void unspillSamples();
 
-   const double* getNormXPoints(){return &normX[0];}
-   const double* getNormYPoints(){return &normY[0];}
+   void getOrigXPoints(dubVect& ioXPoints){ioXPoints.resize(xOrigPoints.size()); xOrigPoints.get(0, ioXPoints.data(), ioXPoints.size());}
+   void getOrigYPoints(dubVect& ioYPoints){ioYPoints.resize(yOrigPoints.size()); yOrigPoints.get(0, ioYPoints.data(), ioYPoints.size());}
+
+   // O(1) copies of the samples for another thread to read (e.g. a background save). They share the
+   // curve's memory until the curve changes the samples (copy on write).
+   void getOrigPointsSnapshot(eAxis axis, typedSampleVect& snapshot){(axis == E_X_AXIS ? xOrigPoints : yOrigPoints).snapshot(snapshot);}
+   void getPointsSnapshot(eAxis axis, sampleVect& snapshot);
+
+   // 1D curves don't store their X points when the X axis math ops are linear, the X value is
+   // generated from the sample index instead. Use these rather than getXPoints() when only a
+   // few X values are needed (getXPoints() has to generate the whole array for those curves).
+   double getXPoint(unsigned int index) const {return implicitXPoints ? (xPointsLinear.m * (double)index) + xPointsLinear.b : xPoints[index];}
+   double getNormXPoint(unsigned int index) const {return (normFactor.xAxis.m * getXPoint(index)) + normFactor.xAxis.b;}
+   double getGuiXPoint(unsigned int index) const {return xNormalized ? getNormXPoint(index) : getXPoint(index);}
+
+   // Normalization is an affine map, so the normalized points are computed when needed rather than stored.
+   double getNormYPoint(unsigned int index) const {return (normFactor.yAxis.m * yPoints[index]) + normFactor.yAxis.b;}
+   double getGuiYPoint(unsigned int index) const {return yNormalized ? getNormYPoint(index) : yPoints[index];}
 
    QColor getColor();
    QwtPlotCurve::CurveStyle getStyle(){return appearance.style;}
@@ -112,10 +133,19 @@ public:
    void resetNormalizeFactor();
    void setCurveSamples();
    void setCurveDataGuiPoints(bool onlyNeedToUpdate1D);
+   void setGuiPointsDeferred(bool deferred){guiPointsDeferred = deferred;}
 
    void ResetCurveSamples(const UnpackPlotMsg* data);
    void UpdateCurveSamples(const UnpackPlotMsg* data);
 
+   // New samples can be applied to a back buffer on another thread while the GUI keeps using the curve.
+   // createBackBuffer copies the curve's samples (copy on write, plus the max / min pyramids) and
+   // swapInBackBuffer makes the back buffer's samples the curve's samples. If the curve was changed in
+   // between (e.g. new math ops), swapInBackBuffer returns false and the new samples need to be applied
+   // to the curve itself. The back buffer is only for ResetCurveSamples / UpdateCurveSamples.
+   CurveData* createBackBuffer();
+   bool swapInBackBuffer(CurveData* backBuffer);
+
    bool setSampleRate(double inSampleRate, bool userSpecified = true);
    double getSampleRate(){return sampleRate;}
 
@@ -145,6 +175,10 @@ public:
    tPlotterIpAddr getLastMsgIpAddr(){return lastMsgIpAddr;}
    ePlotDataTypes getLastMsgDataType(eAxis axis){return axis == E_X_AXIS ? lastMsgXAxisType : lastMsgYAxisType;}
 
+   // Bytes allocated when handing the points to the GUI (Qwt's copy of the samples or growing the reduced point buffers).
+   size_t getGuiPointsBytesAllocatedLastRedraw(){return guiPointsBytesAllocated_lastRedraw;}
+   unsigned long long getGuiPointsBytesAllocatedTotal(){return guiPointsBytesAllocated_total;}
+
    QLabel* pointLabel;
    QAction* curveAction;
    QSignalMapper* mapper;
@@ -152,6 +186,13 @@ public:
    unsigned int getMaxNumPointsFromPlotMsg(){return maxNumPointsFromPlotMsg;}
    double getCalculatedSampleRateFromPlotMsgs(){return sampleRateCalculator.getSampleRate();}
 
+   // Out of core curves (large raw files) only hold the part of the source that is being viewed, either
+   // the samples themselves or a min/max envelope. Curve sample i is source sample (m * i) + b.
+   // The X extent of the curve still covers the whole source.
+   void setOutOfCoreView(const dubVect& yPoints, tLinear sourceIndex, unsigned long long sourceNumSamples);
+   bool isOutOfCore(){return outOfCoreNumSamples > 0;}
+   bool getOutOfCoreSourceRange(double startX, double stopX, long long& startIndex, long long& stopIndex);
+
    void setPointValue(unsigned int index, double value);
    void setPointValue(unsigned int index, double xValue, double yValue);
 
@@ -164,37 +205,48 @@ public:
    maxMinXY get2dDisplayedIndexes(unsigned& numNonContiguousSamples);
    void get2dDisplayedPoints(dubVect& xAxis, dubVect& yAxis);
 
-   void setDisplayedPoints(double val); // Sets all points that are displayed in the current zoom to 'val'
+   void setDisplayedPoints(double val); // Sets all original points that are displayed in the current zoom to 'val', then redoes the math ops on them.
 
 private:
    CurveData();
+   CurveData(CurveData* frontCurve); // Back buffer, see createBackBuffer.
    void init();
+   void copySampleState(CurveData* src, bool takeFromSrc);
+   void sampleStateChanged();
    void fill1DxPoints();
    void findMaxMin();
    void initCurve();
 
-   void findRealMaxMin(const dubVect& inPoints, double& max, double& min);
+   void findRealMaxMin(const sampleVect& inPoints, double& max, double& min);
 
    void performMathOnPoints();
+   void updateSampleSharing();
    void performMathOnPoints(unsigned int sampleStartIndex, unsigned int numSamples);
-   void doMathOnCurve(dubVect& data, tMathOpList& mathOp, unsigned int sampleStartIndex, unsigned int numSamples);
+   void doMathOnCurve(sampleVect& data, const fusedMathOps& mathOps, unsigned int sampleStartIndex, unsigned int numSamples);
    unsigned int removeInvalidPoints();
 
-   void swapSamples(dubVect& samples, int swapIndex);
+   void swapSamples(sampleVect& samples, int swapIndex);
+   void swapSamples(typedSampleVect& samples, int swapIndex);
 
    void UpdateCurveSamples(const dubVect& newYPoints, unsigned int sampleStartIndex, bool modifySpecificPoints);
    void UpdateCurveSamples(const dubVect& newXPoints, const dubVect& newYPoints, unsigned int sampleStartIndex, bool modifySpecificPoints);
 
    void storeLastMsgStats(const UnpackPlotMsg* data);
 
-   void getSamplesToSendToGui_1D(dubVect* xPointsForGui, int& xStartIndex, int& xEndIndex, unsigned int& sampPerPixel, bool addMargin);
-   int findFirstSampleGreaterThan(dubVect* xPointsForGui, double startSearchIndex, double compareValue);
+   void getSamplesToSendToGui_1D(int& xStartIndex, int& xEndIndex, unsigned int& sampPerPixel, bool addMargin);
+   int findFirstSampleGreaterThan(double startSearchIndex, double compareValue);
+   void setGuiSamples(int startIndex, int numSamples);
+   void resizeGuiPoints(size_t numPoints);
+   void setGuiRawSamples(size_t numPoints);
+   size_t getNumXPoints(){return implicitXPoints ? yPoints.size() : xPoints.size();}
 
    void handleNewSampleMsg(unsigned int sampleStartIndex, unsigned int numSamples);
 
    QwtPlot* m_parentPlot;
-   dubVect xOrigPoints;
-   dubVect yOrigPoints;
+   // Samples as they were received, stored in the data type they were sent in. The math ops output
+   // (xPoints / yPoints) is always double. Axes without math ops share their samples with xPoints / yPoints.
+   typedSampleVect xOrigPoints;
+   typedSampleVect yOrigPoints;
    smartMaxMin smartMaxMinXPoints;
    smartMaxMin smartMaxMinYPoints;
    maxMinXY maxMin_beforeScale;
@@ -216,21 +268,39 @@ private:
 
    bool scrollMode;
 
+   // When true, setCurveSamples does not send the points to the GUI (the owner will do that when it redraws).
+   bool guiPointsDeferred;
+
    // Normalize parameters
    tLinearXYAxis normFactor;
 
    bool xNormalized;
    bool yNormalized;
 
+   // 1D X axis generator, x[i] = (m * i) + b. When implicitXPoints is true, xOrigPoints is
+   // left empty and xPoints is only filled in if something asks for the whole array (getXPoints).
+   bool implicitXPoints;
+   tLinear xOrigPointsLinear;
+   tLinear xPointsLinear; // xOrigPointsLinear with the X axis math ops applied.
+   tLinear materializedXPointsLinear; // The generator that was used to fill in xPoints.
+
+   tLinear outOfCoreSourceIndex; // Maps curve sample index to out of core source sample index.
+   unsigned long long outOfCoreNumSamples; // 0 means the curve isn't out of core.
+
    // Math Manipulations.
-   dubVect xPoints;
-   dubVect yPoints;
-   dubVect normX;
-   dubVect normY;
+   sampleVect xPoints;
+   sampleVect yPoints;
 
-   // Reducing the number of points sent to the plot algorithm helps speed things up.
-   dubVect reducedXPoints;
-   dubVect reducedYPoints;
+   // The points the QwtPlotCurve draws, either the 1D reduced points (reducing the number of points sent
+   // to the plot algorithm helps speed things up) or a copy of the points being displayed. The curve points
+   // straight at these rather than making its own copy, so they are counted in getResidentBytes and are
+   // spilled along with the samples. Reused from redraw to redraw, only changed on the GUI thread.
+   sampleVect guiXPoints;
+   sampleVect guiYPoints;
+   size_t numGuiPoints;
+
+   size_t guiPointsBytesAllocated_lastRedraw;
+   unsigned long long guiPointsBytesAllocated_total;
 
    unsigned int oldestPoint_nonScrollModeVersion; // This can equal numPoints. In that case the newest sample is the last point.
    unsigned int plotSize_nonScrollModeVersion;
@@ -243,6 +313,8 @@ private:
 
    tMathOpList mathOpsXAxis;
    tMathOpList mathOpsYAxis;
+   fusedMathOps fusedMathOpsXAxis; // mathOpsXAxis compiled for applying to the samples.
+   fusedMathOps fusedMathOpsYAxis; // mathOpsYAxis compiled for applying to the samples.
 
    // Stats about the last message.
    tPlotterIpAddr lastMsgIpAddr;
@@ -254,6 +326,16 @@ private:
 
    fftSpecAnFunc::eFftSpecAnTraceType fftSpecAnTraceType;
    fftSpecAnFunc fftSpecAn;
+
+   // Changed whenever the samples are changed by something other than swapInBackBuffer. Unique across
+   // all curves, so a back buffer can't match a different curve that was created at the same address.
+   unsigned int sampleStateVersion;
+
+   // Back buffers only. The curve the back buffer was copied from and its sampleStateVersion at the time.
+   // The sample rate calculator is told about the new samples when the back buffer is swapped in.
+   CurveData* frontCurve;
+   unsigned int frontSampleStateVersion;
+   std::vector<unsigned int> backBufferNewSampleMsgs;
 };
 
 #endif
@@ -94,7 +94,7 @@ void GetEntirePlotMsg::initNextWriteMsg()
    {
       m_msgsWriteIndex = 0;
    }
-   m_msgs[m_msgsWriteIndex].clear();
+   m_msgs[m_msgsWriteIndex].reset();
 }
 
 bool GetEntirePlotMsg::ReadPlotPackets(tIncomingMsg* inMsg)
@@ -102,12 +102,14 @@ bool GetEntirePlotMsg::ReadPlotPackets(tIncomingMsg* inMsg)
    bool validMsg = (m_msgsReadIndex != m_msgsWriteIndex);
    if(validMsg)
    {
-      inMsg->msgPtr  = &m_msgs[m_msgsReadIndex][0];
-      inMsg->msgSize = m_msgs[m_msgsReadIndex].size();
+      inMsg->msgBuff = m_msgs[m_msgsReadIndex];
+      inMsg->msgPtr  = inMsg->msgBuff->data();
+      inMsg->msgSize = inMsg->msgBuff->size();
       inMsg->ipAddr  = m_ipAddr;
    }
    else
    {
+      inMsg->msgBuff.reset();
       inMsg->msgPtr  = NULL;
       inMsg->msgSize = 0;
       inMsg->ipAddr  = 0;
@@ -119,7 +121,8 @@ void GetEntirePlotMsg::finishedReadMsg()
 {
    if(m_msgsReadIndex != m_msgsWriteIndex)
    {
-      m_msgs[m_msgsReadIndex].clear();
+      // Release this reader's reference. Anyone else that took a reference keeps the buffer alive.
+      m_msgs[m_msgsReadIndex].reset();
       if(++m_msgsReadIndex == NUM_PACKET_SAVE)
       {
          m_msgsReadIndex = 0;
@@ -179,15 +182,17 @@ void GetEntirePlotMsg::ProcessPlotPacket(const char* inBytes, unsigned int numBy
                if( (m_curMsgSize > (sizeof(m_curAction) + sizeof(m_curMsgSize))) &&
                    (m_curMsgSize <= g_maxTcpPlotMsgSize) )
                {
-                  m_msgs[m_msgsWriteIndex].resize(m_curMsgSize);
+                  // New buffer for every message, the previous buffer may still be in use by the reader.
+                  m_msgs[m_msgsWriteIndex] = std::make_shared<std::vector<char> >(m_curMsgSize);
+                  char* msgBuff = m_msgs[m_msgsWriteIndex]->data();
                   
                   // Got to add the beginning of the message to the message buffer.
                   unsigned int bytesAlreadyRead = 0;
-                  memcpy(&m_msgs[m_msgsWriteIndex][bytesAlreadyRead], &m_curAction, sizeof(m_curAction));
+                  memcpy(&msgBuff[bytesAlreadyRead], &m_curAction, sizeof(m_curAction));
                   bytesAlreadyRead += sizeof(m_curAction);
-                  memcpy(&m_msgs[m_msgsWriteIndex][bytesAlreadyRead], &m_curMsgSize, sizeof(m_curMsgSize));
+                  memcpy(&msgBuff[bytesAlreadyRead], &m_curMsgSize, sizeof(m_curMsgSize));
                   bytesAlreadyRead += sizeof(m_curMsgSize);
-                  setNextState(E_READ_REST_OF_MSG, &m_msgs[m_msgsWriteIndex][bytesAlreadyRead], m_curMsgSize - bytesAlreadyRead);
+                  setNextState(E_READ_REST_OF_MSG, &msgBuff[bytesAlreadyRead], m_curMsgSize - bytesAlreadyRead);
                }
                else
                {
@@ -244,6 +249,7 @@ UnpackPlotMsg::UnpackPlotMsg(tIncomingMsg* inMsg):
    m_msg(inMsg->msgPtr),
    m_msgSize(inMsg->msgSize),
    m_msgReadIndex(0),
+   m_msgBuff(inMsg->msgBuff),
    m_numSamplesInPlot(0)
 {
    unpack(&m_plotAction, sizeof(m_plotAction));
@@ -274,11 +280,10 @@ UnpackPlotMsg::UnpackPlotMsg(tIncomingMsg* inMsg):
                // of data specified in the message.
                if( (m_msgReadIndex + dataSize) == m_msgSize )
                {
+                  UINT_32 ySampSize = getPlotDataTypeSize(m_yAxisDataType);
                   m_yAxisValues.resize(m_numSamplesInPlot);
-                  for(unsigned int i = 0; i < m_numSamplesInPlot; ++i)
-                  {
-                     m_yAxisValues[i] = readSampleValue(m_yAxisDataType);
-                  }
+                  readSampleValues(m_yAxisDataType, m_yAxisValues.data(), m_numSamplesInPlot, 0, ySampSize);
+                  m_msgReadIndex += dataSize;
                }
             }
          break;
@@ -307,29 +312,23 @@ UnpackPlotMsg::UnpackPlotMsg(tIncomingMsg* inMsg):
                // of data specified in the message.
                if( (m_msgReadIndex + dataSize) == m_msgSize )
                {
+                  UINT_32 xSampSize = getPlotDataTypeSize(m_xAxisDataType);
+                  UINT_32 ySampSize = getPlotDataTypeSize(m_yAxisDataType);
                   m_xAxisValues.resize(m_numSamplesInPlot);
                   m_yAxisValues.resize(m_numSamplesInPlot);
                   if(m_interleaved == false)
                   {
-                     for(unsigned int i = 0; i < m_numSamplesInPlot; ++i)
-                     {
-                        m_xAxisValues[i] = readSampleValue(m_xAxisDataType);
-                     }
-                     for(unsigned int i = 0; i < m_numSamplesInPlot; ++i)
-                     {
-                        m_yAxisValues[i] = readSampleValue(m_yAxisDataType);
-                     }
-
+                     // All the X samples, followed by all the Y samples.
+                     readSampleValues(m_xAxisDataType, m_xAxisValues.data(), m_numSamplesInPlot, 0, xSampSize);
+                     readSampleValues(m_yAxisDataType, m_yAxisValues.data(), m_numSamplesInPlot, xSampSize * m_numSamplesInPlot, ySampSize);
                   } // end if(m_interleaved == false)
                   else
                   {
-                     // Interleaved data
-                     for(unsigned int i = 0; i < m_numSamplesInPlot; ++i)
-                     {
-                        m_xAxisValues[i] = readSampleValue(m_xAxisDataType);
-                        m_yAxisValues[i] = readSampleValue(m_yAxisDataType);
-                     }
+                     // Interleaved data, X and Y samples alternate.
+                     readSampleValues(m_xAxisDataType, m_xAxisValues.data(), m_numSamplesInPlot, 0, xSampSize + ySampSize);
+                     readSampleValues(m_yAxisDataType, m_yAxisValues.data(), m_numSamplesInPlot, xSampSize, xSampSize + ySampSize);
                   }
+                  m_msgReadIndex += dataSize;
                }
             }
          break;
@@ -403,126 +402,108 @@ void UnpackPlotMsg::unpackStr(std::string* dst)
    }
 }
 
-double UnpackPlotMsg::readSampleValue(ePlotDataTypes dataType)
+// Time struct wire types. These only exist so the bulk sample kernels below can be
+// templated on them like the other wire types.
+typedef struct{UINT_32 val[2];}tTimeStruct64;  // Index 0 is seconds, index 1 is nanoseconds.
+typedef struct{UINT_32 val[4];}tTimeStruct128; // Index 0 is seconds, index 2 is nanoseconds.
+typedef struct{INT_64 val;}tTimeNanoSec64;
+
+template <typename tWireType>
+static inline double wireSampleToDouble(const tWireType& samp){ return (double)samp; }
+
+static inline double wireSampleToDouble(const tTimeStruct64& samp)
 {
-   double retVal = 0.0;
-   switch(dataType)
+   return (double)((INT_32)samp.val[0]) + ((double)samp.val[1] / (double)1000000000.0);
+}
+
+static inline double wireSampleToDouble(const tTimeStruct128& samp)
+{
+   return (double)samp.val[0] + ((double)samp.val[2] / (double)1000000000.0);
+}
+
+static inline double wireSampleToDouble(const tTimeNanoSec64& samp)
+{
+   return ((double)samp.val) / 1e9; // Convert nanoseconds to seconds
+}
+
+// Convert a run of samples of one wire type to doubles. 'strideBytes' is the distance
+// between the start of each sample (it is bigger than the sample size for interleaved data).
+// The memcpy into a local compiles down to a single unaligned load, so the contiguous
+// case is a tight loop the compiler can vectorize.
+template <typename tWireType>
+static void bulkWireSamplesToDouble(const char* src, double* dst, UINT_32 numSamples, UINT_32 strideBytes)
+{
+   tWireType samp;
+   if(strideBytes == sizeof(tWireType))
    {
-      case E_CHAR:
-      {
-         SCHAR samp = 0;
-         unpack(&samp, sizeof(samp));
-         retVal = (double)samp;
-      }
-      break;
-      case E_UCHAR:
-      {
-         UCHAR samp = 0;
-         unpack(&samp, sizeof(samp));
-         retVal = (double)samp;
-      }
-      break;
-      case E_INT_16:
-      {
-         INT_16 samp = 0;
-         unpack(&samp, sizeof(samp));
-         retVal = (double)samp;
-      }
-      break;
-      case E_UINT_16:
-      {
-         UINT_16 samp = 0;
-         unpack(&samp, sizeof(samp));
-         retVal = (double)samp;
-      }
-      break;
-      case E_INT_32:
-      {
-         INT_32 samp = 0;
-         unpack(&samp, sizeof(samp));
-         retVal = (double)samp;
-      }
-      break;
-      case E_UINT_32:
-      {
-         UINT_32 samp = 0;
-         unpack(&samp, sizeof(samp));
-         retVal = (double)samp;
-      }
-      break;
-      case E_INT_64:
-      {
-         INT_64 samp = 0;
-         unpack(&samp, sizeof(samp));
-         retVal = (double)samp;
-      }
-      break;
-      case E_UINT_64:
+      for(UINT_32 i = 0; i < numSamples; ++i)
       {
-         UINT_64 samp = 0;
-         unpack(&samp, sizeof(samp));
-         retVal = (double)samp;
+         memcpy(&samp, src + (size_t)i * sizeof(tWireType), sizeof(tWireType));
+         dst[i] = wireSampleToDouble(samp);
       }
-      break;
-      case E_FLOAT_16:
-      {
-         FLOAT_16 samp;
-         unpack(&samp, sizeof(samp));
-         retVal = (double)samp;
-      }
-      break;
-      case E_FLOAT_32:
-      {
-         FLOAT_32 samp = 0;
-         unpack(&samp, sizeof(samp));
-         retVal = (double)samp;
-      }
-      break;
-      case E_FLOAT_64:
-      {
-         FLOAT_64 samp = 0;
-         unpack(&samp, sizeof(samp));
-         retVal = (double)samp;
-      }
-      break;
-      case E_TIME_STRUCT_64:
-      {
-         UINT_32 samp[2]; // Index 0 is seconds, index 1 is nanoseconds.
-         unpack(&samp, sizeof(samp));
-         retVal = (double)((INT_32)samp[0]) + ((double)samp[1] / (double)1000000000.0);
-      }
-      break;
-      case E_TIME_STRUCT_128:
-      {
-         UINT_32 samp[4]; // Index 0 is seconds, index 2 is nanoseconds.
-         unpack(&samp, sizeof(samp));
-         retVal = (double)samp[0] + ((double)samp[2] / (double)1000000000.0);
-      }
-      break;
-      case E_TIME_NANOSEC_64:
+   }
+   else
+   {
+      for(UINT_32 i = 0; i < numSamples; ++i)
       {
-         INT_64 samp = 0;
-         unpack(&samp, sizeof(samp));
-         retVal = ((double)samp) / 1e9; // Convert nanoseconds to seconds
+         memcpy(&samp, src + (size_t)i * strideBytes, sizeof(tWireType));
+         dst[i] = wireSampleToDouble(samp);
       }
-      break;
+   }
+}
+
+// Converts 'numSamples' samples of 'dataType' into 'dst'. The first sample starts 'byteOffset'
+// bytes past the current read index and each following sample is 'strideBytes' after the
+// previous one. The message bounds are checked once for the whole run. The read index is
+// not moved, the calling function is responsible for that.
+void UnpackPlotMsg::readSampleValues(ePlotDataTypes dataType, double* dst, UINT_32 numSamples, UINT_32 byteOffset, UINT_32 strideBytes)
+{
+   UINT_32 sampSize = getPlotDataTypeSize(dataType);
+   if(numSamples == 0 || sampSize == 0)
+   {
+      return;
+   }
+
+   // Make sure the last sample is within the message.
+   UINT_64 lastSampEnd = (UINT_64)m_msgReadIndex + byteOffset + ((UINT_64)(numSamples-1) * strideBytes) + sampSize;
+   if(lastSampEnd > m_msgSize)
+   {
+      throw 0; // Indicate to calling function that an error has occurred.
+   }
+
+   const char* src = m_msg + m_msgReadIndex + byteOffset;
+   switch(dataType)
+   {
+      case E_CHAR:            bulkWireSamplesToDouble<SCHAR         >(src, dst, numSamples, strideBytes); break;
+      case E_UCHAR:           bulkWireSamplesToDouble<UCHAR         >(src, dst, numSamples, strideBytes); break;
+      case E_INT_16:          bulkWireSamplesToDouble<INT_16        >(src, dst, numSamples, strideBytes); break;
+      case E_UINT_16:         bulkWireSamplesToDouble<UINT_16       >(src, dst, numSamples, strideBytes); break;
+      case E_INT_32:          bulkWireSamplesToDouble<INT_32        >(src, dst, numSamples, strideBytes); break;
+      case E_UINT_32:         bulkWireSamplesToDouble<UINT_32       >(src, dst, numSamples, strideBytes); break;
+      case E_INT_64:          bulkWireSamplesToDouble<INT_64        >(src, dst, numSamples, strideBytes); break;
+      case E_UINT_64:         bulkWireSamplesToDouble<UINT_64       >(src, dst, numSamples, strideBytes); break;
+      case E_FLOAT_16:        bulkWireSamplesToDouble<FLOAT_16      >(src, dst, numSamples, strideBytes); break;
+      case E_FLOAT_32:        bulkWireSamplesToDouble<FLOAT_32      >(src, dst, numSamples, strideBytes); break;
+      case E_FLOAT_64:        bulkWireSamplesToDouble<FLOAT_64      >(src, dst, numSamples, strideBytes); break;
+      case E_TIME_STRUCT_64:  bulkWireSamplesToDouble<tTimeStruct64 >(src, dst, numSamples, strideBytes); break;
+      case E_TIME_STRUCT_128: bulkWireSamplesToDouble<tTimeStruct128>(src, dst, numSamples, strideBytes); break;
+      case E_TIME_NANOSEC_64: bulkWireSamplesToDouble<tTimeNanoSec64>(src, dst, numSamples, strideBytes); break;
       case E_INVALID_DATA_TYPE:
       break;
    }
-
-   return retVal;
 }
 
 UnpackMultiPlotMsg::UnpackMultiPlotMsg()
 {
 }
 
-UnpackMultiPlotMsg::UnpackMultiPlotMsg(const char* msg, unsigned int size, std::string plotNameOverride)
+UnpackMultiPlotMsg::UnpackMultiPlotMsg(const char* msg, unsigned int size, std::string plotNameOverride, tPlotMsgBuffPtr msgBuff)
 {
    tIncomingMsg inMsg;
    inMsg.msgPtr = msg;
    inMsg.msgSize = size;
    inMsg.ipAddr = 0;
+   inMsg.msgBuff = msgBuff;
    init(&inMsg, plotNameOverride);
 }
 
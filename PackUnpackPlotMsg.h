@@ -177,7 +177,9 @@ private:
 
    ePlotAction m_curAction;
    unsigned int m_curMsgSize;
-   std::vector<char> m_msgs[NUM_PACKET_SAVE];
+   // Each reassembled message gets its own buffer. Ownership is shared with the reader
+   // of the message, so a buffer stays valid after it leaves this ring.
+   std::shared_ptr<std::vector<char> > m_msgs[NUM_PACKET_SAVE];
    unsigned int m_msgsWriteIndex;
    unsigned int m_msgsReadIndex;
 
@@ -217,18 +219,20 @@ public:
 
    const char* GetMsgPtr(){return m_msg;}
    UINT_32 GetMsgPtrSize(){return m_msgSize;}
+   tPlotMsgBuffPtr GetMsgBuff(){return m_msgBuff;}
 
 private:
    
    void unpack(void* dst, unsigned int size);
    void unpackStr(std::string* dst);
 
-   double readSampleValue(ePlotDataTypes dataType);
+   void readSampleValues(ePlotDataTypes dataType, double* dst, UINT_32 numSamples, UINT_32 byteOffset, UINT_32 strideBytes);
    
    
    const char* m_msg;
    UINT_32 m_msgSize;
    UINT_32 m_msgReadIndex;
+   tPlotMsgBuffPtr m_msgBuff; // Owner of the memory m_msg points to (can be null if the caller owns it).
 
    UINT_32 m_numSamplesInPlot;
 
@@ -276,7 +280,7 @@ class UnpackMultiPlotMsg
 {
 public:
    UnpackMultiPlotMsg();
-   UnpackMultiPlotMsg(const char* msg, unsigned int size, std::string plotNameOverride);
+   UnpackMultiPlotMsg(const char* msg, unsigned int size, std::string plotNameOverride, tPlotMsgBuffPtr msgBuff = tPlotMsgBuffPtr());
    UnpackMultiPlotMsg(tIncomingMsg* inMsg);
    ~UnpackMultiPlotMsg();
 
@@ -20,6 +20,7 @@
 #define PlotHelperTypes_h
 
 #include <vector>
+#include <memory>
 
 
 #include <QString>
@@ -456,12 +457,17 @@ typedef enum
    E_DISPLAY_POINT_SIGNED_HEX,
 }eDisplayPointHexDec;
 
+// Reference counted plot message buffer. The buffer is allocated once when the message
+// is reassembled from the socket and is shared (not copied) from then on.
+typedef std::shared_ptr<const std::vector<char> > tPlotMsgBuffPtr;
+
 typedef struct
 {
    tPlotCurveName name;
    const char* msgPtr;
    unsigned int msgSize;
    QDateTime msgTime;
+   tPlotMsgBuffPtr msgBuff; // Keeps the memory msgPtr points to alive.
 }tStoredMsg;
 
 class tPlotterIpAddr
@@ -541,6 +547,7 @@ typedef struct
    const char* msgPtr;
    unsigned int msgSize;
    tPlotterIpAddr ipAddr;
+   tPlotMsgBuffPtr msgBuff; // If set, msgPtr points into this buffer and it can be shared instead of copied.
 }tIncomingMsg;
 
 
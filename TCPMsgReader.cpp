@@ -1,4 +1,4 @@
-/* Copyright 2013 - 2014, 2016, 2025 Dan Williams. All Rights Reserved.
+/* Copyright 2013 - 2014, 2016, 2025 - 2026 Dan Williams. All Rights Reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of this
  * software and associated documentation files (the "Software"), to deal in the Software
@@ -21,6 +21,8 @@
 
 unsigned int g_tcp_maxPacketSize = 2048;
 unsigned int g_tcp_maxStoredPackets = 2048;
+unsigned int g_udp_rcvBuffSize = 0; // 0 = OS default
+unsigned int g_tcp_numEventLoops = 0; // 0 = rx / proc thread per client, > 0 = number of epoll event loop threads
 
 TCPMsgReader::TCPMsgReader(plotGuiMain* parent, int port):
     m_parent(parent)
@@ -35,13 +37,14 @@ TCPMsgReader::TCPMsgReader(plotGuiMain* parent, int port):
                       this,
                       g_tcp_maxPacketSize,
                       g_tcp_maxStoredPackets);
+   dServerSocket_setEventDriven(&m_servSock, g_tcp_numEventLoops);
 
    dServerSocket_bind(&m_servSock);
 
    dServerSocket_accept(&m_servSock);
 
 #ifdef RX_FROM_UDP
-   dUDPSocket_start(&m_udpSock, port+1, RxPacketCallbackUDP, this);
+   dUDPSocket_start(&m_udpSock, port+1, RxPacketCallbackUDP, this, g_udp_rcvBuffSize);
 #endif
 }
 
@@ -63,6 +66,7 @@ TCPMsgReader::~TCPMsgReader()
 void TCPMsgReader::ClientStartCallback(void* inPtr, struct sockaddr_storage* client)
 {
    TCPMsgReader* _this = (TCPMsgReader*)inPtr;
+   QMutexLocker lock(&_this->m_msgReaderMapMutex);
    if(_this->m_msgReaderMap.find(client) == _this->m_msgReaderMap.end())
    {
       _this->m_msgReaderMap[client] = new GetEntirePlotMsg(client);
@@ -72,6 +76,7 @@ void TCPMsgReader::ClientStartCallback(void* inPtr, struct sockaddr_storage* cli
 void TCPMsgReader::ClientEndCallback(void* inPtr, struct sockaddr_storage* client)
 {
    TCPMsgReader* _this = (TCPMsgReader*)inPtr;
+   QMutexLocker lock(&_this->m_msgReaderMapMutex);
    if(_this->m_msgReaderMap.find(client) != _this->m_msgReaderMap.end())
    {
       delete _this->m_msgReaderMap.find(client)->second;
@@ -84,11 +89,23 @@ void TCPMsgReader::RxPacketCallback(void* inPtr, struct sockaddr_storage* client
     TCPMsgReader* _this = (TCPMsgReader*)inPtr;
     tIncomingMsg inMsg;
 
-    _this->m_msgReaderMap[client]->ProcessPlotPacket(packet, size);
-    while(_this->m_msgReaderMap[client]->ReadPlotPackets(&inMsg))
+    // Clients can connect / disconnect (and in epoll mode receive packets) from other
+    // threads, so only hold the lock long enough to find this client's message reader.
+    _this->m_msgReaderMapMutex.lock();
+    GetEntirePlotMsg* msgReader = _this->m_msgReaderMap[client];
+    _this->m_msgReaderMapMutex.unlock();
+
+    FlightRecorder* flightRecorder = _this->m_parent->getFlightRecorder();
+
+    msgReader->ProcessPlotPacket(packet, size);
+    while(msgReader->ReadPlotPackets(&inMsg))
     {
+        if(flightRecorder != NULL)
+        {
+            flightRecorder->record(&inMsg);
+        }
         _this->m_parent->startPlotMsgProcess(&inMsg);
-        _this->m_msgReaderMap[client]->finishedReadMsg();
+        msgReader->finishedReadMsg();
     }
 
 }
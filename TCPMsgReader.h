@@ -1,4 +1,4 @@
-/* Copyright 2013 - 2014 Dan Williams. All Rights Reserved.
+/* Copyright 2013 - 2014, 2026 Dan Williams. All Rights Reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of this
  * software and associated documentation files (the "Software"), to deal in the Software
@@ -28,6 +28,7 @@
 
 #include <map>
 #include <QSharedPointer>
+#include <QMutex>
 
 class plotGuiMain;
 
@@ -40,6 +41,11 @@ public:
    plotGuiMain* m_parent;
 
    std::map<struct sockaddr_storage*, GetEntirePlotMsg*> m_msgReaderMap;
+   QMutex m_msgReaderMapMutex;
+
+#ifdef RX_FROM_UDP
+   void getUdpRxStats(dUDPRxStats* stats){dUDPSocket_getRxStats(&m_udpSock, stats);}
+#endif
    
 private:
    dServerSocket m_servSock;
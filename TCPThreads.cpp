@@ -1,4 +1,4 @@
-/* Copyright 2013, 2017, 2019, 2025 Dan Williams. All Rights Reserved.
+/* Copyright 2013, 2017, 2019, 2025 - 2026 Dan Williams. All Rights Reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of this
  * software and associated documentation files (the "Software"), to deal in the Software
@@ -17,6 +17,7 @@
  * DEALINGS IN THE SOFTWARE.
  */
 #include "TCPThreads.h"
+#include <errno.h>
 
 
 #if defined TCP_SERVER_THREADS_WIN_BUILD && !defined __MINGW32_VERSION
@@ -171,6 +172,12 @@ void* dServerSocket_rxThread(void* voidDClientConn)
          sem_post(&dClientConn->sem);
          dClientConn->rxBuff.buffIndex += packetSize;
       }
+#ifdef TCP_SERVER_THREADS_LINUX_BUILD
+      else if(packetSize < 0 && errno == EINTR)
+      {
+         // Interrupted by a signal, the connection is still good. Try again.
+      }
+#endif
       else
       {
          //printf("rxThread wrong packet size\n");
@@ -309,10 +316,17 @@ void dServerSocket_bind(dServerSocket* dSock)
 
 }
 
-void dServerSocket_accept(dServerSocket* dSock)
+int dServerSocket_accept(dServerSocket* dSock)
 {
+#ifdef TCP_SERVER_THREADS_LINUX_BUILD
+   if(dSock->numEventLoops > 0)
+   {
+      return dServerSocket_startEventLoops(dSock);
+   }
+#endif
    pthread_create(&dSock->acceptThread.thread, NULL, dServerSocket_acceptThread, dSock);
    pthread_create(&dSock->killThread.thread, NULL, dServer_killThreads, dSock);
+   return 0;
 }
 
 dClientConnection* dServerSocket_createNewClientConn(dServerSocket* dSock)
@@ -412,6 +426,14 @@ void dServerSocket_killAll(dServerSocket* dSock)
 {
    struct dClientConnList* clientListPtr = NULL;
 
+#ifdef TCP_SERVER_THREADS_LINUX_BUILD
+   if(dSock->numEventLoops > 0)
+   {
+      dServerSocket_stopEventLoops(dSock);
+      return;
+   }
+#endif
+
    // Kill the accept thread.
    while(dSock->acceptThread.active == 0 && dSock->acceptThread.kill == 0);
    dSock->acceptThread.kill = 1;
@@ -443,3 +465,279 @@ void dServerSocket_killAll(dServerSocket* dSock)
 
 }
 
+void dServerSocket_setEventDriven(dServerSocket* dSock, unsigned int numEventLoops)
+{
+#ifdef TCP_SERVER_THREADS_LINUX_BUILD
+   dSock->numEventLoops = (numEventLoops > DSOCKET_MAX_EVENT_LOOPS) ? DSOCKET_MAX_EVENT_LOOPS : numEventLoops;
+#else
+   // epoll is Linux only, stay with the thread per client implementation.
+   dSock->numEventLoops = 0;
+#endif
+}
+
+#ifdef TCP_SERVER_THREADS_LINUX_BUILD
+static struct dClientConnList* dServerSocket_getClientListNode(dClientConnection* dConn)
+{
+   return (struct dClientConnList*)((char*)dConn - offsetof(struct dClientConnList, cur));
+}
+
+void* dServerSocket_eventLoopThread(void* voidEventLoop)
+{
+   dEventLoop* loop = (dEventLoop*)voidEventLoop;
+   dServerSocket* dSock = (dServerSocket*)loop->dSock;
+   struct epoll_event events[DSOCKET_EPOLL_MAX_EVENTS];
+   int numEvents = 0;
+   int i;
+
+   loop->thread.active = 1;
+
+   while(!loop->thread.kill)
+   {
+      numEvents = epoll_wait(loop->epollFd, events, DSOCKET_EPOLL_MAX_EVENTS, -1);
+      if(numEvents < 0)
+      {
+         // EINTR just means a signal came in while waiting. Nothing else is expected
+         // (the fd and events pointer are always valid), but don't spin if it happens.
+         if(errno != EINTR)
+         {
+            usleep(1000);
+         }
+         continue;
+      }
+      for(i = 0; i < numEvents && !loop->thread.kill; ++i)
+      {
+         void* eventPtr = events[i].data.ptr;
+         if(eventPtr == (void*)loop)
+         {
+            // Wake up event, just clear it and check the kill flag.
+            uint64_t dontCare;
+            ssize_t readSize = read(loop->wakeFd, &dontCare, sizeof(dontCare));
+            (void)readSize;
+         }
+         else if(eventPtr == (void*)dSock)
+         {
+            dServerSocket_eventLoopAccept(dSock);
+         }
+         else
+         {
+            // The packet is handed to the callback before the next recv, so a
+            // single rx buffer per event loop is all that is needed.
+            dClientConnection* dConn = (dClientConnection*)eventPtr;
+            int packetSize = recv(dConn->fd, loop->rxBuff, dSock->maxPacketSize, 0);
+            if(packetSize > 0)
+            {
+               dConn->rxPacketCallback(dConn->callbackInputPtr, &dConn->info, loop->rxBuff, packetSize);
+            }
+            else if(packetSize < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+               // Nothing read, but the connection is still good. epoll will report the client again if there is data.
+            }
+            else
+            {
+               dServerSocket_eventLoopRemoveClient(dSock, loop, dConn);
+            }
+         }
+      }
+   }
+   loop->thread.active = 0;
+
+   return NULL;
+}
+
+int dServerSocket_startEventLoops(dServerSocket* dSock)
+{
+   struct epoll_event ev;
+   unsigned int i;
+   int listening = 0;
+   int success = 1;
+
+   if(dSock->socketFd != INVALID_FD && listen(dSock->socketFd, SOMAXCONN) != -1)
+   {
+      // Non-blocking so all pending connections can be accepted on each event.
+      fcntl(dSock->socketFd, F_SETFL, fcntl(dSock->socketFd, F_GETFL, 0) | O_NONBLOCK);
+      listening = 1;
+   }
+
+   dSock->eventLoops = (dEventLoop*)calloc(dSock->numEventLoops, sizeof(dEventLoop));
+   dSock->nextEventLoop = 0;
+   for(i = 0; i < dSock->numEventLoops; ++i)
+   {
+      dSock->eventLoops[i].epollFd = -1;
+      dSock->eventLoops[i].wakeFd = -1;
+   }
+   for(i = 0; i < dSock->numEventLoops && success; ++i)
+   {
+      dEventLoop* loop = &dSock->eventLoops[i];
+      loop->dSock = dSock;
+      loop->epollFd = epoll_create1(0);
+      loop->wakeFd = eventfd(0, EFD_NONBLOCK);
+      loop->rxBuff = (char*)malloc(dSock->maxPacketSize);
+      success = loop->epollFd != -1 && loop->wakeFd != -1 && loop->rxBuff != NULL;
+
+      if(success)
+      {
+         memset(&ev, 0, sizeof(ev));
+         ev.events = EPOLLIN;
+         ev.data.ptr = loop;
+         success = epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, loop->wakeFd, &ev) != -1;
+      }
+   }
+
+   if(!success)
+   {
+      // Out of fds (or memory). Don't start the server, free what was created so far.
+      dServerSocket_freeEventLoops(dSock);
+      if(dSock->socketFd != INVALID_FD)
+      {
+         closesocket(dSock->socketFd);
+         dSock->socketFd = INVALID_FD;
+      }
+      return -1;
+   }
+
+   // New connections are only accepted by the first event loop, they are then
+   // spread across all the event loops.
+   if(listening)
+   {
+      memset(&ev, 0, sizeof(ev));
+      ev.events = EPOLLIN;
+      ev.data.ptr = dSock;
+      epoll_ctl(dSock->eventLoops[0].epollFd, EPOLL_CTL_ADD, dSock->socketFd, &ev);
+   }
+
+   for(i = 0; i < dSock->numEventLoops; ++i)
+   {
+      pthread_create(&dSock->eventLoops[i].thread.thread, NULL, dServerSocket_eventLoopThread, &dSock->eventLoops[i]);
+   }
+   return 0;
+}
+
+void dServerSocket_freeEventLoops(dServerSocket* dSock)
+{
+   unsigned int i;
+   if(dSock->eventLoops != NULL)
+   {
+      for(i = 0; i < dSock->numEventLoops; ++i)
+      {
+         if(dSock->eventLoops[i].epollFd != -1)
+            close(dSock->eventLoops[i].epollFd);
+         if(dSock->eventLoops[i].wakeFd != -1)
+            close(dSock->eventLoops[i].wakeFd);
+         free(dSock->eventLoops[i].rxBuff);
+      }
+      free(dSock->eventLoops);
+      dSock->eventLoops = NULL;
+   }
+}
+
+void dServerSocket_stopEventLoops(dServerSocket* dSock)
+{
+   struct dClientConnList* clientListPtr = NULL;
+   unsigned int i;
+
+   // Kill the event loop threads (if the event loops failed to start, there is nothing to stop).
+   for(i = 0; i < dSock->numEventLoops && dSock->eventLoops != NULL; ++i)
+   {
+      uint64_t wake = 1;
+      ssize_t writeSize;
+      dSock->eventLoops[i].thread.kill = 1;
+      writeSize = write(dSock->eventLoops[i].wakeFd, &wake, sizeof(wake));
+      (void)writeSize;
+      pthread_join(dSock->eventLoops[i].thread.thread, NULL);
+   }
+
+   // Close all the client connections still active. The event loops are gone,
+   // so nothing else can be touching the client list.
+   while(dSock->clientList != NULL)
+   {
+      clientListPtr = dSock->clientList;
+      closesocket(clientListPtr->cur.fd);
+      dServerSocket_removeClientFromList(clientListPtr, dSock);
+      if(dSock->clientConnEndCallback != NULL)
+      {
+         dSock->clientConnEndCallback(dSock->callbackInputPtr, &clientListPtr->cur.info);
+      }
+      free(clientListPtr);
+   }
+
+   if(dSock->socketFd != INVALID_FD)
+   {
+      closesocket(dSock->socketFd);
+   }
+
+   dServerSocket_freeEventLoops(dSock);
+
+   sem_destroy(&dSock->killThreadSem);
+   pthread_mutex_destroy(&dSock->mutex);
+}
+
+void dServerSocket_eventLoopAccept(dServerSocket* dSock)
+{
+   struct sockaddr_storage clientAddr;
+   SOCKET connectionFd = INVALID_FD;
+
+   do
+   {
+      socklen_t sockStoreSize = sizeof(clientAddr);
+      connectionFd = accept(dSock->socketFd, (struct sockaddr*)&clientAddr, &sockStoreSize);
+      if(connectionFd != INVALID_FD)
+      {
+         dServerSocket_eventLoopAddClient(dSock, connectionFd, &clientAddr);
+      }
+   }while(connectionFd != INVALID_FD);
+}
+
+void dServerSocket_eventLoopAddClient(dServerSocket* dSock, SOCKET clientFd, struct sockaddr_storage* clientAddr)
+{
+   struct epoll_event ev;
+   dEventLoop* loop = &dSock->eventLoops[dSock->nextEventLoop];
+
+   // setup the new client connection structure, no per client threads or rx buffers are needed.
+   dClientConnection* dConn = dServerSocket_createNewClientConn(dSock);
+   memset(dConn, 0, sizeof(dClientConnection));
+   dConn->fd = clientFd;
+   dConn->info = *clientAddr;
+   dConn->rxPacketCallback = dSock->rxPacketCallback;
+   dConn->callbackInputPtr = dSock->callbackInputPtr;
+
+   if(++dSock->nextEventLoop >= dSock->numEventLoops)
+   {
+      dSock->nextEventLoop = 0;
+   }
+
+   // inform parent that a new client has connected, this must happen before
+   // the event loop can start calling the rx callback for this client.
+   if(dSock->clientConnStartCallback != NULL)
+   {
+      dSock->clientConnStartCallback(dSock->callbackInputPtr, &dConn->info);
+   }
+
+   memset(&ev, 0, sizeof(ev));
+   ev.events = EPOLLIN | EPOLLRDHUP;
+   ev.data.ptr = dConn;
+   if(epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, clientFd, &ev) != 0)
+   {
+      dServerSocket_eventLoopRemoveClient(dSock, loop, dConn);
+   }
+}
+
+void dServerSocket_eventLoopRemoveClient(dServerSocket* dSock, dEventLoop* loop, dClientConnection* dConn)
+{
+   struct dClientConnList* clientListPtr = dServerSocket_getClientListNode(dConn);
+
+   epoll_ctl(loop->epollFd, EPOLL_CTL_DEL, dConn->fd, NULL);
+   closesocket(dConn->fd);
+
+   pthread_mutex_lock(&dSock->mutex);
+   dServerSocket_removeClientFromList(clientListPtr, dSock);
+   pthread_mutex_unlock(&dSock->mutex);
+
+   // inform parent that a client has been disconnected
+   if(dSock->clientConnEndCallback != NULL)
+   {
+      dSock->clientConnEndCallback(dSock->callbackInputPtr, &dConn->info);
+   }
+   free(clientListPtr);
+}
+#endif
+
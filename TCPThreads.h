@@ -1,4 +1,4 @@
-/* Copyright 2013, 2016 - 2017, 2025 Dan Williams. All Rights Reserved.
+/* Copyright 2013, 2016 - 2017, 2025 - 2026 Dan Williams. All Rights Reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of this
  * software and associated documentation files (the "Software"), to deal in the Software
@@ -21,6 +21,8 @@
 
 #include <stdio.h>
 #include <stdlib.h> 
+#include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 #include <pthread.h>
 #include <semaphore.h>
@@ -55,6 +57,9 @@
    #include <sys/types.h>
    #include <netinet/in.h>
    #include <sys/socket.h>
+   #include <sys/epoll.h>
+   #include <sys/eventfd.h>
+   #include <fcntl.h>
    
    typedef unsigned int SOCKET;
    #define closesocket(fd) close(fd)
@@ -62,6 +67,10 @@
 
 #define INVALID_FD (0xFFFFFFFF)
 
+// Upper limit on the number of epoll event loop threads the server can be configured to use.
+#define DSOCKET_MAX_EVENT_LOOPS (16)
+#define DSOCKET_EPOLL_MAX_EVENTS (64)
+
 typedef struct
 {
    pthread_t thread;
@@ -109,6 +118,18 @@ struct dClientConnList
    struct dClientConnList* next;
 };
 
+// Event driven mode (Linux only). Each event loop thread services a subset of the
+// client connections from a single epoll instance, instead of each client having
+// its own rx thread and proc thread.
+typedef struct
+{
+   dSocketThread thread;
+   int epollFd;
+   int wakeFd;
+   char* rxBuff;
+   void* dSock;
+}dEventLoop;
+
 typedef struct
 {
    unsigned short port;
@@ -124,6 +145,9 @@ typedef struct
    pthread_mutex_t mutex;
    unsigned int maxPacketSize;
    unsigned int maxStoredPackets;
+   unsigned int numEventLoops; // 0 means one rx thread and one proc thread per client.
+   dEventLoop* eventLoops;
+   unsigned int nextEventLoop;
 }dServerSocket;
 
 
@@ -143,7 +167,7 @@ void* dServerSocket_rxThread(void* voidDClientConn);
 void* dServerSocket_procThread(void* voidDClientConn);
 void* dServer_killThreads(void* voidDSock);
 void dServerSocket_bind(dServerSocket* dSock);
-void dServerSocket_accept(dServerSocket* dSock);
+int dServerSocket_accept(dServerSocket* dSock); // Returns -1 if the server couldn't be started.
 dClientConnection* dServerSocket_createNewClientConn(dServerSocket* dSock);
 void dServerSocket_removeClientFromList(struct dClientConnList* clientListPtr, dServerSocket *dSock);
 void dServerSocket_deleteClient(struct dClientConnList* clientListPtr, dServerSocket* dSock);
@@ -152,6 +176,16 @@ void dServerSocket_killAll(dServerSocket* dSock);
 void dServerSocket_writeNewPacket(dClientConnection* dConn, char* packet, unsigned int size);
 void dServerSocket_readAllPackets(dClientConnection* dConn);
 void dServerSocket_updateIndexForNextPacket(dSocketRxBuff* rxBuff);
+void dServerSocket_setEventDriven(dServerSocket* dSock, unsigned int numEventLoops);
+#ifdef TCP_SERVER_THREADS_LINUX_BUILD
+void* dServerSocket_eventLoopThread(void* voidEventLoop);
+int dServerSocket_startEventLoops(dServerSocket* dSock);
+void dServerSocket_freeEventLoops(dServerSocket* dSock);
+void dServerSocket_stopEventLoops(dServerSocket* dSock);
+void dServerSocket_eventLoopAccept(dServerSocket* dSock);
+void dServerSocket_eventLoopAddClient(dServerSocket* dSock, SOCKET clientFd, struct sockaddr_storage* clientAddr);
+void dServerSocket_eventLoopRemoveClient(dServerSocket* dSock, dEventLoop* loop, dClientConnection* dConn);
+#endif
 
 #endif
 
@@ -1,4 +1,4 @@
-/* Copyright 2014 Dan Williams. All Rights Reserved.
+/* Copyright 2014, 2026 Dan Williams. All Rights Reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of this
  * software and associated documentation files (the "Software"), to deal in the Software
@@ -27,42 +27,98 @@
    #endif
 #endif
 
-void dUDPSocket_updateIndexForNextPacket(dUDPRxBuff* rxBuff)
+#define UDP_RING_SLOT(index) ((index) & (UDP_MAX_STORED_PACKETS-1))
+
+int dUDPSocket_receivePackets(dUDPSocket* dSock, unsigned int writeIndex, unsigned int maxPackets)
 {
-   unsigned int buffIndex = (rxBuff->buffIndex + 3) & ((unsigned int)-4);
-   if( (buffIndex + rxBuff->maxPacketSize) >= sizeof(rxBuff->buff))
+   dUDPRxBuff* rxBuff = &dSock->rxBuff;
+#ifdef UDP_THREADS_LINUX_BUILD
+   // Read as many datagrams as are available (up to maxPackets) with a single system call.
+   struct mmsghdr msgs[UDP_RX_BATCH_SIZE];
+   struct iovec iovecs[UDP_RX_BATCH_SIZE];
+   char ctrlBuff[UDP_RX_BATCH_SIZE][CMSG_SPACE(sizeof(uint32_t))];
+   unsigned int i;
+   int numPackets;
+
+   if(maxPackets > UDP_RX_BATCH_SIZE)
    {
-      rxBuff->buffIndex = 0;
+      maxPackets = UDP_RX_BATCH_SIZE;
    }
-   else
+
+   memset(msgs, 0, sizeof(msgs[0]) * maxPackets);
+   for(i = 0; i < maxPackets; ++i)
    {
-      rxBuff->buffIndex = buffIndex;
+      unsigned int slot = UDP_RING_SLOT(writeIndex + i);
+      iovecs[i].iov_base = rxBuff->buff[slot];
+      iovecs[i].iov_len = UDP_MAX_PACKET_SIZE;
+      msgs[i].msg_hdr.msg_iov = &iovecs[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+      msgs[i].msg_hdr.msg_name = &rxBuff->packetSource[slot];
+      msgs[i].msg_hdr.msg_namelen = sizeof(rxBuff->packetSource[slot]);
+      msgs[i].msg_hdr.msg_control = ctrlBuff[i];
+      msgs[i].msg_hdr.msg_controllen = sizeof(ctrlBuff[i]);
    }
-}
 
-void dUDPSocket_writeNewPacket(dUDPRxBuff* rxBuff, char* packet, unsigned int size, struct sockaddr_storage* source)
-{
-   rxBuff->packetAddr[rxBuff->writeIndex] = packet;
-   rxBuff->packetSize[rxBuff->writeIndex] = size;
-   rxBuff->packetSource[rxBuff->writeIndex] = *source;
-   if(++rxBuff->writeIndex == UDP_MAX_STORED_PACKETS)
+   numPackets = recvmmsg(dSock->socketFd, msgs, maxPackets, MSG_WAITFORONE, NULL);
+
+   for(i = 0; (int)i < numPackets; ++i)
    {
-      rxBuff->writeIndex = 0;
+      struct cmsghdr* cmsg;
+      rxBuff->packetSize[UDP_RING_SLOT(writeIndex + i)] = msgs[i].msg_len;
+
+      // SO_RXQ_OVFL reports the running total of datagrams the OS has dropped on this socket.
+      for(cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg != NULL; cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg))
+      {
+         if(cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL)
+         {
+            uint32_t numDropped;
+            memcpy(&numDropped, CMSG_DATA(cmsg), sizeof(numDropped));
+            rxBuff->numDroppedPackets = numDropped;
+         }
+      }
+   }
+   return numPackets;
+#else
+   unsigned int slot = UDP_RING_SLOT(writeIndex);
+   socklen_t sourceAddrLen = sizeof(rxBuff->packetSource[slot]);
+   int packetSize;
+
+   (void)maxPackets;
+   packetSize = recvfrom( dSock->socketFd,
+                          rxBuff->buff[slot],
+                          UDP_MAX_PACKET_SIZE,
+                          0,
+                          (struct sockaddr *)&rxBuff->packetSource[slot],
+                          &sourceAddrLen);
+   if(packetSize > 0)
+   {
+      rxBuff->packetSize[slot] = packetSize;
+      return 1;
    }
+   return packetSize;
+#endif
 }
 
 void dUDPSocket_readAllPackets(dUDPSocket* udpSock)
 {
-   while(udpSock->rxBuff.readIndex != udpSock->rxBuff.writeIndex)
+   dUDPRxBuff* rxBuff = &udpSock->rxBuff;
+   unsigned int readIndex = rxBuff->readIndex;
+   unsigned int writeIndex = __atomic_load_n(&rxBuff->writeIndex, __ATOMIC_ACQUIRE);
+
+   while(readIndex != writeIndex)
    {
+      unsigned int slot = UDP_RING_SLOT(readIndex);
       udpSock->rxPacketCallback(
          udpSock->callbackValuePtr,
-         &udpSock->rxBuff.packetSource[udpSock->rxBuff.readIndex],
-         udpSock->rxBuff.packetAddr[udpSock->rxBuff.readIndex],
-         udpSock->rxBuff.packetSize[udpSock->rxBuff.readIndex] );
-      if(++udpSock->rxBuff.readIndex == UDP_MAX_STORED_PACKETS)
+         &rxBuff->packetSource[slot],
+         rxBuff->buff[slot],
+         rxBuff->packetSize[slot] );
+
+      // Hand the slot back to the rx thread as soon as it has been processed.
+      __atomic_store_n(&rxBuff->readIndex, ++readIndex, __ATOMIC_RELEASE);
+      if(readIndex == writeIndex)
       {
-         udpSock->rxBuff.readIndex = 0;
+         writeIndex = __atomic_load_n(&rxBuff->writeIndex, __ATOMIC_ACQUIRE);
       }
    }
 }
@@ -79,14 +135,14 @@ void dUDPSocket_wsaInit()
 void dUDPSocket_start(dUDPSocket* dSock,
                       unsigned short port,
                       dRxUDPCallback rxPacketCallback,
-                      void* callbackValuePtr)
+                      void* callbackValuePtr,
+                      unsigned int rcvBuffSize)
 {
    memset(dSock, 0, sizeof(dUDPSocket));
    dSock->port = port;
    dSock->rxPacketCallback = rxPacketCallback;
    dSock->callbackValuePtr = callbackValuePtr;
-   dSock->rxBuff.maxPacketSize = UDP_MAX_PACKET_SIZE;
-   dSock->rxBuff.buffPtr = (char*)dSock->rxBuff.buff;
+   dSock->rcvBuffSize = rcvBuffSize;
 
 #ifdef UDP_THREADS_WIN_BUILD
    dUDPSocket_wsaInit();
@@ -97,7 +153,6 @@ void dUDPSocket_start(dUDPSocket* dSock,
    if(dSock->socketFd != INVALID_FD)
    {
       sem_init(&dSock->dataReadySem, 0, 0);
-      pthread_mutex_init(&dSock->mutex, NULL);
       
       pthread_create((pthread_t*)&dSock->rxThread, NULL, dUDPSocket_rxThread, dSock);
       pthread_create((pthread_t*)&dSock->procThread, NULL, dUDPSocket_procThread, dSock);
@@ -107,30 +162,34 @@ void dUDPSocket_start(dUDPSocket* dSock,
 void* dUDPSocket_rxThread(void* voidDUDPSocket)
 {
    dUDPSocket* dSock = (dUDPSocket*)voidDUDPSocket;
-   int packetSize = 0;
-   struct sockaddr_storage sourceAddr;
-   socklen_t sourceAddrLen = sizeof(sourceAddr);
+   int numPackets = 0;
 
    dSock->rxThread.active = 1;
    printf("rxThread start\n");
    while(!dSock->rxThread.kill)
    {
-      dUDPSocket_updateIndexForNextPacket(&dSock->rxBuff);
-
-      packetSize = recvfrom( dSock->socketFd, 
-                             &dSock->rxBuff.buffPtr[dSock->rxBuff.buffIndex], 
-                             dSock->rxBuff.maxPacketSize, 
-                             0,
-                             (struct sockaddr *)&sourceAddr,
-                             &sourceAddrLen);
-      if(packetSize > 0)
+      unsigned int writeIndex = dSock->rxBuff.writeIndex;
+      unsigned int numFree = UDP_MAX_STORED_PACKETS -
+         (writeIndex - __atomic_load_n(&dSock->rxBuff.readIndex, __ATOMIC_ACQUIRE));
+
+      if(numFree == 0)
       {
-         dUDPSocket_writeNewPacket( &dSock->rxBuff, 
-                                    &dSock->rxBuff.buffPtr[dSock->rxBuff.buffIndex], 
-                                    packetSize,
-                                    &sourceAddr );
+         // Ring is full. Leave new datagrams in the socket receive buffer until the proc thread catches up.
+         dSock->rxBuff.numRingFullWaits++;
+#ifdef UDP_THREADS_WIN_BUILD
+         Sleep(1);
+#else
+         usleep(100);
+#endif
+         continue;
+      }
+
+      numPackets = dUDPSocket_receivePackets(dSock, writeIndex, numFree);
+      if(numPackets > 0)
+      {
+         // Publish the whole batch at once and only wake the proc thread once per batch.
+         __atomic_store_n(&dSock->rxBuff.writeIndex, writeIndex + numPackets, __ATOMIC_RELEASE);
          sem_post(&dSock->dataReadySem);
-         dSock->rxBuff.buffIndex += packetSize;
       }
       else
       {
@@ -209,6 +268,21 @@ void dUDPSocket_bind(dUDPSocket* dSock)
 
    freeaddrinfo(serverInfoList);
 
+   if(success)
+   {
+      int numParam = 1;
+      if(dSock->rcvBuffSize > 0)
+      {
+         // A larger receive buffer lets the OS hold on to bursts of datagrams while the ring is full.
+         numParam = (int)dSock->rcvBuffSize;
+         setsockopt(dSock->socketFd, SOL_SOCKET, SO_RCVBUF, (char*)&numParam, sizeof(numParam));
+      }
+#ifdef UDP_THREADS_LINUX_BUILD
+      numParam = 1;
+      setsockopt(dSock->socketFd, SOL_SOCKET, SO_RXQ_OVFL, (char*)&numParam, sizeof(numParam));
+#endif
+   }
+
 }
 
 void dUDPSocket_stop(dUDPSocket* dSock)
@@ -237,9 +311,13 @@ void dUDPSocket_stop(dUDPSocket* dSock)
       pthread_join(dSock->procThread.thread, NULL);
 
       sem_destroy(&dSock->dataReadySem);
-      pthread_mutex_destroy(&dSock->mutex);
-      
+
       dSock->socketFd = INVALID_FD;
    }
 }
 
+void dUDPSocket_getRxStats(dUDPSocket* dSock, dUDPRxStats* stats)
+{
+   stats->numDroppedPackets = __atomic_load_n(&dSock->rxBuff.numDroppedPackets, __ATOMIC_RELAXED);
+   stats->numRingFullWaits = __atomic_load_n(&dSock->rxBuff.numRingFullWaits, __ATOMIC_RELAXED);
+}
@@ -1,4 +1,4 @@
-/* Copyright 2014 Dan Williams. All Rights Reserved.
+/* Copyright 2014, 2026 Dan Williams. All Rights Reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of this
  * software and associated documentation files (the "Software"), to deal in the Software
@@ -21,6 +21,7 @@
 
 #include <stdio.h>
 #include <stdlib.h> 
+#include <stdint.h>
 #include <string.h>
 #include <semaphore.h>
 #include <pthread.h>
@@ -54,9 +55,10 @@
    #define closesocket(fd) close(fd)
 #endif
 
-#define UDP_MAX_PACKET_SIZE ((2*1024*1024) + 256)
-#define UDP_MAX_PACKETS (20)
-#define UDP_MAX_STORED_PACKETS (2048)
+// The largest possible UDP payload is 65507 bytes, so every ring slot can hold any datagram.
+#define UDP_MAX_PACKET_SIZE (64*1024)
+#define UDP_MAX_STORED_PACKETS (512) // Must be a power of 2.
+#define UDP_RX_BATCH_SIZE (32) // Max number of datagrams to read with a single recvmmsg call.
 
 #define INVALID_FD (0xFFFFFFFF)
 
@@ -68,21 +70,28 @@ typedef struct
    volatile int kill;
 }dUDPThread;
 
+// Single producer (rx thread), single consumer (proc thread) ring of received datagrams.
+// readIndex / writeIndex are free running, only the proc thread writes readIndex and
+// only the rx thread writes writeIndex.
 typedef struct
 {
-   unsigned int buff[((UDP_MAX_PACKET_SIZE*UDP_MAX_PACKETS)+(sizeof(unsigned int)-1))/sizeof(unsigned int)];
-
-   char* buffPtr;
-   unsigned int buffIndex;
-   unsigned int maxPacketSize;
-
-   char* packetAddr[UDP_MAX_STORED_PACKETS];
+   char buff[UDP_MAX_STORED_PACKETS][UDP_MAX_PACKET_SIZE];
    unsigned int packetSize[UDP_MAX_STORED_PACKETS];
    struct sockaddr_storage packetSource[UDP_MAX_STORED_PACKETS];
    unsigned int readIndex;
    unsigned int writeIndex;
+
+   // Statistics
+   volatile unsigned int numDroppedPackets; // Dropped by the OS because the socket receive buffer was full (Linux only).
+   volatile unsigned int numRingFullWaits; // Number of times the rx thread had to wait for the proc thread to free a slot.
 }dUDPRxBuff;
 
+typedef struct
+{
+   unsigned int numDroppedPackets;
+   unsigned int numRingFullWaits;
+}dUDPRxStats;
+
 
 typedef void (*dRxUDPCallback)(void*, struct sockaddr_storage*, char*, unsigned int);
 
@@ -92,7 +101,7 @@ typedef struct
    SOCKET socketFd;
    dRxUDPCallback rxPacketCallback;
    void* callbackValuePtr;
-   pthread_mutex_t mutex;
+   unsigned int rcvBuffSize; // SO_RCVBUF size, 0 = use the OS default.
 
    dUDPThread rxThread;
    dUDPThread procThread;
@@ -105,16 +114,20 @@ void dUDPSocket_wsaInit();
 void dUDPSocket_start(dUDPSocket* dSock,
                       unsigned short port,
                       dRxUDPCallback rxPacketCallback,
-                      void* callbackValuePtr);
+                      void* callbackValuePtr,
+                      unsigned int rcvBuffSize);
 void dUDPSocket_bind(dUDPSocket* dSock);
 
 void* dUDPSocket_rxThread(void* voidDUDPSocket);
 void* dUDPSocket_procThread(void* voidDUDPSocket);
 
 void dUDPSocket_stop(dUDPSocket* dSock);
-void dUDPSocket_writeNewPacket(dUDPRxBuff* rxBuff, char* packet, unsigned int size, struct sockaddr_storage* source);
+
+// Can be called from any thread while the socket is running. The counters are kept after
+// dUDPSocket_stop and are only reset by the next dUDPSocket_start.
+void dUDPSocket_getRxStats(dUDPSocket* dSock, dUDPRxStats* stats);
+int dUDPSocket_receivePackets(dUDPSocket* dSock, unsigned int writeIndex, unsigned int maxPackets);
 void dUDPSocket_readAllPackets(dUDPSocket* udpSock);
-void dUDPSocket_updateIndexForNextPacket(dUDPRxBuff* rxBuff);
 
 #endif
 
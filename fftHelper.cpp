@@ -18,9 +18,14 @@
  */
 #include <fftw3.h>
 #include <math.h>
+#include <pthread.h>
 #include "PlotHelperTypes.h"
 #include "fftHelper.h"
 
+// Only fftw_execute is thread safe. Child curves compute FFTs from worker threads, so
+// the FFTW planner calls need to be serialized.
+static pthread_mutex_t fftwPlannerMutex = PTHREAD_MUTEX_INITIALIZER;
+
 // Overwrite NaN samples at the beginning with 0's
 // There are many reasons why samples at the beginning might be NaN values:
 // Scroll mode, FM Demod, etc...
@@ -91,7 +96,9 @@ void complexFFT::removePlan()
    }
    if(needToRemovePlan)
    {
+      pthread_mutex_lock(&fftwPlannerMutex);
       fftw_destroy_plan(p);
+      pthread_mutex_unlock(&fftwPlannerMutex);
    }
    N = 0;
 }
@@ -106,7 +113,9 @@ void complexFFT::run(const dubVect& inRe, const dubVect& inIm, dubVect& outRe, d
       removePlan();
       in = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * newN);
       out = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * newN);
+      pthread_mutex_lock(&fftwPlannerMutex);
       p = fftw_plan_dft_1d(newN, in, out, FFTW_FORWARD, FFTW_ESTIMATE);
+      pthread_mutex_unlock(&fftwPlannerMutex);
    }
    N = newN; // Always set this (i.e. if input is size 0, don't do anything).
 
@@ -180,7 +189,9 @@ void realFFT::removePlan()
    }
    if(needToRemovePlan)
    {
+      pthread_mutex_lock(&fftwPlannerMutex);
       fftw_destroy_plan(p);
+      pthread_mutex_unlock(&fftwPlannerMutex);
    }
    N = 0;
 }
@@ -194,7 +205,9 @@ void realFFT::run(const dubVect& inRe, dubVect& outRe, double* windowCoef)
       removePlan();
       in = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * newN);
       out = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * newN);
+      pthread_mutex_lock(&fftwPlannerMutex);
       p = fftw_plan_dft_1d(newN, in, out, FFTW_FORWARD, FFTW_ESTIMATE);
+      pthread_mutex_unlock(&fftwPlannerMutex);
    }
    N = newN; // Always set this (i.e. if input is size 0, don't do anything).
 
@@ -1,4 +1,4 @@
-/* Copyright 2019 Dan Williams. All Rights Reserved.
+/* Copyright 2019, 2026 Dan Williams. All Rights Reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of this
  * software and associated documentation files (the "Software"), to deal in the Software
@@ -22,6 +22,7 @@
  *  Created on: Mar 27, 2019
  *      Author: d
  */
+#include <algorithm>
 #include <QMutexLocker>
 #include "fftSpectrumAnalyzerFunctions.h"
 
@@ -71,6 +72,34 @@ void fftSpecAnFunc::getAveragePoints(dubVect& ioXPoints)
    ioXPoints = m_avgValue;
 }
 
+void fftSpecAnFunc::copyFrom(fftSpecAnFunc& src)
+{
+   QMutexLocker srcLock(&src.m_fftSpecAnFuncMutex);
+   QMutexLocker lock(&m_fftSpecAnFuncMutex);
+
+   m_fftNumBins = src.m_fftNumBins;
+   m_maxHold = src.m_maxHold;
+   m_numDesiredAvgPoints = src.m_numDesiredAvgPoints;
+   m_allAvgFfts = src.m_allAvgFfts;
+   m_numAvgPointsPerBin = src.m_numAvgPointsPerBin;
+   m_avgSumLinear = src.m_avgSumLinear;
+   m_avgValue = src.m_avgValue;
+}
+
+void fftSpecAnFunc::swap(fftSpecAnFunc& other)
+{
+   QMutexLocker lock(&m_fftSpecAnFuncMutex);
+   QMutexLocker otherLock(&other.m_fftSpecAnFuncMutex);
+
+   std::swap(m_fftNumBins, other.m_fftNumBins);
+   m_maxHold.swap(other.m_maxHold);
+   std::swap(m_numDesiredAvgPoints, other.m_numDesiredAvgPoints);
+   m_allAvgFfts.swap(other.m_allAvgFfts);
+   m_numAvgPointsPerBin.swap(other.m_numAvgPointsPerBin);
+   m_avgSumLinear.swap(other.m_avgSumLinear);
+   m_avgValue.swap(other.m_avgValue);
+}
+
 void fftSpecAnFunc::reset()
 {
    QMutexLocker lock(&m_fftSpecAnFuncMutex);
@@ -1,4 +1,4 @@
-/* Copyright 2019 Dan Williams. All Rights Reserved.
+/* Copyright 2019, 2026 Dan Williams. All Rights Reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of this
  * software and associated documentation files (the "Software"), to deal in the Software
@@ -55,6 +55,10 @@ public:
 
    bool isFftPlot(){return m_isFftPlot;}
 
+   // Copy / swap the max hold and average state of another fftSpecAnFunc for the same plot type.
+   void copyFrom(fftSpecAnFunc& src);
+   void swap(fftSpecAnFunc& other);
+
 private:
    // Do not allow default constructor, copy contructor, etc.
    fftSpecAnFunc();
@@ -0,0 +1,416 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include "flightRecorder.h"
+#include "FileSystemOperations.h"
+
+// Records are gathered into blocks of this size before being written, so the disk sees large sequential writes.
+#define FLIGHT_RECORDER_BLOCK_SIZE (4*1024*1024)
+
+// If this many bytes of messages are waiting to be written, new messages are dropped from the recording.
+#define FLIGHT_RECORDER_MAX_QUEUED_BYTES (256*1024*1024)
+
+// Queued messages are written at least this often, even if a full block hasn't been queued yet.
+#define FLIGHT_RECORDER_MAX_WRITE_DELAY_MS (500)
+
+static const char FLIGHT_RECORDER_MAGIC[8] = {'P', 'L', 'O', 'T', 'R', 'E', 'C', '\x1a'};
+
+// Defaults, can be changed via ini file. An empty directory path means the flight recorder is off.
+std::string g_flightRecorderDir = "";
+uint64_t g_flightRecorderFileSize = 256*1024*1024;
+unsigned int g_flightRecorderNumFiles = 16;
+
+
+int64_t flightRecorderTimeUs()
+{
+   return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Returns the .plotrec files in the directory, oldest first. File names start with
+// the time of their first record, zero padded, so sorting by name sorts by time.
+static std::vector<std::string> getRecFilePaths(const std::string& dirPath)
+{
+   std::vector<std::string> recFilePaths;
+   fso::tDirContents dirContents;
+   fso::GetDirContents(dirContents, dirPath, false);
+   for(fso::tDirContents::iterator iter = dirContents.begin(); iter != dirContents.end(); ++iter)
+   {
+      if(!iter->b_isDir && fso::GetExt(iter->t_path) == FLIGHT_RECORDER_REC_EXT)
+      {
+         recFilePaths.push_back(dirPath + fso::dirSep() + iter->t_path); // Non-recursive listings are just the file name.
+      }
+   }
+   std::sort(recFilePaths.begin(), recFilePaths.end());
+   return recFilePaths;
+}
+
+static std::string getIdxFilePath(const std::string& recFilePath)
+{
+   return fso::RemoveExt(recFilePath) + "." + FLIGHT_RECORDER_IDX_EXT;
+}
+
+static void removeRecFile(const std::string& recFilePath)
+{
+   QFile::remove(recFilePath.c_str());
+   QFile::remove(getIdxFilePath(recFilePath).c_str());
+}
+
+static int64_t getRecFileStartTimeUs(const std::string& recFilePath)
+{
+   // The file name is "plotter_<start time>".
+   std::string fileName = fso::GetFileNameNoExt(recFilePath);
+   size_t timeStart = fileName.find('_');
+   return timeStart == std::string::npos ? 0 : strtoll(fileName.c_str() + timeStart + 1, NULL, 10);
+}
+
+
+FlightRecorder::FlightRecorder(std::string dirPath, uint64_t maxFileSize, unsigned int maxNumFiles):
+   m_dirPath(fso::DontEndWithDirSep(dirPath)),
+   m_maxFileSize(maxFileSize),
+   m_maxNumFiles(std::max(maxNumFiles, 1u)),
+   m_queuedBytes(0),
+   m_numDroppedMsgs(0),
+   m_stop(false),
+   m_recFileSize(0),
+   m_blockStartTimeUs(0)
+{
+   m_block.reserve(FLIGHT_RECORDER_BLOCK_SIZE + sizeof(tFlightRecorderMsgHeader));
+   fso::recursiveCreateDir(m_dirPath);
+   start();
+}
+
+FlightRecorder::~FlightRecorder()
+{
+   // Let the I/O thread write everything that has been queued before stopping.
+   m_queueMutex.lock();
+   m_stop = true;
+   m_queueCond.wakeOne();
+   m_queueMutex.unlock();
+   wait();
+}
+
+void FlightRecorder::record(const tIncomingMsg* inMsg)
+{
+   tQueuedMsg msg;
+   msg.header.timeUs = flightRecorderTimeUs();
+   msg.header.ipAddr = (uint32_t)inMsg->ipAddr.m_ipV4Addr;
+   msg.header.msgSize = inMsg->msgSize;
+   msg.msgBuff = inMsg->msgBuff;
+   msg.msgPtr = inMsg->msgPtr;
+   if(msg.msgBuff == nullptr)
+   {
+      // The caller owns the memory, make a copy that lives until the message is written.
+      msg.msgBuff = std::make_shared<const std::vector<char> >(inMsg->msgPtr, inMsg->msgPtr + inMsg->msgSize);
+      msg.msgPtr = msg.msgBuff->data();
+   }
+
+   uint64_t recordSize = sizeof(msg.header) + msg.header.msgSize;
+
+   QMutexLocker lock(&m_queueMutex);
+   if(m_queuedBytes + recordSize > FLIGHT_RECORDER_MAX_QUEUED_BYTES)
+   {
+      ++m_numDroppedMsgs;
+      return;
+   }
+
+   // Only wake the I/O thread once a full block is ready, otherwise it wakes up on its own.
+   bool wakeIoThread = (m_queuedBytes < FLIGHT_RECORDER_BLOCK_SIZE) && (m_queuedBytes + recordSize >= FLIGHT_RECORDER_BLOCK_SIZE);
+   m_queuedMsgs.push_back(msg);
+   m_queuedBytes += recordSize;
+   if(wakeIoThread)
+   {
+      m_queueCond.wakeOne();
+   }
+}
+
+uint64_t FlightRecorder::getNumDroppedMsgs()
+{
+   QMutexLocker lock(&m_queueMutex);
+   return m_numDroppedMsgs;
+}
+
+void FlightRecorder::run()
+{
+   std::vector<tQueuedMsg> msgs;
+   bool stop = false;
+   while(!stop)
+   {
+      m_queueMutex.lock();
+      if(!m_stop && m_queuedBytes < FLIGHT_RECORDER_BLOCK_SIZE)
+      {
+         m_queueCond.wait(&m_queueMutex, FLIGHT_RECORDER_MAX_WRITE_DELAY_MS);
+      }
+      msgs.swap(m_queuedMsgs);
+      stop = m_stop;
+      m_queueMutex.unlock();
+
+      if(msgs.size() > 0)
+      {
+         writeMsgs(msgs);
+
+         // The queued bytes include the messages being written, so a slow disk can't let the memory grow without limit.
+         uint64_t writtenBytes = 0;
+         for(size_t i = 0; i < msgs.size(); ++i)
+         {
+            writtenBytes += sizeof(msgs[i].header) + msgs[i].header.msgSize;
+         }
+         msgs.clear(); // Release the message buffers.
+
+         m_queueMutex.lock();
+         m_queuedBytes -= writtenBytes;
+         m_queueMutex.unlock();
+      }
+   }
+   closeFile();
+}
+
+void FlightRecorder::writeMsgs(std::vector<tQueuedMsg>& msgs)
+{
+   for(size_t i = 0; i < msgs.size(); ++i)
+   {
+      const tQueuedMsg& msg = msgs[i];
+      uint64_t recordSize = sizeof(msg.header) + msg.header.msgSize;
+
+      // Roll over to a new file when this record would put the current file over the size limit.
+      bool fileHasRecords = (m_recFileSize + m_block.size()) > sizeof(tFlightRecorderFileHeader);
+      if(!m_recFile.isOpen() || (fileHasRecords && (m_recFileSize + m_block.size() + recordSize) > m_maxFileSize))
+      {
+         writeBlock();
+         closeFile();
+         if(!openNextFile(msg.header.timeUs))
+         {
+            continue; // Can't write to the directory. The message isn't recorded.
+         }
+      }
+
+      if(m_block.size() == 0)
+      {
+         m_blockStartTimeUs = msg.header.timeUs;
+      }
+      const char* headerBytes = (const char*)&msg.header;
+      m_block.insert(m_block.end(), headerBytes, headerBytes + sizeof(msg.header));
+
+      if(msg.header.msgSize >= FLIGHT_RECORDER_BLOCK_SIZE)
+      {
+         // Big message, write it straight from its buffer rather than copying it into the block.
+         if(writeBlock())
+         {
+            qint64 numBytesWritten = m_recFile.write(msg.msgPtr, msg.header.msgSize);
+            if(numBytesWritten == (qint64)msg.header.msgSize)
+            {
+               m_recFileSize += numBytesWritten;
+            }
+            else
+            {
+               // The record header is already in the file, anything appended after the partial
+               // payload would be misaligned. Start a new file with the next message.
+               closeFile();
+            }
+         }
+      }
+      else
+      {
+         m_block.insert(m_block.end(), msg.msgPtr, msg.msgPtr + msg.header.msgSize);
+         if(m_block.size() >= FLIGHT_RECORDER_BLOCK_SIZE)
+         {
+            writeBlock();
+         }
+      }
+   }
+
+   // Don't hold on to a partial block, get everything queued so far to the disk.
+   writeBlock();
+   m_recFile.flush();
+   m_idxFile.flush();
+}
+
+bool FlightRecorder::writeBlock()
+{
+   if(m_block.size() == 0 || !m_recFile.isOpen())
+   {
+      m_block.clear();
+      return m_recFile.isOpen();
+   }
+
+   tFlightRecorderIndexEntry indexEntry;
+   indexEntry.timeUs = m_blockStartTimeUs;
+   indexEntry.fileOffset = m_recFileSize;
+
+   qint64 numBytesWritten = m_recFile.write(m_block.data(), m_block.size());
+   bool success = (numBytesWritten == (qint64)m_block.size());
+   if(success)
+   {
+      m_recFileSize += numBytesWritten;
+      m_idxFile.write((const char*)&indexEntry, sizeof(indexEntry));
+   }
+   else
+   {
+      // Don't append after a partial block, the records would be misaligned. Start a new file with the next message.
+      closeFile();
+   }
+   m_block.clear();
+   return success;
+}
+
+bool FlightRecorder::openNextFile(int64_t timeUs)
+{
+   char fileName[64];
+   snprintf(fileName, sizeof(fileName), "plotter_%020lld.%s", (long long)timeUs, FLIGHT_RECORDER_REC_EXT);
+   std::string recFilePath = m_dirPath + fso::dirSep() + fileName;
+
+   m_recFile.setFileName(recFilePath.c_str());
+   m_idxFile.setFileName(getIdxFilePath(recFilePath).c_str());
+   if(!m_recFile.open(QIODevice::WriteOnly | QIODevice::Truncate) || !m_idxFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+   {
+      closeFile();
+      removeRecFile(recFilePath);
+      return false;
+   }
+
+   tFlightRecorderFileHeader fileHeader;
+   memset(&fileHeader, 0, sizeof(fileHeader));
+   memcpy(fileHeader.magic, FLIGHT_RECORDER_MAGIC, sizeof(fileHeader.magic));
+   fileHeader.version = FLIGHT_RECORDER_VERSION;
+   if(m_recFile.write((const char*)&fileHeader, sizeof(fileHeader)) != (qint64)sizeof(fileHeader))
+   {
+      closeFile();
+      removeRecFile(recFilePath); // Don't leave an empty file behind for every message when the disk is full.
+      return false;
+   }
+   m_recFileSize = sizeof(fileHeader);
+
+   removeOldFiles();
+   return true;
+}
+
+void FlightRecorder::closeFile()
+{
+   if(m_recFile.isOpen())
+      m_recFile.close();
+   if(m_idxFile.isOpen())
+      m_idxFile.close();
+   m_recFileSize = 0;
+}
+
+void FlightRecorder::removeOldFiles()
+{
+   std::vector<std::string> recFilePaths = getRecFilePaths(m_dirPath);
+   for(size_t i = 0; i + m_maxNumFiles < recFilePaths.size(); ++i)
+   {
+      removeRecFile(recFilePaths[i]);
+   }
+}
+
+
+FlightRecorderReader::FlightRecorderReader(std::string dirPath, int64_t startTimeUs, int64_t endTimeUs):
+   m_recFilePaths(getRecFilePaths(fso::DontEndWithDirSep(dirPath))),
+   m_fileIndex(0),
+   m_startTimeUs(startTimeUs),
+   m_endTimeUs(endTimeUs)
+{
+   // Skip the files that end before the time span starts (i.e. the next file starts before the time span).
+   while(m_fileIndex + 1 < m_recFilePaths.size() && getRecFileStartTimeUs(m_recFilePaths[m_fileIndex + 1]) <= m_startTimeUs)
+   {
+      ++m_fileIndex;
+   }
+   if(m_fileIndex < m_recFilePaths.size())
+   {
+      openFile(m_fileIndex);
+   }
+}
+
+bool FlightRecorderReader::openFile(size_t fileIndex)
+{
+   m_recFile.close();
+   m_recFile.setFileName(m_recFilePaths[fileIndex].c_str());
+
+   tFlightRecorderFileHeader fileHeader;
+   if( !m_recFile.open(QIODevice::ReadOnly) ||
+       m_recFile.read((char*)&fileHeader, sizeof(fileHeader)) != (qint64)sizeof(fileHeader) ||
+       memcmp(fileHeader.magic, FLIGHT_RECORDER_MAGIC, sizeof(fileHeader.magic)) != 0 ||
+       fileHeader.version != FLIGHT_RECORDER_VERSION )
+   {
+      m_recFile.close();
+      return false;
+   }
+
+   // Use the index to jump to the last block that starts before the time span.
+   QFile idxFile(getIdxFilePath(m_recFilePaths[fileIndex]).c_str());
+   if(idxFile.open(QIODevice::ReadOnly))
+   {
+      std::vector<tFlightRecorderIndexEntry> index(idxFile.size() / sizeof(tFlightRecorderIndexEntry));
+      if(index.size() > 0 && idxFile.read((char*)index.data(), index.size() * sizeof(index[0])) == (qint64)(index.size() * sizeof(index[0])))
+      {
+         uint64_t seekOffset = 0;
+         for(size_t i = 0; i < index.size() && index[i].timeUs <= m_startTimeUs; ++i)
+         {
+            seekOffset = index[i].fileOffset;
+         }
+         if(seekOffset > 0)
+         {
+            m_recFile.seek(seekOffset);
+         }
+      }
+   }
+   return true;
+}
+
+bool FlightRecorderReader::readNext(tIncomingMsg* inMsg, int64_t* timeUs)
+{
+   while(m_fileIndex < m_recFilePaths.size())
+   {
+      tFlightRecorderMsgHeader header;
+      if(m_recFile.isOpen() && m_recFile.read((char*)&header, sizeof(header)) == (qint64)sizeof(header))
+      {
+         if(header.timeUs > m_endTimeUs)
+         {
+            m_fileIndex = m_recFilePaths.size(); // Past the end of the time span, done.
+            break;
+         }
+         else if(header.timeUs < m_startTimeUs)
+         {
+            m_recFile.seek(m_recFile.pos() + header.msgSize);
+            continue;
+         }
+
+         std::shared_ptr<std::vector<char> > msgBuff = std::make_shared<std::vector<char> >(header.msgSize);
+         if(m_recFile.read(msgBuff->data(), header.msgSize) == (qint64)header.msgSize)
+         {
+            inMsg->msgBuff = msgBuff;
+            inMsg->msgPtr = msgBuff->data();
+            inMsg->msgSize = header.msgSize;
+            inMsg->ipAddr = tPlotterIpAddr((tPlotterIpAddr::tIpV4)header.ipAddr);
+            *timeUs = header.timeUs;
+            return true;
+         }
+      }
+
+      // End of this file (or a record cut short by the plotter exiting while writing), go to the next file.
+      if(++m_fileIndex < m_recFilePaths.size())
+      {
+         openFile(m_fileIndex);
+      }
+   }
+
+   m_recFile.close();
+   return false;
+}
@@ -0,0 +1,141 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef flightRecorder_h
+#define flightRecorder_h
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QFile>
+#include "PlotHelperTypes.h"
+
+// Flight recorder file layout. Each .plotrec file starts with a tFlightRecorderFileHeader
+// followed by records, each record is a tFlightRecorderMsgHeader followed by the raw
+// (reassembled) plot message. Each .plotrec file has a matching .plotidx file that is
+// a list of tFlightRecorderIndexEntry, one entry per block of records written to the
+// .plotrec file, so a time span can be found without reading all the records.
+#define FLIGHT_RECORDER_VERSION (1)
+#define FLIGHT_RECORDER_REC_EXT "plotrec"
+#define FLIGHT_RECORDER_IDX_EXT "plotidx"
+
+typedef struct
+{
+   char magic[8];
+   uint32_t version;
+   uint32_t reserved;
+}tFlightRecorderFileHeader;
+
+typedef struct
+{
+   int64_t timeUs; // Microseconds since epoch, when the message was received.
+   uint32_t ipAddr; // IPv4 address of the message source.
+   uint32_t msgSize;
+}tFlightRecorderMsgHeader;
+
+typedef struct
+{
+   int64_t timeUs; // Time of the first record in the block.
+   uint64_t fileOffset; // Offset of the first record in the block.
+}tFlightRecorderIndexEntry;
+
+int64_t flightRecorderTimeUs(); // Current time in the units used by the flight recorder files.
+
+
+// Appends every incoming plot message to size capped rolling files. record() only queues a
+// reference to the message buffer, all the file I/O is done in large writes on its own thread.
+class FlightRecorder : public QThread
+{
+public:
+   FlightRecorder(std::string dirPath, uint64_t maxFileSize, unsigned int maxNumFiles);
+   ~FlightRecorder();
+
+   // Called from the socket threads. Never blocks on file I/O, if the I/O thread falls too
+   // far behind the message is dropped from the recording (it is still plotted).
+   void record(const tIncomingMsg* inMsg);
+
+   uint64_t getNumDroppedMsgs();
+
+private:
+   FlightRecorder();
+   FlightRecorder(FlightRecorder const&);
+   void operator=(FlightRecorder const&);
+
+   typedef struct
+   {
+      tFlightRecorderMsgHeader header;
+      tPlotMsgBuffPtr msgBuff;
+      const char* msgPtr;
+   }tQueuedMsg;
+
+   void run();
+   void writeMsgs(std::vector<tQueuedMsg>& msgs);
+   bool writeBlock();
+   bool openNextFile(int64_t timeUs);
+   void closeFile();
+   void removeOldFiles();
+
+   std::string m_dirPath;
+   uint64_t m_maxFileSize;
+   unsigned int m_maxNumFiles;
+
+   // Protected by m_queueMutex.
+   QMutex m_queueMutex;
+   QWaitCondition m_queueCond;
+   std::vector<tQueuedMsg> m_queuedMsgs;
+   uint64_t m_queuedBytes;
+   uint64_t m_numDroppedMsgs;
+   bool m_stop;
+
+   // Only accessed from the I/O thread.
+   QFile m_recFile;
+   QFile m_idxFile;
+   uint64_t m_recFileSize;
+   std::vector<char> m_block;
+   int64_t m_blockStartTimeUs;
+};
+
+
+// Reads back the messages recorded by FlightRecorder in a time span. The messages
+// are returned as tIncomingMsg so they can be fed to plotGuiMain::startPlotMsgProcess.
+class FlightRecorderReader
+{
+public:
+   FlightRecorderReader(std::string dirPath, int64_t startTimeUs = INT64_MIN, int64_t endTimeUs = INT64_MAX);
+
+   // Returns false when there are no more messages in the time span.
+   bool readNext(tIncomingMsg* inMsg, int64_t* timeUs);
+
+private:
+   FlightRecorderReader();
+   FlightRecorderReader(FlightRecorderReader const&);
+   void operator=(FlightRecorderReader const&);
+
+   bool openFile(size_t fileIndex);
+
+   std::vector<std::string> m_recFilePaths;
+   size_t m_fileIndex;
+   QFile m_recFile;
+   int64_t m_startTimeUs;
+   int64_t m_endTimeUs;
+};
+
+#endif
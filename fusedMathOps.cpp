@@ -0,0 +1,368 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#include <math.h>
+#include <algorithm>
+#include "fusedMathOps.h"
+
+fusedMathOps::fusedMathOps():
+   m_affinePending(false),
+   m_affineHasAdd(false),
+   m_affineScale(1.0),
+   m_affineOffset(0.0)
+{
+}
+
+void fusedMathOps::compile(const tMathOpList& mathOps)
+{
+   m_program.clear();
+   m_affinePending = false;
+
+   for(tMathOpList::const_iterator mathIter = mathOps.begin(); mathIter != mathOps.end(); ++mathIter)
+   {
+      double num = mathIter->num;
+      switch(mathIter->op)
+      {
+         case E_ADD:
+            addAffine(1.0, num);
+            m_affineHasAdd = true;
+         break;
+         case E_MULTIPLY:
+            addAffine(num, 0.0);
+         break;
+         case E_DIVIDE:
+         {
+            // Only fold the divide into a multiply when the reciprocal is exact (i.e. power of 2),
+            // otherwise the result could be off by a bit from what dividing would give.
+            int exponent;
+            double mantissa = frexp(num, &exponent);
+            double reciprocal = 1.0 / num;
+            if((mantissa == 0.5 || mantissa == -0.5) && std::isfinite(reciprocal) && reciprocal != 0.0)
+               addAffine(reciprocal, 0.0);
+            else
+               addOp(E_FUSED_DIVIDE, num);
+         }
+         break;
+         case E_SHIFT_UP:
+         case E_SHIFT_DOWN:
+         {
+            int shift = mathIter->op == E_SHIFT_UP ? (int)num : -(int)num;
+            double scale = ldexp(1.0, shift);
+            if(std::isnormal(scale))
+               addAffine(scale, 0.0); // Multiplying by a power of 2 is exactly the same as ldexp.
+            else
+               addOp(E_FUSED_SHIFT, (double)shift);
+         }
+         break;
+         case E_POWER:
+            addOp(E_FUSED_POWER, num);
+         break;
+         case E_LOG:
+            addOp(E_FUSED_LOG, mathIter->helperNum);
+         break;
+         case E_ALOG:
+            addOp(E_FUSED_ALOG, num);
+         break;
+         case E_MOD:
+            addOp(E_FUSED_MOD, num);
+         break;
+         case E_ABS:
+            addOp(E_FUSED_ABS);
+         break;
+         case E_ROUND:
+            if(num == 0)
+               addOp(E_FUSED_ROUND);
+            else
+               addOp(E_FUSED_ROUND_DECIMAL, pow(10, num));
+         break;
+         case E_ROUND_UP:
+            if(num == 0)
+               addOp(E_FUSED_ROUND_UP);
+            else
+               addOp(E_FUSED_ROUND_UP_DECIMAL, pow(10, num));
+         break;
+         case E_ROUND_DOWN:
+            if(num == 0)
+               addOp(E_FUSED_ROUND_DOWN);
+            else
+               addOp(E_FUSED_ROUND_DOWN_DECIMAL, pow(10, num));
+         break;
+         case E_LIMIT_UPPER:
+            addOp(E_FUSED_LIMIT_UPPER, num);
+         break;
+         case E_LIMIT_LOWER:
+            addOp(E_FUSED_LIMIT_LOWER, num);
+         break;
+         case E_SIN:
+            addOp(E_FUSED_SIN);
+         break;
+         case E_COS:
+            addOp(E_FUSED_COS);
+         break;
+         case E_TAN:
+            addOp(E_FUSED_TAN);
+         break;
+         case E_ASIN:
+            addOp(E_FUSED_ASIN);
+         break;
+         case E_ACOS:
+            addOp(E_FUSED_ACOS);
+         break;
+         case E_ATAN:
+            addOp(E_FUSED_ATAN);
+         break;
+         case E_SIGN:
+            addOp(E_FUSED_SIGN);
+         break;
+         case E_FLOAT_SIGN_BIT:
+            addOp(E_FUSED_FLOAT_SIGN_BIT);
+         break;
+         case E_FLOAT_IS_NAN:
+            addOp(E_FUSED_FLOAT_IS_NAN);
+         break;
+         case E_FLOAT_IS_INF:
+            addOp(E_FUSED_FLOAT_IS_INF);
+         break;
+      }
+   }
+   flushAffine();
+}
+
+void fusedMathOps::apply(double* samples, unsigned int numSamples) const
+{
+   size_t programSize = m_program.size();
+   for(unsigned int blockStart = 0; blockStart < numSamples; blockStart += FUSED_MATH_OPS_BLOCK_SIZE)
+   {
+      unsigned int blockSize = std::min((unsigned int)FUSED_MATH_OPS_BLOCK_SIZE, numSamples - blockStart);
+      for(size_t i = 0; i < programSize; ++i)
+      {
+         applyOp(m_program[i], &samples[blockStart], blockSize);
+      }
+   }
+}
+
+void fusedMathOps::addAffine(double scale, double offset)
+{
+   if(m_affinePending)
+   {
+      // (x * s1 + o1) * s2 + o2 = x * (s1 * s2) + (o1 * s2 + o2)
+      m_affineScale *= scale;
+      m_affineOffset = m_affineOffset * scale + offset;
+   }
+   else
+   {
+      m_affinePending = true;
+      m_affineHasAdd = false;
+      m_affineScale = scale;
+      m_affineOffset = offset;
+   }
+}
+
+void fusedMathOps::addOp(eFusedOp op, double a)
+{
+   flushAffine();
+   tFusedOp newOp;
+   newOp.op = op;
+   newOp.a = a;
+   newOp.b = 0.0;
+   m_program.push_back(newOp);
+}
+
+bool fusedMathOps::getAffine(tLinear& affine) const
+{
+   affine.m = 1.0;
+   affine.b = 0.0;
+   for(std::vector<tFusedOp>::const_iterator iter = m_program.begin(); iter != m_program.end(); ++iter)
+   {
+      switch(iter->op)
+      {
+         case E_FUSED_SCALE:
+            affine.m *= iter->a;
+            affine.b *= iter->a;
+         break;
+         case E_FUSED_OFFSET:
+            affine.b += iter->b;
+         break;
+         case E_FUSED_SCALE_OFFSET:
+            affine.m = affine.m * iter->a;
+            affine.b = affine.b * iter->a + iter->b;
+         break;
+         case E_FUSED_DIVIDE:
+            affine.m /= iter->a;
+            affine.b /= iter->a;
+         break;
+         default:
+            return false;
+      }
+   }
+   return true;
+}
+
+void fusedMathOps::flushAffine()
+{
+   if(m_affinePending)
+   {
+      m_affinePending = false;
+
+      tFusedOp newOp;
+      newOp.a = m_affineScale;
+      newOp.b = m_affineOffset;
+      // Adding 0 still turns -0 into +0, so only drop the offset when there wasn't an add.
+      if(m_affineOffset == 0.0 && !m_affineHasAdd)
+      {
+         if(m_affineScale == 1.0)
+            return; // Nothing to do.
+         newOp.op = E_FUSED_SCALE;
+      }
+      else if(m_affineScale == 1.0)
+      {
+         newOp.op = E_FUSED_OFFSET;
+      }
+      else
+      {
+         newOp.op = E_FUSED_SCALE_OFFSET;
+      }
+      m_program.push_back(newOp);
+   }
+}
+
+void fusedMathOps::applyOp(const tFusedOp& fusedOp, double* samples, unsigned int numSamples)
+{
+   // Copy to locals so the compiler knows writing to the samples can't change them.
+   const double a = fusedOp.a;
+   const double b = fusedOp.b;
+
+   switch(fusedOp.op)
+   {
+      case E_FUSED_SCALE:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] *= a;
+      break;
+      case E_FUSED_OFFSET:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] += b;
+      break;
+      case E_FUSED_SCALE_OFFSET:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = samples[i] * a + b;
+      break;
+      case E_FUSED_DIVIDE:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] /= a;
+      break;
+      case E_FUSED_SHIFT:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = ldexp(samples[i], (int)a);
+      break;
+      case E_FUSED_POWER:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = pow(samples[i], a);
+      break;
+      case E_FUSED_LOG:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = log(samples[i]) / a;
+      break;
+      case E_FUSED_ALOG:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = pow(a, samples[i]);
+      break;
+      case E_FUSED_MOD:
+         for(unsigned int i = 0; i < numSamples; ++i)
+         {
+            double modVal = fmod(samples[i], a);
+            samples[i] = modVal < 0 ? modVal + a : modVal;
+         }
+      break;
+      case E_FUSED_ABS:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = fabs(samples[i]);
+      break;
+      case E_FUSED_ROUND:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = round(samples[i]);
+      break;
+      case E_FUSED_ROUND_UP:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = ceil(samples[i]);
+      break;
+      case E_FUSED_ROUND_DOWN:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = floor(samples[i]);
+      break;
+      case E_FUSED_ROUND_DECIMAL:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = round(samples[i] * a) / a;
+      break;
+      case E_FUSED_ROUND_UP_DECIMAL:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = ceil(samples[i] * a) / a;
+      break;
+      case E_FUSED_ROUND_DOWN_DECIMAL:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = floor(samples[i] * a) / a;
+      break;
+      case E_FUSED_LIMIT_UPPER:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = samples[i] > a ? a : samples[i];
+      break;
+      case E_FUSED_LIMIT_LOWER:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = samples[i] < a ? a : samples[i];
+      break;
+      case E_FUSED_SIN:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = sin(samples[i]);
+      break;
+      case E_FUSED_COS:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = cos(samples[i]);
+      break;
+      case E_FUSED_TAN:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = tan(samples[i]);
+      break;
+      case E_FUSED_ASIN:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = asin(samples[i]);
+      break;
+      case E_FUSED_ACOS:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = acos(samples[i]);
+      break;
+      case E_FUSED_ATAN:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = atan(samples[i]);
+      break;
+      case E_FUSED_SIGN:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = (double)((0.0 < samples[i]) - (samples[i] < 0.0)); // always return +1, 0, or -1
+      break;
+      case E_FUSED_FLOAT_SIGN_BIT:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = std::signbit(samples[i]);
+      break;
+      case E_FUSED_FLOAT_IS_NAN:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = std::isnan(samples[i]);
+      break;
+      case E_FUSED_FLOAT_IS_INF:
+         for(unsigned int i = 0; i < numSamples; ++i)
+            samples[i] = std::isinf(samples[i]);
+      break;
+   }
+}
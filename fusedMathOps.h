@@ -0,0 +1,101 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef FUSEDMATHOPS_H
+#define FUSEDMATHOPS_H
+
+#include <vector>
+#include "PlotHelperTypes.h"
+
+// Number of samples that all of the ops are applied to before moving on to the next samples.
+// Small enough that the block stays in L1 cache between ops.
+#define FUSED_MATH_OPS_BLOCK_SIZE (1024)
+
+// A tMathOpList compiled into a flat list of ops that are applied a block of samples at a time.
+// Each op is a tight loop over the block (no per sample list walk or switch), so the simple ops
+// vectorize. Runs of add / multiply / shift are folded into a single scale + offset op and any
+// per op constants (i.e. 10^n for rounding to n decimal places) are computed once up front.
+class fusedMathOps
+{
+public:
+   fusedMathOps();
+
+   void compile(const tMathOpList& mathOps);
+   bool empty() const {return m_program.size() == 0;}
+
+   void apply(double* samples, unsigned int numSamples) const;
+
+   // If all the ops are linear, returns true and sets the equivalent samples[i] * m + b.
+   bool getAffine(tLinear& affine) const;
+
+private:
+   typedef enum
+   {
+      E_FUSED_SCALE,
+      E_FUSED_OFFSET,
+      E_FUSED_SCALE_OFFSET,
+      E_FUSED_DIVIDE,
+      E_FUSED_SHIFT,
+      E_FUSED_POWER,
+      E_FUSED_LOG,
+      E_FUSED_ALOG,
+      E_FUSED_MOD,
+      E_FUSED_ABS,
+      E_FUSED_ROUND,
+      E_FUSED_ROUND_UP,
+      E_FUSED_ROUND_DOWN,
+      E_FUSED_ROUND_DECIMAL,
+      E_FUSED_ROUND_UP_DECIMAL,
+      E_FUSED_ROUND_DOWN_DECIMAL,
+      E_FUSED_LIMIT_UPPER,
+      E_FUSED_LIMIT_LOWER,
+      E_FUSED_SIN,
+      E_FUSED_COS,
+      E_FUSED_TAN,
+      E_FUSED_ASIN,
+      E_FUSED_ACOS,
+      E_FUSED_ATAN,
+      E_FUSED_SIGN,
+      E_FUSED_FLOAT_SIGN_BIT,
+      E_FUSED_FLOAT_IS_NAN,
+      E_FUSED_FLOAT_IS_INF
+   }eFusedOp;
+
+   typedef struct
+   {
+      eFusedOp op;
+      double a;
+      double b;
+   }tFusedOp;
+
+   void addAffine(double scale, double offset);
+   void addOp(eFusedOp op, double a = 0.0);
+   void flushAffine();
+
+   static void applyOp(const tFusedOp& fusedOp, double* samples, unsigned int numSamples);
+
+   std::vector<tFusedOp> m_program;
+
+   // Scale / offset that is still being built up from a run of linear ops (only valid when m_affinePending is true).
+   bool m_affinePending;
+   bool m_affineHasAdd;
+   double m_affineScale;
+   double m_affineOffset;
+};
+
+#endif
@@ -1,4 +1,4 @@
-/* Copyright 2016, 2020, 2024 Dan Williams. All Rights Reserved.
+/* Copyright 2016, 2020, 2024, 2026 Dan Williams. All Rights Reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of this
  * software and associated documentation files (the "Software"), to deal in the Software
@@ -17,6 +17,7 @@
  * DEALINGS IN THE SOFTWARE.
  */
 #include <QMessageBox>
+#include <QProgressDialog>
 #include "localPlotCreate.h"
 #include "FileSystemOperations.h"
 #include "dString.h"
@@ -26,6 +27,10 @@
 #include "openrawdialog.h"
 
 
+static void restoreCsvProgress(void* progressDialog, int percentDone)
+{
+   ((QProgressDialog*)progressDialog)->setValue(percentDone);
+}
 
 bool localPlotCreate::validateNewPlotCurveName(CurveCommander* p_curveCmdr, QString& plotName, QString& curveName)
 {
@@ -99,8 +104,13 @@ bool localPlotCreate::validateNewPlotCurveName(CurveCommander* p_curveCmdr, QStr
 
 void localPlotCreate::restorePlotFromFile(CurveCommander* p_curveCmdr, QString fileName, QString plotName, bool rawFile)
 {
+   QString ext(fso::GetExt(dString::Lower(fileName.toStdString())).c_str());
+   bool plotFileV2 = ext == "plot" && RestorePlotV2::isPlotFileV2(fileName);
+
+   // Version 2 plot files are memory mapped instead of read in.
    std::vector<char> curveFile;
-   fso::ReadBinaryFile(fileName.toStdString(), curveFile);
+   if(plotFileV2 == false)
+      fso::ReadBinaryFile(fileName.toStdString(), curveFile);
 
    // Get plot name.
    if(plotName == "")
@@ -113,8 +123,16 @@ void localPlotCreate::restorePlotFromFile(CurveCommander* p_curveCmdr, QString f
    }
 
    bool inputIsValid = fileName == "" ? true : false; // NULL string return is cancel, which is valid.
-   QString ext(fso::GetExt(dString::Lower(fileName.toStdString())).c_str());
-   if(ext == "curve")
+   if(plotFileV2)
+   {
+      RestorePlotV2 restorePlot(fileName);
+      inputIsValid = restorePlot.isValid && restorePlot.loadAllCurves();
+      if(inputIsValid)
+      {
+         restoreMultipleCurves(p_curveCmdr, restorePlot.plotName, restorePlot.params);
+      }
+   }
+   else if(ext == "curve")
    {
       RestoreCurve t_restoreCurve(curveFile);
       inputIsValid = t_restoreCurve.isValid;
@@ -138,10 +156,15 @@ void localPlotCreate::restorePlotFromFile(CurveCommander* p_curveCmdr, QString f
    }
    else if(ext == "csv")
    {
-      RestoreCsv restoreCsv(curveFile);
+      // The dialog only shows up if the parse takes a while (i.e. large CSV files).
+      QProgressDialog progress("Reading " + fileName, QString(), 0, 100);
+      progress.setWindowModality(Qt::ApplicationModal);
+
+      RestoreCsv restoreCsv(curveFile, restoreCsvProgress, &progress);
       inputIsValid = restoreCsv.isValid;
       if(restoreCsv.isValid)
       {
+         std::vector<char>().swap(curveFile); // Done with the file contents, free them before the curves are created.
          restoreMultipleCurves(p_curveCmdr, plotName, restoreCsv.params);
       }
    }
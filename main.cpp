@@ -1,4 +1,4 @@
-/* Copyright 2013 - 2019, 2021, 2023, 2025 Dan Williams. All Rights Reserved.
+/* Copyright 2013 - 2019, 2021, 2023, 2025 - 2026 Dan Williams. All Rights Reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of this
  * software and associated documentation files (the "Software"), to deal in the Software
@@ -22,6 +22,7 @@
 #include <assert.h>
 #include <vector>
 #include "plotguimain.h"
+#include "plotMsgReplay.h"
 #include "dString.h"
 #include "FileSystemOperations.h"
 #include "PackUnpackPlotMsg.h"
@@ -40,11 +41,15 @@
 static bool g_portsSpecifiedViaCmdLine = false;
 static std::vector<unsigned short> g_ports;
 static std::vector<std::string> g_cmdLineRestorePlotFilePaths;
+static bool g_replayActive = false;
+static tPlotMsgReplayParams g_replayParams;
 
 // Global Variables (might be extern'd)
 bool defaultCursorZoomModeIsZoom = false;
 bool default2dPlotStyleIsLines = false; // true = Lines, false = Dots
 bool inSpectrumAnalyzerMode = false;
+unsigned int g_maxReplotRateHz = 60; // 0 = replot for every new plot message
+size_t g_memoryBudget = 0; // 0 = no limit
 tSpecAnModeParam spectrumAnalyzerParams;
 
 // Local Functions
@@ -82,12 +87,67 @@ static void processCmdLineArgs(int argc, char *argv[])
       }
    }
 
+   // Replay / ingest benchmark options.
+   //    --replay <flight recorder dir|synthetic>
+   //    --replay-speed <N|max>           (default 1, i.e. the recorded rate)
+   //    --replay-target <direct|tcp>     (default direct)
+   //    --replay-msgs <N> --replay-samples <N> --replay-rate <msgs per sec>   (synthetic source only)
+   //    --replay-exit                    (exit the plotter once the replay report is printed)
+   plotMsgReplay_setDefaultParams(&g_replayParams);
+   std::vector<bool> argIsReplayOption(argc, false);
+   for(int argIndex = 1; argIndex < argc; ++argIndex)
+   {
+      std::string arg(argv[argIndex]);
+      std::string value = argIndex + 1 < argc ? argv[argIndex + 1] : "";
+      bool hasValue = true;
+      if(arg == "--replay")
+      {
+         g_replayActive = true;
+         g_replayParams.source = value;
+      }
+      else if(arg == "--replay-speed")
+      {
+         g_replayParams.speed = dString::Lower(value) == "max" ? 0.0 : atof(value.c_str());
+      }
+      else if(arg == "--replay-target")
+      {
+         g_replayParams.target = dString::Lower(value) == "tcp" ? E_REPLAY_TARGET_TCP : E_REPLAY_TARGET_DIRECT;
+      }
+      else if(arg == "--replay-msgs")
+      {
+         g_replayParams.synthNumMsgs = atoi(value.c_str());
+      }
+      else if(arg == "--replay-samples")
+      {
+         g_replayParams.synthSamplesPerMsg = atoi(value.c_str());
+      }
+      else if(arg == "--replay-rate")
+      {
+         g_replayParams.synthMsgsPerSec = atoi(value.c_str());
+      }
+      else if(arg == "--replay-exit")
+      {
+         g_replayParams.exitWhenDone = true;
+         hasValue = false;
+      }
+      else
+      {
+         continue;
+      }
+
+      argIsReplayOption[argIndex] = true;
+      if(hasValue && argIndex + 1 < argc)
+      {
+         argIsReplayOption[++argIndex] = true;
+      }
+   }
+
    // If any of the command line arguments are valid file paths, assume they are stored plot files
    // and restore them from the files.
    for(int argIndex = 1; argIndex < argc; ++argIndex)
    {
       std::string plotFilePath(argv[argIndex]);
-      if(fso::FileExists(plotFilePath))
+      if(!argIsReplayOption[argIndex] && fso::FileExists(plotFilePath))
       {
          g_cmdLineRestorePlotFilePaths.push_back(plotFilePath);
       }
@@ -201,7 +261,8 @@ static void setSpectrumAnalyzerModeFromIni(std::string iniFile)
    }
 }
 
-static bool getByteSizeFromIni(const std::string& iniFile, const std::string& key, unsigned int& retNum)
+template<typename tNum>
+static bool getByteSizeFromIni(const std::string& iniFile, const std::string& key, tNum& retNum)
 {
    bool found = false;
    std::string keySearchStr = std::string("\n") + key + "="; 
@@ -210,7 +271,7 @@ static bool getByteSizeFromIni(const std::string& iniFile, const std::string& ke
    std::string sizeNumStr = dString::SplitNumFromStr(strBegin);
    if(sizeNumStr.size() > 0)
    {
-      retNum = atoi(sizeNumStr.c_str());
+      retNum = (tNum)strtoull(sizeNumStr.c_str(), NULL, 10);
       std::string nextChar = strBegin.substr(0, 1);
 
       // Determine scale
@@ -218,6 +279,8 @@ static bool getByteSizeFromIni(const std::string& iniFile, const std::string& ke
          retNum *= 1024;
       else if(dString::Lower(nextChar) == "m")
          retNum *= (1024*1024);
+      else if(dString::Lower(nextChar) == "g")
+         retNum *= (1024*1024*1024);
       found = true;
    }
    return found;
@@ -290,12 +353,43 @@ static void processIniFile(int argc, char *argv[])
       getByteSizeFromIni(iniFile, "socket_max_packet_size", g_tcp_maxPacketSize);
       getByteSizeFromIni(iniFile, "socket_max_stored_packets", g_tcp_maxStoredPackets);
 
+      extern unsigned int g_udp_rcvBuffSize;
+      getByteSizeFromIni(iniFile, "udp_socket_rcv_buff_size", g_udp_rcvBuffSize);
+
+      // Optional flight recorder, records every incoming plot message to rolling files in this directory.
+      extern std::string g_flightRecorderDir;
+      extern uint64_t g_flightRecorderFileSize;
+      extern unsigned int g_flightRecorderNumFiles;
+      std::string iniFile_flightRecorder = iniFile; // GetMiddle modifies the string passed in.
+      g_flightRecorderDir = dString::GetMiddle(&iniFile_flightRecorder, "\nflight_recorder_dir=", "\n");
+      getByteSizeFromIni(iniFile, "flight_recorder_file_size", g_flightRecorderFileSize);
+      getByteSizeFromIni(iniFile, "flight_recorder_num_files", g_flightRecorderNumFiles);
+
+      // Determine whether the socket server uses threads per client or epoll event loops.
+      extern unsigned int g_tcp_numEventLoops;
+      std::string iniFile_serverMode = iniFile; // GetMiddle modifies the string passed in.
+      std::string serverMode = dString::GetMiddle(&iniFile_serverMode, "\nsocket_server_mode=", "\n");
+      if(serverMode == std::string("epoll"))
+      {
+         g_tcp_numEventLoops = 1;
+         getByteSizeFromIni(iniFile, "socket_event_loop_threads", g_tcp_numEventLoops);
+      }
+
       std::string defaultMode = dString::GetMiddle(&iniFile, "\ndefault_mode=", "\n");
       if(defaultMode == std::string("zoom"))
       {
          defaultCursorZoomModeIsZoom = true;
       }
 
+      std::string iniFile_maxReplotRate = iniFile; // GetMiddle modifies the string passed in.
+      std::string maxReplotRate = dString::GetMiddle(&iniFile_maxReplotRate, "\nmax_replot_rate=", "\n");
+      if(maxReplotRate.size() > 0)
+      {
+         g_maxReplotRateHz = atoi(maxReplotRate.c_str());
+      }
+
+      getByteSizeFromIni(iniFile, "memory_budget", g_memoryBudget);
+
       std::string useLinesStyleFor2d = dString::GetMiddle(&iniFile, "\nuse_lines_for_2d_plots=", "\n");
       if(useLinesStyleFor2d == std::string("true"))
       {
@@ -334,7 +428,18 @@ static int startGuiApp()
    pgm.show();
 #endif
 
-   return a.exec();
+   PlotMsgReplay* replay = NULL;
+   if(g_replayActive)
+   {
+      g_replayParams.tcpPort = g_ports[0];
+      replay = new PlotMsgReplay(&pgm, g_replayParams);
+      replay->start();
+   }
+
+   int retVal = a.exec();
+
+   delete replay; // Waits for the replay thread to finish.
+   return retVal;
 }
 
 static int stopGuiApp()
@@ -429,7 +534,9 @@ int main(int argc, char *argv[])
 
       restorePathsFromCmdLineInThisInstance(); // If cmd line has plot files to resore, create a thread to restore them once the main gui is created.
 
-      return startGuiApp();
+      int retVal = startGuiApp();
+      persistentParam_flush(); // Parameter changes are written in the background, make sure the last ones make it to disk.
+      return retVal;
    }
    else
    {
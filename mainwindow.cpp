@@ -25,6 +25,8 @@
 #include <QInputDialog>
 #include <QMessageBox>
 #include <QElapsedTimer>
+#include <QThreadPool>
+#include <QRunnable>
 #include <QtWidgets>
 #include <sstream>
 #include <iostream>
@@ -87,6 +89,11 @@ MainWindow::MainWindow(CurveCommander* curveCmdr, plotGuiMain* plotGui, QString
    m_qwtDragZoomModePicker(NULL),
    m_qwtDragZoomModePicker2(NULL),
    m_qwtGrid(NULL),
+   m_ingestedPlotMsg(NULL),
+   m_ingestedPlotMsgSamplesApplied(false),
+   m_ingestedPlotMsgIngestNs(0),
+   m_plotMsgIngestBusy(false),
+   m_plotMsgIngestRunning(false),
    m_selectMode(E_CURSOR),
    m_selectedCurveIndex(0),
    m_userHasSpecifiedZoomType(false),
@@ -350,6 +357,10 @@ MainWindow::MainWindow(CurveCommander* curveCmdr, plotGuiMain* plotGui, QString
 
     m_activityIndicator_timer.start(ACTIVITY_INDICATOR_ON_PERIOD_MS);
 
+    m_replotTimer.setSingleShot(true);
+    connect(&m_replotTimer, SIGNAL(timeout()), this, SLOT(replotTimerSlot()));
+    m_timeSinceLastReplot.start();
+
     // Disable SNR Calc Action by default. It will be activated (i.e. made visable) if there is a curve
     // that is an FFT curve.
     m_toggleSnrCalcAction.setVisible(false);
@@ -381,6 +392,14 @@ MainWindow::~MainWindow()
         delete m_selectedCursorActions[i].mapper;
     }
 
+    // Wait for the worker thread to finish with the message it is ingesting before deleting the curves.
+    m_plotMsgQueueMutex.lock();
+    while(m_plotMsgIngestRunning)
+    {
+        m_plotMsgIngestDoneCond.wait(&m_plotMsgQueueMutex);
+    }
+    m_plotMsgQueueMutex.unlock();
+
     m_qwtCurvesMutex.lock();
     for(int i = 0; i < m_qwtCurves.size(); ++i)
     {
@@ -440,12 +459,21 @@ MainWindow::~MainWindow()
 
    // Make sure all plot messages that are still queued are deleted.
     m_plotMsgQueueMutex.lock();
+    if(m_ingestedPlotMsg != NULL)
+    {
+        m_curveCommander->plotMsgGroupRemovedWithoutBeingProcessed(m_ingestedPlotMsg);
+        delete m_ingestedPlotMsg;
+        m_ingestedPlotMsg = NULL;
+        deleteBackBuffers(m_ingestedBackBuffers);
+        m_plotGuiMain->plotMsgGroupDropped();
+    }
     while(m_plotMsgQueue.size() > 0)
     {
         plotMsgGroup* plotMsg = m_plotMsgQueue.front();
         m_plotMsgQueue.pop();
         m_curveCommander->plotMsgGroupRemovedWithoutBeingProcessed(plotMsg);
         delete plotMsg;
+        m_plotGuiMain->plotMsgGroupDropped();
     }
     m_plotMsgQueueMutex.unlock();
 
@@ -707,10 +735,11 @@ void MainWindow::readPlotMsg(plotMsgGroup* plotMsg)
    // If we are allowing new curve data, then push it onto the queue. Otherwise clear it out right now.
    if(m_allowNewCurves || plotMsg->m_changeCausedByUserGuiInput)
    {
+      m_plotGuiMain->plotMsgGroupQueued();
       m_plotMsgQueueMutex.lock();
       m_plotMsgQueue.push(plotMsg);
+      startPlotMsgIngest();
       m_plotMsgQueueMutex.unlock();
-      emit readPlotMsgSignal();
    }
    else
    {
@@ -731,98 +760,238 @@ void MainWindow::readPlotMsg(plotMsgGroup* plotMsg)
    resetActivityIndicator();
 }
 
-void MainWindow::readPlotMsgSlot()
+// Runs the plot message ingest for a single plot window on a thread pool thread.
+class plotMsgIngestRunner : public QRunnable
 {
-   while(m_plotMsgQueue.size() > 0)
+public:
+   plotMsgIngestRunner(MainWindow* plotGui): m_plotGui(plotGui){}
+   void run(){m_plotGui->runPlotMsgIngest();}
+private:
+   MainWindow* m_plotGui;
+};
+
+void MainWindow::startPlotMsgIngest()
+{
+   // Note: It is expected that m_plotMsgQueueMutex is locked before this function is called.
+   if(m_plotMsgIngestBusy == false && m_plotMsgQueue.size() > 0)
    {
-      plotMsgGroup* multiPlotMsg = NULL;
+      m_plotMsgIngestBusy = true;
+      m_plotMsgIngestRunning = true;
+      QThreadPool::globalInstance()->start(new plotMsgIngestRunner(this));
+   }
+}
 
-      m_plotMsgQueueMutex.lock();
-      if(m_plotMsgQueue.size() > 0)
+void MainWindow::runPlotMsgIngest()
+{
+   m_plotMsgQueueMutex.lock();
+   plotMsgGroup* multiPlotMsg = m_plotMsgQueue.front();
+   m_plotMsgQueue.pop();
+   m_plotMsgQueueMutex.unlock();
+
+   QElapsedTimer ingestTimer;
+   ingestTimer.start();
+   std::vector<tCurveBackBuffer> backBuffers;
+   bool samplesApplied = ingestPlotMsg(multiPlotMsg, backBuffers);
+   qint64 ingestNs = ingestTimer.nsecsElapsed();
+
+   // Hand the message to the GUI thread.
+   m_plotMsgQueueMutex.lock();
+   m_ingestedPlotMsg = multiPlotMsg;
+   m_ingestedBackBuffers.swap(backBuffers);
+   m_ingestedPlotMsgSamplesApplied = samplesApplied;
+   m_ingestedPlotMsgIngestNs = ingestNs;
+   emit readPlotMsgSignal();
+   m_plotMsgIngestRunning = false;
+   m_plotMsgIngestDoneCond.wakeAll();
+   m_plotMsgQueueMutex.unlock();
+}
+
+bool MainWindow::ingestPlotMsg(plotMsgGroup* plotMsg, std::vector<tCurveBackBuffer>& backBuffers)
+{
+   std::vector<CurveData*> subPlotMsgBackBuffers;
+   std::vector<bool> subPlotMsgResetsCurve;
+
+   m_qwtCurvesMutex.lock();
+
+   // Creating new curves and changing curve properties affect the GUI, those messages are
+   // handled entirely on the GUI thread.
+   for(UnpackPlotMsgPtrList::iterator iter = plotMsg->m_plotMsgs.begin(); iter != plotMsg->m_plotMsgs.end(); ++iter)
+   {
+      UnpackPlotMsg* subPlotMsg = (*iter);
+      if(subPlotMsg->m_useCurveMathProps || getCurveIndex(QString(subPlotMsg->m_curveName.c_str())) < 0)
       {
-         multiPlotMsg = m_plotMsgQueue.front();
-         m_plotMsgQueue.pop();
+         m_qwtCurvesMutex.unlock();
+         return false;
       }
-      m_plotMsgQueueMutex.unlock();
+   }
 
-      if(multiPlotMsg != NULL)
+   // Only copy the curves while locked, one back buffer per curve.
+   for(UnpackPlotMsgPtrList::iterator iter = plotMsg->m_plotMsgs.begin(); iter != plotMsg->m_plotMsgs.end(); ++iter)
+   {
+      UnpackPlotMsg* subPlotMsg = (*iter);
+      QString curveName(subPlotMsg->m_curveName.c_str());
+      CurveData* frontCurve = m_qwtCurves[getCurveIndex(curveName)];
+      CurveData* backBuffer = NULL;
+      for(size_t i = 0; i < backBuffers.size(); ++i)
       {
-         bool newCurveAdded = false;
-         bool firstCurve = m_qwtCurves.size() == 0;
-         for(UnpackPlotMsgPtrList::iterator iter = multiPlotMsg->m_plotMsgs.begin(); iter != multiPlotMsg->m_plotMsgs.end(); ++iter)
+         if(backBuffers[i].frontCurve == frontCurve)
          {
-            UnpackPlotMsg* plotMsg = (*iter);
-            QString curveName( plotMsg->m_curveName.c_str() );
+            backBuffer = backBuffers[i].backBuffer;
+            break;
+         }
+      }
+      if(backBuffer == NULL)
+      {
+         tCurveBackBuffer newBackBuffer;
+         newBackBuffer.curveName = curveName;
+         newBackBuffer.frontCurve = frontCurve;
+         newBackBuffer.backBuffer = backBuffer = frontCurve->createBackBuffer();
+         backBuffers.push_back(newBackBuffer);
+      }
+      subPlotMsgBackBuffers.push_back(backBuffer);
+      subPlotMsgResetsCurve.push_back(plotMsgResetsCurve(subPlotMsg));
+   }
 
-            if(getCurveIndex(curveName) < 0)
-            {
-               newCurveAdded = true;
-            }
+   m_qwtCurvesMutex.unlock();
+
+   // Apply the new samples to the back buffers (in message order), the GUI thread will swap them in.
+   size_t subPlotMsgIndex = 0;
+   for(UnpackPlotMsgPtrList::iterator iter = plotMsg->m_plotMsgs.begin(); iter != plotMsg->m_plotMsgs.end(); ++iter)
+   {
+      applyCurveSamples(subPlotMsgBackBuffers[subPlotMsgIndex], (*iter), subPlotMsgResetsCurve[subPlotMsgIndex]);
+      ++subPlotMsgIndex;
+   }
+   return true;
+}
 
-            createUpdateCurve(plotMsg);
+void MainWindow::deleteBackBuffers(std::vector<tCurveBackBuffer>& backBuffers)
+{
+   for(size_t i = 0; i < backBuffers.size(); ++i)
+   {
+      delete backBuffers[i].backBuffer;
+   }
+   backBuffers.clear();
+}
 
-            if(plotMsg->m_useCurveMathProps)
-            {
-               setCurveProperties(
-                  curveName, E_X_AXIS, plotMsg->m_curveMathProps.sampleRate, plotMsg->m_curveMathProps.mathOpsXAxis);
-               setCurveProperties(
-                  curveName, E_Y_AXIS, plotMsg->m_curveMathProps.sampleRate, plotMsg->m_curveMathProps.mathOpsYAxis);
-            }
+void MainWindow::readPlotMsgSlot()
+{
+   plotMsgGroup* multiPlotMsg = NULL;
+   std::vector<tCurveBackBuffer> backBuffers;
+   bool samplesAlreadyApplied = false;
+   qint64 ingestNs = 0;
+
+   m_plotMsgQueueMutex.lock();
+   multiPlotMsg = m_ingestedPlotMsg;
+   backBuffers.swap(m_ingestedBackBuffers);
+   samplesAlreadyApplied = m_ingestedPlotMsgSamplesApplied;
+   ingestNs = m_ingestedPlotMsgIngestNs;
+   m_ingestedPlotMsg = NULL;
+   m_plotMsgQueueMutex.unlock();
+
+   // Swap in the back buffers the new samples were applied to. If a curve was changed or removed since its
+   // back buffer was copied, the new samples for that curve are applied below instead.
+   QStringList curvesNotSwappedIn;
+   if(backBuffers.size() > 0)
+   {
+      m_qwtCurvesMutex.lock();
+      for(size_t i = 0; i < backBuffers.size(); ++i)
+      {
+         CurveData* frontCurve = backBuffers[i].frontCurve;
+         if(!m_qwtCurves.contains(frontCurve) || !frontCurve->swapInBackBuffer(backBuffers[i].backBuffer))
+         {
+            curvesNotSwappedIn.push_back(backBuffers[i].curveName);
          }
-         updatePlotWithNewCurveData(!newCurveAdded);
+      }
+      m_qwtCurvesMutex.unlock();
+      deleteBackBuffers(backBuffers);
+   }
+
+   if(multiPlotMsg != NULL)
+   {
+      QElapsedTimer applyTimer;
+      applyTimer.start();
 
-         // Inform parent that a curve has been added / changed
-         for(UnpackPlotMsgPtrList::iterator iter = multiPlotMsg->m_plotMsgs.begin(); iter != multiPlotMsg->m_plotMsgs.end(); ++iter)
+      bool newCurveAdded = false;
+      bool firstCurve = m_qwtCurves.size() == 0;
+      for(UnpackPlotMsgPtrList::iterator iter = multiPlotMsg->m_plotMsgs.begin(); iter != multiPlotMsg->m_plotMsgs.end(); ++iter)
+      {
+         UnpackPlotMsg* plotMsg = (*iter);
+         QString curveName( plotMsg->m_curveName.c_str() );
+
+         if(getCurveIndex(curveName) < 0)
          {
-            UnpackPlotMsg* plotMsg = (*iter);
-            QString curveName( plotMsg->m_curveName.c_str() );
-            int curveIndex = getCurveIndex(curveName);
-            m_curveCommander->curveUpdated(multiPlotMsg, plotMsg, m_qwtCurves[curveIndex], true);
-
-            // Make sure the SNR Calc bars are updated. If a new curve is plotted that is a
-            // valid SNR curve, make sure the SNR Calc action is made visable.
-            bool validSnrCurve = m_snrCalcBars->curveUpdated(m_qwtCurves[curveIndex], m_qwtCurves);
-            if(validSnrCurve && m_toggleSnrCalcAction.isVisible() == false)
-            {
-               m_toggleSnrCalcAction.setVisible(true);
+            newCurveAdded = true;
+         }
 
-               // Don't allow Specturm Analyzer Functions for Complex FFTs (they can have negative values, which don't make sense in that case)
-               if(m_qwtCurves[curveIndex]->getPlotType() != E_PLOT_TYPE_COMPLEX_FFT)
-               {
-                  m_toggleSpecAnAction.setVisible(true);
-               }
-            }
+         createUpdateCurve(plotMsg, samplesAlreadyApplied && !curvesNotSwappedIn.contains(curveName));
 
-            // If this is a new FFT plot / curve, initialize to Max Hold Zoom mode. This is because
-            // the max / min of the Y axis can jitter around in FFT plots (especially the min of
-            // the Y axis).
-            if(validSnrCurve && newCurveAdded && firstCurve && !m_userHasSpecifiedZoomType && !m_plotZoom->m_maxHoldZoom)
-            {
-               maxHoldZoom();
-            }
+         if(plotMsg->m_useCurveMathProps)
+         {
+            setCurveProperties(
+               curveName, E_X_AXIS, plotMsg->m_curveMathProps.sampleRate, plotMsg->m_curveMathProps.mathOpsXAxis);
+            setCurveProperties(
+               curveName, E_Y_AXIS, plotMsg->m_curveMathProps.sampleRate, plotMsg->m_curveMathProps.mathOpsYAxis);
          }
+      }
+      scheduleUpdatePlotWithNewCurveData(!newCurveAdded);
 
-         // Done with new plot messages.
-         delete multiPlotMsg;
+      // Inform parent that a curve has been added / changed
+      for(UnpackPlotMsgPtrList::iterator iter = multiPlotMsg->m_plotMsgs.begin(); iter != multiPlotMsg->m_plotMsgs.end(); ++iter)
+      {
+         UnpackPlotMsg* plotMsg = (*iter);
+         QString curveName( plotMsg->m_curveName.c_str() );
+         int curveIndex = getCurveIndex(curveName);
+         m_curveCommander->curveUpdated(multiPlotMsg, plotMsg, m_qwtCurves[curveIndex], true);
 
-         if(newCurveAdded)
+         // Make sure the SNR Calc bars are updated. If a new curve is plotted that is a
+         // valid SNR curve, make sure the SNR Calc action is made visable.
+         bool validSnrCurve = m_snrCalcBars->curveUpdated(m_qwtCurves[curveIndex], m_qwtCurves);
+         if(validSnrCurve && m_toggleSnrCalcAction.isVisible() == false)
          {
-            QMutexLocker lock(&m_qwtCurvesMutex);
-            if(m_snrCalcBars->isVisable())
+            m_toggleSnrCalcAction.setVisible(true);
+
+            // Don't allow Specturm Analyzer Functions for Complex FFTs (they can have negative values, which don't make sense in that case)
+            if(m_qwtCurves[curveIndex]->getPlotType() != E_PLOT_TYPE_COMPLEX_FFT)
             {
-               // If the SNR Calc Bars are visable, make sure they are displayed in front of any new curves.
-               m_snrCalcBars->moveToFront();
+               m_toggleSpecAnAction.setVisible(true);
             }
+         }
+
+         // If this is a new FFT plot / curve, initialize to Max Hold Zoom mode. This is because
+         // the max / min of the Y axis can jitter around in FFT plots (especially the min of
+         // the Y axis).
+         if(validSnrCurve && newCurveAdded && firstCurve && !m_userHasSpecifiedZoomType && !m_plotZoom->m_maxHoldZoom)
+         {
+            maxHoldZoom();
+         }
+      }
+
+      // Done with new plot messages.
+      delete multiPlotMsg;
 
-            // The GUI parameters (e.g. canvas size) do not get fully initialized right away when the curve is
-            // first created. Update the points sent to the GUI to ensure the correct GUI parameters are taken
-            // in to account.
-            updateAllCurveGuiPointsReplot();
+      if(newCurveAdded)
+      {
+         QMutexLocker lock(&m_qwtCurvesMutex);
+         if(m_snrCalcBars->isVisable())
+         {
+            // If the SNR Calc Bars are visable, make sure they are displayed in front of any new curves.
+            m_snrCalcBars->moveToFront();
          }
 
+         // The GUI parameters (e.g. canvas size) do not get fully initialized right away when the curve is
+         // first created. Update the points sent to the GUI to ensure the correct GUI parameters are taken
+         // in to account.
+         updateAllCurveGuiPointsReplot();
       }
-   }
 
+      // Done with the ingested message, start ingesting the next one.
+      m_plotMsgQueueMutex.lock();
+      m_plotMsgIngestBusy = false;
+      startPlotMsgIngest();
+      m_plotMsgQueueMutex.unlock();
+
+      m_plotGuiMain->plotMsgGroupDone(ingestNs, applyTimer.nsecsElapsed());
+   }
 }
 
 void MainWindow::setCurveSampleRate(QString curveName, double sampleRate, bool userSpecified)
@@ -993,13 +1162,8 @@ void MainWindow::setCurveVisibleHidden(QString curveName, bool visible, bool hid
     }
 }
 
-void MainWindow::createUpdateCurve(UnpackPlotMsg* unpackPlotMsg)
+bool MainWindow::plotMsgResetsCurve(UnpackPlotMsg* unpackPlotMsg)
 {
-   QMutexLocker lock(&m_qwtCurvesMutex);
-
-   QString name = unpackPlotMsg->m_curveName.c_str();
-   ePlotDim plotDim = plotActionToPlotDim(unpackPlotMsg->m_plotAction);
-
    bool resetCurve = false;
    switch(unpackPlotMsg->m_plotAction)
    {
@@ -1012,6 +1176,48 @@ void MainWindow::createUpdateCurve(UnpackPlotMsg* unpackPlotMsg)
          // Keep variables at their initialized values.
       break;
    }
+   return resetCurve;
+}
+
+void MainWindow::updateCurveSamples(int curveIndex, UnpackPlotMsg* unpackPlotMsg, bool resetCurve)
+{
+   QMutexLocker lock(&m_qwtCurvesMutex);
+
+   // The new samples will be sent to the GUI on the next replot.
+   m_qwtCurves[curveIndex]->setGuiPointsDeferred(true);
+   applyCurveSamples(m_qwtCurves[curveIndex], unpackPlotMsg, resetCurve);
+   m_qwtCurves[curveIndex]->setGuiPointsDeferred(false);
+}
+
+void MainWindow::applyCurveSamples(CurveData* curve, UnpackPlotMsg* unpackPlotMsg, bool resetCurve)
+{
+   ePlotDim plotDim = plotActionToPlotDim(unpackPlotMsg->m_plotAction);
+
+   // Check for any reason to not allow the new samples.
+   if( plotDim == E_PLOT_DIM_INVALID || unpackPlotMsg->m_yAxisValues.size() <= 0 ||
+       (plotDim != E_PLOT_DIM_1D && unpackPlotMsg->m_xAxisValues.size() <= 0) )
+   {
+      return;
+   }
+
+   if(resetCurve == true)
+   {
+      curve->ResetCurveSamples(unpackPlotMsg);
+   }
+   else
+   {
+      curve->UpdateCurveSamples(unpackPlotMsg);
+   }
+}
+
+void MainWindow::createUpdateCurve(UnpackPlotMsg* unpackPlotMsg, bool samplesAlreadyApplied)
+{
+   QMutexLocker lock(&m_qwtCurvesMutex);
+
+   QString name = unpackPlotMsg->m_curveName.c_str();
+   ePlotDim plotDim = plotActionToPlotDim(unpackPlotMsg->m_plotAction);
+
+   bool resetCurve = plotMsgResetsCurve(unpackPlotMsg);
 
    // Check for any reason to not allow the adding of the new curve.
    if( plotDim == E_PLOT_DIM_INVALID || unpackPlotMsg->m_yAxisValues.size() <= 0 ||
@@ -1024,13 +1230,9 @@ void MainWindow::createUpdateCurve(UnpackPlotMsg* unpackPlotMsg)
    if(curveIndex >= 0)
    {
       // Curve Exists.
-      if(resetCurve == true)
-      {
-         m_qwtCurves[curveIndex]->ResetCurveSamples(unpackPlotMsg);
-      }
-      else
+      if(samplesAlreadyApplied == false)
       {
-         m_qwtCurves[curveIndex]->UpdateCurveSamples(unpackPlotMsg);
+         updateCurveSamples(curveIndex, unpackPlotMsg, resetCurve);
       }
    }
    else
@@ -1097,6 +1299,9 @@ void MainWindow::createUpdateCurve(UnpackPlotMsg* unpackPlotMsg)
       ui->lblSpecAnAvgCntLabel->setText("Avg Count: " + avgCountStr);
    }
 
+   // If this curve is showing an out of core file, let it know where its samples are in the file.
+   m_curveCommander->initOutOfCoreCurve(getPlotName(), name, m_qwtCurves[curveIndex]);
+
    initCursorIndex(curveIndex);
 }
 
@@ -1157,16 +1362,28 @@ void MainWindow::handleCurveDataChange(int curveIndex, bool onlyPlotSizeChanged)
 
 void MainWindow::updatePlotWithNewCurveData(bool onlyCurveDataChanged)
 {
+   // The ingest worker thread can be resizing the curve sample buffers, hold the curves lock
+   // while the replot and the cursors read the samples.
+   QMutexLocker lock(&m_qwtCurvesMutex);
+
    if(onlyCurveDataChanged == false)
    {
       m_needToUpdateGuiOnNextPlotUpdate = true;
    }
 
-   // Only update the GUI if no more Plot Messages are queued. If more Plot Messages are queued we
-   // may as well wait until they are all processed. Basically, this avoids the processor hit that
-   // is caused by updating the GUI when we know the plot is just going to change anyway.
-   if(m_plotMsgQueue.size() == 0)
+   // Only update the GUI if no more Plot Messages are queued or being ingested. If more Plot Messages
+   // are on the way we may as well wait until they are all processed. Basically, this avoids the processor
+   // hit that is caused by updating the GUI when we know the plot is just going to change anyway.
+   m_plotMsgQueueMutex.lock();
+   bool morePlotMsgsComing = m_plotMsgQueue.size() > 0 || m_plotMsgIngestRunning;
+   m_plotMsgQueueMutex.unlock();
+
+   if(morePlotMsgsComing == false)
    {
+      // Any scheduled replot is covered by this one.
+      m_replotTimer.stop();
+      m_timeSinceLastReplot.restart();
+
       calcMaxMin(); // Make sure m_maxMin is updated.
       replotMainPlot(false);
 
@@ -1189,6 +1406,38 @@ void MainWindow::updatePlotWithNewCurveData(bool onlyCurveDataChanged)
    }
 }
 
+// Plot messages can come in much faster than they can be displayed. Instead of redrawing
+// the plot for every message, redraw at most once per display frame. All the curve data
+// that comes in during the frame is drawn by the single replot at the end of the frame.
+void MainWindow::scheduleUpdatePlotWithNewCurveData(bool onlyCurveDataChanged)
+{
+   extern unsigned int g_maxReplotRateHz;
+
+   if(g_maxReplotRateHz == 0)
+   {
+      // No limit on the replot rate.
+      updatePlotWithNewCurveData(onlyCurveDataChanged);
+      return;
+   }
+
+   if(onlyCurveDataChanged == false)
+   {
+      m_needToUpdateGuiOnNextPlotUpdate = true;
+   }
+
+   if(m_replotTimer.isActive() == false)
+   {
+      qint64 framePeriodMs = 1000 / g_maxReplotRateHz;
+      qint64 msSinceLastReplot = m_timeSinceLastReplot.elapsed();
+      m_replotTimer.start(msSinceLastReplot >= framePeriodMs ? 0 : (int)(framePeriodMs - msSinceLastReplot));
+   }
+}
+
+void MainWindow::replotTimerSlot()
+{
+   updatePlotWithNewCurveData(true);
+}
+
 void MainWindow::toggleLegend()
 {
     m_legendDisplayed = !m_legendDisplayed;
@@ -1438,6 +1687,8 @@ void MainWindow::maxHoldZoom()
 
 void MainWindow::scrollModeToggle()
 {
+   QMutexLocker lock(&m_qwtCurvesMutex); // Plot messages can be applied to the curves from the ingest worker thread.
+
    m_scrollMode = !m_scrollMode; // Toggle
    if(m_scrollMode)
    {
@@ -1450,7 +1701,6 @@ void MainWindow::scrollModeToggle()
    m_scrollModeChangePlotSizeAction.setVisible(m_scrollMode);
 
    // Inform all the Child Curves of the new Scroll Mode state.
-   QMutexLocker lock(&m_qwtCurvesMutex);
    for(int i = 0; i < m_qwtCurves.size(); ++i)
    {
       m_qwtCurves[i]->handleScrollModeTransitions(m_scrollMode);
@@ -1484,6 +1734,59 @@ void MainWindow::clearAllSamplesSilent()
    clearCurveSamples(false, true); // Clear all curve's samples without asking the user.
 }
 
+size_t MainWindow::getCurvesResidentBytes()
+{
+   QMutexLocker lock(&m_qwtCurvesMutex);
+   size_t numBytes = 0;
+   for(int i = 0; i < m_qwtCurves.size(); ++i)
+   {
+      numBytes += m_qwtCurves[i]->getResidentBytes();
+   }
+   return numBytes;
+}
+
+void MainWindow::spillCurveSamples()
+{
+   QMutexLocker lock(&m_qwtCurvesMutex);
+   for(int i = 0; i < m_qwtCurves.size(); ++i)
+   {
+      m_qwtCurves[i]->spillSamples();
+   }
+}
+
+void MainWindow::unspillCurveSamples()
+{
+   QMutexLocker lock(&m_qwtCurvesMutex);
+   for(int i = 0; i < m_qwtCurves.size(); ++i)
+   {
+      m_qwtCurves[i]->unspillSamples();
+   }
+}
+
+// Returns the source samples that are in the current zoom.
+bool MainWindow::getOutOfCoreSourceRange(const QString& curveName, long long& startIndex, long long& stopIndex)
+{
+   QMutexLocker lock(&m_qwtCurvesMutex);
+   int curveIndex = getCurveIndex(curveName);
+   if(curveIndex < 0)
+   {
+      return false;
+   }
+   maxMinXY zoomDim = m_plotZoom->getCurZoom();
+   return m_qwtCurves[curveIndex]->getOutOfCoreSourceRange(zoomDim.minX, zoomDim.maxX, startIndex, stopIndex);
+}
+
+void MainWindow::setOutOfCoreView(const QString& curveName, const dubVect& yPoints, tLinear sourceIndex, unsigned long long sourceNumSamples)
+{
+   QMutexLocker lock(&m_qwtCurvesMutex);
+   int curveIndex = getCurveIndex(curveName);
+   if(curveIndex >= 0)
+   {
+      m_qwtCurves[curveIndex]->setOutOfCoreView(yPoints, sourceIndex, sourceNumSamples);
+      handleCurveDataChange(curveIndex, false);
+   }
+}
+
 void MainWindow::clearAllSamplesSlot()
 {
    clearCurveSamples(true, true); // Clear all curve's samples, but ask the user for confirmation before doing so.
@@ -2015,8 +2318,13 @@ void MainWindow::on_horizontalScrollBar_sliderMoved(int /*position*/)
 
 void MainWindow::setDisplayIoMapIp(std::stringstream &iostr)
 {
-    iostr << std::setprecision(m_displayPrecision);
-    switch(m_displayType)
+    setDisplayIoMapIp(iostr, m_displayType, m_displayPrecision);
+}
+
+void MainWindow::setDisplayIoMapIp(std::stringstream &iostr, eDisplayPointType displayType, int displayPrecision)
+{
+    iostr << std::setprecision(displayPrecision);
+    switch(displayType)
     {
     case E_DISPLAY_POINT_FIXED:
         iostr << std::fixed;
@@ -2039,8 +2347,13 @@ void MainWindow::clearDisplayIoMapIp(std::stringstream &iostr)
 
 bool MainWindow::setDisplayIoMapipXAxis(std::stringstream& iostr, CurveData* curve)
 {
-    bool simpleXAxis = (curve->getPlotDim() == E_PLOT_DIM_1D) &&
-                       ( (curve->getSampleRate() == 1.0) || (curve->getSampleRate() == 0.0) );
+    return setDisplayIoMapipXAxis(iostr, curve->getPlotDim(), curve->getSampleRate(), m_displayType, m_displayPrecision);
+}
+
+bool MainWindow::setDisplayIoMapipXAxis(std::stringstream& iostr, ePlotDim plotDim, double sampleRate, eDisplayPointType displayType, int displayPrecision)
+{
+    bool simpleXAxis = (plotDim == E_PLOT_DIM_1D) &&
+                       ( (sampleRate == 1.0) || (sampleRate == 0.0) );
 
     if(simpleXAxis)
     {
@@ -2048,7 +2361,7 @@ bool MainWindow::setDisplayIoMapipXAxis(std::stringstream& iostr, CurveData* cur
     }
     else
     {
-        setDisplayIoMapIp(iostr);
+        setDisplayIoMapIp(iostr, displayType, displayPrecision);
     }
 
     return !simpleXAxis;
@@ -2154,7 +2467,7 @@ void MainWindow::displayPointLabels_getLabelText(std::stringstream& lblText, uns
       lblText << "<b>"; // Make Bold
 
    lblText << DISPLAY_POINT_START;
-   displayLabelAddNum(lblText, curve->getXPoints()[curvePointIndex], E_X_AXIS);
+   displayLabelAddNum(lblText, curve->getXPoint(curvePointIndex), E_X_AXIS);
    lblText << DISPLAY_POINT_MID;
 
    if(displayFormatSet == false)
@@ -2232,7 +2545,7 @@ void MainWindow::displayPointLabels_clean()
 
          // Set the tool tip text.
          std::stringstream toolTipText;
-         displayPointLabels_getToolTipText(toolTipText, m_qwtCurves[i]->getCurveTitle(), m_qwtCurves[i]->getXPoints()[m_qwtSelectedSample->m_pointIndex], m_qwtCurves[i]->getYPoints()[m_qwtSelectedSample->m_pointIndex], false);
+         displayPointLabels_getToolTipText(toolTipText, m_qwtCurves[i]->getCurveTitle(), m_qwtCurves[i]->getXPoint(m_qwtSelectedSample->m_pointIndex), m_qwtCurves[i]->getYPoints()[m_qwtSelectedSample->m_pointIndex], false);
          m_qwtCurves[i]->pointLabel->setToolTip(toolTipText.str().c_str());
 
          ui->InfoLayout->addWidget(m_qwtCurves[i]->pointLabel);
@@ -2262,7 +2575,7 @@ void MainWindow::displayPointLabels_update()
 
             // Set the tool tip text.
             std::stringstream toolTipText;
-            displayPointLabels_getToolTipText(toolTipText, m_qwtCurves[i]->getCurveTitle(), m_qwtCurves[i]->getXPoints()[m_qwtSelectedSample->m_pointIndex], m_qwtCurves[i]->getYPoints()[m_qwtSelectedSample->m_pointIndex], false);
+            displayPointLabels_getToolTipText(toolTipText, m_qwtCurves[i]->getCurveTitle(), m_qwtCurves[i]->getXPoint(m_qwtSelectedSample->m_pointIndex), m_qwtCurves[i]->getYPoints()[m_qwtSelectedSample->m_pointIndex], false);
             m_qwtCurves[i]->pointLabel->setToolTip(toolTipText.str().c_str());
          }
          else
@@ -3892,6 +4205,9 @@ void MainWindow::plotZoomDimChanged(const tMaxMinXY& plotDimensions, const tMaxM
       // When a plot is a 1D plot, we reduce the samples send to the GUI based on the X Axis zoom dimensions.
       // Thus, we only need to update the samples sent to the GUI when the X Axis zoom has changed.
       updateAllCurveGuiPoints();
+
+      // Out of core curves may need to load a different part of their file.
+      m_curveCommander->outOfCoreZoomChanged(getPlotName());
    }
 
    if(m_snrCalcBars != NULL)
@@ -4227,6 +4543,10 @@ void MainWindow::silentSavePlotToFile()
                fullPath = saveDir + fso::dirSep() + fileName + "_" + QString::number(fileNameAppendNum).toStdString() + ext;
             }
 
+            // The file is written later on a background thread. Create it now to reserve the name, so
+            // another save started before this one finishes doesn't pick the same file name.
+            fso::WriteFile(fullPath, "");
+
             // Fill in vector of curve data in the correct order.
             tCurveCommanderInfo allPlots = m_curveCommander->getCurveCommanderInfo();
             QVector<CurveData*> curves;
@@ -4238,10 +4558,7 @@ void MainWindow::silentSavePlotToFile()
             }
 
             // Save the plot data.
-            SavePlot savePlot(this, plotName, curves, saveType);
-            PackedCurveData dataToWriteToFile;
-            savePlot.getPackedData(dataToWriteToFile);
-            fso::WriteFile(fullPath, &dataToWriteToFile[0], dataToWriteToFile.size());
+            BackgroundPlotSave::start(this, QString(fullPath.c_str()), plotName, curves, saveType, false);
          }
          else
          {
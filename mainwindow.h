@@ -42,7 +42,9 @@
 #include <QCursor>
 #include <QSharedPointer>
 #include <QMutex>
+#include <QWaitCondition>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QSemaphore>
 
 #include <queue>
@@ -149,6 +151,9 @@ public:
 
     void readPlotMsg(plotMsgGroup* plotMsg);
 
+    // Called from a worker thread. Applies the next queued plot message to the curve samples.
+    void runPlotMsgIngest();
+
     void setCurveSampleRate(QString curveName, double sampleRate, bool userSpecified);
 
     void setCurveProperties(QString curveName, eAxis axis, double sampleRate, tMathOpList& mathOps);
@@ -170,10 +175,16 @@ public:
     unsigned int findNextUnusedColorIndex();
 
     void setDisplayIoMapIp(std::stringstream &iostr);
-    void clearDisplayIoMapIp(std::stringstream& iostr);
+    static void clearDisplayIoMapIp(std::stringstream& iostr);
     bool setDisplayIoMapipXAxis(std::stringstream& iostr, CurveData *curve);
     void setDisplayIoMapipYAxis(std::stringstream& iostr);
 
+    // Same as above, but with the display settings passed in (i.e. for formatting off the GUI thread).
+    static void setDisplayIoMapIp(std::stringstream &iostr, eDisplayPointType displayType, int displayPrecision);
+    static bool setDisplayIoMapipXAxis(std::stringstream& iostr, ePlotDim plotDim, double sampleRate, eDisplayPointType displayType, int displayPrecision);
+    eDisplayPointType getDisplayType(){return m_displayType;}
+    int getDisplayPrecision(){return m_displayPrecision;}
+
     void toggleCurveVisability(const QString& curveName);
 
     void setLegendState(bool showLegend);
@@ -182,6 +193,9 @@ public:
 
     QString getPlotName(){return m_plotName;}
 
+    // Locked while the curve samples are being changed (including by the plot message ingest worker thread).
+    QMutex* getCurvesMutex(){return &m_qwtCurvesMutex;}
+
     void setScrollMode(bool newState, int size = 0);
     void externalZoomReset();
     void setSnrBarMode(bool newState);
@@ -195,6 +209,15 @@ public:
     bool closeSubWindows(); // Returns true if sub-windows were closed.
 
     void clearAllSamplesSilent(); // Silently clears all samples on all the curves.
+
+    // Memory budget support (see CurveCommander::memoryBudgetTimerSlot).
+    size_t getCurvesResidentBytes();
+    void spillCurveSamples();
+    void unspillCurveSamples();
+
+    // Out of core curve support (see CurveCommander::outOfCoreZoomChangedSlot).
+    bool getOutOfCoreSourceRange(const QString& curveName, long long& startIndex, long long& stopIndex);
+    void setOutOfCoreView(const QString& curveName, const dubVect& yPoints, tLinear sourceIndex, unsigned long long sourceNumSamples);
     
     bool m_spectrumAnalyzerViewSet;
 private:
@@ -230,6 +253,27 @@ private:
     std::queue<plotMsgGroup*> m_plotMsgQueue;
     QMutex m_plotMsgQueueMutex;
 
+    // Plot messages are applied to the curve samples on a worker thread, one message at a time. The ingested
+    // message is then handed to the GUI thread, which sends the new samples to the plot and informs the
+    // Curve Commander. The next message isn't ingested until the GUI thread is done with the previous one,
+    // so child curves always see the parent samples from the message they are being informed about.
+    // The new samples are applied to back buffers of the curves, so the curves themselves are only locked
+    // while the GUI thread swaps the back buffers in.
+    // These are protected by m_plotMsgQueueMutex.
+    typedef struct
+    {
+       QString curveName;
+       CurveData* frontCurve;
+       CurveData* backBuffer;
+    }tCurveBackBuffer;
+    plotMsgGroup* m_ingestedPlotMsg;
+    std::vector<tCurveBackBuffer> m_ingestedBackBuffers;
+    bool m_ingestedPlotMsgSamplesApplied; // False if the GUI thread still needs to create / update the curves.
+    qint64 m_ingestedPlotMsgIngestNs; // Time the worker thread spent ingesting the message.
+    bool m_plotMsgIngestBusy; // A message is being ingested or is waiting on the GUI thread.
+    bool m_plotMsgIngestRunning; // The worker thread is running.
+    QWaitCondition m_plotMsgIngestDoneCond;
+
     eSelectMode m_selectMode;
 
     int m_selectedCurveIndex;
@@ -258,6 +302,10 @@ private:
 
     bool m_needToUpdateGuiOnNextPlotUpdate;
 
+    // Used to limit how often new curve data causes the plot to be redrawn.
+    QTimer m_replotTimer;
+    QElapsedTimer m_timeSinceLastReplot;
+
     bool m_cursorCanSelectAnyCurve;
 
     QList<tMenuActionMapper> m_selectedCursorActions;
@@ -368,11 +416,19 @@ private:
 
     void resetPlot();
 
-    void createUpdateCurve(UnpackPlotMsg* unpackPlotMsg);
+    void createUpdateCurve(UnpackPlotMsg* unpackPlotMsg, bool samplesAlreadyApplied = false);
+    bool plotMsgResetsCurve(UnpackPlotMsg* unpackPlotMsg);
+    void updateCurveSamples(int curveIndex, UnpackPlotMsg* unpackPlotMsg, bool resetCurve);
+    static void applyCurveSamples(CurveData* curve, UnpackPlotMsg* unpackPlotMsg, bool resetCurve);
+
+    void startPlotMsgIngest();
+    bool ingestPlotMsg(plotMsgGroup* plotMsg, std::vector<tCurveBackBuffer>& backBuffers);
+    static void deleteBackBuffers(std::vector<tCurveBackBuffer>& backBuffers);
 
     void initCursorIndex(int curveIndex);
     void handleCurveDataChange(int curveIndex, bool onlyPlotSizeChanged = false);
     void updatePlotWithNewCurveData(bool onlyCurveDataChanged);
+    void scheduleUpdatePlotWithNewCurveData(bool onlyCurveDataChanged);
 
     maxMinXY calcMaxMin(bool limitedZoom = false, eAxis limitedAxis = E_X_AXIS, double startValue = 0, double stopValue = 0);
     void SetZoomPlotDimensions(maxMinXY plotDimensions, bool changeCausedByUserGuiInput);
@@ -538,6 +594,7 @@ private slots:
     void updateCurveOrder();
 
     void activityIndicatorTimerSlot();
+    void replotTimerSlot();
 
     // Spectrum Analyzer Like GUI Element functions.
     void on_radClearWrite_clicked();
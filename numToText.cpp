@@ -0,0 +1,162 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "numToText.h"
+
+// std::to_chars matches printf output exactly and is much faster, but the floating
+// point overloads are only available on newer standard libraries.
+#if __cplusplus >= 201703L && defined(__has_include)
+   #if __has_include(<charconv>)
+      #include <charconv>
+   #endif
+#endif
+
+// Default precision of a stream (and printf) when no valid precision has been set.
+#define NUM_TO_TEXT_DEFAULT_PRECISION (6)
+
+// Largest whole number that is always stored exactly in a double and can be written with writeInt.
+#define NUM_TO_TEXT_MAX_FAST_PATH_INT (1e15)
+
+static const char g_twoDigitLookup[] =
+   "00010203040506070809"
+   "10111213141516171819"
+   "20212223242526272829"
+   "30313233343536373839"
+   "40414243444546474849"
+   "50515253545556575859"
+   "60616263646566676869"
+   "70717273747576777879"
+   "80818283848586878889"
+   "90919293949596979899";
+
+
+NumToText::NumToText(eDisplayPointType displayType, int displayPrecision):
+   m_displayType(displayType),
+   m_precision(displayPrecision < 0 ? NUM_TO_TEXT_DEFAULT_PRECISION : displayPrecision)
+{
+   switch(m_displayType)
+   {
+      case E_DISPLAY_POINT_FIXED:
+         // Whole numbers are written as the integer followed by '.' and 'm_precision' zeros.
+         m_maxIntFastPath = NUM_TO_TEXT_MAX_FAST_PATH_INT;
+         m_maxChars = 312 + m_precision; // Sign, 309 integer digits, '.', null terminator and the fractional digits.
+      break;
+      case E_DISPLAY_POINT_SCIENTIFIC:
+         m_maxIntFastPath = 0; // Always has an exponent, no fast path.
+         m_maxChars = 12 + m_precision; // Sign, digit, '.', "e+308", null terminator and the fractional digits.
+      break;
+      case E_DISPLAY_POINT_AUTO:
+      default:
+      {
+         // Auto only writes whole numbers without an exponent when they have no more digits than the precision.
+         int precision = m_precision == 0 ? 1 : m_precision;
+         m_maxIntFastPath = precision < 15 ? pow(10.0, precision) : NUM_TO_TEXT_MAX_FAST_PATH_INT;
+         m_maxChars = 12 + precision;
+         m_displayType = E_DISPLAY_POINT_AUTO;
+      }
+      break;
+   }
+}
+
+char* NumToText::write(char* out, double val) const
+{
+   if(fabs(val) < m_maxIntFastPath)
+   {
+      int64_t intVal = (int64_t)val;
+      if((double)intVal == val && (intVal != 0 || !signbit(val)))
+      {
+         out = writeInt(out, intVal);
+         if(m_displayType == E_DISPLAY_POINT_FIXED && m_precision > 0)
+         {
+            *out++ = '.';
+            memset(out, '0', m_precision);
+            out += m_precision;
+         }
+         return out;
+      }
+   }
+   return writeFallback(out, val);
+}
+
+char* NumToText::writeFallback(char* out, double val) const
+{
+#if defined(__cpp_lib_to_chars)
+   // Leave inf / nan to printf so they are written the same way a stream would write them.
+   if(isfinite(val))
+   {
+      std::chars_format format =
+         m_displayType == E_DISPLAY_POINT_FIXED ? std::chars_format::fixed :
+         m_displayType == E_DISPLAY_POINT_SCIENTIFIC ? std::chars_format::scientific :
+         std::chars_format::general;
+      std::to_chars_result result = std::to_chars(out, out + m_maxChars, val, format, m_precision);
+      if(result.ec == std::errc())
+      {
+         return result.ptr;
+      }
+   }
+#endif
+   const char* format =
+      m_displayType == E_DISPLAY_POINT_FIXED ? "%.*f" :
+      m_displayType == E_DISPLAY_POINT_SCIENTIFIC ? "%.*e" :
+      "%.*g";
+   int numChars = snprintf(out, m_maxChars, format, m_precision, val);
+   return numChars > 0 ? out + numChars : out;
+}
+
+char* NumToText::writeInt(char* out, int64_t val)
+{
+   uint64_t mag = (uint64_t)val;
+   if(val < 0)
+   {
+      *out++ = '-';
+      mag = 0 - mag;
+   }
+
+   // Write the digits backwards into a temp buffer, 2 at a time.
+   char digits[20];
+   char* digitsPtr = digits + sizeof(digits);
+   while(mag >= 100)
+   {
+      unsigned twoDigits = (unsigned)(mag % 100);
+      mag /= 100;
+      digitsPtr -= 2;
+      memcpy(digitsPtr, &g_twoDigitLookup[2*twoDigits], 2);
+   }
+   if(mag >= 10)
+   {
+      digitsPtr -= 2;
+      memcpy(digitsPtr, &g_twoDigitLookup[2*mag], 2);
+   }
+   else
+   {
+      *--digitsPtr = (char)('0' + mag);
+   }
+
+   size_t numDigits = digits + sizeof(digits) - digitsPtr;
+   memcpy(out, digitsPtr, numDigits);
+   return out + numDigits;
+}
+
+char* NumToText::writeStr(char* out, const char* str, size_t len)
+{
+   memcpy(out, str, len);
+   return out + len;
+}
@@ -0,0 +1,55 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef NumToText_h
+#define NumToText_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include "PlotHelperTypes.h"
+
+// Converts doubles to text without going through a stream. The output matches what a
+// std::stringstream set up by MainWindow::setDisplayIoMapIp would produce for the same
+// display type / precision, but is written straight into a caller supplied buffer.
+class NumToText
+{
+public:
+   NumToText(eDisplayPointType displayType, int displayPrecision);
+
+   // Upper limit on the number of chars a single call to write can add to the buffer.
+   size_t maxChars() const {return m_maxChars;}
+
+   // Writes 'val' to 'out' and returns a pointer to the char after the last char written.
+   // The caller must have at least maxChars() chars available at 'out'. No null terminator is written.
+   char* write(char* out, double val) const;
+
+   static char* writeInt(char* out, int64_t val);
+   static char* writeStr(char* out, const char* str, size_t len);
+
+private:
+   NumToText();
+
+   char* writeFallback(char* out, double val) const;
+
+   eDisplayPointType m_displayType;
+   int m_precision;
+   double m_maxIntFastPath; // Whole numbers with a magnitude below this are written with writeInt.
+   size_t m_maxChars;
+};
+
+#endif
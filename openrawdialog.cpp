@@ -28,6 +28,10 @@
 #include "persistentParameters.h"
 #include "rawFileTypes.h"
 #include "float16Helpers.h"
+#include <QFile>
+
+// Files this big default to being opened out of core.
+#define OPEN_RAW_OUT_OF_CORE_DEFAULT_BYTES (1024LL*1024LL*1024LL)
 
 template <typename T>
 std::string toStringWithSigFigs(const T val, const int sigFigs = 3)
@@ -72,6 +76,7 @@ bool openRawDialog::deterimineRawType(CurveCommander* curveCmdr, const QString&
    this->setWindowTitle( (std::string("Opening ") + fso::GetFile(filePath.toStdString())).c_str() );
 
    m_curFileSizeBytes = fso::GetFileSize(filePath.toStdString());
+   ui->chkOutOfCore->setChecked(m_curFileSizeBytes >= OPEN_RAW_OUT_OF_CORE_DEFAULT_BYTES);
    double oneLessByte = m_curFileSizeBytes - 1;
    ui->spnSliceStart->setMinimum(-oneLessByte);
    ui->spnSliceStart->setMaximum(oneLessByte);
@@ -258,89 +263,83 @@ void openRawDialog::plotTheFile(CurveCommander* curveCmdr, const QString& filePa
    QString curveName1 = ui->txtCurveName->text();
    QString curveName2 = ui->txtCurveName2->text();
 
-   std::vector<char> inputFileBytes;
-   fso::ReadBinaryFile(filePath.toStdString(), inputFileBytes);
-   dubVect curveValues1;
-   dubVect curveValues2;
+   // Check if we need to set the sample rate.
+   tCurveMathProperties mathProps;
+   tCurveMathProperties* mathPropsPtr = nullptr; // setting this to null means don't set the sample rate.
+   if(settingSampleRateViaGui())
+   {
+      mathProps.sampleRate = ui->spnSampRate->value();
+      mathPropsPtr = &mathProps; // Indicate that the sample rate should be set.
+   }
 
    int64_t bytesToRemoveFromFront, totalBytesToKeep;
    getSliceValueBytes(bytesToRemoveFromFront, totalBytesToKeep);
-   if(int64_t(inputFileBytes.size()) >= (bytesToRemoveFromFront+totalBytesToKeep))
-   {
-      inputFileBytes.erase(inputFileBytes.begin(), inputFileBytes.begin()+bytesToRemoveFromFront);
-      inputFileBytes.resize(totalBytesToKeep);
-   }
 
-   auto openRawType = (eRawTypes)ui->cmbRawType->currentIndex();
-   switch(openRawType)
+   if(ui->chkOutOfCore->isChecked())
    {
-      case E_RAW_TYPE_SIGNED_INT_8:    { fillFromRaw<int8_t  >(inputFileBytes, curveValues1); } break;
-      case E_RAW_TYPE_SIGNED_INT_16:   { fillFromRaw<int16_t >(inputFileBytes, curveValues1); } break;
-      case E_RAW_TYPE_SIGNED_INT_32:   { fillFromRaw<int32_t >(inputFileBytes, curveValues1); } break;
-      case E_RAW_TYPE_SIGNED_INT_64:   { fillFromRaw<int64_t >(inputFileBytes, curveValues1); } break;
-      case E_RAW_TYPE_UNSIGNED_INT_8:  { fillFromRaw<uint8_t >(inputFileBytes, curveValues1); } break;
-      case E_RAW_TYPE_UNSIGNED_INT_16: { fillFromRaw<uint16_t>(inputFileBytes, curveValues1); } break;
-      case E_RAW_TYPE_UNSIGNED_INT_32: { fillFromRaw<uint32_t>(inputFileBytes, curveValues1); } break;
-      case E_RAW_TYPE_UNSIGNED_INT_64: { fillFromRaw<uint64_t>(inputFileBytes, curveValues1); } break;
-      case E_RAW_TYPE_FLOAT_16:        { fillFromRaw<FLOAT_16>(inputFileBytes, curveValues1); } break;
-      case E_RAW_TYPE_FLOAT_32:        { fillFromRaw<float   >(inputFileBytes, curveValues1); } break;
-      case E_RAW_TYPE_FLOAT_64:        { fillFromRaw<double  >(inputFileBytes, curveValues1); } break;
-      case E_RAW_TYPE_INTERLEAVED_SIGNED_INT_8:    { fillFromRaw<int8_t  >(inputFileBytes, curveValues1, 2, 0); fillFromRaw<int8_t  >(inputFileBytes, curveValues2, 2, 1);} break;
-      case E_RAW_TYPE_INTERLEAVED_SIGNED_INT_16:   { fillFromRaw<int16_t >(inputFileBytes, curveValues1, 2, 0); fillFromRaw<int16_t >(inputFileBytes, curveValues2, 2, 1);} break;
-      case E_RAW_TYPE_INTERLEAVED_SIGNED_INT_32:   { fillFromRaw<int32_t >(inputFileBytes, curveValues1, 2, 0); fillFromRaw<int32_t >(inputFileBytes, curveValues2, 2, 1);} break;
-      case E_RAW_TYPE_INTERLEAVED_SIGNED_INT_64:   { fillFromRaw<int64_t >(inputFileBytes, curveValues1, 2, 0); fillFromRaw<int64_t >(inputFileBytes, curveValues2, 2, 1);} break;
-      case E_RAW_TYPE_INTERLEAVED_UNSIGNED_INT_8:  { fillFromRaw<uint8_t >(inputFileBytes, curveValues1, 2, 0); fillFromRaw<uint8_t >(inputFileBytes, curveValues2, 2, 1);} break;
-      case E_RAW_TYPE_INTERLEAVED_UNSIGNED_INT_16: { fillFromRaw<uint16_t>(inputFileBytes, curveValues1, 2, 0); fillFromRaw<uint16_t>(inputFileBytes, curveValues2, 2, 1);} break;
-      case E_RAW_TYPE_INTERLEAVED_UNSIGNED_INT_32: { fillFromRaw<uint32_t>(inputFileBytes, curveValues1, 2, 0); fillFromRaw<uint32_t>(inputFileBytes, curveValues2, 2, 1);} break;
-      case E_RAW_TYPE_INTERLEAVED_UNSIGNED_INT_64: { fillFromRaw<uint64_t>(inputFileBytes, curveValues1, 2, 0); fillFromRaw<uint64_t>(inputFileBytes, curveValues2, 2, 1);} break;
-      case E_RAW_TYPE_INTERLEAVED_FLOAT_16:        { fillFromRaw<FLOAT_16>(inputFileBytes, curveValues1, 2, 0); fillFromRaw<FLOAT_16>(inputFileBytes, curveValues2, 2, 1);} break;
-      case E_RAW_TYPE_INTERLEAVED_FLOAT_32:        { fillFromRaw<float   >(inputFileBytes, curveValues1, 2, 0); fillFromRaw<float   >(inputFileBytes, curveValues2, 2, 1);} break;
-      case E_RAW_TYPE_INTERLEAVED_FLOAT_64:        { fillFromRaw<double  >(inputFileBytes, curveValues1, 2, 0); fillFromRaw<double  >(inputFileBytes, curveValues2, 2, 1);} break;
-      default: break;
+      // Only the part of the file that is in view will be loaded.
+      curveCmdr->openOutOfCoreRawFile( plotName, curveName1, curveName2, filePath, (eRawTypes)ui->cmbRawType->currentIndex(),
+                                       bytesToRemoveFromFront, totalBytesToKeep, mathPropsPtr );
+      savePersistentParams(mathPropsPtr);
+      return;
    }
 
-   // Check if we need to set the sample rate.
-   tCurveMathProperties mathProps;
-   tCurveMathProperties* mathPropsPtr = nullptr; // setting this to null means don't set the sample rate.
-   if(settingSampleRateViaGui())
+   dubVect curveValues1;
+   dubVect curveValues2;
+
+   // Map just the slice of the file that is being plotted, rather than reading the whole file in.
+   QFile inputFile(filePath);
+   const char* inputFileBytes = nullptr;
+   int64_t inputFileNumBytes = 0;
+   std::vector<char> inputFileCopy;
+   if(inputFile.open(QIODevice::ReadOnly))
    {
-      mathProps.sampleRate = ui->spnSampRate->value();
-      mathPropsPtr = &mathProps; // Indicate that the sample rate should be set.
+      int64_t offset = 0;
+      inputFileNumBytes = inputFile.size();
+      if(inputFileNumBytes >= (bytesToRemoveFromFront+totalBytesToKeep))
+      {
+         offset = bytesToRemoveFromFront;
+         inputFileNumBytes = totalBytesToKeep;
+      }
+
+      if(inputFileNumBytes > 0)
+      {
+         inputFileBytes = (const char*)inputFile.map(offset, inputFileNumBytes);
+         if(inputFileBytes == nullptr)
+         {
+            // Couldn't map the file (e.g. not enough address space), fall back to reading the slice in.
+            inputFileCopy.resize(inputFileNumBytes);
+            if(inputFile.seek(offset) && inputFile.read(inputFileCopy.data(), inputFileNumBytes) == inputFileNumBytes)
+               inputFileBytes = inputFileCopy.data();
+            else
+               inputFileNumBytes = 0;
+         }
+      }
    }
 
-   // Finally, this will actually create the plots.
+   rawFileToDouble((eRawTypes)ui->cmbRawType->currentIndex(), inputFileBytes, (size_t)inputFileNumBytes, curveValues1, curveValues2);
+
+   // Done with the file.
+   if(inputFileBytes != nullptr && inputFileBytes != inputFileCopy.data())
+      inputFile.unmap((uchar*)inputFileBytes);
+   inputFile.close();
+   std::vector<char>().swap(inputFileCopy);
+
+   // Finally, this will actually create the plots. Store the samples in the file's type rather than as doubles.
+   ePlotDataTypes dataType = rawTypeToPlotDataType((eRawTypes)ui->cmbRawType->currentIndex());
    if(curveValues1.size() > 0)
-      curveCmdr->create1dCurve(plotName, curveName1, E_PLOT_TYPE_1D, curveValues1, mathPropsPtr);
+      curveCmdr->create1dCurve(plotName, curveName1, E_PLOT_TYPE_1D, curveValues1, mathPropsPtr, dataType);
    if(curveValues2.size() > 0)
-      curveCmdr->create1dCurve(plotName, curveName2, E_PLOT_TYPE_1D, curveValues2, mathPropsPtr);
+      curveCmdr->create1dCurve(plotName, curveName2, E_PLOT_TYPE_1D, curveValues2, mathPropsPtr, dataType);
       
-   // Save persistent info
-   persistentParam_setParam_f64(PERSIST_PARAM_OPEN_RAW_TYPE, (double)ui->cmbRawType->currentIndex());
-   if(mathPropsPtr != nullptr)
-      persistentParam_setParam_f64(PERSIST_PARAM_OPEN_RAW_SAMP_RATE, mathProps.sampleRate);
+   savePersistentParams(mathPropsPtr);
 }
 
-template <typename tRawFileType>
-void openRawDialog::fillFromRaw(const std::vector<char>& inFile, dubVect& result, int dimension, int offsetIndex)
+void openRawDialog::savePersistentParams(tCurveMathProperties* mathProps)
 {
-   assert(dimension > 0 && dimension < 3);
-   assert(offsetIndex < dimension);
-
-   // Determine some sizes.
-   constexpr size_t RAW_TYPE_SIZE = sizeof(tRawFileType);
-   const size_t inFileSizeBytes = inFile.size();
-   const size_t blockSizeBytes = RAW_TYPE_SIZE * dimension;
-   const size_t offsetBytes = RAW_TYPE_SIZE * offsetIndex;
-   const char* inFilePtr = inFile.data();
-
-   size_t numLoops = inFileSizeBytes / blockSizeBytes; // round down.
-   result.resize(numLoops);
-   tRawFileType rawVal;
-   for(size_t i = 0; i < numLoops; ++i)
-   {
-      memcpy(&rawVal, &inFilePtr[i*blockSizeBytes+offsetBytes], RAW_TYPE_SIZE);
-      result[i] = (double)(rawVal);
-   }
+   persistentParam_setParam_f64(PERSIST_PARAM_OPEN_RAW_TYPE, (double)ui->cmbRawType->currentIndex());
+   if(mathProps != nullptr)
+      persistentParam_setParam_f64(PERSIST_PARAM_OPEN_RAW_SAMP_RATE, mathProps->sampleRate);
 }
 
 void openRawDialog::setSampRateVisible()
@@ -80,8 +80,7 @@ private:
 
    void plotTheFile(CurveCommander* curveCmdr, const QString& filePath);
 
-   template <typename tRawFileType>
-   void fillFromRaw(const std::vector<char>& inFile, dubVect& result, int dimension = 1, int offsetIndex = 0); 
+   void savePersistentParams(tCurveMathProperties* mathProps);
 
    void setSampRateVisible();
    void setSliceVisible();
@@ -0,0 +1,418 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#include <math.h>
+#include <algorithm>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QMutexLocker>
+#include "outOfCoreRawFile.h"
+
+///////////////////////////////////////////
+// Constants
+///////////////////////////////////////////
+#define OUT_OF_CORE_INDEX_MAGIC (0x444F4C50) // PLOD
+#define OUT_OF_CORE_INDEX_VERSION (1)
+#define OUT_OF_CORE_MAX_LEVELS (16)
+
+#define OUT_OF_CORE_BASE_SAMPLES_PER_BUCKET (4096) // Level 0 bucket size.
+#define OUT_OF_CORE_LEVEL_FACTOR (8) // Each level has 1/8 the number of buckets as the level below it.
+#define OUT_OF_CORE_MAX_VIEW_BUCKETS (8192) // Most min/max buckets put in a single view.
+#define OUT_OF_CORE_MAX_RAW_VIEW_SAMPLES (1<<22) // Views narrower than this are read from the raw file.
+#define OUT_OF_CORE_BUILD_CHUNK_BUCKETS (1024) // Level 0 buckets read from the raw file at a time when building the index.
+
+
+// The index file is this header followed by the levels. Each level is an array of buckets, each bucket
+// has a min and max value (double) for each channel.
+typedef struct
+{
+   uint32_t magic;
+   uint32_t version;
+   uint32_t rawType;
+   uint32_t numLevels;
+   int64_t rawFileSize;
+   int64_t rawFileModTime;
+   int64_t byteOffset;
+   int64_t numBytes;
+   int64_t numSamples;
+   int64_t samplesPerBucket[OUT_OF_CORE_MAX_LEVELS];
+   int64_t numBuckets[OUT_OF_CORE_MAX_LEVELS];
+   int64_t levelOffset[OUT_OF_CORE_MAX_LEVELS]; // Byte offset in the index file.
+}tOutOfCoreIndexHeader;
+
+
+outOfCoreRawFile::outOfCoreRawFile(const QString& filePath, eRawTypes rawType, int64_t byteOffset, int64_t numBytes):
+   m_filePath(filePath),
+   m_rawType(rawType),
+   m_byteOffset(byteOffset),
+   m_numBytes(numBytes),
+   m_numChannels(rawTypeIsInterleaved(rawType) ? 2 : 1),
+   m_numSamples(numBytes / (int64_t)RAW_TYPE_BLOCK_SIZE[rawType]),
+   m_rawFile(filePath),
+   m_index(NULL),
+   m_indexBuildDone(false)
+{
+   m_rawFile.open(QIODevice::ReadOnly);
+}
+
+outOfCoreRawFile::~outOfCoreRawFile()
+{
+   unloadIndex();
+   m_rawFile.close();
+}
+
+void outOfCoreRawFile::unloadIndex()
+{
+   // Note: It is expected that m_indexMutex is locked before this function is called (or that no other thread is using this object).
+   if(m_index != NULL && m_indexMem.empty())
+   {
+      m_indexFile.unmap((uchar*)m_index);
+   }
+   m_indexFile.close();
+   m_index = NULL;
+   std::vector<char>().swap(m_indexMem);
+}
+
+bool outOfCoreRawFile::isIndexReady()
+{
+   QMutexLocker lock(&m_indexMutex);
+   return m_index != NULL;
+}
+
+bool outOfCoreRawFile::isIndexBuildDone()
+{
+   QMutexLocker lock(&m_indexMutex);
+   return m_indexBuildDone;
+}
+
+bool outOfCoreRawFile::loadIndex()
+{
+   QMutexLocker lock(&m_indexMutex);
+   unloadIndex();
+
+   QFileInfo rawFileInfo(m_filePath);
+   m_indexFile.setFileName(getIndexFilePath());
+   if(!m_indexFile.open(QIODevice::ReadOnly))
+   {
+      return false;
+   }
+
+   int64_t indexSize = m_indexFile.size();
+   const char* index = NULL;
+   if(indexSize >= (int64_t)sizeof(tOutOfCoreIndexHeader))
+   {
+      index = (const char*)m_indexFile.map(0, indexSize);
+      if(index == NULL)
+      {
+         // Couldn't map the index file, fall back to reading it in.
+         m_indexMem.resize(indexSize);
+         if(m_indexFile.read(m_indexMem.data(), indexSize) == indexSize)
+            index = m_indexMem.data();
+      }
+   }
+   bool valid = index != NULL;
+   if(valid)
+   {
+      // Make sure the index is for this version of the raw file.
+      const tOutOfCoreIndexHeader* header = (const tOutOfCoreIndexHeader*)index;
+      valid = header->magic == OUT_OF_CORE_INDEX_MAGIC &&
+              header->version == OUT_OF_CORE_INDEX_VERSION &&
+              header->rawType == (uint32_t)m_rawType &&
+              header->rawFileSize == rawFileInfo.size() &&
+              header->rawFileModTime == rawFileInfo.lastModified().toMSecsSinceEpoch() &&
+              header->byteOffset == m_byteOffset &&
+              header->numBytes == m_numBytes &&
+              header->numSamples == m_numSamples &&
+              header->numLevels > 0 && header->numLevels <= OUT_OF_CORE_MAX_LEVELS;
+      for(uint32_t level = 0; valid && level < header->numLevels; ++level)
+      {
+         int64_t levelSize = header->numBuckets[level] * m_numChannels * 2 * sizeof(double);
+         valid = header->levelOffset[level] >= (int64_t)sizeof(tOutOfCoreIndexHeader) &&
+                 header->levelOffset[level] + levelSize <= indexSize;
+      }
+   }
+
+   if(valid)
+   {
+      m_index = index;
+   }
+   else
+   {
+      if(index != NULL && m_indexMem.empty())
+         m_indexFile.unmap((uchar*)index);
+      m_indexFile.close();
+      std::vector<char>().swap(m_indexMem);
+   }
+   return valid;
+}
+
+bool outOfCoreRawFile::buildIndex()
+{
+   bool success = false;
+   QFile rawFile(m_filePath);
+   if(m_numSamples > 0 && rawFile.open(QIODevice::ReadOnly))
+   {
+      const int64_t numChannels = m_numChannels;
+      const int64_t bucketStride = 2 * numChannels; // min / max for each channel.
+      std::vector< std::vector<double> > levels;
+      std::vector<int64_t> levelSamplesPerBucket;
+
+      // Level 0 is read from the raw file.
+      int64_t numBuckets = (m_numSamples + OUT_OF_CORE_BASE_SAMPLES_PER_BUCKET - 1) / OUT_OF_CORE_BASE_SAMPLES_PER_BUCKET;
+      levels.resize(1);
+      levels[0].resize(numBuckets * bucketStride);
+      levelSamplesPerBucket.push_back(OUT_OF_CORE_BASE_SAMPLES_PER_BUCKET);
+
+      dubVect channels[2];
+      success = true;
+      for(int64_t chunkBucket = 0; success && chunkBucket < numBuckets; chunkBucket += OUT_OF_CORE_BUILD_CHUNK_BUCKETS)
+      {
+         int64_t chunkStart = chunkBucket * OUT_OF_CORE_BASE_SAMPLES_PER_BUCKET;
+         int64_t chunkSize = std::min((int64_t)OUT_OF_CORE_BUILD_CHUNK_BUCKETS * OUT_OF_CORE_BASE_SAMPLES_PER_BUCKET, m_numSamples - chunkStart);
+         success = readSamples(rawFile, chunkStart, chunkSize, channels[0], channels[1]);
+         for(int64_t channel = 0; success && channel < numChannels; ++channel)
+         {
+            const double* samples = channels[channel].data();
+            double* bucket = &levels[0][(chunkBucket * numChannels + channel) * 2];
+            for(int64_t i = 0; i < chunkSize; i += OUT_OF_CORE_BASE_SAMPLES_PER_BUCKET)
+            {
+               double minVal = NAN;
+               double maxVal = NAN;
+               int64_t bucketEnd = std::min(i + OUT_OF_CORE_BASE_SAMPLES_PER_BUCKET, chunkSize);
+               for(int64_t j = i; j < bucketEnd; ++j)
+               {
+                  if(isDoubleValid(samples[j]))
+                  {
+                     minVal = std::fmin(minVal, samples[j]);
+                     maxVal = std::fmax(maxVal, samples[j]);
+                  }
+               }
+               bucket[0] = minVal;
+               bucket[1] = maxVal;
+               bucket += bucketStride;
+            }
+         }
+      }
+
+      // Each level above combines OUT_OF_CORE_LEVEL_FACTOR buckets from the level below. Stop once the
+      // whole file fits in a single view.
+      while(success && numBuckets > OUT_OF_CORE_MAX_VIEW_BUCKETS && levels.size() < OUT_OF_CORE_MAX_LEVELS)
+      {
+         int64_t newNumBuckets = (numBuckets + OUT_OF_CORE_LEVEL_FACTOR - 1) / OUT_OF_CORE_LEVEL_FACTOR;
+         std::vector<double> newLevel(newNumBuckets * bucketStride, NAN);
+         const std::vector<double>& prevLevel = levels.back();
+         for(int64_t bucket = 0; bucket < numBuckets; ++bucket)
+         {
+            const double* src = &prevLevel[bucket * bucketStride];
+            double* dst = &newLevel[(bucket / OUT_OF_CORE_LEVEL_FACTOR) * bucketStride];
+            for(int64_t i = 0; i < bucketStride; i += 2)
+            {
+               dst[i]   = std::fmin(dst[i],   src[i]);
+               dst[i+1] = std::fmax(dst[i+1], src[i+1]);
+            }
+         }
+         levels.push_back(std::vector<double>());
+         levels.back().swap(newLevel);
+         levelSamplesPerBucket.push_back(levelSamplesPerBucket.back() * OUT_OF_CORE_LEVEL_FACTOR);
+         numBuckets = newNumBuckets;
+      }
+
+      if(success)
+      {
+         // Put the index together.
+         QFileInfo rawFileInfo(m_filePath);
+         tOutOfCoreIndexHeader header;
+         memset(&header, 0, sizeof(header));
+         header.magic = OUT_OF_CORE_INDEX_MAGIC;
+         header.version = OUT_OF_CORE_INDEX_VERSION;
+         header.rawType = (uint32_t)m_rawType;
+         header.numLevels = (uint32_t)levels.size();
+         header.rawFileSize = rawFileInfo.size();
+         header.rawFileModTime = rawFileInfo.lastModified().toMSecsSinceEpoch();
+         header.byteOffset = m_byteOffset;
+         header.numBytes = m_numBytes;
+         header.numSamples = m_numSamples;
+
+         int64_t indexSize = sizeof(header);
+         for(size_t level = 0; level < levels.size(); ++level)
+         {
+            header.samplesPerBucket[level] = levelSamplesPerBucket[level];
+            header.numBuckets[level] = levels[level].size() / bucketStride;
+            header.levelOffset[level] = indexSize;
+            indexSize += levels[level].size() * sizeof(double);
+         }
+
+         std::vector<char> index(indexSize);
+         memcpy(&index[0], &header, sizeof(header));
+         for(size_t level = 0; level < levels.size(); ++level)
+         {
+            memcpy(&index[header.levelOffset[level]], levels[level].data(), levels[level].size() * sizeof(double));
+            std::vector<double>().swap(levels[level]);
+         }
+
+         // Save the index next to the raw file. Write to a temp file first so a partially written
+         // index file is never left behind.
+         QString indexPath = getIndexFilePath();
+         QString tempIndexPath = indexPath + ".tmp";
+         QFile tempIndexFile(tempIndexPath);
+         bool saved = tempIndexFile.open(QIODevice::WriteOnly | QIODevice::Truncate) &&
+                      tempIndexFile.write(index.data(), indexSize) == indexSize;
+         tempIndexFile.close();
+         if(saved)
+         {
+            QFile::remove(indexPath);
+            saved = QFile::rename(tempIndexPath, indexPath);
+         }
+         if(!saved)
+         {
+            QFile::remove(tempIndexPath);
+         }
+
+         if(!saved || !loadIndex())
+         {
+            // Couldn't save the index (e.g. the directory is read only). Just keep it in memory.
+            QMutexLocker lock(&m_indexMutex);
+            unloadIndex();
+            m_indexMem.swap(index);
+            m_index = m_indexMem.data();
+         }
+      }
+   }
+
+   QMutexLocker lock(&m_indexMutex);
+   m_indexBuildDone = true;
+   return success;
+}
+
+bool outOfCoreRawFile::readSamples(QFile& rawFile, int64_t startIndex, int64_t numSamples, dubVect& channel1, dubVect& channel2)
+{
+   const int64_t blockSize = (int64_t)RAW_TYPE_BLOCK_SIZE[m_rawType];
+   int64_t offset = m_byteOffset + (startIndex * blockSize);
+   int64_t numBytes = numSamples * blockSize;
+   if(numBytes <= 0)
+   {
+      channel1.clear();
+      channel2.clear();
+      return true;
+   }
+
+   const char* bytes = (const char*)rawFile.map(offset, numBytes);
+   if(bytes != NULL)
+   {
+      rawFileToDouble(m_rawType, bytes, (size_t)numBytes, channel1, channel2);
+      rawFile.unmap((uchar*)bytes);
+      return true;
+   }
+
+   // Couldn't map the file, fall back to reading it in.
+   std::vector<char> fileBytes(numBytes);
+   bool success = rawFile.seek(offset) && rawFile.read(fileBytes.data(), numBytes) == numBytes;
+   if(success)
+   {
+      rawFileToDouble(m_rawType, fileBytes.data(), (size_t)numBytes, channel1, channel2);
+   }
+   return success;
+}
+
+tOutOfCoreView outOfCoreRawFile::getView(int64_t startIndex, int64_t stopIndex)
+{
+   startIndex = std::max(std::min(startIndex, m_numSamples), (int64_t)0);
+   stopIndex = std::max(std::min(stopIndex, m_numSamples), startIndex);
+   int64_t width = std::max(stopIndex - startIndex, (int64_t)1);
+
+   // Load some margin on each side so small pans can use the samples that are already loaded.
+   tOutOfCoreView view;
+   view.requestStart = startIndex;
+   view.requestStop = stopIndex;
+   view.loadStart = std::max(startIndex - (width / 2), (int64_t)0);
+   view.loadStop = std::min(stopIndex + (width / 2), m_numSamples);
+
+   if(width <= OUT_OF_CORE_MAX_RAW_VIEW_SAMPLES)
+   {
+      view.level = OUT_OF_CORE_RAW_LEVEL;
+   }
+   else
+   {
+      // Use the most detailed level that doesn't put too many buckets in the view.
+      QMutexLocker lock(&m_indexMutex);
+      const tOutOfCoreIndexHeader* header = (const tOutOfCoreIndexHeader*)m_index;
+      view.level = header != NULL ? (int)header->numLevels - 1 : 0;
+      for(int level = 0; header != NULL && level < (int)header->numLevels; ++level)
+      {
+         if(width / header->samplesPerBucket[level] <= OUT_OF_CORE_MAX_VIEW_BUCKETS)
+         {
+            view.level = level;
+            break;
+         }
+      }
+   }
+   return view;
+}
+
+bool outOfCoreRawFile::viewContains(const tOutOfCoreView& loaded, const tOutOfCoreView& wanted)
+{
+   return loaded.level == wanted.level &&
+          loaded.loadStart <= wanted.requestStart &&
+          loaded.loadStop >= wanted.requestStop;
+}
+
+bool outOfCoreRawFile::readView(const tOutOfCoreView& view, int channel, dubVect& yPoints, tLinear& sourceIndex)
+{
+   if(channel < 0 || channel >= m_numChannels)
+   {
+      return false;
+   }
+
+   if(view.level == OUT_OF_CORE_RAW_LEVEL)
+   {
+      dubVect channels[2];
+      if(!readSamples(m_rawFile, view.loadStart, view.loadStop - view.loadStart, channels[0], channels[1]))
+      {
+         return false;
+      }
+      yPoints.swap(channels[channel]);
+      sourceIndex.m = 1.0;
+      sourceIndex.b = (double)view.loadStart;
+   }
+   else
+   {
+      QMutexLocker lock(&m_indexMutex);
+      const tOutOfCoreIndexHeader* header = (const tOutOfCoreIndexHeader*)m_index;
+      if(header == NULL || view.level < 0 || view.level >= (int)header->numLevels)
+      {
+         return false;
+      }
+
+      // The min and max of each bucket become 2 points. The max is placed half way through the bucket.
+      int64_t samplesPerBucket = header->samplesPerBucket[view.level];
+      int64_t startBucket = view.loadStart / samplesPerBucket;
+      int64_t stopBucket = std::min((view.loadStop + samplesPerBucket - 1) / samplesPerBucket, header->numBuckets[view.level]);
+      const double* buckets = (const double*)(m_index + header->levelOffset[view.level]);
+
+      yPoints.resize(std::max(stopBucket - startBucket, (int64_t)0) * 2);
+      for(int64_t bucket = startBucket; bucket < stopBucket; ++bucket)
+      {
+         const double* minMax = &buckets[(bucket * m_numChannels + channel) * 2];
+         yPoints[(bucket - startBucket) * 2]     = minMax[0];
+         yPoints[(bucket - startBucket) * 2 + 1] = minMax[1];
+      }
+      sourceIndex.m = (double)samplesPerBucket / 2.0;
+      sourceIndex.b = (double)(startBucket * samplesPerBucket);
+   }
+   return yPoints.size() > 0;
+}
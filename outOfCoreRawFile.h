@@ -0,0 +1,98 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef outOfCoreRawFile_h
+#define outOfCoreRawFile_h
+
+#include <stdint.h>
+#include <vector>
+#include <QString>
+#include <QFile>
+#include <QMutex>
+#include "PlotHelperTypes.h"
+#include "rawFileTypes.h"
+
+// Level of detail of an out of core view. Level -1 is the raw samples, level 0 and up are min/max envelopes.
+#define OUT_OF_CORE_RAW_LEVEL (-1)
+
+typedef struct
+{
+   int level;
+   int64_t requestStart; // Source samples that need to be in view.
+   int64_t requestStop;
+   int64_t loadStart; // Source samples that will be loaded (the request plus some margin for panning).
+   int64_t loadStop;
+}tOutOfCoreView;
+
+// A raw file that is too big to be loaded into memory. A multi-level min/max index of the file is saved next
+// to the file (<file>.lod) so reopening the file doesn't require reading through the whole file again. When
+// zoomed out, views are served from the index. When zoomed in far enough, the samples are read from the file.
+class outOfCoreRawFile
+{
+public:
+   outOfCoreRawFile(const QString& filePath, eRawTypes rawType, int64_t byteOffset, int64_t numBytes);
+   ~outOfCoreRawFile();
+
+   // Returns true if the index file exists and matches the raw file.
+   bool loadIndex();
+
+   // Reads through the whole raw file to build the index. This can take a while, call from a worker thread.
+   bool buildIndex();
+
+   bool isIndexReady();
+   bool isIndexBuildDone();
+
+   QString getFilePath(){return m_filePath;}
+   int getNumChannels(){return m_numChannels;}
+   int64_t getNumSamples(){return m_numSamples;} // Per channel.
+   ePlotDataTypes getDataType(){return rawTypeToPlotDataType(m_rawType);}
+
+   // Picks the level of detail for viewing source samples [startIndex, stopIndex).
+   tOutOfCoreView getView(int64_t startIndex, int64_t stopIndex);
+
+   // Returns true if what was loaded for 'loaded' can be used for 'wanted'.
+   static bool viewContains(const tOutOfCoreView& loaded, const tOutOfCoreView& wanted);
+
+   // sourceIndex maps the yPoints index to the source sample index.
+   bool readView(const tOutOfCoreView& view, int channel, dubVect& yPoints, tLinear& sourceIndex);
+
+private:
+   outOfCoreRawFile();
+
+   bool readSamples(QFile& rawFile, int64_t startIndex, int64_t numSamples, dubVect& channel1, dubVect& channel2);
+   QString getIndexFilePath(){return m_filePath + ".lod";}
+   void unloadIndex();
+
+   QString m_filePath;
+   eRawTypes m_rawType;
+   int64_t m_byteOffset;
+   int64_t m_numBytes;
+   int m_numChannels;
+   int64_t m_numSamples;
+
+   QFile m_rawFile; // For reading the samples in view.
+
+   // The index. Either mapped from the index file or held in memory (if the index file couldn't be written).
+   QMutex m_indexMutex;
+   QFile m_indexFile;
+   const char* m_index;
+   std::vector<char> m_indexMem;
+   bool m_indexBuildDone;
+};
+
+#endif
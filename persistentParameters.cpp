@@ -1,4 +1,4 @@
-/* Copyright 2016 - 2017 Dan Williams. All Rights Reserved.
+/* Copyright 2016 - 2017, 2026 Dan Williams. All Rights Reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of this
  * software and associated documentation files (the "Software"), to deal in the Software
@@ -24,7 +24,13 @@
  */
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#include <map>
+#include <vector>
+#include <chrono>
+#include <thread>
 #include <QDir>
+#include <QSaveFile>
 #include "persistentParameters.h"
 #include "FileSystemOperations.h"
 #include "dString.h"
@@ -33,15 +39,153 @@
 static const std::string PERSISTENT_FILE_NAME = "persistentParam.ini";
 static const std::string DELIM = "=";
 
+// Changes are written to disk once no new changes have been made for this long.
+#define PERSISTENT_PARAM_WRITE_DELAY_MS (500)
+
 
 static std::string iniPath = "";
 
+// The ini file is read into memory (in persistentParam_setPath) and gets are served from memory.
+// iniLines is the file contents in order, iniLineIndex maps a parameter name to its line.
+static std::vector<std::string> iniLines;
+static std::map<std::string, size_t> iniLineIndex;
+
+// Parameters that have been set since the last write. Only these are written, on top of whatever
+// is in the file at the time, so parameters set by other plotter instances aren't lost.
+static std::map<std::string, std::string> pendingParams;
+static std::chrono::steady_clock::time_point lastChangeTime;
+static bool writerThreadStarted = false;
+static pthread_t writerThread;
+static pthread_cond_t writerCond = PTHREAD_COND_INITIALIZER;
+
+// Protects all the above.
 static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 
+// Held for the whole read / merge / write so two writes can't undo each other.
+static pthread_mutex_t writeMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+static void parseIniFile(const std::string& path, std::vector<std::string>& lines, std::map<std::string, size_t>& lineIndex)
+{
+   lines.clear();
+   lineIndex.clear();
+
+   std::string endl = dString::GetLineEnding();
+   std::string iniFile = dString::ConvertLineEndingToOS(fso::ReadFile(path));
+   std::vector<std::string> fileLines = dString::SplitV(iniFile, endl);
+   for(size_t i = 0; i < fileLines.size(); ++i)
+   {
+      if(fileLines[i] != "") // Drop empty lines.
+      {
+         int delimPos = dString::InStr(fileLines[i], DELIM);
+         if(delimPos >= 0)
+         {
+            std::string paramName = dString::Left(fileLines[i], delimPos);
+            if(lineIndex.find(paramName) == lineIndex.end()) // If a parameter is in the file more than once, the first one is used.
+            {
+               lineIndex[paramName] = lines.size();
+            }
+         }
+         lines.push_back(fileLines[i]);
+      }
+   }
+}
+
+static void setIniLine(std::vector<std::string>& lines, std::map<std::string, size_t>& lineIndex, const std::string& paramName, const std::string& writeVal)
+{
+   std::string line = paramName + DELIM + writeVal;
+   std::map<std::string, size_t>::iterator iter = lineIndex.find(paramName);
+   if(iter == lineIndex.end())
+   {
+      lineIndex[paramName] = lines.size();
+      lines.push_back(line);
+   }
+   else
+   {
+      lines[iter->second] = line;
+   }
+}
+
+// Writes the parameters that have been set since the last write to the ini file. The file
+// is re-read first and only the set parameters are changed, then it is written to a temp
+// file that is renamed over the ini file, so a crash or full disk mid write can't leave a
+// truncated ini file behind.
+static void writeIniFile()
+{
+   pthread_mutex_lock(&writeMutex);
+
+   pthread_mutex_lock(&mutex);
+   std::map<std::string, std::string> paramsToWrite;
+   paramsToWrite.swap(pendingParams);
+   std::string path = iniPath;
+   pthread_mutex_unlock(&mutex);
+
+   if(paramsToWrite.size() > 0 && path != "")
+   {
+      std::vector<std::string> lines;
+      std::map<std::string, size_t> lineIndex;
+      parseIniFile(path, lines, lineIndex);
+      for(std::map<std::string, std::string>::iterator iter = paramsToWrite.begin(); iter != paramsToWrite.end(); ++iter)
+      {
+         setIniLine(lines, lineIndex, iter->first, iter->second);
+      }
+
+      std::string iniFile = dString::JoinV(lines, dString::GetLineEnding());
+      QSaveFile saveFile(QString::fromStdString(fso::dirSepToOS(path)));
+      if(saveFile.open(QIODevice::WriteOnly))
+      {
+         saveFile.write(iniFile.c_str(), iniFile.size());
+         saveFile.commit();
+      }
+
+      // Pick up any parameters other plotter instances have written. Parameters set
+      // since this write started are still pending, keep them on top.
+      pthread_mutex_lock(&mutex);
+      if(path == iniPath)
+      {
+         iniLines.swap(lines);
+         iniLineIndex.swap(lineIndex);
+         for(std::map<std::string, std::string>::iterator iter = pendingParams.begin(); iter != pendingParams.end(); ++iter)
+         {
+            setIniLine(iniLines, iniLineIndex, iter->first, iter->second);
+         }
+      }
+      pthread_mutex_unlock(&mutex);
+   }
+
+   pthread_mutex_unlock(&writeMutex);
+}
+
+static void* writerThreadFunc(void*)
+{
+   while(true)
+   {
+      pthread_mutex_lock(&mutex);
+      while(pendingParams.size() == 0)
+      {
+         pthread_cond_wait(&writerCond, &mutex);
+      }
+
+      // Wait for the changes to settle, dialogs tend to set several parameters in a row.
+      std::chrono::steady_clock::time_point writeTime;
+      while((writeTime = lastChangeTime + std::chrono::milliseconds(PERSISTENT_PARAM_WRITE_DELAY_MS)) > std::chrono::steady_clock::now())
+      {
+         pthread_mutex_unlock(&mutex);
+         std::this_thread::sleep_until(writeTime);
+         pthread_mutex_lock(&mutex);
+      }
+      pthread_mutex_unlock(&mutex);
+
+      writeIniFile();
+   }
+   return NULL;
+}
+
 void persistentParam_setPath(std::string path)
 {
+   persistentParam_flush(); // Write out any changes to the old path first.
+
    pthread_mutex_lock(&mutex);
-   
    if(fso::FileExists(path))
    {
       std::string ext = dString::Lower(fso::GetExt(path));
@@ -81,55 +225,51 @@ void persistentParam_setPath(std::string path)
       std::string iniFileInit = "";
       fso::WriteFile(iniPath, iniFileInit);
    }
+   pendingParams.clear();
+   iniLines.clear();
+   iniLineIndex.clear();
+   if(iniPath != "")
+   {
+      parseIniFile(iniPath, iniLines, iniLineIndex);
+   }
    pthread_mutex_unlock(&mutex);
 }
 
+void persistentParam_flush()
+{
+   writeIniFile();
+}
+
 bool persistentParam_setParam_str(const std::string& paramName, std::string writeVal)
 {
    bool success = false;
-   if(fso::FileExists(iniPath))
+   bool writeNow = false;
+   pthread_mutex_lock(&mutex);
+   if(iniPath != "")
    {
-      pthread_mutex_lock(&mutex);
+      // Write even if the value matches the in-memory copy, another plotter instance might have written a different value to the file.
+      setIniLine(iniLines, iniLineIndex, paramName, writeVal);
+      pendingParams[paramName] = writeVal;
+      lastChangeTime = std::chrono::steady_clock::now();
+      if(writerThreadStarted == false)
       {
-         std::string searchStr = paramName + DELIM;
-         std::string iniFile = dString::ConvertLineEndingToOS(fso::ReadFile(iniPath));
-         std::string endl = dString::GetLineEnding();
-         
-         std::vector<std::string> lines = dString::SplitV(iniFile, endl);
-         bool paramNameExistsInLines = false;
-         for(size_t i = 0; i < lines.size(); ++i)
+         writerThreadStarted = pthread_create(&writerThread, NULL, writerThreadFunc, NULL) == 0;
+         if(writerThreadStarted)
          {
-            if(dString::Left(lines[i], searchStr.size()) == searchStr)
-            {
-               paramNameExistsInLines = true;
-               lines[i] = searchStr + writeVal;
-               break;
-            }
+            pthread_detach(writerThread);
          }
-         
-         iniFile = dString::JoinV(lines, endl);
-         if(paramNameExistsInLines == false)
-         {
-            iniFile = iniFile + endl + searchStr + writeVal;
-         }      
-         
-         // Remove any double line endings.
-         std::string twoEndl = endl + endl;
-         while(dString::InStr(iniFile, twoEndl) >= 0)
-         {
-            iniFile = dString::Replace(iniFile, twoEndl, endl);
-         }
-         // Don't start or end with endl.
-         iniFile = dString::DontStartWithThis(iniFile, endl);
-         iniFile = dString::DontEndWithThis(iniFile, endl);
-   
-         fso::WriteFile(iniPath, iniFile);
-         
-         success = true;
       }
-      pthread_mutex_unlock(&mutex); 
+      pthread_cond_signal(&writerCond);
+      writeNow = writerThreadStarted == false; // If the writer thread couldn't be started, write now.
+      success = true;
    }
-   
+   pthread_mutex_unlock(&mutex);
+
+   if(writeNow)
+   {
+      writeIniFile();
+   }
+
    return success;
 }
 bool persistentParam_setParam_f64(const std::string& paramName, double writeVal)
@@ -142,28 +282,14 @@ bool persistentParam_setParam_f64(const std::string& paramName, double writeVal)
 bool persistentParam_getParam_str(const std::string& paramName, std::string& retVal)
 {
    bool success = false;
-   if(fso::FileExists(iniPath))
+   pthread_mutex_lock(&mutex);
+   std::map<std::string, size_t>::iterator iter = iniLineIndex.find(paramName);
+   if(iter != iniLineIndex.end())
    {
-      pthread_mutex_lock(&mutex);
-      std::string endl = dString::GetLineEnding();
-      std::string searchStr = endl + paramName + DELIM;
-      
-      std::string iniFile = dString::ConvertLineEndingToOS(fso::ReadFile(iniPath));
-      iniFile = dString::DontStartWithThis(iniFile, endl);
-      iniFile = dString::DontEndWithThis(iniFile, endl);
-      
-      // Make sure iniFile starts and ends with line ending for easier searching in the following lines.
-      iniFile = endl + iniFile + endl;
-      
-      if(dString::InStr(iniFile, paramName) >= 0)
-      {
-         std::string temp = iniFile;
-         retVal = dString::GetMiddle(&temp, searchStr, endl);
-         success = true;
-      }
-      
-      pthread_mutex_unlock(&mutex);
+      retVal = iniLines[iter->second].substr(paramName.size() + DELIM.size());
+      success = true;
    }
+   pthread_mutex_unlock(&mutex);
 
    return success;
 }
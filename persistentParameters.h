@@ -1,4 +1,4 @@
-/* Copyright 2016 - 2017, 2019 - 2021, 2024 Dan Williams. All Rights Reserved.
+/* Copyright 2016 - 2017, 2019 - 2021, 2024, 2026 Dan Williams. All Rights Reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of this
  * software and associated documentation files (the "Software"), to deal in the Software
@@ -50,6 +50,10 @@ static const std::string PERSIST_PARAM_OPEN_RAW_SAMP_RATE = "openRawSampRate";
 
 void persistentParam_setPath(std::string path);
 
+// Sets are written to disk in the background a short time after the last change.
+// Call this before exiting to write out any changes that haven't been written yet.
+void persistentParam_flush();
+
 bool persistentParam_setParam_str(const std::string& paramName, std::string writeVal);
 bool persistentParam_setParam_f64(const std::string& paramName, double writeVal);
 
@@ -0,0 +1,343 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <QApplication>
+#include <QAbstractEventDispatcher>
+#include "plotMsgReplay.h"
+#include "plotguimain.h"
+#include "flightRecorder.h"
+#include "sendTCPPacket.h"
+#include "plotMsgPack.h"
+
+#define REPLAY_SYNTH_NUM_CURVES (4)
+
+// How long to keep trying to connect to the TCP server while the plotter starts up.
+#define REPLAY_TCP_CONNECT_TRIES (100)
+#define REPLAY_TCP_CONNECT_RETRY_MS (100)
+
+// How long to wait for the plotter to work through the messages after the last one is sent.
+#define REPLAY_FINISH_TIMEOUT_MS (60*1000)
+#define REPLAY_FINISH_POLL_MS (10)
+
+
+void plotMsgReplay_setDefaultParams(tPlotMsgReplayParams* params)
+{
+   params->source = PLOT_MSG_REPLAY_SYNTHETIC_SOURCE;
+   params->speed = 1.0;
+   params->target = E_REPLAY_TARGET_DIRECT;
+   params->tcpPort = 2000;
+   params->exitWhenDone = false;
+   params->synthNumMsgs = 100000;
+   params->synthSamplesPerMsg = 1000;
+   params->synthMsgsPerSec = 1000;
+}
+
+static double nsToUs(int64_t ns)
+{
+   return (double)ns / 1000.0;
+}
+
+static void printLatency(const char* stageName, const tIngestLatency& latency)
+{
+   double avgUs = latency.count > 0 ? nsToUs(latency.totalNs) / (double)latency.count : 0.0;
+   printf("   %-12s avg %10.1f us   max %10.1f us\n", stageName, avgUs, nsToUs(latency.maxNs));
+}
+
+
+PlotMsgReplay::PlotMsgReplay(plotGuiMain* pgm, const tPlotMsgReplayParams& params):
+   m_pgm(pgm),
+   m_params(params),
+   m_abort(false),
+   m_guiIdleNs(0),
+   m_guiBlockStartNs(-1),
+   m_success(false),
+   m_numMsgsSent(0),
+   m_elapsedNs(0),
+   m_guiBusyNs(0)
+{
+   m_timer.start();
+
+   // Must be constructed in the GUI thread, so the slots run in the GUI thread.
+   QObject::connect(this, SIGNAL(replayDoneSignal()),
+                    this, SLOT(replayDoneSlot()), Qt::QueuedConnection);
+
+   QAbstractEventDispatcher* guiDispatcher = QAbstractEventDispatcher::instance();
+   if(guiDispatcher != NULL)
+   {
+      QObject::connect(guiDispatcher, SIGNAL(aboutToBlock()),
+                       this, SLOT(guiAboutToBlockSlot()), Qt::DirectConnection);
+      QObject::connect(guiDispatcher, SIGNAL(awake()),
+                       this, SLOT(guiAwakeSlot()), Qt::DirectConnection);
+   }
+}
+
+PlotMsgReplay::~PlotMsgReplay()
+{
+   m_abort = true;
+   wait();
+}
+
+void PlotMsgReplay::run()
+{
+   if(m_params.source == PLOT_MSG_REPLAY_SYNTHETIC_SOURCE)
+   {
+      createSyntheticMsgs();
+   }
+   else if(!loadRecording())
+   {
+      printf("Replay: no plot messages found in \"%s\"\n", m_params.source.c_str());
+   }
+
+   int sockfd = -1;
+   if(m_msgs.size() > 0 && m_params.target == E_REPLAY_TARGET_TCP)
+   {
+      // The plotter's TCP server might not be up yet.
+      for(int tryCount = 0; sockfd < 0 && tryCount < REPLAY_TCP_CONNECT_TRIES && !m_abort; ++tryCount)
+      {
+         sockfd = sendTCPPacket_init_and_print("127.0.0.1", m_params.tcpPort, 0);
+         if(sockfd < 0)
+         {
+            QThread::msleep(REPLAY_TCP_CONNECT_RETRY_MS);
+         }
+      }
+      if(sockfd < 0)
+      {
+         printf("Replay: unable to connect to TCP port %u\n", (unsigned int)m_params.tcpPort);
+         m_msgs.clear();
+      }
+   }
+
+   if(m_msgs.size() > 0)
+   {
+      m_pgm->resetIngestStats();
+      qint64 startTimeNs = m_timer.nsecsElapsed();
+      qint64 startGuiIdleNs = getGuiIdleNs();
+
+      bool sendFailed = false;
+      for(size_t i = 0; i < m_msgs.size() && !sendFailed && !m_abort; ++i)
+      {
+         if(m_params.speed > 0)
+         {
+            waitUntil(startTimeNs + (qint64)((double)m_msgs[i].timeUs * 1000.0 / m_params.speed));
+         }
+
+         if(m_params.target == E_REPLAY_TARGET_TCP)
+         {
+            sendFailed = !sendTcp(sockfd, m_msgs[i].msg.msgPtr, m_msgs[i].msg.msgSize);
+         }
+         else
+         {
+            tIncomingMsg inMsg = m_msgs[i].msg; // startPlotMsgProcess doesn't take a const pointer.
+            m_pgm->startPlotMsgProcess(&inMsg);
+         }
+         m_numMsgsSent += sendFailed ? 0 : 1;
+      }
+
+      if(sockfd >= 0)
+      {
+         sendTCPPacket_close(sockfd);
+      }
+
+      m_success = !sendFailed && waitForPlotterToFinish();
+      m_elapsedNs = m_timer.nsecsElapsed() - startTimeNs;
+      m_guiBusyNs = m_elapsedNs - (getGuiIdleNs() - startGuiIdleNs);
+   }
+
+   m_msgs.clear();
+   emit replayDoneSignal();
+}
+
+bool PlotMsgReplay::loadRecording()
+{
+   FlightRecorderReader reader(m_params.source);
+   tReplayMsg replayMsg;
+   int64_t firstTimeUs = 0;
+   while(reader.readNext(&replayMsg.msg, &replayMsg.timeUs))
+   {
+      if(m_msgs.size() == 0)
+      {
+         firstTimeUs = replayMsg.timeUs;
+      }
+      replayMsg.timeUs -= firstTimeUs;
+      m_msgs.push_back(replayMsg);
+   }
+   return m_msgs.size() > 0;
+}
+
+void PlotMsgReplay::createSyntheticMsgs()
+{
+   unsigned int numSamp = std::max(m_params.synthSamplesPerMsg, 1u);
+   unsigned int msgsPerSec = std::max(m_params.synthMsgsPerSec, 1u);
+   std::vector<FLOAT_32> samples(numSamp);
+   std::string curveNames[REPLAY_SYNTH_NUM_CURVES];
+   UINT_32 sampleStartIndex[REPLAY_SYNTH_NUM_CURVES];
+
+   for(unsigned int i = 0; i < REPLAY_SYNTH_NUM_CURVES; ++i)
+   {
+      curveNames[i] = "curve" + std::to_string(i);
+      sampleStartIndex[i] = 0;
+   }
+
+   m_msgs.resize(m_params.synthNumMsgs);
+   for(unsigned int msgIndex = 0; msgIndex < m_params.synthNumMsgs; ++msgIndex)
+   {
+      unsigned int curveIndex = msgIndex % REPLAY_SYNTH_NUM_CURVES;
+
+      t1dPlot param;
+      param.plotName = "replay";
+      param.curveName = curveNames[curveIndex].c_str();
+      param.numSamp = numSamp;
+      param.yAxisType = E_FLOAT_32;
+
+      for(unsigned int i = 0; i < numSamp; ++i)
+      {
+         samples[i] = (FLOAT_32)sin((double)(sampleStartIndex[curveIndex] + i) * 0.01 + (double)curveIndex);
+      }
+
+      std::shared_ptr<std::vector<char> > msgBuff = std::make_shared<std::vector<char> >(getUpdatePlot1dMsgSize(&param));
+      packUpdate1dPlotMsg(&param, sampleStartIndex[curveIndex], samples.data(), msgBuff->data());
+      sampleStartIndex[curveIndex] += numSamp;
+
+      tReplayMsg& replayMsg = m_msgs[msgIndex];
+      replayMsg.timeUs = (int64_t)msgIndex * 1000000 / msgsPerSec;
+      replayMsg.msg.msgPtr = msgBuff->data();
+      replayMsg.msg.msgSize = (unsigned int)msgBuff->size();
+      replayMsg.msg.ipAddr = tPlotterIpAddr((tPlotterIpAddr::tIpV4)0x7F000001); // 127.0.0.1
+      replayMsg.msg.msgBuff = msgBuff;
+   }
+}
+
+void PlotMsgReplay::waitUntil(qint64 timeNs)
+{
+   qint64 waitNs = timeNs - m_timer.nsecsElapsed();
+   if(waitNs > 0)
+   {
+      std::this_thread::sleep_for(std::chrono::nanoseconds(waitNs));
+   }
+}
+
+bool PlotMsgReplay::sendTcp(int sockfd, const char* msg, unsigned int size)
+{
+   // Large messages might only be partially sent.
+   while(size > 0)
+   {
+      int numSent = sendTCPPacket_send(sockfd, msg, size);
+      if(numSent <= 0)
+      {
+         printf("Replay: TCP send failed\n");
+         return false;
+      }
+      msg += numSent;
+      size -= (unsigned int)numSent;
+   }
+   return true;
+}
+
+bool PlotMsgReplay::waitForPlotterToFinish()
+{
+   qint64 timeoutNs = m_timer.nsecsElapsed() + (qint64)REPLAY_FINISH_TIMEOUT_MS * 1000 * 1000;
+   while(m_timer.nsecsElapsed() < timeoutNs && !m_abort)
+   {
+      tIngestStats stats = m_pgm->getIngestStats();
+      // Done once every message has been handed to the plot windows and the plot windows
+      // have put all the samples on the plots.
+      if( stats.numMsgs >= m_numMsgsSent &&
+          stats.numMsgsDispatched + stats.numQueueDrops >= stats.numMsgsQueued &&
+          stats.numGroupsDone + stats.numGroupsDropped >= stats.numGroupsQueued )
+      {
+         return true;
+      }
+      QThread::msleep(REPLAY_FINISH_POLL_MS);
+   }
+   printf("Replay: timed out waiting for the plotter to process the messages\n");
+   return false;
+}
+
+qint64 PlotMsgReplay::getGuiIdleNs()
+{
+   // Include the time the GUI thread has been blocked so far if it is blocked right now.
+   qint64 blockStartNs = m_guiBlockStartNs;
+   qint64 idleNs = m_guiIdleNs;
+   if(blockStartNs >= 0)
+   {
+      idleNs += m_timer.nsecsElapsed() - blockStartNs;
+   }
+   return idleNs;
+}
+
+void PlotMsgReplay::guiAboutToBlockSlot()
+{
+   m_guiBlockStartNs = m_timer.nsecsElapsed();
+}
+
+void PlotMsgReplay::guiAwakeSlot()
+{
+   qint64 blockStartNs = m_guiBlockStartNs;
+   if(blockStartNs >= 0)
+   {
+      // Update the total before clearing the start time, so getGuiIdleNs never skips the blocked time.
+      m_guiIdleNs += m_timer.nsecsElapsed() - blockStartNs;
+      m_guiBlockStartNs = -1;
+   }
+}
+
+void PlotMsgReplay::replayDoneSlot()
+{
+   wait(); // The replay thread is done once it emits replayDoneSignal.
+
+   if(m_numMsgsSent > 0)
+   {
+      tIngestStats stats = m_pgm->getIngestStats();
+      double seconds = std::max((double)m_elapsedNs / 1e9, 1e-9);
+
+      char speedStr[32] = "max";
+      if(m_params.speed > 0)
+      {
+         snprintf(speedStr, sizeof(speedStr), "%gx", m_params.speed);
+      }
+
+      printf("Replay of \"%s\" at %s speed via %s%s\n",
+             m_params.source.c_str(),
+             speedStr,
+             m_params.target == E_REPLAY_TARGET_TCP ? "TCP" : "direct",
+             m_success ? "" : " (incomplete)");
+      printf("   msgs sent    %llu\n", (unsigned long long)m_numMsgsSent);
+      printf("   msgs/s       %.1f\n", (double)stats.numMsgs / seconds);
+      printf("   samples/s    %.1f\n", (double)stats.numSamples / seconds);
+      printf("   queue drops  %llu of %llu queued\n", (unsigned long long)stats.numQueueDrops, (unsigned long long)stats.numMsgsQueued);
+      printf("   GUI busy     %.1f%% of %.3f s\n", 100.0 * (double)m_guiBusyNs / (double)std::max(m_elapsedNs, (qint64)1), seconds);
+      printLatency("unpack", stats.unpack);
+      printLatency("queue wait", stats.queueWait);
+      printLatency("dispatch", stats.dispatch);
+      printLatency("plot ingest", stats.ingest);
+      printLatency("plot apply", stats.apply);
+      fflush(stdout);
+   }
+
+   if(m_params.exitWhenDone)
+   {
+      QApplication::quit();
+   }
+}
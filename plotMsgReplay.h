@@ -0,0 +1,112 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef plotMsgReplay_h
+#define plotMsgReplay_h
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include <QObject>
+#include <QThread>
+#include <QElapsedTimer>
+#include "PlotHelperTypes.h"
+
+class plotGuiMain;
+
+#define PLOT_MSG_REPLAY_SYNTHETIC_SOURCE "synthetic"
+
+typedef enum
+{
+   E_REPLAY_TARGET_DIRECT, // Call plotGuiMain::startPlotMsgProcess directly, skipping the sockets.
+   E_REPLAY_TARGET_TCP     // Send to this plotter's own TCP server port.
+}eReplayTarget;
+
+typedef struct
+{
+   std::string source; // Flight recorder directory or PLOT_MSG_REPLAY_SYNTHETIC_SOURCE.
+   double speed;       // 1.0 = recorded rate, N = N times the recorded rate, 0 = as fast as possible.
+   eReplayTarget target;
+   unsigned short tcpPort;
+   bool exitWhenDone;
+
+   // Only used for the synthetic source.
+   unsigned int synthNumMsgs;
+   unsigned int synthSamplesPerMsg;
+   unsigned int synthMsgsPerSec; // Message rate at 1x speed.
+}tPlotMsgReplayParams;
+
+void plotMsgReplay_setDefaultParams(tPlotMsgReplayParams* params);
+
+
+// Drives a recorded or synthetic plot message stream into the plotter and reports the
+// ingest throughput and per stage latency. The messages are all loaded / packed before
+// the replay starts so the timing only covers the plotter itself.
+class PlotMsgReplay : public QThread
+{
+   Q_OBJECT
+public:
+   PlotMsgReplay(plotGuiMain* pgm, const tPlotMsgReplayParams& params);
+   ~PlotMsgReplay();
+
+private:
+   PlotMsgReplay();
+   PlotMsgReplay(PlotMsgReplay const&);
+   void operator=(PlotMsgReplay const&);
+
+   typedef struct
+   {
+      int64_t timeUs; // Relative to the first message.
+      tIncomingMsg msg;
+   }tReplayMsg;
+
+   void run();
+   bool loadRecording();
+   void createSyntheticMsgs();
+   void waitUntil(qint64 timeNs);
+   bool sendTcp(int sockfd, const char* msg, unsigned int size);
+   bool waitForPlotterToFinish();
+   qint64 getGuiIdleNs();
+
+   plotGuiMain* m_pgm;
+   tPlotMsgReplayParams m_params;
+   std::vector<tReplayMsg> m_msgs;
+
+   QElapsedTimer m_timer;
+   std::atomic<bool> m_abort; // Set if the plotter is closed before the replay is done.
+
+   // Written by the GUI thread, read by the replay thread.
+   std::atomic<qint64> m_guiIdleNs;
+   std::atomic<qint64> m_guiBlockStartNs; // -1 when the GUI thread is awake.
+
+   // Results, set by the replay thread before replayDoneSignal.
+   bool m_success;
+   uint64_t m_numMsgsSent;
+   qint64 m_elapsedNs;
+   qint64 m_guiBusyNs;
+
+signals:
+   void replayDoneSignal();
+
+private slots:
+   void replayDoneSlot();
+   void guiAboutToBlockSlot();
+   void guiAwakeSlot();
+};
+
+#endif
@@ -17,6 +17,7 @@
  * DEALINGS IN THE SOFTWARE.
  */
 #include <string>
+#include <algorithm>
 #include <QProcess>
 #include <QMessageBox>
 #include <thread>
@@ -34,10 +35,22 @@
 
 #define MAX_NUM_MSGS_IN_QUEUE (1000)
 
+extern std::string g_flightRecorderDir;
+extern uint64_t g_flightRecorderFileSize;
+extern unsigned int g_flightRecorderNumFiles;
+
+static void addIngestLatency(tIngestLatency& latency, qint64 timeNs)
+{
+   ++latency.count;
+   latency.totalNs += timeNs;
+   latency.maxNs = std::max(latency.maxNs, (int64_t)timeNs);
+}
+
 
 plotGuiMain::plotGuiMain(QWidget *parent, std::vector<unsigned short> tcpPorts, bool showTrayIcon) :
    QMainWindow(parent),
    ui(new Ui::plotGuiMain),
+   m_flightRecorder(NULL),
    m_trayIcon(NULL),
    m_trayExitAction("Exit", this),
    m_trayEnDisNewCurvesAction("Disable New Curves", this),
@@ -50,13 +63,14 @@ plotGuiMain::plotGuiMain(QWidget *parent, std::vector<unsigned short> tcpPorts,
    m_updateBinaryAction("Update", this),
    m_trayMenu(NULL),
    m_curveCommander(this),
-   m_allowNewCurves(true),
-   m_storedMsgBuff(g_maxTcpPlotMsgSize),
-   m_storedMsgBuffIndex(0)
+   m_allowNewCurves(true)
 {
     ui->setupUi(this);
     this->setFixedSize(165, 95);
 
+    memset(&m_ingestStats, 0, sizeof(m_ingestStats));
+    m_ingestTimer.start();
+
     QObject::connect(this, SIGNAL(readPlotMsgSignal()),
                      this, SLOT(readPlotMsgSlot()), Qt::QueuedConnection);
 
@@ -66,6 +80,12 @@ plotGuiMain::plotGuiMain(QWidget *parent, std::vector<unsigned short> tcpPorts,
     QObject::connect(this, SIGNAL(closeAllPlotsSafeRetrySignal()),
                      this, SLOT(closeAllPlotsSafeRetrySlot()), Qt::QueuedConnection);
 
+    // The flight recorder needs to exist before any messages can be received.
+    if(g_flightRecorderDir != "")
+    {
+       m_flightRecorder = new FlightRecorder(g_flightRecorderDir, g_flightRecorderFileSize, g_flightRecorderNumFiles);
+    }
+
     if(tcpPorts.size() > 0)
     {
        for(size_t i = 0; i < tcpPorts.size(); ++i)
@@ -135,6 +155,11 @@ plotGuiMain::~plotGuiMain()
        delete m_tcpMsgReaders[i];
     }
 
+    if(m_flightRecorder != NULL)
+    {
+       delete m_flightRecorder; // Writes out any messages that are still queued.
+    }
+
     if(m_trayIcon != NULL)
     {
        delete m_trayIcon;
@@ -250,56 +275,92 @@ void plotGuiMain::updateBinarySlot()
    }
 }
 
+tIngestStats plotGuiMain::getIngestStats()
+{
+   QMutexLocker lock(&m_multiPlotMsgsQueueMutex);
+   return m_ingestStats;
+}
+
+void plotGuiMain::resetIngestStats()
+{
+   QMutexLocker lock(&m_multiPlotMsgsQueueMutex);
+   memset(&m_ingestStats, 0, sizeof(m_ingestStats));
+}
+
+void plotGuiMain::plotMsgGroupQueued()
+{
+   QMutexLocker lock(&m_multiPlotMsgsQueueMutex);
+   ++m_ingestStats.numGroupsQueued;
+}
+
+void plotGuiMain::plotMsgGroupDone(qint64 ingestNs, qint64 applyNs)
+{
+   QMutexLocker lock(&m_multiPlotMsgsQueueMutex);
+   ++m_ingestStats.numGroupsDone;
+   addIngestLatency(m_ingestStats.ingest, ingestNs);
+   addIngestLatency(m_ingestStats.apply, applyNs);
+}
+
+void plotGuiMain::plotMsgGroupDropped()
+{
+   QMutexLocker lock(&m_multiPlotMsgsQueueMutex);
+   ++m_ingestStats.numGroupsDropped;
+}
+
 void plotGuiMain::startPlotMsgProcess(tIncomingMsg* inMsg)
 {
    const char* msg = inMsg->msgPtr;
    unsigned int size = inMsg->msgSize;
+   qint64 startTimeNs = m_ingestTimer.nsecsElapsed();
 
-   m_curveCommander.getIpBlocker()->addIpAddrToList(inMsg->ipAddr); // Store off the IP address
+   m_multiPlotMsgsQueueMutex.lock();
+   ++m_ingestStats.numMsgs;
+   m_multiPlotMsgsQueueMutex.unlock();
 
-   // g_maxTcpPlotMsgSize can be set via .ini file. Make sure the buffer is big enough to store a "max sized" message.
-   if(m_storedMsgBuff.size() < g_maxTcpPlotMsgSize)
-      m_storedMsgBuff.resize(g_maxTcpPlotMsgSize);
+   m_curveCommander.getIpBlocker()->addIpAddrToList(inMsg->ipAddr); // Store off the IP address
 
-   if(m_allowNewCurves == true && size <= m_storedMsgBuff.size())
+   // g_maxTcpPlotMsgSize can be set via .ini file.
+   if(m_allowNewCurves == true && size <= g_maxTcpPlotMsgSize)
    {
-      m_storedMsgBuffMutex.lock(); // Make sure multiple threads cannot modify buffer at same time
-
-      // Make sure new message won't overrun the buffer.
-      if( ((int64_t)m_storedMsgBuffIndex + (int64_t)size) > (int64_t)m_storedMsgBuff.size() )
-      {
-         m_storedMsgBuffIndex = 0;
-      }
-
-      char* msgCopy = m_storedMsgBuff.data()+m_storedMsgBuffIndex;
-      memcpy(msgCopy, msg, size);
+      tIncomingMsg msgToUnpack = *inMsg;
 
-      // Update index to position for next packet (make sure index is mod 4)
-      m_storedMsgBuffIndex = (m_storedMsgBuffIndex + size + 3) & (~3);
-      if( m_storedMsgBuffIndex >= m_storedMsgBuff.size() )
+      // Messages from the socket reassembly already own their buffer, just take a reference to it.
+      // Only copy if the caller still owns the memory (i.e. it may be freed after this function returns).
+      if(msgToUnpack.msgBuff == nullptr)
       {
-         m_storedMsgBuffIndex = 0;
+         msgToUnpack.msgBuff = std::make_shared<const std::vector<char> >(msg, msg + size);
+         msgToUnpack.msgPtr = msgToUnpack.msgBuff->data();
       }
 
-      m_storedMsgBuffMutex.unlock();
-
-      tIncomingMsg msgToUnpack = *inMsg;
-      msgToUnpack.msgPtr = msgCopy;
-
       UnpackMultiPlotMsg* msgUnpacker = new UnpackMultiPlotMsg(&msgToUnpack);
       if(msgUnpacker->m_plotMsgs.size() > 0)
       {
+         uint64_t numSamples = 0;
+         for(std::map<std::string, plotMsgGroup*>::iterator allMsgs = msgUnpacker->m_plotMsgs.begin(); allMsgs != msgUnpacker->m_plotMsgs.end(); ++allMsgs)
+         {
+            UnpackPlotMsgPtrList& plotMsgs = allMsgs->second->m_plotMsgs;
+            for(UnpackPlotMsgPtrList::iterator plotMsg = plotMsgs.begin(); plotMsg != plotMsgs.end(); ++plotMsg)
+            {
+               numSamples += (*plotMsg)->m_yAxisValues.size();
+            }
+         }
+
          bool msgPopped = false;
+         tQueuedPlotMsg queuedMsg = {msgUnpacker, m_ingestTimer.nsecsElapsed()};
          m_multiPlotMsgsQueueMutex.lock();
          // If the queue of plot messages is getting too big (i.e. we aren't keeping up)
          // remove the oldest messages from the queue (i.e. drop them on the ground).
          while(m_multiPlotMsgs.size() > MAX_NUM_MSGS_IN_QUEUE)
          {
-            delete m_multiPlotMsgs.front();
+            delete m_multiPlotMsgs.front().plotMsg;
             m_multiPlotMsgs.pop();
             msgPopped = true;
+            ++m_ingestStats.numQueueDrops;
          }
-         m_multiPlotMsgs.push(msgUnpacker);
+         m_multiPlotMsgs.push(queuedMsg);
+         ++m_ingestStats.numMsgsQueued;
+         m_ingestStats.numSamples += numSamples;
+         addIngestLatency(m_ingestStats.unpack, queuedMsg.queuedTimeNs - startTimeNs);
          m_multiPlotMsgsQueueMutex.unlock();
 
          // If a message has been popped off the queue, then there is no reason to
@@ -324,17 +385,24 @@ void plotGuiMain::readPlotMsgSlot()
 
    while(finishedReading == false)
    {
+      qint64 queuedTimeNs = 0;
       m_multiPlotMsgsQueueMutex.lock();
       if(m_multiPlotMsgs.size() > 0)
       {
-         plotMsg = m_multiPlotMsgs.front();
+         plotMsg = m_multiPlotMsgs.front().plotMsg;
+         queuedTimeNs = m_multiPlotMsgs.front().queuedTimeNs;
          m_multiPlotMsgs.pop();
       }
       m_multiPlotMsgsQueueMutex.unlock();
 
+      qint64 readStartTimeNs = m_ingestTimer.nsecsElapsed();
       readPlotMsg(plotMsg);
+      qint64 readEndTimeNs = m_ingestTimer.nsecsElapsed();
 
       m_multiPlotMsgsQueueMutex.lock();
+      ++m_ingestStats.numMsgsDispatched;
+      addIngestLatency(m_ingestStats.queueWait, readStartTimeNs - queuedTimeNs);
+      addIngestLatency(m_ingestStats.dispatch, readEndTimeNs - readStartTimeNs);
       finishedReading = m_multiPlotMsgs.size() == 0;
       m_multiPlotMsgsQueueMutex.unlock();
    }
@@ -393,10 +461,11 @@ void plotGuiMain::readPlotMsg(UnpackMultiPlotMsg* plotMsg)
          for(UnpackPlotMsgPtrList::iterator plotMsgs = group->m_plotMsgs.begin(); plotMsgs != group->m_plotMsgs.end(); ++plotMsgs)
          {
             // Grab the parameters needed for storePlotMsg.
+            tPlotMsgBuffPtr msgBuff( (*plotMsgs)->GetMsgBuff() );
             const char* msgPtr( (*plotMsgs)->GetMsgPtr() );
             unsigned int msgSize( (*plotMsgs)->GetMsgPtrSize() );
             QString curveName( (*plotMsgs)->m_curveName.c_str() );
-            m_curveCommander.storePlotMsg(msgPtr, msgSize, plotName, curveName);
+            m_curveCommander.storePlotMsg(msgBuff, msgPtr, msgSize, plotName, curveName);
          }
       }
 
@@ -406,9 +475,9 @@ void plotGuiMain::readPlotMsg(UnpackMultiPlotMsg* plotMsg)
    delete plotMsg;
 }
 
-void plotGuiMain::restorePlotMsg(const char *msg, unsigned int size, tPlotCurveName plotCurveName)
+void plotGuiMain::restorePlotMsg(tPlotMsgBuffPtr msgBuff, const char *msg, unsigned int size, tPlotCurveName plotCurveName)
 {
-   UnpackMultiPlotMsg* plotMsg = new UnpackMultiPlotMsg(msg, size, plotCurveName.plot.toStdString());
+   UnpackMultiPlotMsg* plotMsg = new UnpackMultiPlotMsg(msg, size, plotCurveName.plot.toStdString(), msgBuff);
    if(plotMsg->m_plotMsgs.size() > 0)
    {
       // Change all plot/curve names that were read from the unpacked message to the plot/curve names passed into this function.
@@ -422,8 +491,10 @@ void plotGuiMain::restorePlotMsg(const char *msg, unsigned int size, tPlotCurveN
          }
       }
 
+      tQueuedPlotMsg queuedMsg = {plotMsg, m_ingestTimer.nsecsElapsed()};
       m_multiPlotMsgsQueueMutex.lock();
-      m_multiPlotMsgs.push(plotMsg);
+      m_multiPlotMsgs.push(queuedMsg);
+      ++m_ingestStats.numMsgsQueued;
       m_multiPlotMsgsQueueMutex.unlock();
       emit readPlotMsgSignal();
    }
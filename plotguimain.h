@@ -31,12 +31,14 @@
 #include <QMap>
 #include <QSemaphore>
 #include <QMutex>
+#include <QElapsedTimer>
 
 #include "mainwindow.h"
 #include "TCPMsgReader.h"
 #include "PlotHelperTypes.h"
 #include "CurveData.h"
 #include "CurveCommander.h"
+#include "flightRecorder.h"
 
 class createFFTPlot;
 
@@ -44,6 +46,35 @@ namespace Ui {
 class plotGuiMain;
 }
 
+// Plot message ingest counters, used to measure throughput (see PlotMsgReplay). Times are in nanoseconds.
+typedef struct
+{
+   uint64_t count;
+   int64_t totalNs;
+   int64_t maxNs;
+}tIngestLatency;
+
+typedef struct
+{
+   uint64_t numMsgs;          // Messages passed to startPlotMsgProcess.
+   uint64_t numMsgsQueued;    // Messages queued for the GUI thread.
+   uint64_t numSamples;       // Samples in the queued messages.
+   uint64_t numQueueDrops;    // Queued messages dropped because the GUI thread wasn't keeping up.
+   uint64_t numMsgsDispatched; // Queued messages the GUI thread has handed to the plot windows.
+
+   // Each message is split into one group per plot. The plot windows ingest the groups on a worker
+   // thread and then apply them on the GUI thread. A group is done once its samples are on the plot.
+   uint64_t numGroupsQueued;  // Groups queued by the plot windows.
+   uint64_t numGroupsDone;    // Groups the plot windows have finished applying.
+   uint64_t numGroupsDropped; // Groups dropped because their plot window was closed.
+
+   tIngestLatency unpack;     // startPlotMsgProcess being called to the message being queued.
+   tIngestLatency queueWait;  // Message being queued to the GUI thread reading it out of the queue.
+   tIngestLatency dispatch;   // GUI thread handing the message to the plot windows.
+   tIngestLatency ingest;     // Plot window worker thread applying a group's samples to the curves.
+   tIngestLatency apply;      // Plot window GUI thread applying an ingested group (plot update, Curve Commander).
+}tIngestStats;
+
 class plotGuiMain : public QMainWindow
 {
     Q_OBJECT
@@ -57,9 +88,18 @@ public:
     void closeAllPlotsFromLib();
 
     void readPlotMsg(UnpackMultiPlotMsg *plotMsg);
-    void restorePlotMsg(const char *msg, unsigned int size, tPlotCurveName plotCurveName);
+    void restorePlotMsg(tPlotMsgBuffPtr msgBuff, const char *msg, unsigned int size, tPlotCurveName plotCurveName);
 
     CurveCommander& getCurveCommander(){return m_curveCommander;}
+    FlightRecorder* getFlightRecorder(){return m_flightRecorder;} // NULL if the flight recorder is off.
+
+    tIngestStats getIngestStats();
+    void resetIngestStats();
+
+    // Called by the plot windows as they process the plot message groups handed to them.
+    void plotMsgGroupQueued();
+    void plotMsgGroupDone(qint64 ingestNs, qint64 applyNs);
+    void plotMsgGroupDropped();
 
     void restorePlotFile(std::string plotFilePath);
 
@@ -67,6 +107,7 @@ private:
 
     Ui::plotGuiMain *ui;
     std::vector<TCPMsgReader*> m_tcpMsgReaders;
+    FlightRecorder* m_flightRecorder;
 
     QSystemTrayIcon* m_trayIcon;
     QAction m_trayExitAction;
@@ -86,12 +127,17 @@ private:
 
     bool m_allowNewCurves;
 
-    std::vector<char> m_storedMsgBuff;
-    unsigned int m_storedMsgBuffIndex;
-    QMutex m_storedMsgBuffMutex;
+    typedef struct
+    {
+       UnpackMultiPlotMsg* plotMsg;
+       qint64 queuedTimeNs;
+    }tQueuedPlotMsg;
 
-    std::queue<UnpackMultiPlotMsg*> m_multiPlotMsgs;
+    // The queue and the ingest stats are protected by m_multiPlotMsgsQueueMutex.
+    std::queue<tQueuedPlotMsg> m_multiPlotMsgs;
     QMutex m_multiPlotMsgsQueueMutex;
+    tIngestStats m_ingestStats;
+    QElapsedTimer m_ingestTimer;
 
     std::list<std::string> m_plotFilesToRestoreList;
     QMutex m_plotFilesToRestoreMutex;
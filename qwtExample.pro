@@ -39,6 +39,10 @@ SOURCES += main.cpp\
     TCPMsgReader.cpp \
     PackUnpackPlotMsg.cpp \
     openrawdialog.cpp \
+    outOfCoreRawFile.cpp \
+    numToText.cpp \
+    flightRecorder.cpp \
+    plotMsgReplay.cpp \
     plotguimain.cpp \
     dString.cpp \
     FileSystemOperations.cpp \
@@ -54,6 +58,9 @@ SOURCES += main.cpp\
     overwriterenamedialog.cpp \
     setsampleratedialog.cpp \
     smartMaxMin.cpp \
+    fusedMathOps.cpp \
+    typedSampleVect.cpp \
+    sampleBuff.cpp \
     persistentParameters.cpp \
     localPlotCreate.cpp \
     plotBar.cpp \
@@ -79,6 +86,10 @@ HEADERS  += mainwindow.h \
     CurveData.h \
     curvesortcolordialog.h \
     openrawdialog.h \
+    outOfCoreRawFile.h \
+    numToText.h \
+    flightRecorder.h \
+    plotMsgReplay.h \
     plotguimain.h \
     dString.h \
     FileSystemOperations.h \
@@ -95,6 +106,10 @@ HEADERS  += mainwindow.h \
     logToFile.h \
     setsampleratedialog.h \
     smartMaxMin.h \
+    sampleVect.h \
+    sampleBuff.h \
+    typedSampleVect.h \
+    fusedMathOps.h \
     persistentParameters.h \
     sendTCPPacket.h \
     localPlotCreate.h \
@@ -16,7 +16,17 @@
  * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
  * DEALINGS IN THE SOFTWARE.
  */
+#include <assert.h>
+#include <string.h>
+#include <algorithm>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
 #include "rawFileTypes.h"
+#include "float16Helpers.h"
+
+// Don't bother splitting up small files across threads.
+#define RAW_FILE_MIN_BLOCKS_PER_THREAD (1<<20)
 
 const QString RAW_TYPE_DROPDOWN[E_RAW_TYPE_SIZE] =
 {
@@ -68,4 +78,147 @@ const size_t RAW_TYPE_BLOCK_SIZE[E_RAW_TYPE_SIZE] =
     4, //E_RAW_TYPE_INTERLEAVED_FLOAT_16,
     8, //E_RAW_TYPE_INTERLEAVED_FLOAT_32,
    16  //E_RAW_TYPE_INTERLEAVED_FLOAT_64
-};
\ No newline at end of file
+};
+
+// Converts blocks [startBlock, endBlock) of the raw file. Each block is 1 value, or 2 interleaved values
+// (the 2nd value goes to result2).
+template <typename tRawFileType>
+static void rawFileBlocksToDouble(const char* inFilePtr, size_t startBlock, size_t endBlock, int dimension, double* result1, double* result2)
+{
+   constexpr size_t RAW_TYPE_SIZE = sizeof(tRawFileType);
+   tRawFileType rawVal;
+   if(dimension == 1)
+   {
+      for(size_t i = startBlock; i < endBlock; ++i)
+      {
+         memcpy(&rawVal, &inFilePtr[i*RAW_TYPE_SIZE], RAW_TYPE_SIZE);
+         result1[i] = (double)(rawVal);
+      }
+   }
+   else
+   {
+      // Deinterleave in a single pass.
+      for(size_t i = startBlock; i < endBlock; ++i)
+      {
+         memcpy(&rawVal, &inFilePtr[2*i*RAW_TYPE_SIZE], RAW_TYPE_SIZE);
+         result1[i] = (double)(rawVal);
+         memcpy(&rawVal, &inFilePtr[(2*i+1)*RAW_TYPE_SIZE], RAW_TYPE_SIZE);
+         result2[i] = (double)(rawVal);
+      }
+   }
+}
+
+template <typename tRawFileType>
+class rawFileConvertRunner : public QRunnable
+{
+public:
+   rawFileConvertRunner(const char* inFilePtr, size_t startBlock, size_t endBlock, int dimension, double* result1, double* result2):
+      m_inFilePtr(inFilePtr), m_startBlock(startBlock), m_endBlock(endBlock), m_dimension(dimension), m_result1(result1), m_result2(result2){}
+   void run(){rawFileBlocksToDouble<tRawFileType>(m_inFilePtr, m_startBlock, m_endBlock, m_dimension, m_result1, m_result2);}
+private:
+   const char* m_inFilePtr;
+   size_t m_startBlock;
+   size_t m_endBlock;
+   int m_dimension;
+   double* m_result1;
+   double* m_result2;
+};
+
+template <typename tRawFileType>
+static void fillFromRaw(const char* inFilePtr, size_t inFileSizeBytes, dubVect& result1, dubVect& result2, int dimension)
+{
+   assert(dimension > 0 && dimension < 3);
+
+   // Determine some sizes.
+   constexpr size_t RAW_TYPE_SIZE = sizeof(tRawFileType);
+   const size_t blockSizeBytes = RAW_TYPE_SIZE * dimension;
+
+   size_t numBlocks = inFilePtr != nullptr ? inFileSizeBytes / blockSizeBytes : 0; // round down.
+   result1.resize(numBlocks);
+   if(dimension > 1)
+      result2.resize(numBlocks);
+   double* result2Ptr = dimension > 1 ? result2.data() : nullptr;
+
+   // Split the conversion across threads. Each thread gets a contiguous range of blocks.
+   size_t numThreads = std::max(QThread::idealThreadCount(), 1);
+   size_t blocksPerThread = std::max((numBlocks + numThreads - 1) / numThreads, (size_t)RAW_FILE_MIN_BLOCKS_PER_THREAD);
+   if(numBlocks <= blocksPerThread)
+   {
+      rawFileBlocksToDouble<tRawFileType>(inFilePtr, 0, numBlocks, dimension, result1.data(), result2Ptr);
+      return;
+   }
+
+   QThreadPool threadPool;
+   threadPool.setMaxThreadCount((int)numThreads);
+   for(size_t startBlock = 0; startBlock < numBlocks; startBlock += blocksPerThread)
+   {
+      size_t endBlock = std::min(startBlock + blocksPerThread, numBlocks);
+      threadPool.start(new rawFileConvertRunner<tRawFileType>(inFilePtr, startBlock, endBlock, dimension, result1.data(), result2Ptr));
+   }
+   threadPool.waitForDone();
+}
+
+void rawFileToDouble(eRawTypes rawType, const char* inFilePtr, size_t inFileSizeBytes, dubVect& result1, dubVect& result2)
+{
+   const char* p = inFilePtr;
+   size_t n = inFileSizeBytes;
+   switch(rawType)
+   {
+      case E_RAW_TYPE_SIGNED_INT_8:    { fillFromRaw<int8_t  >(p, n, result1, result2, 1); } break;
+      case E_RAW_TYPE_SIGNED_INT_16:   { fillFromRaw<int16_t >(p, n, result1, result2, 1); } break;
+      case E_RAW_TYPE_SIGNED_INT_32:   { fillFromRaw<int32_t >(p, n, result1, result2, 1); } break;
+      case E_RAW_TYPE_SIGNED_INT_64:   { fillFromRaw<int64_t >(p, n, result1, result2, 1); } break;
+      case E_RAW_TYPE_UNSIGNED_INT_8:  { fillFromRaw<uint8_t >(p, n, result1, result2, 1); } break;
+      case E_RAW_TYPE_UNSIGNED_INT_16: { fillFromRaw<uint16_t>(p, n, result1, result2, 1); } break;
+      case E_RAW_TYPE_UNSIGNED_INT_32: { fillFromRaw<uint32_t>(p, n, result1, result2, 1); } break;
+      case E_RAW_TYPE_UNSIGNED_INT_64: { fillFromRaw<uint64_t>(p, n, result1, result2, 1); } break;
+      case E_RAW_TYPE_FLOAT_16:        { fillFromRaw<FLOAT_16>(p, n, result1, result2, 1); } break;
+      case E_RAW_TYPE_FLOAT_32:        { fillFromRaw<float   >(p, n, result1, result2, 1); } break;
+      case E_RAW_TYPE_FLOAT_64:        { fillFromRaw<double  >(p, n, result1, result2, 1); } break;
+      case E_RAW_TYPE_INTERLEAVED_SIGNED_INT_8:    { fillFromRaw<int8_t  >(p, n, result1, result2, 2); } break;
+      case E_RAW_TYPE_INTERLEAVED_SIGNED_INT_16:   { fillFromRaw<int16_t >(p, n, result1, result2, 2); } break;
+      case E_RAW_TYPE_INTERLEAVED_SIGNED_INT_32:   { fillFromRaw<int32_t >(p, n, result1, result2, 2); } break;
+      case E_RAW_TYPE_INTERLEAVED_SIGNED_INT_64:   { fillFromRaw<int64_t >(p, n, result1, result2, 2); } break;
+      case E_RAW_TYPE_INTERLEAVED_UNSIGNED_INT_8:  { fillFromRaw<uint8_t >(p, n, result1, result2, 2); } break;
+      case E_RAW_TYPE_INTERLEAVED_UNSIGNED_INT_16: { fillFromRaw<uint16_t>(p, n, result1, result2, 2); } break;
+      case E_RAW_TYPE_INTERLEAVED_UNSIGNED_INT_32: { fillFromRaw<uint32_t>(p, n, result1, result2, 2); } break;
+      case E_RAW_TYPE_INTERLEAVED_UNSIGNED_INT_64: { fillFromRaw<uint64_t>(p, n, result1, result2, 2); } break;
+      case E_RAW_TYPE_INTERLEAVED_FLOAT_16:        { fillFromRaw<FLOAT_16>(p, n, result1, result2, 2); } break;
+      case E_RAW_TYPE_INTERLEAVED_FLOAT_32:        { fillFromRaw<float   >(p, n, result1, result2, 2); } break;
+      case E_RAW_TYPE_INTERLEAVED_FLOAT_64:        { fillFromRaw<double  >(p, n, result1, result2, 2); } break;
+      default: break;
+   }
+}
+
+bool rawTypeIsInterleaved(eRawTypes rawType)
+{
+   return rawType >= E_RAW_TYPE_INTERLEAVED_SIGNED_INT_8 && rawType < E_RAW_TYPE_SIZE;
+}
+
+ePlotDataTypes rawTypeToPlotDataType(eRawTypes rawType)
+{
+   switch(rawType)
+   {
+      case E_RAW_TYPE_SIGNED_INT_8:
+      case E_RAW_TYPE_INTERLEAVED_SIGNED_INT_8:    return E_CHAR;
+      case E_RAW_TYPE_SIGNED_INT_16:
+      case E_RAW_TYPE_INTERLEAVED_SIGNED_INT_16:   return E_INT_16;
+      case E_RAW_TYPE_SIGNED_INT_32:
+      case E_RAW_TYPE_INTERLEAVED_SIGNED_INT_32:   return E_INT_32;
+      case E_RAW_TYPE_SIGNED_INT_64:
+      case E_RAW_TYPE_INTERLEAVED_SIGNED_INT_64:   return E_INT_64;
+      case E_RAW_TYPE_UNSIGNED_INT_8:
+      case E_RAW_TYPE_INTERLEAVED_UNSIGNED_INT_8:  return E_UCHAR;
+      case E_RAW_TYPE_UNSIGNED_INT_16:
+      case E_RAW_TYPE_INTERLEAVED_UNSIGNED_INT_16: return E_UINT_16;
+      case E_RAW_TYPE_UNSIGNED_INT_32:
+      case E_RAW_TYPE_INTERLEAVED_UNSIGNED_INT_32: return E_UINT_32;
+      case E_RAW_TYPE_UNSIGNED_INT_64:
+      case E_RAW_TYPE_INTERLEAVED_UNSIGNED_INT_64: return E_UINT_64;
+      case E_RAW_TYPE_FLOAT_16:
+      case E_RAW_TYPE_INTERLEAVED_FLOAT_16:        return E_FLOAT_16;
+      case E_RAW_TYPE_FLOAT_32:
+      case E_RAW_TYPE_INTERLEAVED_FLOAT_32:        return E_FLOAT_32;
+      default:                                     return E_FLOAT_64;
+   }
+}
@@ -18,6 +18,7 @@
  */
 #pragma once
 #include <QString>
+#include "PlotHelperTypes.h"
 
 typedef enum
 {
@@ -48,3 +49,9 @@ typedef enum
 
 extern const QString RAW_TYPE_DROPDOWN[E_RAW_TYPE_SIZE];
 extern const size_t RAW_TYPE_BLOCK_SIZE[E_RAW_TYPE_SIZE];
+
+// Converts the raw file bytes to doubles. For interleaved types the 2nd value of each pair goes to result2.
+void rawFileToDouble(eRawTypes rawType, const char* inFilePtr, size_t inFileSizeBytes, dubVect& result1, dubVect& result2);
+
+bool rawTypeIsInterleaved(eRawTypes rawType);
+ePlotDataTypes rawTypeToPlotDataType(eRawTypes rawType);
@@ -0,0 +1,91 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#include "sampleBuff.h"
+
+#if (defined(_WIN32) || defined(__WIN32__))
+   #define SAMPLE_BUFF_WIN_BUILD
+#else
+   #include <string>
+   #include <unistd.h>
+   #include <fcntl.h>
+   #include <sys/mman.h>
+#endif
+
+
+#ifdef SAMPLE_BUFF_WIN_BUILD
+
+void* sampleBuffSpill(const void* src, size_t numBytes)
+{
+   // Not supported, the samples stay in RAM.
+   (void)src;
+   (void)numBytes;
+   return NULL;
+}
+
+void sampleBuffUnmap(void* ptr, size_t numBytes)
+{
+   (void)ptr;
+   (void)numBytes;
+}
+
+#else
+
+void* sampleBuffSpill(const void* src, size_t numBytes)
+{
+   const char* tmpDir = getenv("TMPDIR");
+   std::string path = std::string(tmpDir != NULL && tmpDir[0] != '\0' ? tmpDir : "/tmp") + "/plotterSpillXXXXXX";
+
+   int fd = mkstemp(&path[0]);
+   if(fd < 0)
+   {
+      return NULL;
+   }
+   unlink(path.c_str()); // The file is deleted as soon as it is unmapped.
+
+   // Allocate the file's blocks up front. Running out of disk space while writing to the mapping would crash.
+   void* mapped = MAP_FAILED;
+   if(posix_fallocate(fd, 0, numBytes) == 0)
+   {
+      mapped = mmap(NULL, numBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   }
+   close(fd); // The mapping keeps the file open.
+
+   if(mapped == MAP_FAILED)
+   {
+      return NULL;
+   }
+
+   memcpy(mapped, src, numBytes);
+
+   // Write the pages out now so they are clean, then drop them from this process. The kernel can
+   // reclaim clean file pages, anonymous memory can't be reclaimed without swap.
+   msync(mapped, numBytes, MS_SYNC);
+   madvise(mapped, numBytes, MADV_DONTNEED);
+   return mapped;
+}
+
+void sampleBuffUnmap(void* ptr, size_t numBytes)
+{
+   if(ptr != NULL)
+   {
+      munmap(ptr, numBytes);
+   }
+}
+
+#endif
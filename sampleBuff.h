@@ -0,0 +1,229 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef SAMPLEBUFF_H
+#define SAMPLEBUFF_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <atomic>
+#include <algorithm>
+
+// Copy 'numBytes' from 'src' into a temp file and memory map it. The pages are written out and dropped
+// from this process' resident memory, they are read back in from the file when they are accessed.
+// Returns NULL if the samples couldn't be spilled.
+void* sampleBuffSpill(const void* src, size_t numBytes);
+void sampleBuffUnmap(void* ptr, size_t numBytes);
+
+// Backing memory of a sampleBuff. Copies of a sampleBuff share it until one of them changes it.
+struct sampleBuffStorage
+{
+   sampleBuffStorage(): refCount(1), ptr(NULL), capacityBytes(0), spilled(false){}
+   std::atomic<int> refCount;
+   void* ptr;
+   size_t capacityBytes;
+   bool spilled;
+};
+
+// Growable backing buffer for curve samples (T must be a plain data type). Unlike std::vector, this
+// grows with realloc. Large buffers are mmap'd by malloc, so realloc can remap their pages to a bigger
+// address range instead of allocating a new buffer and copying into it. Growing a curve with hundreds
+// of millions of samples then doesn't copy the samples or need the old and new buffers at the same time.
+// The capacity still grows geometrically so small appends are amortized. Pages that are allocated but
+// not yet written to don't use any physical memory.
+// New elements are not initialized.
+// The elements can also be spilled out to a memory mapped temp file to free up RAM (see spill()).
+// Copies share the elements (copy on write). Anything that can change the elements, including the
+// non-const accessors, first gives the sampleBuff its own copy if the elements are shared. The
+// reference count is atomic, so a copy can be read on one thread while the sampleBuff it was copied
+// from keeps being changed on another (the sampleBuff objects themselves are not thread safe).
+template<typename T>
+class sampleBuff
+{
+public:
+   sampleBuff(): m_storage(NULL), m_size(0){}
+   sampleBuff(const T* src, size_t count): m_storage(NULL), m_size(0){assign(src, count);}
+   sampleBuff(const sampleBuff& src): m_storage(NULL), m_size(0){share(src);}
+   ~sampleBuff(){release();}
+
+   sampleBuff& operator=(const sampleBuff& rhs)
+   {
+      share(rhs);
+      return *this;
+   }
+
+   size_t size() const {return m_size;}
+   size_t capacity() const {return m_storage != NULL ? m_storage->capacityBytes / sizeof(T) : 0;}
+   bool isSpilled() const {return m_storage != NULL && m_storage->spilled;}
+   bool isShared() const {return m_storage != NULL && m_storage->refCount.load(std::memory_order_acquire) > 1;}
+   T* data() {detach(); return ptr();}
+   const T* data() const {return ptr();}
+   T& operator[](size_t index) {return data()[index];}
+   const T& operator[](size_t index) const {return ptr()[index];}
+
+   void assign(const T* src, size_t count)
+   {
+      if(count > capacity() || isShared())
+         release(); // Nothing needs to be kept, don't have realloc / detach copy the old samples.
+      resize(count);
+      if(count > 0)
+         memcpy(data(), src, sizeof(T) * count);
+   }
+
+   void resize(size_t newSize)
+   {
+      size_t oldCapacity = capacity();
+      if(newSize > oldCapacity)
+         grow(std::max(newSize, oldCapacity + (oldCapacity / 2)));
+      m_size = newSize;
+   }
+
+   void reserve(size_t newCapacity)
+   {
+      if(newCapacity > capacity())
+         grow(newCapacity);
+   }
+
+   // Insert 'count' uninitialized elements at 'index'.
+   void insert(size_t index, size_t count)
+   {
+      size_t numToMove = m_size - index;
+      resize(m_size + count);
+      T* elements = data();
+      memmove(elements + index + count, elements + index, sizeof(T) * numToMove);
+   }
+
+   // Clear and give the memory back (if no copies are still using it).
+   void release()
+   {
+      if(m_storage != NULL && m_storage->refCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+         if(m_storage->spilled)
+            sampleBuffUnmap(m_storage->ptr, m_storage->capacityBytes);
+         else
+            free(m_storage->ptr);
+         delete m_storage;
+      }
+      m_storage = NULL;
+      m_size = 0;
+   }
+
+   void swap(sampleBuff& other)
+   {
+      std::swap(m_storage, other.m_storage);
+      std::swap(m_size, other.m_size);
+   }
+
+   // Share the elements of 'src', which can have a different element type (its elements are then
+   // reinterpreted as T). Nothing is copied until one of them changes the elements.
+   template<typename U>
+   void share(const sampleBuff<U>& src)
+   {
+      if(src.m_storage != NULL)
+         src.m_storage->refCount.fetch_add(1, std::memory_order_relaxed);
+      size_t newSize = (src.m_size * sizeof(U)) / sizeof(T);
+      sampleBuffStorage* newStorage = src.m_storage;
+      release();
+      m_storage = newStorage;
+      m_size = newSize;
+   }
+
+   // Move the elements out to a memory mapped temp file. They can still be read / written as normal.
+   // Growing the buffer brings the elements back into RAM. Returns false if the elements couldn't be spilled.
+   // Shared elements stay in RAM, the copies sharing them may be reading them.
+   bool spill()
+   {
+      if(m_storage != NULL && !m_storage->spilled && m_size > 0 && !isShared())
+      {
+         void* mapped = sampleBuffSpill(m_storage->ptr, sizeof(T) * m_size);
+         if(mapped != NULL)
+         {
+            free(m_storage->ptr);
+            m_storage->ptr = mapped;
+            m_storage->capacityBytes = sizeof(T) * m_size;
+            m_storage->spilled = true;
+         }
+      }
+      return isSpilled();
+   }
+
+   // Bring spilled elements back into RAM.
+   void unspill()
+   {
+      if(isSpilled())
+      {
+         if(isShared())
+         {
+            detach(); // The private copy is made in RAM.
+            return;
+         }
+         void* heapPtr = malloc(m_storage->capacityBytes);
+         if(heapPtr == NULL)
+            throw std::bad_alloc();
+         memcpy(heapPtr, m_storage->ptr, m_storage->capacityBytes);
+         sampleBuffUnmap(m_storage->ptr, m_storage->capacityBytes);
+         m_storage->ptr = heapPtr;
+         m_storage->spilled = false;
+      }
+   }
+
+private:
+   template<typename U> friend class sampleBuff;
+
+   T* ptr() const {return m_storage != NULL ? (T*)m_storage->ptr : NULL;}
+
+   // Give this sampleBuff its own copy of the elements if they are shared.
+   void detach()
+   {
+      if(isShared())
+      {
+         sampleBuffStorage* copy = new sampleBuffStorage();
+         copy->capacityBytes = m_storage->capacityBytes;
+         copy->ptr = malloc(copy->capacityBytes);
+         if(copy->ptr == NULL)
+         {
+            delete copy;
+            throw std::bad_alloc();
+         }
+         size_t size = m_size;
+         memcpy(copy->ptr, m_storage->ptr, sizeof(T) * size);
+         release();
+         m_storage = copy;
+         m_size = size;
+      }
+   }
+
+   void grow(size_t newCapacity)
+   {
+      detach();
+      unspill();
+      if(m_storage == NULL)
+         m_storage = new sampleBuffStorage();
+      void* newPtr = realloc(m_storage->ptr, sizeof(T) * newCapacity);
+      if(newPtr == NULL)
+         throw std::bad_alloc();
+      m_storage->ptr = newPtr;
+      m_storage->capacityBytes = sizeof(T) * newCapacity;
+   }
+
+   sampleBuffStorage* m_storage;
+   size_t m_size;
+};
+
+#endif
@@ -0,0 +1,170 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef SAMPLEVECT_H
+#define SAMPLEVECT_H
+
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include "PlotHelperTypes.h"
+#include "sampleBuff.h"
+
+// Vector of curve samples that can drop samples from its beginning without moving the
+// rest of the samples. The samples are a window [m_start, m_start + m_size) into a larger
+// backing buffer. Scroll mode slides the window forward, so adding N new samples costs O(N)
+// instead of O(curve size). The window is only moved back to the beginning of the backing
+// buffer when it runs off the end. The backing buffer is given some head room when that
+// happens, so the move is amortized over many scrolls.
+// The samples are always contiguous, so data() can be handed to anything that wants a plain array.
+// Copies share the backing buffer until one of them is changed (see sampleBuff), so a copy can be
+// taken in O(1) and read on another thread. The non-const accessors are for writing, they make a
+// private copy of shared samples. Use constData() or the const accessors to read.
+class sampleVect
+{
+public:
+   sampleVect(): m_start(0), m_size(0){}
+   sampleVect(const dubVect& src): m_buff(src.data(), src.size()), m_start(0), m_size(src.size()){}
+   sampleVect(const sampleVect& src): m_buff(src.m_buff), m_start(src.m_start), m_size(src.m_size){}
+
+   sampleVect& operator=(const sampleVect& rhs)
+   {
+      m_buff = rhs.m_buff;
+      m_start = rhs.m_start;
+      m_size = rhs.m_size;
+      return *this;
+   }
+   sampleVect& operator=(const dubVect& rhs)
+   {
+      assign(rhs.data(), rhs.size());
+      return *this;
+   }
+
+   size_t size() const {return m_size;}
+   bool empty() const {return m_size == 0;}
+
+   double* data() {return m_buff.data() + m_start;}
+   const double* data() const {return m_buff.data() + m_start;}
+   const double* constData() const {return m_buff.data() + m_start;}
+   double* begin() {return data();}
+   double* end() {return data() + m_size;}
+   const double* begin() const {return data();}
+   const double* end() const {return data() + m_size;}
+
+   double& operator[](size_t index) {return m_buff[m_start + index];}
+   const double& operator[](size_t index) const {return m_buff[m_start + index];}
+
+   void clear()
+   {
+      m_start = 0;
+      m_size = 0;
+   }
+
+   // Clear and give the backing buffer's memory back.
+   void release()
+   {
+      m_buff.release();
+      m_start = 0;
+      m_size = 0;
+   }
+
+   // Spilled samples are kept in a memory mapped temp file instead of RAM (see sampleBuff).
+   bool spill(){return m_buff.spill();}
+   bool isSpilled() const {return m_buff.isSpilled();}
+   void unspill(){m_buff.unspill();}
+   size_t getResidentBytes() const {return m_buff.isSpilled() ? 0 : sizeof(double) * m_buff.capacity();}
+
+   void resize(size_t newSize, double fillValue = 0.0)
+   {
+      if(m_start + newSize > m_buff.size())
+      {
+         moveToBeginning();
+         if(newSize > m_buff.size())
+            m_buff.resize(newSize);
+      }
+      if(newSize > m_size)
+         std::fill(data() + m_size, data() + newSize, fillValue);
+      m_size = newSize;
+   }
+
+   void insertAtBeginning(size_t count, double fillValue)
+   {
+      if(count <= m_start)
+         m_start -= count;
+      else
+         m_buff.insert(m_start, count);
+      m_size += count;
+      std::fill(data(), data() + count, fillValue);
+   }
+
+   void eraseFromBeginning(size_t count)
+   {
+      count = std::min(count, m_size);
+      m_start += count;
+      m_size -= count;
+   }
+
+   // Drop the 'count' oldest samples and append 'count' new samples to the end (the size doesn't change).
+   // 'count' must not be larger than size(). If newSamples is NULL the new samples are left for the
+   // caller to fill in.
+   void scroll(const double* newSamples, size_t count)
+   {
+      size_t numToKeep = m_size - count;
+      if(m_start + m_size + count > m_buff.size())
+      {
+         // Out of room at the end of the backing buffer. Move the samples that are being kept
+         // to the beginning and make sure there is room for a good number of future scrolls.
+         memmove(m_buff.data(), data() + count, sizeof(double) * numToKeep);
+         m_start = 0;
+         size_t minBuffSize = m_size + std::max(m_size / 2, count);
+         if(m_buff.size() < minBuffSize)
+            m_buff.resize(minBuffSize);
+      }
+      else
+      {
+         m_start += count;
+      }
+      if(newSamples != NULL && count > 0)
+         memcpy(data() + numToKeep, newSamples, sizeof(double) * count);
+   }
+
+private:
+   friend class typedSampleVect; // To share the backing buffer with typedSampleVect snapshots.
+
+   void assign(const double* src, size_t count)
+   {
+      m_buff.assign(src, count);
+      m_start = 0;
+      m_size = count;
+   }
+
+   void moveToBeginning()
+   {
+      if(m_start > 0)
+      {
+         memmove(m_buff.data(), data(), sizeof(double) * m_size);
+         m_start = 0;
+      }
+   }
+
+   sampleBuff<double> m_buff;
+   size_t m_start;
+   size_t m_size;
+};
+
+#endif
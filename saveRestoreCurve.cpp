@@ -25,6 +25,10 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <algorithm>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QByteArray>
 #include "saveRestoreCurve.h"
 #include "persistentParameters.h"
 #include "dString.h"
@@ -38,6 +42,9 @@ static const std::string CLIPBOARD_EXCEL_CELL_DELIM = "\t";
 
 static const std::string C_HEADER_LINE_DELIM = "\r\n";
 
+// Initial guess of the number of chars each number in a text save will use. The text buffer grows if it is too small.
+#define TEXT_SAVE_CHARS_PER_NUM_ESTIMATE (12)
+
 const QString OPEN_SAVE_FILTER_PLOT_STR = "Plots (*.plot)";
 const QString OPEN_SAVE_FILTER_CURVE_STR = "Curves (*.curve)";
 const QString OPEN_SAVE_FILTER_CSV_STR = "Comma Separated Values (*.csv)";
@@ -70,6 +77,48 @@ static void pack(char** packArray, const void* toPack, size_t packSize)
    (*packArray) += packSize;
 }
 
+// Builds up text directly in a PackedCurveData buffer. Space is made available before each
+// write, so numbers can be converted in place instead of going through a stream.
+class textBuffer
+{
+public:
+   textBuffer(PackedCurveData& buff, size_t sizeEstimate): m_buff(buff), m_size(0)
+   {
+      m_buff.resize(sizeEstimate);
+   }
+
+   // Returns where to write the next text, with at least 'maxChars' available.
+   char* getWritePtr(size_t maxChars)
+   {
+      if(m_size + maxChars > m_buff.size())
+      {
+         m_buff.resize(std::max(2 * m_buff.size(), m_size + maxChars));
+      }
+      return m_buff.data() + m_size;
+   }
+
+   // Marks everything before 'writePtr' as written.
+   void setWritePtr(char* writePtr)
+   {
+      m_size = writePtr - m_buff.data();
+   }
+
+   void append(const std::string& str)
+   {
+      setWritePtr(NumToText::writeStr(getWritePtr(str.size()), str.data(), str.size()));
+   }
+
+   // Trims the buffer to the text that was written.
+   void finish()
+   {
+      m_buff.resize(m_size);
+   }
+
+private:
+   PackedCurveData& m_buff;
+   size_t m_size;
+};
+
 static std::string convertToValidCName(std::string inStr)
 {
    const char* in_cstr = inStr.c_str();
@@ -260,8 +309,108 @@ unsigned getRawCurveBytes(const double* inX, const double* inY, size_t numPoints
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 
+CurveSnapshot::CurveSnapshot(CurveData* curve, eSaveRestorePlotCurveType type, bool limitToZoom):
+   m_curveTitle(curve->getCurveTitle()),
+   m_plotDim(curve->getPlotDim()),
+   m_plotType(curve->getPlotType()),
+   m_numPoints(curve->getNumPoints()),
+   m_sampleRate(curve->getSampleRate()),
+   m_mathOpsXAxis(curve->getMathOps(E_X_AXIS)),
+   m_mathOpsYAxis(curve->getMathOps(E_Y_AXIS)),
+   m_lastMsgXAxisType(curve->getLastMsgDataType(E_X_AXIS)),
+   m_lastMsgYAxisType(curve->getLastMsgDataType(E_Y_AXIS))
+{
+   bool is2D = (m_plotDim == E_PLOT_DIM_2D);
+   bool isCHeader = (type == E_SAVE_RESTORE_C_HEADER_AUTO_TYPE) ||
+                    (type == E_SAVE_RESTORE_C_HEADER_INT) ||
+                    (type == E_SAVE_RESTORE_C_HEADER_FLOAT); // C Headers always save all the points.
+
+   m_1dDisplayedIndexes.minX = -1;
+   m_1dDisplayedIndexes.maxX = -1;
+
+   if(type == E_SAVE_RESTORE_RAW)
+   {
+      curve->getOrigPointsSnapshot(E_Y_AXIS, m_yOrigPoints);
+      if(is2D)
+         curve->getOrigPointsSnapshot(E_X_AXIS, m_xOrigPoints);
+   }
+   else if(limitToZoom && is2D && !isCHeader)
+   {
+      // The displayed points are scattered around the curve, these do need to be copied.
+      dubVect xPoints;
+      dubVect yPoints;
+      curve->get2dDisplayedPoints(xPoints, yPoints);
+      m_xPoints = xPoints;
+      m_yPoints = yPoints;
+   }
+   else
+   {
+      curve->getPointsSnapshot(E_Y_AXIS, m_yPoints);
+      if(is2D)
+      {
+         curve->getPointsSnapshot(E_X_AXIS, m_xPoints);
+      }
+      else if(limitToZoom)
+      {
+         m_1dDisplayedIndexes = curve->get1dDisplayedIndexes();
+      }
+   }
+}
+
+void CurveSnapshot::get2dDisplayedPoints(dubVect& xAxis, dubVect& yAxis)
+{
+   xAxis.assign(m_xPoints.constData(), m_xPoints.constData() + m_xPoints.size());
+   yAxis.assign(m_yPoints.constData(), m_yPoints.constData() + m_yPoints.size());
+}
+
+SaveDisplayFormat::SaveDisplayFormat(MainWindow* plotGui):
+   m_plotName(plotGui->getPlotName()),
+   m_displayType(plotGui->getDisplayType()),
+   m_displayPrecision(plotGui->getDisplayPrecision())
+{
+}
+
+SaveDisplayFormat::SaveDisplayFormat(QString plotName, eDisplayPointType displayType, int displayPrecision):
+   m_plotName(plotName),
+   m_displayType(displayType),
+   m_displayPrecision(displayPrecision)
+{
+}
+
+NumToText SaveDisplayFormat::getXAxisFormat(CurveSnapshot* curve)
+{
+   // Same as MainWindow::setDisplayIoMapipXAxis, a simple 1D X Axis is written as whole numbers.
+   bool simpleXAxis = (curve->getPlotDim() == E_PLOT_DIM_1D) &&
+                      ( (curve->getSampleRate() == 1.0) || (curve->getSampleRate() == 0.0) );
+   return simpleXAxis ? NumToText(E_DISPLAY_POINT_FIXED, 0) : NumToText(m_displayType, m_displayPrecision);
+}
+
+NumToText SaveDisplayFormat::getYAxisFormat()
+{
+   return NumToText(m_displayType, m_displayPrecision);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
 SaveCurve::SaveCurve(MainWindow *plotGui, CurveData *curve, eSaveRestorePlotCurveType type, bool limitToZoom):
    m_limitToZoom(limitToZoom)
+{
+   SaveDisplayFormat displayFormat(plotGui);
+   CurveSnapshot snapshot(curve, type, limitToZoom);
+   save(&displayFormat, &snapshot, type);
+}
+
+SaveCurve::SaveCurve(SaveDisplayFormat* displayFormat, CurveSnapshot* curve, eSaveRestorePlotCurveType type, bool limitToZoom):
+   m_limitToZoom(limitToZoom)
+{
+   save(displayFormat, curve, type);
+}
+
+void SaveCurve::save(SaveDisplayFormat* displayFormat, CurveSnapshot* curve, eSaveRestorePlotCurveType type)
 {
    switch(type)
    {
@@ -270,15 +419,15 @@ SaveCurve::SaveCurve(MainWindow *plotGui, CurveData *curve, eSaveRestorePlotCurv
          SaveRaw(curve);
       break;
       case E_SAVE_RESTORE_CSV:
-         SaveExcel(plotGui, curve, CSV_CELL_DELIM);
+         SaveExcel(displayFormat, curve, CSV_CELL_DELIM);
       break;
       case E_SAVE_RESTORE_CLIPBOARD_EXCEL:
-         SaveExcel(plotGui, curve, CLIPBOARD_EXCEL_CELL_DELIM);
+         SaveExcel(displayFormat, curve, CLIPBOARD_EXCEL_CELL_DELIM);
       break;
       case E_SAVE_RESTORE_C_HEADER_AUTO_TYPE:
       case E_SAVE_RESTORE_C_HEADER_INT:
       case E_SAVE_RESTORE_C_HEADER_FLOAT:
-         SaveCHeader(plotGui, curve, type);
+         SaveCHeader(displayFormat, curve, type);
       break;
       case E_SAVE_RESTORE_BIN_AUTO_TYPE:
       case E_SAVE_RESTORE_BIN_S8:  // E_CHAR,
@@ -304,7 +453,7 @@ void SaveCurve::getPackedData(PackedCurveData& packedDataReturn)
    packedDataReturn.insert(packedDataReturn.end(), packedCurveData.begin(), packedCurveData.end());
 }
 
-void SaveCurve::SaveRaw(CurveData* curve)
+void SaveCurve::SaveRaw(CurveSnapshot* curve)
 {
     tSaveRestoreCurveParams params;
     params.curveName = curve->getCurveTitle();
@@ -362,16 +511,23 @@ void SaveCurve::SaveRaw(CurveData* curve)
        pack(&packArray, &(*iter), sizeof(*iter));
 
     // Pack Y Axis Data
-    pack(&packArray, curve->getOrigYPoints(), dataPointsSize1Axis);
+    dubVect origPoints;
+    curve->getOrigYPoints(origPoints);
+    pack(&packArray, origPoints.data(), dataPointsSize1Axis);
 
     // Pack X Axis Data if 2D plot
     if(params.plotDim == E_PLOT_DIM_2D)
-       pack(&packArray, curve->getOrigXPoints(), dataPointsSize1Axis);
+    {
+       curve->getOrigXPoints(origPoints);
+       pack(&packArray, origPoints.data(), dataPointsSize1Axis);
+    }
 }
 
-void SaveCurve::SaveExcel(MainWindow* plotGui, CurveData* curve, std::string delim)
+void SaveCurve::SaveExcel(SaveDisplayFormat* displayFormat, CurveSnapshot* curve, std::string delim)
 {
-   std::stringstream csvFile;
+   NumToText xAxisFormat = displayFormat->getXAxisFormat(curve);
+   NumToText yAxisFormat = displayFormat->getYAxisFormat();
+   std::string curveTitle = curve->getCurveTitle().toStdString();
    if(curve->getPlotDim() == E_PLOT_DIM_2D) ////// 2D --------------------------
    {
       // Determine the points to use
@@ -401,16 +557,21 @@ void SaveCurve::SaveExcel(MainWindow* plotGui, CurveData* curve, std::string del
       m_hasData = (numPoints > 0);
 
       // Build the CSV File
-      csvFile << curve->getCurveTitle().toStdString() << " - X Axis" << delim;
-      csvFile << curve->getCurveTitle().toStdString() << " - Y Axis\r\n";
+      textBuffer csvFile(packedCurveData, 2 * (size_t)numPoints * TEXT_SAVE_CHARS_PER_NUM_ESTIMATE);
+      csvFile.append(curveTitle + " - X Axis" + delim);
+      csvFile.append(curveTitle + " - Y Axis\r\n");
+
+      size_t maxLineSize = xAxisFormat.maxChars() + delim.size() + yAxisFormat.maxChars() + EXCEL_LINE_DELIM.size();
       for(unsigned int i = 0; i < numPoints; ++i)
       {
-         plotGui->setDisplayIoMapipXAxis(csvFile, curve);
-         csvFile << xPoints[i] << delim;
-         plotGui->setDisplayIoMapipYAxis(csvFile);
-         csvFile << yPoints[i] << EXCEL_LINE_DELIM;
+         char* writePtr = csvFile.getWritePtr(maxLineSize);
+         writePtr = xAxisFormat.write(writePtr, xPoints[i]);
+         writePtr = NumToText::writeStr(writePtr, delim.data(), delim.size());
+         writePtr = yAxisFormat.write(writePtr, yPoints[i]);
+         writePtr = NumToText::writeStr(writePtr, EXCEL_LINE_DELIM.data(), EXCEL_LINE_DELIM.size());
+         csvFile.setWritePtr(writePtr);
       }
-      plotGui->clearDisplayIoMapIp(csvFile);
+      csvFile.finish();
    }
    else ////// 1D --------------------------
    {
@@ -427,29 +588,33 @@ void SaveCurve::SaveExcel(MainWindow* plotGui, CurveData* curve, std::string del
          if(displayed.maxX < stopExclusive)
             stopExclusive = displayed.maxX;
       }
-      
-      csvFile << curve->getCurveTitle().toStdString() << EXCEL_LINE_DELIM;
 
-      plotGui->setDisplayIoMapipYAxis(csvFile);
+      // Detemine if this curve has data to save.
+      m_hasData = (stopExclusive > startInclusive);
+
+      textBuffer csvFile(packedCurveData, (m_hasData ? (size_t)(stopExclusive - startInclusive) : 0) * TEXT_SAVE_CHARS_PER_NUM_ESTIMATE);
+      csvFile.append(curveTitle + EXCEL_LINE_DELIM);
+
+      const double* yPoints = curve->getYPoints();
+      size_t maxLineSize = yAxisFormat.maxChars() + EXCEL_LINE_DELIM.size();
       for(unsigned int i = startInclusive; i < stopExclusive; ++i)
       {
-         csvFile << curve->getYPoints()[i] << EXCEL_LINE_DELIM;
+         char* writePtr = csvFile.getWritePtr(maxLineSize);
+         writePtr = yAxisFormat.write(writePtr, yPoints[i]);
+         writePtr = NumToText::writeStr(writePtr, EXCEL_LINE_DELIM.data(), EXCEL_LINE_DELIM.size());
+         csvFile.setWritePtr(writePtr);
       }
-      plotGui->clearDisplayIoMapIp(csvFile);
-
-      // Detemine if this curve has data to save.
-      m_hasData = (stopExclusive > startInclusive);
+      csvFile.finish();
    }
-
-   packedCurveData.resize(csvFile.str().size());
-   memcpy(&packedCurveData[0], csvFile.str().c_str(), csvFile.str().size());
 }
 
-void SaveCurve::SaveCHeader(MainWindow* plotGui, CurveData* curve, eSaveRestorePlotCurveType type)
+void SaveCurve::SaveCHeader(SaveDisplayFormat* displayFormat, CurveSnapshot* curve, eSaveRestorePlotCurveType type)
 {
    std::stringstream headerFile;
-   std::stringstream outFile;
+   std::stringstream declaration;
    static const int MAX_SAMP_PER_LINE = 10;
+   static const std::string SAMP_DELIM = ", ";
+   static const size_t MAX_INT_CHARS = 20; // Sign and 19 digits.
    int sampPerLineCount = 0;
 
    unsigned int numSamplesToWrite = curve->getNumPoints();
@@ -463,99 +628,66 @@ void SaveCurve::SaveCHeader(MainWindow* plotGui, CurveData* curve, eSaveRestoreP
       curve->getLastMsgDataType(E_Y_AXIS));
    std::string dataType_str = getDataStrName(dataType_type, dataType_isInt);
 
-   headerFile << getCHeaderTypedefStr(plotGui->getPlotName(), curve->getCurveTitle(), dataType_str) << C_HEADER_LINE_DELIM;
+   headerFile << getCHeaderTypedefStr(displayFormat->getPlotName(), curve->getCurveTitle(), dataType_str) << C_HEADER_LINE_DELIM;
 
-   if(curve->getPlotDim() != E_PLOT_DIM_1D)
-   {
-      const double* xPoints = curve->getXPoints();
-      const double* yPoints = curve->getYPoints();
-      outFile << getPlotNameCHeaderTypeName(plotGui->getPlotName(), curve->getCurveTitle()) << " " <<
-                 getPlotNameCHeaderVariableName(curve->getCurveTitle()) <<
-                 "[" << curve->getNumPoints() << "][2] = {" << C_HEADER_LINE_DELIM;
+   NumToText xAxisFormat = displayFormat->getXAxisFormat(curve);
+   NumToText yAxisFormat = displayFormat->getYAxisFormat();
+   size_t maxXChars = dataType_isInt ? MAX_INT_CHARS : xAxisFormat.maxChars();
+   size_t maxYChars = dataType_isInt ? MAX_INT_CHARS : yAxisFormat.maxChars();
 
-      if(dataType_isInt)
-      {
-         for(unsigned int i = 0; i < numSamplesToWrite; ++i)
-         {
-            outFile << "{" << (INT_64)xPoints[i] << "," << (INT_64)yPoints[i] << "}";
-            if(i < (numSamplesToWrite-1))
-               outFile << ", ";
-            if(++sampPerLineCount >= MAX_SAMP_PER_LINE)
-            {
-               outFile << C_HEADER_LINE_DELIM;
-               sampPerLineCount = 0;
-            }
-         }
-      }
-      else
-      {
-         for(unsigned int i = 0; i < numSamplesToWrite; ++i)
-         {
-            plotGui->setDisplayIoMapipXAxis(outFile, curve);
-            outFile << "{" << xPoints[i] << ",";
-            plotGui->setDisplayIoMapipYAxis(outFile);
-            outFile << yPoints[i] << "}";
-            if(i < (numSamplesToWrite-1))
-               outFile << ", ";
-            if(++sampPerLineCount >= MAX_SAMP_PER_LINE)
-            {
-               outFile << C_HEADER_LINE_DELIM;
-               sampPerLineCount = 0;
-            }
-         }
-         plotGui->clearDisplayIoMapIp(outFile);
-      }
-      outFile << "};" << C_HEADER_LINE_DELIM << C_HEADER_LINE_DELIM;
+   const double* yPoints = curve->getYPoints();
+   bool is2D = (curve->getPlotDim() != E_PLOT_DIM_1D);
+   if(is2D)
+   {
+      declaration << getPlotNameCHeaderTypeName(displayFormat->getPlotName(), curve->getCurveTitle()) << " " <<
+                     getPlotNameCHeaderVariableName(curve->getCurveTitle()) <<
+                     "[" << curve->getNumPoints() << "][2] = {" << C_HEADER_LINE_DELIM;
    }
    else
    {
-      const double* yPoints = curve->getYPoints();
-      outFile << getPlotNameCHeaderTypeName(plotGui->getPlotName(), curve->getCurveTitle()) << " " <<
-                 getPlotNameCHeaderVariableName(curve->getCurveTitle()) <<
-                 "[" << curve->getNumPoints() << "] = {" << C_HEADER_LINE_DELIM;
+      declaration << getPlotNameCHeaderTypeName(displayFormat->getPlotName(), curve->getCurveTitle()) << " " <<
+                     getPlotNameCHeaderVariableName(curve->getCurveTitle()) <<
+                     "[" << curve->getNumPoints() << "] = {" << C_HEADER_LINE_DELIM;
+   }
+
+   textBuffer outFile(packedCurveData, (is2D ? 2 : 1) * (size_t)numSamplesToWrite * TEXT_SAVE_CHARS_PER_NUM_ESTIMATE);
+   outFile.append(declaration.str());
 
-      if(dataType_isInt)
+   // Worst case size of a sample, i.e. "{x,y}" followed by ", " and a line delimiter.
+   size_t maxSampSize = (is2D ? (maxXChars + maxYChars + 3) : maxYChars) + SAMP_DELIM.size() + C_HEADER_LINE_DELIM.size();
+   const double* xPoints = is2D ? curve->getXPoints() : nullptr;
+   for(unsigned int i = 0; i < numSamplesToWrite; ++i)
+   {
+      char* writePtr = outFile.getWritePtr(maxSampSize);
+      if(is2D)
       {
-         for(unsigned int i = 0; i < numSamplesToWrite; ++i)
-         {
-            outFile << (INT_64)yPoints[i];
-            if(i < (numSamplesToWrite-1))
-               outFile << ", ";
-            if(++sampPerLineCount >= MAX_SAMP_PER_LINE)
-            {
-               outFile << C_HEADER_LINE_DELIM;
-               sampPerLineCount = 0;
-            }
-         }
+         *writePtr++ = '{';
+         writePtr = dataType_isInt ? NumToText::writeInt(writePtr, (INT_64)xPoints[i]) : xAxisFormat.write(writePtr, xPoints[i]);
+         *writePtr++ = ',';
+         writePtr = dataType_isInt ? NumToText::writeInt(writePtr, (INT_64)yPoints[i]) : yAxisFormat.write(writePtr, yPoints[i]);
+         *writePtr++ = '}';
       }
       else
       {
-         plotGui->setDisplayIoMapipYAxis(outFile);
-         for(unsigned int i = 0; i < numSamplesToWrite; ++i)
-         {
-            outFile << yPoints[i];
-            if(i < (numSamplesToWrite-1))
-               outFile << ", ";
-            if(++sampPerLineCount >= MAX_SAMP_PER_LINE)
-            {
-               outFile << C_HEADER_LINE_DELIM;
-               sampPerLineCount = 0;
-            }
-         }
-         plotGui->clearDisplayIoMapIp(outFile);
+         writePtr = dataType_isInt ? NumToText::writeInt(writePtr, (INT_64)yPoints[i]) : yAxisFormat.write(writePtr, yPoints[i]);
       }
-      outFile << "};" << C_HEADER_LINE_DELIM << C_HEADER_LINE_DELIM;
+      if(i < (numSamplesToWrite-1))
+         writePtr = NumToText::writeStr(writePtr, SAMP_DELIM.data(), SAMP_DELIM.size());
+      if(++sampPerLineCount >= MAX_SAMP_PER_LINE)
+      {
+         writePtr = NumToText::writeStr(writePtr, C_HEADER_LINE_DELIM.data(), C_HEADER_LINE_DELIM.size());
+         sampPerLineCount = 0;
+      }
+      outFile.setWritePtr(writePtr);
    }
-
+   outFile.append("};" + C_HEADER_LINE_DELIM + C_HEADER_LINE_DELIM);
+   outFile.finish();
 
    packedCurveHead.resize(headerFile.str().size());
    memcpy(&packedCurveHead[0], headerFile.str().c_str(), headerFile.str().size());
-
-   packedCurveData.resize(outFile.str().size());
-   memcpy(&packedCurveData[0], outFile.str().c_str(), outFile.str().size());
 }
 
-void SaveCurve::SaveBinary(CurveData* curve, eSaveRestorePlotCurveType type)
+void SaveCurve::SaveBinary(CurveSnapshot* curve, eSaveRestorePlotCurveType type)
 {
    bool is2D = (curve->getPlotDim() == E_PLOT_DIM_2D);
 
@@ -773,23 +905,71 @@ void RestoreCurve::unpack(void* toUnpack, size_t unpackSize)
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 
+class saveCurveRunner : public QRunnable
+{
+public:
+   saveCurveRunner(SaveDisplayFormat* displayFormat, CurveSnapshot* curve, eSaveRestorePlotCurveType type, bool limitToZoom):
+      m_displayFormat(displayFormat), m_curve(curve), m_type(type), m_limitToZoom(limitToZoom)
+   {
+      setAutoDelete(false);
+   }
+   void run(){saveCurve.reset(new SaveCurve(m_displayFormat, m_curve, m_type, m_limitToZoom));}
+
+   std::unique_ptr<SaveCurve> saveCurve;
+private:
+   SaveDisplayFormat* m_displayFormat;
+   CurveSnapshot* m_curve;
+   eSaveRestorePlotCurveType m_type;
+   bool m_limitToZoom;
+};
+
 SavePlot::SavePlot(MainWindow* plotGui, QString plotName, QVector<CurveData*>& plotInfo, eSaveRestorePlotCurveType type, bool limitToZoom):
-   m_limitToZoom(limitToZoom)
+   canceled(false),
+   m_limitToZoom(limitToZoom),
+   m_progressCallback(NULL),
+   m_progressInputPtr(NULL)
+{
+   SaveDisplayFormat displayFormat(plotGui);
+   std::vector<std::unique_ptr<CurveSnapshot> > snapshots;
+   QVector<CurveSnapshot*> curves;
+   {
+      // Keep the plot message ingest worker from changing the samples mid snapshot.
+      QMutexLocker lock(plotGui->getCurvesMutex());
+      for(int i = 0; i < plotInfo.size(); ++i)
+      {
+         snapshots.emplace_back(new CurveSnapshot(plotInfo[i], type, limitToZoom));
+         curves.push_back(snapshots.back().get());
+      }
+   }
+   save(&displayFormat, plotName, curves, type);
+}
+
+SavePlot::SavePlot(SaveDisplayFormat* displayFormat, QString plotName, QVector<CurveSnapshot*>& plotInfo, eSaveRestorePlotCurveType type, bool limitToZoom,
+                   tSaveProgressCallback progressCallback, void* progressInputPtr):
+   canceled(false),
+   m_limitToZoom(limitToZoom),
+   m_progressCallback(progressCallback),
+   m_progressInputPtr(progressInputPtr)
+{
+   save(displayFormat, plotName, plotInfo, type);
+}
+
+void SavePlot::save(SaveDisplayFormat* displayFormat, QString plotName, QVector<CurveSnapshot*>& plotInfo, eSaveRestorePlotCurveType type)
 {
    switch(type)
    {
       default:
       case E_SAVE_RESTORE_RAW:
-         SaveRaw(plotGui, plotName, plotInfo);
+         SaveRaw(displayFormat, plotName, plotInfo);
       break;
       case E_SAVE_RESTORE_CSV:
       case E_SAVE_RESTORE_CLIPBOARD_EXCEL:
-         SaveExcel(plotGui, plotInfo, type);
+         SaveExcel(displayFormat, plotInfo, type);
       break;
       case E_SAVE_RESTORE_C_HEADER_AUTO_TYPE:
       case E_SAVE_RESTORE_C_HEADER_INT:
       case E_SAVE_RESTORE_C_HEADER_FLOAT:
-         SaveCHeader(plotGui, plotInfo, type);
+         SaveCHeader(displayFormat, plotInfo, type);
       break;
       case E_SAVE_RESTORE_BIN_AUTO_TYPE:
       case E_SAVE_RESTORE_BIN_S8:  // E_CHAR,
@@ -803,7 +983,7 @@ SavePlot::SavePlot(MainWindow* plotGui, QString plotName, QVector<CurveData*>& p
       case E_SAVE_RESTORE_BIN_F16: // E_FLOAT_16,
       case E_SAVE_RESTORE_BIN_F32: // E_FLOAT_32,
       case E_SAVE_RESTORE_BIN_F64: // E_FLOAT_64,
-         SaveBinary(plotGui, plotInfo, type);
+         SaveBinary(displayFormat, plotInfo, type);
       break;
    }
 }
@@ -815,13 +995,24 @@ void SavePlot::getPackedData(PackedCurveData& packedDataReturn)
    packedDataReturn.insert(packedDataReturn.end(), packedCurveData.begin(), packedCurveData.end());
 }
 
-void SavePlot::SaveRaw(MainWindow* plotGui, QString plotName, QVector<CurveData*>& plotInfo)
+bool SavePlot::updateProgress(int curveIndex, int numCurves)
+{
+   if(m_progressCallback != NULL && canceled == false && numCurves > 0)
+   {
+      canceled = !m_progressCallback(m_progressInputPtr, (100 * curveIndex) / numCurves);
+   }
+   return !canceled;
+}
+
+void SavePlot::SaveRaw(SaveDisplayFormat* displayFormat, QString plotName, QVector<CurveSnapshot*>& plotInfo)
 {
    QVector<PackedCurveData> curveRawFiles;
    UINT_32 fileSize = 0;
    for(int i = 0; i < plotInfo.size(); ++i)
    {
-      SaveCurve curveFile(plotGui, plotInfo[i], E_SAVE_RESTORE_RAW, m_limitToZoom);
+      if(!updateProgress(i, plotInfo.size()))
+         return;
+      SaveCurve curveFile(displayFormat, plotInfo[i], E_SAVE_RESTORE_RAW, m_limitToZoom);
       curveRawFiles.push_back(curveFile.packedCurveData);
       fileSize += curveFile.packedCurveData.size();
    }
@@ -859,24 +1050,80 @@ void SavePlot::SaveRaw(MainWindow* plotGui, QString plotName, QVector<CurveData*
 
 }
 
-void SavePlot::SaveExcel(MainWindow* plotGui, QVector<CurveData*> &plotInfo, eSaveRestorePlotCurveType type)
+bool SavePlot::saveCurves(SaveDisplayFormat* displayFormat, QVector<CurveSnapshot*>& plotInfo, eSaveRestorePlotCurveType type, std::vector<std::unique_ptr<SaveCurve> >& savedCurves)
+{
+   // Each curve is converted independently (i.e. its own columns in a CSV file or its own array
+   // in a C header), so convert a batch of curves in parallel and check for cancel between batches.
+   int maxThreads = std::max(QThread::idealThreadCount(), 1);
+   QThreadPool threadPool;
+   threadPool.setMaxThreadCount(maxThreads);
+
+   savedCurves.clear();
+   for(int batchStart = 0; batchStart < plotInfo.size(); batchStart += maxThreads)
+   {
+      if(!updateProgress(batchStart, plotInfo.size()))
+         return false;
+
+      int batchEnd = std::min(batchStart + maxThreads, plotInfo.size());
+      std::vector<std::unique_ptr<saveCurveRunner> > runners;
+      for(int i = batchStart; i < batchEnd; ++i)
+      {
+         runners.emplace_back(new saveCurveRunner(displayFormat, plotInfo[i], type, m_limitToZoom));
+         threadPool.start(runners.back().get());
+      }
+      threadPool.waitForDone();
+
+      for(size_t i = 0; i < runners.size(); ++i)
+      {
+         savedCurves.push_back(std::move(runners[i]->saveCurve));
+      }
+   }
+   return true;
+}
+
+void SavePlot::SaveExcel(SaveDisplayFormat* displayFormat, QVector<CurveSnapshot*> &plotInfo, eSaveRestorePlotCurveType type)
 {
    std::string delim = type == E_SAVE_RESTORE_CLIPBOARD_EXCEL ? CLIPBOARD_EXCEL_CELL_DELIM : CSV_CELL_DELIM;
-   QVector<QStringList> curveCsvFiles;
+   std::vector<std::unique_ptr<SaveCurve> > saveCurvesList;
+   if(!saveCurves(displayFormat, plotInfo, type, saveCurvesList))
+      return;
+
+   // Find the non-empty lines of each curve's CSV text. The lines are copied straight from
+   // the curve's text into the combined file.
+   typedef struct
+   {
+      const char* text;
+      size_t size;
+   }tCsvLine;
+   std::vector<std::vector<tCsvLine> > curveCsvFiles;
    QVector<ePlotDim> curvePlotDim;
+   size_t maxTextSize = 0;
    for(int i = 0; i < plotInfo.size(); ++i)
    {
-      SaveCurve curveFile(plotGui, plotInfo[i], type, m_limitToZoom);
-      if(curveFile.hasData())
+      SaveCurve* curveFile = saveCurvesList[i].get();
+      if(curveFile->hasData())
       {
-         curveFile.packedCurveData.push_back('\0'); // Null Terminate to make the char array a string.
-         curveCsvFiles.push_back(QString(&curveFile.packedCurveData[0]).split(EXCEL_LINE_DELIM.c_str(), Qt::SkipEmptyParts));
+         std::vector<tCsvLine> lines;
+         const char* lineStart = curveFile->packedCurveData.data();
+         const char* textEnd = lineStart + curveFile->packedCurveData.size();
+         while(lineStart < textEnd)
+         {
+            const char* lineEnd = std::search(lineStart, textEnd, EXCEL_LINE_DELIM.begin(), EXCEL_LINE_DELIM.end());
+            if(lineEnd > lineStart)
+            {
+               tCsvLine line = {lineStart, (size_t)(lineEnd - lineStart)};
+               lines.push_back(line);
+            }
+            lineStart = (lineEnd < textEnd) ? lineEnd + EXCEL_LINE_DELIM.size() : textEnd;
+         }
+         curveCsvFiles.push_back(lines);
          curvePlotDim.push_back(plotInfo[i]->getPlotDim());
+         maxTextSize += curveFile->packedCurveData.size();
       }
    }
 
-   int maxNumLines = 0;
-   for(int curveIndex = 0; curveIndex < curveCsvFiles.size(); ++curveIndex)
+   size_t maxNumLines = 0;
+   for(size_t curveIndex = 0; curveIndex < curveCsvFiles.size(); ++curveIndex)
    {
       if(curveCsvFiles[curveIndex].size() > maxNumLines)
       {
@@ -884,48 +1131,51 @@ void SavePlot::SaveExcel(MainWindow* plotGui, QVector<CurveData*> &plotInfo, eSa
       }
    }
 
-   QString packed;
-   for(int lineIndex = 0; lineIndex < maxNumLines; ++lineIndex)
+   size_t numCurves = curveCsvFiles.size();
+   textBuffer packed(packedCurveData, maxTextSize + maxNumLines * numCurves * 2 * delim.size());
+   for(size_t lineIndex = 0; lineIndex < maxNumLines; ++lineIndex)
    {
-      int numCurves = curveCsvFiles.size();
-      for(int curveIndex = 0; curveIndex < numCurves; ++curveIndex)
+      for(size_t curveIndex = 0; curveIndex < numCurves; ++curveIndex)
       {
          bool lastColumn = (curveIndex >= (numCurves-1));
          if(curveCsvFiles[curveIndex].size() > lineIndex)
          {
-            packed.append(curveCsvFiles[curveIndex][lineIndex]);
+            const tCsvLine& line = curveCsvFiles[curveIndex][lineIndex];
+            packed.setWritePtr(NumToText::writeStr(packed.getWritePtr(line.size), line.text, line.size));
          }
          else if((curvePlotDim[curveIndex] == E_PLOT_DIM_2D) && !lastColumn)
          {
-            packed.append(delim.c_str()); // No data for this 2D curve, but more curves are available for this row. Add extra demin to make this 2D.
+            packed.append(delim); // No data for this 2D curve, but more curves are available for this row. Add extra demin to make this 2D.
          }
 
          if(!lastColumn)
          {
-            packed.append(delim.c_str());
+            packed.append(delim);
          }
          else
          {
-            packed.append(EXCEL_LINE_DELIM.c_str());
+            packed.append(EXCEL_LINE_DELIM);
          }
       }
    }
-
-   packedCurveData.resize(packed.size());
-   memcpy(&packedCurveData[0], packed.toStdString().c_str(), packed.size());
+   packed.finish();
 }
 
-void SavePlot::SaveCHeader(MainWindow* plotGui, QVector<CurveData*>& plotInfo, eSaveRestorePlotCurveType type)
+void SavePlot::SaveCHeader(SaveDisplayFormat* displayFormat, QVector<CurveSnapshot*>& plotInfo, eSaveRestorePlotCurveType type)
 {
-   for(int i = 0; i < plotInfo.size(); ++i)
+   std::vector<std::unique_ptr<SaveCurve> > saveCurvesList;
+   if(!saveCurves(displayFormat, plotInfo, type, saveCurvesList))
+      return;
+
+   for(size_t i = 0; i < saveCurvesList.size(); ++i)
    {
-      SaveCurve curveFile(plotGui, plotInfo[i], type, m_limitToZoom);
-      packedCurveHead.insert(packedCurveHead.end(), curveFile.packedCurveHead.begin(), curveFile.packedCurveHead.end());
-      packedCurveData.insert(packedCurveData.end(), curveFile.packedCurveData.begin(), curveFile.packedCurveData.end());
+      SaveCurve* curveFile = saveCurvesList[i].get();
+      packedCurveHead.insert(packedCurveHead.end(), curveFile->packedCurveHead.begin(), curveFile->packedCurveHead.end());
+      packedCurveData.insert(packedCurveData.end(), curveFile->packedCurveData.begin(), curveFile->packedCurveData.end());
    }
 }
 
-void SavePlot::SaveBinary(MainWindow* plotGui, QVector<CurveData*>& plotInfo, eSaveRestorePlotCurveType type)
+void SavePlot::SaveBinary(SaveDisplayFormat* displayFormat, QVector<CurveSnapshot*>& plotInfo, eSaveRestorePlotCurveType type)
 {
    packedCurveHead.clear(); // No Header. This is a raw binary file.
    packedCurveData.clear(); // Clear data (it will be modified later in this function)
@@ -938,7 +1188,9 @@ void SavePlot::SaveBinary(MainWindow* plotGui, QVector<CurveData*>& plotInfo, eS
    unsigned numBytesPerPoint = 0;
    for(int i = 0; i < plotInfo.size(); ++i)
    {
-      saveCurves.emplace_back(std::make_shared<SaveCurve>(plotGui, plotInfo[i], type, m_limitToZoom));
+      if(!updateProgress(i, plotInfo.size()))
+         return;
+      saveCurves.emplace_back(std::make_shared<SaveCurve>(displayFormat, plotInfo[i], type, m_limitToZoom));
       saveCurvesRawBytesPtr.emplace_back(saveCurves[i]->hasData() ? saveCurves[i]->packedCurveData.data() : nullptr);
       saveCurvesTypeSize.emplace_back(saveCurves[i]->hasData() ? saveCurves[i]->binary_dataTypeSize : 0); // If no data, this should be zero.
       if(saveCurves[i]->hasData())
@@ -1065,55 +1317,630 @@ RestorePlot::RestorePlot(PackedCurveData &packedPlot)
    isValid = true;
 }
 
-RestoreCsv::RestoreCsv(PackedCurveData &packedPlot)
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+static const char PLOT_FILE_V2_MAGIC[8] = {'\x89', 'P', 'L', 'O', 'T', '\r', '\n', '\x1a'};
+
+// If the first chunk of a curve's points doesn't compress to less than this fraction of its
+// size (e.g. noisy floating point samples), the rest of the chunks are stored uncompressed.
+#define PLOT_FILE_V2_MIN_COMPRESSION_RATIO (0.75)
+
+static void copyPlotFileV2Name(char* dst, const QString& name)
+{
+   // dst is expected to be zeroed, so the copy is always null terminated.
+   std::string nameStr = name.left(MAX_STORE_PLOT_CURVE_NAME_SIZE).toStdString();
+   strncpy(dst, nameStr.c_str(), PLOT_FILE_V2_NAME_SIZE - 1);
+}
+
+SavePlotV2::SavePlotV2(QString path, QString plotName, QVector<CurveSnapshot*>& plotInfo, bool compress,
+                       tSaveProgressCallback progressCallback, void* progressInputPtr):
+   fileWritten(false),
+   m_compress(compress),
+   m_progressCallback(progressCallback),
+   m_progressInputPtr(progressInputPtr),
+   m_numPointsToWrite(0),
+   m_numPointsWritten(0)
 {
-   isValid = false;
+   for(int i = 0; i < plotInfo.size(); ++i)
+   {
+      m_numPointsToWrite += (uint64_t)plotInfo[i]->getNumPoints() * (plotInfo[i]->getPlotDim() == E_PLOT_DIM_2D ? 2 : 1);
+   }
 
-   UINT_32 totalSamplesInCsv = 0;
+   // Write to a temp file first so a partially written plot file is never left behind.
+   QString tempPath = path + ".tmp";
+   QFile file(tempPath);
+   if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+      return; // Early return on failure.
 
-   if(packedPlot.size() <= 0)
+   tPlotFileV2Header header;
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, PLOT_FILE_V2_MAGIC, sizeof(header.magic));
+   header.version = PLOT_FILE_V2_VERSION;
+   header.numCurves = plotInfo.size();
+   copyPlotFileV2Name(header.plotName, plotName);
+
+   // The header is written again at the end, once the curve table offset is known.
+   bool success = file.write((const char*)&header, sizeof(header)) == (int64_t)sizeof(header);
+
+   std::vector<char> curveTable;
+   for(int i = 0; success && i < plotInfo.size(); ++i)
+   {
+      success = writeCurve(file, plotInfo[i], curveTable);
+   }
+
+   if(success)
+   {
+      header.curveTableOffset = file.pos();
+      success = file.write(curveTable.data(), curveTable.size()) == (int64_t)curveTable.size() &&
+                file.seek(0) &&
+                file.write((const char*)&header, sizeof(header)) == (int64_t)sizeof(header);
+   }
+   file.close();
+
+   if(success)
+   {
+      QFile::remove(path);
+      success = QFile::rename(tempPath, path);
+   }
+   if(!success)
+   {
+      QFile::remove(tempPath);
+   }
+   fileWritten = success;
+}
+
+bool SavePlotV2::writeCurve(QFile& file, CurveSnapshot* curve, std::vector<char>& curveTable)
+{
+   tMathOpList mathOpsXAxis = curve->getMathOps(E_X_AXIS);
+   tMathOpList mathOpsYAxis = curve->getMathOps(E_Y_AXIS);
+
+   tPlotFileV2Curve curveHeader;
+   memset(&curveHeader, 0, sizeof(curveHeader));
+   copyPlotFileV2Name(curveHeader.curveName, curve->getCurveTitle());
+   curveHeader.plotDim = curve->getPlotDim();
+   curveHeader.plotType = curve->getPlotType();
+   curveHeader.numPoints = curve->getNumPoints();
+   curveHeader.sampleRate = curve->getSampleRate();
+   curveHeader.numXMapOps = mathOpsXAxis.size();
+   curveHeader.numYMapOps = mathOpsYAxis.size();
+
+   std::vector<tPlotFileV2Chunk> chunks;
+   bool success = writeChunks(file, curve, E_Y_AXIS, chunks);
+   if(success && curveHeader.plotDim == E_PLOT_DIM_2D)
+   {
+      success = writeChunks(file, curve, E_X_AXIS, chunks);
+   }
+   curveHeader.numChunks = chunks.size();
+
+   // Add the curve to the curve table.
+   size_t tableEntrySize =
+         sizeof(curveHeader) +
+         ((curveHeader.numXMapOps + curveHeader.numYMapOps) * sizeof(tOperation)) +
+         (chunks.size() * sizeof(tPlotFileV2Chunk));
+   size_t tableIndex = curveTable.size();
+   curveTable.resize(tableIndex + tableEntrySize);
+   char* packPtr = &curveTable[tableIndex];
+
+   pack(&packPtr, &curveHeader, sizeof(curveHeader));
+   for(tMathOpList::iterator iter = mathOpsXAxis.begin(); iter != mathOpsXAxis.end(); ++iter)
+      pack(&packPtr, &(*iter), sizeof(*iter));
+   for(tMathOpList::iterator iter = mathOpsYAxis.begin(); iter != mathOpsYAxis.end(); ++iter)
+      pack(&packPtr, &(*iter), sizeof(*iter));
+   if(chunks.size() > 0)
+      pack(&packPtr, chunks.data(), chunks.size() * sizeof(tPlotFileV2Chunk));
+
+   return success;
+}
+
+bool SavePlotV2::writeChunks(QFile& file, CurveSnapshot* curve, eAxis axis, std::vector<tPlotFileV2Chunk>& chunks)
+{
+   size_t numPoints = curve->getNumPoints();
+   bool compress = m_compress;
+
+   // The chunks are written straight from the snapshot's samples, in the type they are stored in.
+   const typedSampleVect& points = curve->getOrigPoints(axis);
+   const char* pointBytes = (const char*)points.getStorage();
+   size_t pointSize = points.getSampleSize();
+   for(size_t startIndex = 0; startIndex < numPoints; startIndex += PLOT_FILE_V2_CHUNK_POINTS)
+   {
+      tPlotFileV2Chunk chunk;
+      memset(&chunk, 0, sizeof(chunk));
+      chunk.fileOffset = file.pos();
+      chunk.axis = axis;
+      chunk.compression = E_PLOT_FILE_V2_UNCOMPRESSED;
+      chunk.startIndex = startIndex;
+      chunk.numPoints = std::min(numPoints - startIndex, (size_t)PLOT_FILE_V2_CHUNK_POINTS);
+      chunk.dataType = points.getStorageType();
+      chunk.storedSize = chunk.numPoints * pointSize;
+
+      const char* chunkBytes = pointBytes + (startIndex * pointSize);
+      QByteArray compressed;
+      if(compress)
+      {
+         compressed = qCompress((const uchar*)chunkBytes, (int)chunk.storedSize, 1); // Fastest compression level.
+         if(compressed.size() < (chunk.storedSize * PLOT_FILE_V2_MIN_COMPRESSION_RATIO))
+         {
+            chunkBytes = compressed.constData();
+            chunk.storedSize = compressed.size();
+            chunk.compression = E_PLOT_FILE_V2_ZLIB;
+         }
+         else
+         {
+            compress = false;
+         }
+      }
+
+      if(file.write(chunkBytes, chunk.storedSize) != chunk.storedSize)
+      {
+         return false;
+      }
+      chunks.push_back(chunk);
+
+      m_numPointsWritten += chunk.numPoints;
+      if(m_progressCallback != NULL && !m_progressCallback(m_progressInputPtr, (int)((100 * m_numPointsWritten) / m_numPointsToWrite)))
+      {
+         return false; // Canceled.
+      }
+   }
+   return true;
+}
+
+
+class restorePlotV2Runner : public QRunnable
+{
+public:
+   restorePlotV2Runner(RestorePlotV2* restorePlot, int curveIndex, const tPlotFileV2Chunk& chunk):
+      m_restorePlot(restorePlot), m_curveIndex(curveIndex), m_chunk(chunk), m_success(false)
+   {
+      setAutoDelete(false);
+   }
+   void run(){m_success = m_restorePlot->loadChunk(m_curveIndex, m_chunk);}
+   bool success(){return m_success;}
+private:
+   RestorePlotV2* m_restorePlot;
+   int m_curveIndex;
+   tPlotFileV2Chunk m_chunk;
+   bool m_success;
+};
+
+bool RestorePlotV2::isPlotFileV2(QString path)
+{
+   QFile file(path);
+   char magic[sizeof(PLOT_FILE_V2_MAGIC)];
+   return file.open(QIODevice::ReadOnly) &&
+          file.read(magic, sizeof(magic)) == (int64_t)sizeof(magic) &&
+          memcmp(magic, PLOT_FILE_V2_MAGIC, sizeof(magic)) == 0;
+}
+
+RestorePlotV2::RestorePlotV2(QString path):
+   isValid(false),
+   m_file(path),
+   m_fileMap(NULL),
+   m_fileSize(0)
+{
+   if(!m_file.open(QIODevice::ReadOnly))
+      return; // Invalid, early return.
+
+   m_fileSize = m_file.size();
+   if(m_fileSize < (int64_t)sizeof(tPlotFileV2Header))
+      return; // Invalid, early return.
+
+   // If the file can't be mapped (e.g. too big for a 32 bit address space), the chunks are read in as they are loaded.
+   m_fileMap = (const char*)m_file.map(0, m_fileSize);
+
+   tPlotFileV2Header header;
+   if( !readFile(0, &header, sizeof(header)) ||
+       memcmp(header.magic, PLOT_FILE_V2_MAGIC, sizeof(header.magic)) != 0 ||
+       header.version != PLOT_FILE_V2_VERSION ||
+       memchr(header.plotName, '\0', sizeof(header.plotName)) == NULL ||
+       header.curveTableOffset < (int64_t)sizeof(header) ||
+       header.curveTableOffset > m_fileSize )
+   {
       return; // Invalid, early return.
+   }
+
+   std::vector<char> curveTable(m_fileSize - header.curveTableOffset);
+   if(!readFile(header.curveTableOffset, curveTable.data(), curveTable.size()))
+      return; // Invalid, early return.
+
+   const char* tablePtr = curveTable.data();
+   size_t tableRemaining = curveTable.size();
+
+   params.resize(header.numCurves);
+   m_curveChunks.resize(header.numCurves);
+   for(uint32_t curveIndex = 0; curveIndex < header.numCurves; ++curveIndex)
+   {
+      tSaveRestoreCurveParams& curveParams = params[curveIndex];
+      std::vector<tPlotFileV2Chunk>& chunks = m_curveChunks[curveIndex];
+
+      tPlotFileV2Curve curveHeader;
+      if(tableRemaining < sizeof(curveHeader))
+         return; // Invalid, early return.
+      memcpy(&curveHeader, tablePtr, sizeof(curveHeader));
+      tablePtr += sizeof(curveHeader);
+      tableRemaining -= sizeof(curveHeader);
+
+      curveParams.plotDim = (ePlotDim)curveHeader.plotDim;
+      curveParams.plotType = (ePlotType)curveHeader.plotType;
+      if( memchr(curveHeader.curveName, '\0', sizeof(curveHeader.curveName)) == NULL ||
+          valid_ePlotDim(curveParams.plotDim) == false ||
+          valid_ePlotType(curveParams.plotType) == false )
+      {
+         return; // Invalid, early return.
+      }
+
+      curveParams.curveName = QString(curveHeader.curveName);
+      curveParams.numPoints = curveHeader.numPoints;
+      curveParams.mathProps.sampleRate = curveHeader.sampleRate;
+      curveParams.numXMapOps = curveHeader.numXMapOps;
+      curveParams.numYMapOps = curveHeader.numYMapOps;
+
+      // Get the Math Operations.
+      uint64_t numMapOps = (uint64_t)curveHeader.numXMapOps + curveHeader.numYMapOps;
+      if(tableRemaining < numMapOps * sizeof(tOperation))
+         return; // Invalid, early return.
+      curveParams.mathProps.mathOpsXAxis.clear();
+      curveParams.mathProps.mathOpsYAxis.clear();
+      for(uint64_t i = 0; i < numMapOps; ++i)
+      {
+         tOperation newOp;
+         memcpy(&newOp, tablePtr, sizeof(newOp));
+         tablePtr += sizeof(newOp);
+         tableRemaining -= sizeof(newOp);
+
+         // Validate new operation... return if invalid.
+         if(valid_eMathOp(newOp.op) == false)
+            return;
+
+         if(i < curveHeader.numXMapOps)
+            curveParams.mathProps.mathOpsXAxis.push_back(newOp);
+         else
+            curveParams.mathProps.mathOpsYAxis.push_back(newOp);
+      }
+
+      // Get the chunk table. Each chunk must be in the sample chunk section of the file
+      // and every point of the curve must be stored in a chunk.
+      if(tableRemaining < (uint64_t)curveHeader.numChunks * sizeof(tPlotFileV2Chunk))
+         return; // Invalid, early return.
+      chunks.resize(curveHeader.numChunks);
+      if(curveHeader.numChunks > 0)
+         memcpy(chunks.data(), tablePtr, curveHeader.numChunks * sizeof(tPlotFileV2Chunk));
+      tablePtr += curveHeader.numChunks * sizeof(tPlotFileV2Chunk);
+      tableRemaining -= curveHeader.numChunks * sizeof(tPlotFileV2Chunk);
+
+      uint64_t numXPointsInChunks = 0;
+      uint64_t numYPointsInChunks = 0;
+      for(size_t i = 0; i < chunks.size(); ++i)
+      {
+         const tPlotFileV2Chunk& chunk = chunks[i];
+         ePlotDataTypes dataType = (ePlotDataTypes)chunk.dataType;
+         bool dataTypeValid = chunk.dataType < E_INVALID_DATA_TYPE &&
+                              typedSampleVect::getStorageTypeForDataType(dataType) == dataType;
+         int64_t numBytes = dataTypeValid ? (int64_t)chunk.numPoints * getPlotDataTypeSize(dataType) : 0;
+         bool chunkValid =
+               dataTypeValid &&
+               (chunk.axis == E_Y_AXIS || (chunk.axis == E_X_AXIS && curveParams.plotDim == E_PLOT_DIM_2D)) &&
+               ((uint64_t)chunk.startIndex + chunk.numPoints) <= curveHeader.numPoints &&
+               chunk.fileOffset >= (int64_t)sizeof(header) &&
+               chunk.storedSize >= 0 &&
+               chunk.fileOffset <= header.curveTableOffset - chunk.storedSize &&
+               ( (chunk.compression == E_PLOT_FILE_V2_UNCOMPRESSED && chunk.storedSize == numBytes) ||
+                 (chunk.compression == E_PLOT_FILE_V2_ZLIB && chunk.storedSize <= numBytes) );
+         if(chunkValid == false)
+            return; // Invalid, early return.
+
+         if(chunk.axis == E_X_AXIS)
+            numXPointsInChunks += chunk.numPoints;
+         else
+            numYPointsInChunks += chunk.numPoints;
+      }
+
+      uint64_t numXPointsExpected = curveParams.plotDim == E_PLOT_DIM_2D ? curveHeader.numPoints : 0;
+      if(numYPointsInChunks != curveHeader.numPoints || numXPointsInChunks != numXPointsExpected)
+         return; // Invalid, early return.
+   }
+
+   plotName = QString(header.plotName);
+   isValid = true;
+}
 
-   std::string csvFile(&packedPlot[0], packedPlot.size());
+RestorePlotV2::~RestorePlotV2()
+{
+   if(m_fileMap != NULL)
+      m_file.unmap((uchar*)m_fileMap);
+}
 
-   // Determine the line ending
-   std::string lineEnding;
-   int numDosEnd, numUnxEnd;
+bool RestorePlotV2::readFile(int64_t offset, void* dst, int64_t numBytes)
+{
+   if(m_fileMap != NULL)
+   {
+      memcpy(dst, m_fileMap + offset, numBytes);
+      return true;
+   }
+
+   QMutexLocker lock(&m_fileMutex);
+   return m_file.seek(offset) && m_file.read((char*)dst, numBytes) == numBytes;
+}
+
+bool RestorePlotV2::loadChunk(int curveIndex, const tPlotFileV2Chunk& chunk)
+{
+   dubVect& points = chunk.axis == E_X_AXIS ? params[curveIndex].xOrigPoints : params[curveIndex].yOrigPoints;
+   double* dst = points.data() + chunk.startIndex;
+   ePlotDataTypes dataType = (ePlotDataTypes)chunk.dataType;
+   int64_t numBytes = (int64_t)chunk.numPoints * getPlotDataTypeSize(dataType);
+
+   if(chunk.compression == E_PLOT_FILE_V2_UNCOMPRESSED)
+   {
+      if(dataType == E_FLOAT_64)
+         return readFile(chunk.fileOffset, dst, numBytes);
+      const unsigned char* src = (const unsigned char*)m_fileMap + chunk.fileOffset;
+      if(m_fileMap != NULL && ((uintptr_t)src % getPlotDataTypeSize(dataType)) == 0)
+      {
+         typedSampleVect::convertStorageToDouble(dataType, src, dst, chunk.numPoints);
+         return true;
+      }
+      // Not mapped or not aligned to the sample size, read the chunk in.
+      std::vector<unsigned char> readIn(numBytes);
+      if(!readFile(chunk.fileOffset, readIn.data(), numBytes))
+         return false;
+      typedSampleVect::convertStorageToDouble(dataType, readIn.data(), dst, chunk.numPoints);
+      return true;
+   }
 
-   // Limit the number of characters to search over.
-   if(csvFile.size() <= 500000)
+   const char* compressed = m_fileMap + chunk.fileOffset;
+   std::vector<char> readIn;
+   if(m_fileMap == NULL)
    {
-      numDosEnd = dString::Count(csvFile, "\r\n");
-      numUnxEnd = dString::Count(csvFile, "\n");
+      readIn.resize(chunk.storedSize);
+      if(!readFile(chunk.fileOffset, readIn.data(), chunk.storedSize))
+         return false;
+      compressed = readIn.data();
    }
+
+   QByteArray uncompressed = qUncompress((const uchar*)compressed, (int)chunk.storedSize);
+   if(uncompressed.size() != numBytes)
+      return false;
+   typedSampleVect::convertStorageToDouble(dataType, (const unsigned char*)uncompressed.constData(), dst, chunk.numPoints);
+   return true;
+}
+
+void RestorePlotV2::resizeCurvePoints(int curveIndex)
+{
+   tSaveRestoreCurveParams& curveParams = params[curveIndex];
+   curveParams.yOrigPoints.resize(curveParams.numPoints);
+   if(curveParams.plotDim == E_PLOT_DIM_2D)
+      curveParams.xOrigPoints.resize(curveParams.numPoints);
    else
+      curveParams.xOrigPoints.clear();
+}
+
+bool RestorePlotV2::loadCurve(int curveIndex)
+{
+   if(isValid == false || curveIndex < 0 || curveIndex >= params.size())
+      return false;
+
+   resizeCurvePoints(curveIndex);
+   std::vector<tPlotFileV2Chunk>& chunks = m_curveChunks[curveIndex];
+   for(size_t i = 0; i < chunks.size(); ++i)
+   {
+      if(loadChunk(curveIndex, chunks[i]) == false)
+         return false;
+   }
+   return true;
+}
+
+bool RestorePlotV2::loadAllCurves()
+{
+   if(isValid == false)
+      return false;
+
+   // Size all the curves up front, then each chunk can be loaded straight into place on its own thread.
+   std::vector<std::unique_ptr<restorePlotV2Runner> > runners;
+   for(int curveIndex = 0; curveIndex < params.size(); ++curveIndex)
+   {
+      resizeCurvePoints(curveIndex);
+      std::vector<tPlotFileV2Chunk>& chunks = m_curveChunks[curveIndex];
+      for(size_t i = 0; i < chunks.size(); ++i)
+      {
+         runners.emplace_back(new restorePlotV2Runner(this, curveIndex, chunks[i]));
+      }
+   }
+
+   QThreadPool threadPool;
+   threadPool.setMaxThreadCount(std::max(QThread::idealThreadCount(), 1));
+   for(size_t i = 0; i < runners.size(); ++i)
+   {
+      threadPool.start(runners[i].get());
+   }
+   threadPool.waitForDone();
+
+   bool success = true;
+   for(size_t i = 0; i < runners.size(); ++i)
+   {
+      success = success && runners[i]->success();
+   }
+   return success;
+}
+
+// CSV files are parsed in batches of rows so progress can be reported between batches.
+// Each batch is split on row boundaries between the worker threads.
+#define CSV_RESTORE_BATCH_BYTES (64*1024*1024)
+#define CSV_RESTORE_MIN_BYTES_PER_THREAD (1024*1024)
+
+// Cells are copied to a stack buffer before conversion, so strtod stops at the end of the cell.
+#define CSV_RESTORE_MAX_CELL_SIZE (127)
+
+static double csvCellToDouble(const char* cellStart, const char* cellEnd, bool& badCell)
+{
+   if(cellStart == cellEnd)
    {
-      std::string csvFileSmall = csvFile.substr(0, 500000);
-      numDosEnd = dString::Count(csvFileSmall, "\r\n");
-      numUnxEnd = dString::Count(csvFileSmall, "\n");
+      return NAN; // If cell is empty, set point to "Not A Number"
    }
 
-   if(numDosEnd == 0 || numUnxEnd > (2*numDosEnd))
+   size_t cellSize = cellEnd - cellStart;
+   char cellBuff[CSV_RESTORE_MAX_CELL_SIZE+1];
+   std::string longCell; // Only used (allocated) for cells that don't fit in the stack buffer.
+   const char* cellStr = cellBuff;
+   if(cellSize <= CSV_RESTORE_MAX_CELL_SIZE)
    {
-      lineEnding = "\n";
+      memcpy(cellBuff, cellStart, cellSize);
+      cellBuff[cellSize] = '\0';
    }
    else
    {
-      lineEnding = "\r\n";
+      longCell.assign(cellStart, cellSize);
+      cellStr = longCell.c_str();
+   }
+
+   char* parseEnd = NULL;
+   double newValue = strtod(cellStr, &parseEnd);
+   if(parseEnd == cellStr)
+   {
+      badCell = true;
+   }
+   return newValue;
+}
+
+// Parses a range of CSV rows into its own column vectors. The runners are reused for
+// every batch, so the column vectors only allocate while they grow to the batch size.
+class restoreCsvRunner : public QRunnable
+{
+public:
+   restoreCsvRunner(int numCol, bool dosLineEnding):
+      m_numCol(numCol), m_dosLineEnding(dosLineEnding), m_rowsStart(NULL), m_rowsEnd(NULL), m_hasBadCells(false), m_columns(numCol)
+   {
+      setAutoDelete(false);
+   }
+
+   void setRows(const char* rowsStart, const char* rowsEnd)
+   {
+      m_rowsStart = rowsStart;
+      m_rowsEnd = rowsEnd;
+      for(int i = 0; i < m_numCol; ++i)
+      {
+         m_columns[i].clear();
+      }
+   }
+
+   void run()
+   {
+      const char* rowStart = m_rowsStart;
+      while(rowStart < m_rowsEnd)
+      {
+         const char* rowEnd = (const char*)memchr(rowStart, '\n', m_rowsEnd - rowStart);
+         const char* nextRow = rowEnd != NULL ? rowEnd + 1 : m_rowsEnd;
+         if(rowEnd == NULL)
+         {
+            rowEnd = m_rowsEnd;
+         }
+         else if(m_dosLineEnding && rowEnd > rowStart && rowEnd[-1] == '\r')
+         {
+            --rowEnd;
+         }
+
+         parseRow(rowStart, rowEnd);
+         rowStart = nextRow;
+      }
+   }
+
+   bool hasBadCells(){return m_hasBadCells;}
+   dubVect& getColumn(int colIndex){return m_columns[colIndex];}
+
+private:
+   void parseRow(const char* rowStart, const char* rowEnd)
+   {
+      int colIndex = 0;
+      const char* colPtr = rowStart;
+      const char* delimPos = (const char*)memchr(colPtr, CSV_CELL_DELIM_CHAR, rowEnd - colPtr); // Returns NULL if no match is found.
+
+      // Keep looping until Num Columns is hit or no more delimiters exist.
+      while(colIndex < m_numCol && delimPos)
+      {
+         m_columns[colIndex].push_back(csvCellToDouble(colPtr, delimPos, m_hasBadCells));
+
+         colPtr = delimPos + 1;
+         delimPos = (const char*)memchr(colPtr, CSV_CELL_DELIM_CHAR, rowEnd - colPtr);
+         ++colIndex;
+      }
+
+      // Handle last column that has no delmiter after it.
+      if(colIndex < m_numCol)
+      {
+         m_columns[colIndex].push_back(csvCellToDouble(colPtr, rowEnd, m_hasBadCells));
+      }
+   }
+
+   int m_numCol;
+   bool m_dosLineEnding;
+   const char* m_rowsStart;
+   const char* m_rowsEnd;
+   bool m_hasBadCells;
+   std::vector<dubVect> m_columns;
+};
+
+// Returns the start of the row after 'pos' (or 'end' if there isn't one).
+static const char* csvNextRowStart(const char* pos, const char* end)
+{
+   if(pos >= end)
+      return end;
+   const char* lineEnd = (const char*)memchr(pos, '\n', end - pos);
+   return lineEnd != NULL ? lineEnd + 1 : end;
+}
+
+RestoreCsv::RestoreCsv(PackedCurveData &packedPlot, tRestoreCsvProgressCallback progressCallback, void* progressInputPtr)
+{
+   isValid = false;
+   hasBadCells = false;
+
+   UINT_32 totalSamplesInCsv = 0;
+
+   if(packedPlot.size() <= 0)
+      return; // Invalid, early return.
+
+   // Parse straight out of the file buffer, no copies of the file or its rows are made.
+   const char* csvStart = &packedPlot[0];
+   const char* csvEnd = csvStart + packedPlot.size();
+
+   // Determine the line ending. Limit the number of characters to search over.
+   size_t searchSize = std::min(packedPlot.size(), (size_t)500000);
+   int numDosEnd = 0, numUnxEnd = 0;
+   for(size_t i = 0; i < searchSize; ++i)
+   {
+      if(csvStart[i] == '\n')
+      {
+         ++numUnxEnd;
+         if(i > 0 && csvStart[i-1] == '\r')
+            ++numDosEnd;
+      }
    }
 
-   // Split file into rows.
-   std::vector<std::string> csvRows;
-   dString::SplitV(csvFile, lineEnding, csvRows);
-   while(csvRows[csvRows.size()-1] == "") // Remove empty lines from the bottom.
+   bool dosLineEnding = !(numDosEnd == 0 || numUnxEnd > (2*numDosEnd));
+   const char* lineEnding = dosLineEnding ? "\r\n" : "\n";
+   size_t lineEndingSize = strlen(lineEnding);
+
+   // Remove empty lines from the bottom.
+   while((size_t)(csvEnd - csvStart) >= lineEndingSize && memcmp(csvEnd - lineEndingSize, lineEnding, lineEndingSize) == 0)
    {
-      csvRows.pop_back();
+      csvEnd -= lineEndingSize;
    }
+   if(csvEnd == csvStart)
+      return; // Invalid, early return.
 
    try
    {
+      const char* dataStart = csvNextRowStart(csvStart, csvEnd);
+      const char* firstRowEnd = dataStart;
+      if(firstRowEnd > csvStart && firstRowEnd[-1] == '\n')
+         --firstRowEnd;
+      if(dosLineEnding && firstRowEnd > csvStart && firstRowEnd[-1] == '\r')
+         --firstRowEnd;
+      std::string firstRow(csvStart, firstRowEnd - csvStart);
+
       std::vector<std::string> csvCells;
-      dString::SplitV(csvRows[0], CSV_CELL_DELIM, csvCells);
+      dString::SplitV(firstRow, CSV_CELL_DELIM, csvCells);
 
       // Determine if the first row is a header row.
       bool firstRowIsAllNums = true;
@@ -1131,39 +1958,86 @@ RestoreCsv::RestoreCsv(PackedCurveData &packedPlot)
       params.resize(numCol);
 
       // Fill in the values from the CSV File.
-      int rowStart = firstRowIsAllNums ? 0 : 1;
-      int numRows = (int)csvRows.size();
+      const char* rowsStart = firstRowIsAllNums ? csvStart : dataStart;
+      size_t numThreads = std::max(QThread::idealThreadCount(), 1);
 
-      for(int rowIndex = rowStart; rowIndex < numRows; ++rowIndex)
+      QThreadPool threadPool;
+      threadPool.setMaxThreadCount((int)numThreads);
+      std::vector<std::unique_ptr<restoreCsvRunner>> runners;
+      for(size_t i = 0; i < numThreads; ++i)
       {
-         int colIndex = 0;
-         const char* colPtr = csvRows[rowIndex].c_str();
-         const char* endPtr = colPtr + csvRows[rowIndex].size();
-         const char* delimPos = strchr(colPtr, CSV_CELL_DELIM_CHAR); // Returns NULL if no match is found.
+         runners.emplace_back(new restoreCsvRunner(numCol, dosLineEnding));
+      }
+
+      const char* batchStart = rowsStart;
+      while(batchStart < csvEnd)
+      {
+         const char* batchEnd = (size_t)(csvEnd - batchStart) > CSV_RESTORE_BATCH_BYTES ?
+            csvNextRowStart(batchStart + CSV_RESTORE_BATCH_BYTES, csvEnd) : csvEnd;
+
+         // Split the batch on row boundaries, each thread gets a contiguous range of rows.
+         size_t bytesPerThread = std::max(((size_t)(batchEnd - batchStart) + numThreads - 1) / numThreads, (size_t)CSV_RESTORE_MIN_BYTES_PER_THREAD);
+         size_t numRunners = 0;
+         const char* runnerStart = batchStart;
+         while(runnerStart < batchEnd && numRunners < numThreads)
+         {
+            const char* runnerEnd = (numRunners == numThreads-1 || (size_t)(batchEnd - runnerStart) <= bytesPerThread) ?
+               batchEnd : csvNextRowStart(runnerStart + bytesPerThread, batchEnd);
+            runners[numRunners]->setRows(runnerStart, runnerEnd);
+            runnerStart = runnerEnd;
+            ++numRunners;
+         }
+
+         if(numRunners == 1)
+         {
+            runners[0]->run();
+         }
+         else
+         {
+            for(size_t i = 0; i < numRunners; ++i)
+            {
+               threadPool.start(runners[i].get());
+            }
+            threadPool.waitForDone();
+         }
 
-         // Keep looping until Num Columns is hit or no more delimiters exist.
-         while(colIndex < numCol && delimPos)
+         if(batchStart == rowsStart && batchEnd < csvEnd)
          {
-            double newValue = colPtr != delimPos ? strtod(colPtr, NULL) : NAN; // If cell is empty, set point to "Not A Number"
-            params[colIndex].yOrigPoints.push_back(newValue);
+            // Use the first batch to estimate the final column sizes, to avoid growing the columns over and over.
+            double bytesRatio = (double)(csvEnd - rowsStart) / (double)(batchEnd - rowsStart);
+            for(int col = 0; col < numCol; ++col)
+            {
+               size_t batchSize = 0;
+               for(size_t i = 0; i < numRunners; ++i)
+               {
+                  batchSize += runners[i]->getColumn(col).size();
+               }
+               params[col].yOrigPoints.reserve((size_t)(bytesRatio * (double)batchSize * 1.05));
+            }
+         }
 
-            colPtr = delimPos + 1;
-            delimPos = strchr(colPtr, CSV_CELL_DELIM_CHAR);
-            ++colIndex;
+         // Append the parsed values to the columns, in row order.
+         for(size_t i = 0; i < numRunners; ++i)
+         {
+            hasBadCells = hasBadCells || runners[i]->hasBadCells();
+            for(int col = 0; col < numCol; ++col)
+            {
+               dubVect& runnerColumn = runners[i]->getColumn(col);
+               dubVect& column = params[col].yOrigPoints;
+               column.insert(column.end(), runnerColumn.begin(), runnerColumn.end());
+            }
          }
 
-         // Handle last column that has no delmiter after it.
-         if(colIndex < numCol)
+         batchStart = batchEnd;
+         if(progressCallback != NULL)
          {
-            double newValue = colPtr != endPtr ? strtod(colPtr, NULL) : NAN; // If cell is empty, set point to "Not A Number"
-            params[colIndex].yOrigPoints.push_back(newValue);
+            progressCallback(progressInputPtr, (int)(100.0 * (double)(batchStart - rowsStart) / (double)(csvEnd - rowsStart)));
          }
       }
 
       // Get curve names from first row.
       if(firstRowIsAllNums == false)
       {
-         dString::SplitV(csvRows[0], CSV_CELL_DELIM, csvCells);
          for(int i = 0; i < numCol; ++i)
          {
             params[i].curveName = csvCells[i].c_str();
@@ -1208,6 +2082,119 @@ RestoreCsv::RestoreCsv(PackedCurveData &packedPlot)
 ////////////////////////////////////////////////////////////////////////////////
 
 
+// Saves of big plots can take a long time. They get their own thread pool so they don't hold
+// up the short jobs (plot message ingest, child curves) on the global thread pool.
+static QThreadPool* backgroundPlotSaveThreadPool()
+{
+   static QThreadPool threadPool;
+   return &threadPool;
+}
+
+class backgroundPlotSaveRunner : public QRunnable
+{
+public:
+   backgroundPlotSaveRunner(BackgroundPlotSave* backgroundSave): m_backgroundSave(backgroundSave){}
+   void run(){m_backgroundSave->save();}
+private:
+   BackgroundPlotSave* m_backgroundSave;
+};
+
+void BackgroundPlotSave::start(MainWindow* plotGui, QString path, QString plotName, QVector<CurveData*>& plotInfo, eSaveRestorePlotCurveType type, bool limitToZoom)
+{
+   BackgroundPlotSave* backgroundSave = new BackgroundPlotSave(plotGui, path, plotName, plotInfo, type, limitToZoom);
+   backgroundPlotSaveThreadPool()->start(new backgroundPlotSaveRunner(backgroundSave));
+}
+
+BackgroundPlotSave::BackgroundPlotSave(MainWindow* plotGui, QString path, QString plotName, QVector<CurveData*>& plotInfo, eSaveRestorePlotCurveType type, bool limitToZoom):
+   m_path(path),
+   m_plotName(plotName),
+   m_type(type),
+   m_limitToZoom(limitToZoom),
+   m_displayFormat(plotGui),
+   m_progressDialog(NULL),
+   m_canceled(0)
+{
+   // Snapshotting the curves is the only part of the save that runs on the GUI thread. Keep the
+   // plot message ingest worker from changing the samples mid snapshot.
+   {
+      QMutexLocker lock(plotGui->getCurvesMutex());
+      for(int i = 0; i < plotInfo.size(); ++i)
+      {
+         m_snapshots.emplace_back(new CurveSnapshot(plotInfo[i], type, limitToZoom));
+         m_curves.push_back(m_snapshots.back().get());
+      }
+   }
+
+   // Not parented to the plot, the plot can be closed while the save is running.
+   m_progressDialog = new QProgressDialog("Saving " + path, "Cancel", 0, 100);
+   m_progressDialog->setWindowModality(Qt::NonModal);
+   m_progressDialog->setMinimumDuration(1000);
+
+   connect(this, SIGNAL(progressSignal(int)), m_progressDialog, SLOT(setValue(int)), Qt::QueuedConnection);
+   connect(this, SIGNAL(finishedSignal(bool)), this, SLOT(finished(bool)), Qt::QueuedConnection);
+   connect(m_progressDialog, SIGNAL(canceled()), this, SLOT(cancel()));
+}
+
+BackgroundPlotSave::~BackgroundPlotSave()
+{
+   delete m_progressDialog;
+}
+
+void BackgroundPlotSave::save()
+{
+   bool fileWritten = false;
+   if(m_type == E_SAVE_RESTORE_RAW)
+   {
+      SavePlotV2 savePlot(m_path, m_plotName, m_curves, true, saveProgress, this);
+      fileWritten = savePlot.fileWritten;
+   }
+   else
+   {
+      SavePlot savePlot(&m_displayFormat, m_plotName, m_curves, m_type, m_limitToZoom, saveProgress, this);
+      if(savePlot.canceled == false)
+      {
+         // Write the header and data straight to the file, instead of packing them together first.
+         QFile file(m_path);
+         fileWritten = file.open(QIODevice::WriteOnly | QIODevice::Truncate) &&
+                       file.write(savePlot.packedCurveHead.data(), savePlot.packedCurveHead.size()) == (qint64)savePlot.packedCurveHead.size() &&
+                       file.write(savePlot.packedCurveData.data(), savePlot.packedCurveData.size()) == (qint64)savePlot.packedCurveData.size();
+      }
+   }
+
+   // Done with the snapshots, free them now rather than waiting for the GUI thread to delete this object.
+   m_curves.clear();
+   m_snapshots.clear();
+
+   emit finishedSignal(fileWritten); // Nothing can be done with this object after this, it may be deleted.
+}
+
+bool BackgroundPlotSave::saveProgress(void* backgroundSave, int percentDone)
+{
+   BackgroundPlotSave* self = (BackgroundPlotSave*)backgroundSave;
+   emit self->progressSignal(percentDone);
+   return self->m_canceled.loadAcquire() == 0;
+}
+
+void BackgroundPlotSave::cancel()
+{
+   m_canceled.storeRelease(1);
+}
+
+void BackgroundPlotSave::finished(bool fileWritten)
+{
+   if(fileWritten == false && m_canceled.loadAcquire() == 0)
+   {
+      QMessageBox::warning(NULL, "Save Failed", "Failed to write " + m_path);
+   }
+   deleteLater();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////////
+
+
 bool SavePlotCurveDialog::saveCurve(const QString& plotName, const QString& curveName)
 {
    bool fileWritten = false;
@@ -1364,11 +2351,7 @@ bool SavePlotCurveDialog::savePlot(const QString& plotName)
 
          if(saveType != E_SAVE_RESTORE_INVALID)
          {
-            SavePlot savePlot(allPlots[plotName].plotGui, plotName, curves, saveType, true);
-            PackedCurveData dataToWriteToFile;
-            savePlot.getPackedData(dataToWriteToFile);
-            fso::WriteFile(fileName.toStdString(), &dataToWriteToFile[0], dataToWriteToFile.size());
-
+            BackgroundPlotSave::start(allPlots[plotName].plotGui, fileName, plotName, curves, saveType, true);
             fileWritten = true;
          }
       }
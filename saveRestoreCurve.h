@@ -20,11 +20,19 @@
 #define saveRestoreCurve_h
 
 #include <vector>
+#include <memory>
+#include <sstream>
+#include <stdint.h>
 #include <QWidget>
+#include <QFile>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QProgressDialog>
 #include "DataTypes.h"
 #include "CurveData.h"
 #include "mainwindow.h"
 #include "CurveCommander.h"
+#include "numToText.h"
 
 #define MAX_STORE_PLOT_CURVE_NAME_SIZE (100)
 
@@ -73,10 +81,84 @@ typedef struct
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Called with the percent of the save that is done. Returns false to cancel the save.
+typedef bool (*tSaveProgressCallback)(void*, int);
+
+// Copy of everything the save code needs from a curve. It is taken on the GUI thread, so the curve
+// can keep updating (or be removed) while the copy is written out on a worker thread. Only the points
+// that 'type' saves are copied. The getters match CurveData's.
+class CurveSnapshot
+{
+public:
+   CurveSnapshot(CurveData* curve, eSaveRestorePlotCurveType type, bool limitToZoom);
+
+   QString getCurveTitle(){return m_curveTitle;}
+   ePlotDim getPlotDim(){return m_plotDim;}
+   ePlotType getPlotType(){return m_plotType;}
+   unsigned int getNumPoints(){return m_numPoints;}
+   double getSampleRate(){return m_sampleRate;}
+   tMathOpList getMathOps(eAxis axis){return axis == E_X_AXIS ? m_mathOpsXAxis : m_mathOpsYAxis;}
+   ePlotDataTypes getLastMsgDataType(eAxis axis){return axis == E_X_AXIS ? m_lastMsgXAxisType : m_lastMsgYAxisType;}
+
+   const double* getXPoints(){return m_xPoints.constData();}
+   const double* getYPoints(){return m_yPoints.constData();}
+   maxMinXY get1dDisplayedIndexes(){return m_1dDisplayedIndexes;}
+   void get2dDisplayedPoints(dubVect& xAxis, dubVect& yAxis);
+
+   void getOrigXPoints(dubVect& ioXPoints){ioXPoints.resize(m_xOrigPoints.size()); m_xOrigPoints.get(0, ioXPoints.data(), ioXPoints.size());}
+   void getOrigYPoints(dubVect& ioYPoints){ioYPoints.resize(m_yOrigPoints.size()); m_yOrigPoints.get(0, ioYPoints.data(), ioYPoints.size());}
+   void getOrigXPoints(size_t startIndex, double* ioXPoints, size_t numPoints){m_xOrigPoints.get(startIndex, ioXPoints, numPoints);}
+   void getOrigYPoints(size_t startIndex, double* ioYPoints, size_t numPoints){m_yOrigPoints.get(startIndex, ioYPoints, numPoints);}
+   // The original samples in the type they are stored in (see typedSampleVect).
+   const typedSampleVect& getOrigPoints(eAxis axis){return axis == E_X_AXIS ? m_xOrigPoints : m_yOrigPoints;}
+
+private:
+   CurveSnapshot();
+   CurveSnapshot(CurveSnapshot const&);
+   void operator=(CurveSnapshot const&);
+
+   QString m_curveTitle;
+   ePlotDim m_plotDim;
+   ePlotType m_plotType;
+   unsigned int m_numPoints;
+   double m_sampleRate;
+   tMathOpList m_mathOpsXAxis;
+   tMathOpList m_mathOpsYAxis;
+   ePlotDataTypes m_lastMsgXAxisType;
+   ePlotDataTypes m_lastMsgYAxisType;
+
+   // The samples share the curve's memory (copy on write), so taking a snapshot doesn't copy them.
+   sampleVect m_xPoints; // Only the displayed points for 2D curves when limiting to the zoom.
+   sampleVect m_yPoints;
+   maxMinXY m_1dDisplayedIndexes;
+   typedSampleVect m_xOrigPoints;
+   typedSampleVect m_yOrigPoints;
+};
+
+// Copy of the plot's name and number display settings, used by the text save types.
+class SaveDisplayFormat
+{
+public:
+   SaveDisplayFormat(MainWindow* plotGui);
+   SaveDisplayFormat(QString plotName, eDisplayPointType displayType, int displayPrecision);
+
+   QString getPlotName(){return m_plotName;}
+   NumToText getXAxisFormat(CurveSnapshot* curve);
+   NumToText getYAxisFormat();
+
+private:
+   QString m_plotName;
+   eDisplayPointType m_displayType;
+   int m_displayPrecision;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 class SaveCurve
 {
 public:
    SaveCurve(MainWindow* plotGui, CurveData* curve, eSaveRestorePlotCurveType type, bool limitToZoom = false);
+   SaveCurve(SaveDisplayFormat* displayFormat, CurveSnapshot* curve, eSaveRestorePlotCurveType type, bool limitToZoom = false);
    void getPackedData(PackedCurveData& packedDataReturn);
 
    PackedCurveData packedCurveHead;
@@ -93,10 +175,11 @@ private:
    SaveCurve(SaveCurve const&);
    void operator=(SaveCurve const&);
 
-   void SaveRaw(CurveData* curve);
-   void SaveExcel(MainWindow* plotGui, CurveData* curve, std::string delim);
-   void SaveCHeader(MainWindow* plotGui, CurveData* curve, eSaveRestorePlotCurveType type);
-   void SaveBinary(CurveData* curve, eSaveRestorePlotCurveType type);
+   void save(SaveDisplayFormat* displayFormat, CurveSnapshot* curve, eSaveRestorePlotCurveType type);
+   void SaveRaw(CurveSnapshot* curve);
+   void SaveExcel(SaveDisplayFormat* displayFormat, CurveSnapshot* curve, std::string delim);
+   void SaveCHeader(SaveDisplayFormat* displayFormat, CurveSnapshot* curve, eSaveRestorePlotCurveType type);
+   void SaveBinary(CurveSnapshot* curve, eSaveRestorePlotCurveType type);
 
    bool m_limitToZoom;
    bool m_hasData = false;
@@ -132,22 +215,34 @@ class SavePlot
 {
 public:
    SavePlot(MainWindow* plotGui, QString plotName, QVector<CurveData*>& plotInfo, eSaveRestorePlotCurveType type, bool limitToZoom = false);
+   SavePlot(SaveDisplayFormat* displayFormat, QString plotName, QVector<CurveSnapshot*>& plotInfo, eSaveRestorePlotCurveType type, bool limitToZoom = false,
+            tSaveProgressCallback progressCallback = NULL, void* progressInputPtr = NULL);
    void getPackedData(PackedCurveData& packedDataReturn);
 
    PackedCurveData packedCurveHead;
    PackedCurveData packedCurveData;
+
+   bool canceled;
 private:
 
    SavePlot();
    SavePlot(SavePlot const&);
    void operator=(SavePlot const&);
 
-   void SaveRaw(MainWindow* plotGui, QString plotName, QVector<CurveData*>& plotInfo);
-   void SaveExcel(MainWindow* plotGui, QVector<CurveData*>& plotInfo, eSaveRestorePlotCurveType type);
-   void SaveCHeader(MainWindow* plotGui, QVector<CurveData*>& plotInfo, eSaveRestorePlotCurveType type);
-   void SaveBinary(MainWindow* plotGui, QVector<CurveData*>& plotInfo, eSaveRestorePlotCurveType type);
+   void save(SaveDisplayFormat* displayFormat, QString plotName, QVector<CurveSnapshot*>& plotInfo, eSaveRestorePlotCurveType type);
+   void SaveRaw(SaveDisplayFormat* displayFormat, QString plotName, QVector<CurveSnapshot*>& plotInfo);
+   void SaveExcel(SaveDisplayFormat* displayFormat, QVector<CurveSnapshot*>& plotInfo, eSaveRestorePlotCurveType type);
+   void SaveCHeader(SaveDisplayFormat* displayFormat, QVector<CurveSnapshot*>& plotInfo, eSaveRestorePlotCurveType type);
+   void SaveBinary(SaveDisplayFormat* displayFormat, QVector<CurveSnapshot*>& plotInfo, eSaveRestorePlotCurveType type);
+
+   bool updateProgress(int curveIndex, int numCurves); // Returns false if the save was canceled.
+
+   // Runs SaveCurve on all the curves, several at a time. Returns false if the save was canceled.
+   bool saveCurves(SaveDisplayFormat* displayFormat, QVector<CurveSnapshot*>& plotInfo, eSaveRestorePlotCurveType type, std::vector<std::unique_ptr<SaveCurve> >& savedCurves);
 
    bool m_limitToZoom;
+   tSaveProgressCallback m_progressCallback;
+   void* m_progressInputPtr;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -170,15 +265,129 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Version 2 plot files (.plot). Layout:
+//    tPlotFileV2Header
+//    Sample chunks (each chunk is a range of one curve's X or Y points, optionally compressed)
+//    Curve table, for each curve: tPlotFileV2Curve, X math ops, Y math ops, tPlotFileV2Chunk for each chunk
+// The curve table is at the end since the chunk offsets aren't known until the chunks are written.
+// A plot with no curves and a curve with no points (and so no chunks) are both valid.
+// The chunks are stored in the curve's storage type (see typedSampleVect), restoring widens them to double.
+// Version 1 plot files (RestorePlot) start with the plot name, which can't start with the magic bytes.
+#define PLOT_FILE_V2_VERSION (3) // 3: chunks are stored in the curve's storage type instead of double.
+#define PLOT_FILE_V2_NAME_SIZE (104) // Room for MAX_STORE_PLOT_CURVE_NAME_SIZE chars plus null term, padded to 8 bytes.
+#define PLOT_FILE_V2_CHUNK_POINTS (1<<20)
+
+typedef enum
+{
+   E_PLOT_FILE_V2_UNCOMPRESSED,
+   E_PLOT_FILE_V2_ZLIB // qCompress / qUncompress
+}ePlotFileV2Compression;
+
+typedef struct
+{
+   char magic[8];
+   uint32_t version;
+   uint32_t numCurves;
+   int64_t curveTableOffset;
+   char plotName[PLOT_FILE_V2_NAME_SIZE];
+}tPlotFileV2Header;
+
+typedef struct
+{
+   char curveName[PLOT_FILE_V2_NAME_SIZE];
+   int32_t plotDim;
+   int32_t plotType;
+   uint32_t numPoints;
+   uint32_t numXMapOps;
+   double sampleRate;
+   uint32_t numYMapOps;
+   uint32_t numChunks;
+}tPlotFileV2Curve;
+
+typedef struct
+{
+   int64_t fileOffset;
+   int64_t storedSize; // Size in the file, i.e. the compressed size if the chunk is compressed.
+   uint32_t axis;      // eAxis, E_X_AXIS or E_Y_AXIS.
+   uint32_t compression; // ePlotFileV2Compression
+   uint32_t startIndex;
+   uint32_t numPoints;
+   uint32_t dataType;  // ePlotDataTypes the points are stored as.
+   uint32_t reserved;
+}tPlotFileV2Chunk;
+
+class SavePlotV2
+{
+public:
+   // Writes the plot file one chunk at a time, the whole plot is never packed in memory.
+   SavePlotV2(QString path, QString plotName, QVector<CurveSnapshot*>& plotInfo, bool compress = true,
+              tSaveProgressCallback progressCallback = NULL, void* progressInputPtr = NULL);
+
+   bool fileWritten;
+
+private:
+   SavePlotV2();
+   SavePlotV2(SavePlotV2 const&);
+   void operator=(SavePlotV2 const&);
+
+   bool writeCurve(QFile& file, CurveSnapshot* curve, std::vector<char>& curveTable);
+   bool writeChunks(QFile& file, CurveSnapshot* curve, eAxis axis, std::vector<tPlotFileV2Chunk>& chunks);
+
+   bool m_compress;
+   tSaveProgressCallback m_progressCallback;
+   void* m_progressInputPtr;
+   uint64_t m_numPointsToWrite;
+   uint64_t m_numPointsWritten;
+};
+
+class RestorePlotV2
+{
+public:
+   // Only reads in the header and curve table. The points are loaded with loadCurve / loadAllCurves.
+   RestorePlotV2(QString path);
+   ~RestorePlotV2();
+
+   static bool isPlotFileV2(QString path);
+
+   bool loadCurve(int curveIndex);
+   bool loadAllCurves(); // Loads the chunks in parallel.
+
+   QString plotName;
+   QVector<tSaveRestoreCurveParams> params; // The points are empty until the curve is loaded.
+
+   bool isValid;
+
+private:
+   RestorePlotV2();
+   RestorePlotV2(RestorePlotV2 const&);
+   void operator=(RestorePlotV2 const&);
+
+   friend class restorePlotV2Runner;
+   bool readFile(int64_t offset, void* dst, int64_t numBytes);
+   bool loadChunk(int curveIndex, const tPlotFileV2Chunk& chunk);
+   void resizeCurvePoints(int curveIndex);
+
+   QFile m_file;
+   const char* m_fileMap; // NULL if the file couldn't be mapped, chunks are read in instead.
+   int64_t m_fileSize;
+   QMutex m_fileMutex;
+   std::vector<std::vector<tPlotFileV2Chunk> > m_curveChunks;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+// Called with the percent of the CSV file that has been parsed so far.
+typedef void (*tRestoreCsvProgressCallback)(void*, int);
+
 class RestoreCsv
 {
 public:
-   RestoreCsv(PackedCurveData &packedPlot);
+   RestoreCsv(PackedCurveData &packedPlot, tRestoreCsvProgressCallback progressCallback = NULL, void* progressInputPtr = NULL);
 
    QVector<tSaveRestoreCurveParams> params;
 
    bool isValid;
-   bool hasBadCells;
+   bool hasBadCells; // Non-empty cells that could not be parsed as a number (they are restored as 0).
 
 private:
    RestoreCsv();
@@ -188,6 +397,48 @@ private:
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Saves a plot to a file on a worker thread, so the GUI (and live data) keeps running while a
+// large plot is formatted and written. The curves are snapshotted when the save is started.
+// A progress dialog (with a cancel button) shows up if the save takes a while.
+class BackgroundPlotSave : public QObject
+{
+   Q_OBJECT
+public:
+   // The object deletes itself when the save is done.
+   static void start(MainWindow* plotGui, QString path, QString plotName, QVector<CurveData*>& plotInfo, eSaveRestorePlotCurveType type, bool limitToZoom);
+
+signals:
+   void progressSignal(int percentDone);
+   void finishedSignal(bool fileWritten);
+
+private slots:
+   void cancel();
+   void finished(bool fileWritten);
+
+private:
+   BackgroundPlotSave(MainWindow* plotGui, QString path, QString plotName, QVector<CurveData*>& plotInfo, eSaveRestorePlotCurveType type, bool limitToZoom);
+   ~BackgroundPlotSave();
+   BackgroundPlotSave(BackgroundPlotSave const&);
+   void operator=(BackgroundPlotSave const&);
+
+   friend class backgroundPlotSaveRunner;
+   void save(); // Runs on the worker thread.
+   static bool saveProgress(void* backgroundSave, int percentDone);
+
+   QString m_path;
+   QString m_plotName;
+   eSaveRestorePlotCurveType m_type;
+   bool m_limitToZoom;
+   SaveDisplayFormat m_displayFormat;
+   std::vector<std::unique_ptr<CurveSnapshot> > m_snapshots;
+   QVector<CurveSnapshot*> m_curves;
+
+   QProgressDialog* m_progressDialog;
+   QAtomicInt m_canceled;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 class CurveCommander;
 
 class SavePlotCurveDialog
@@ -197,7 +448,7 @@ public:
       : m_widgetParent(widgetParent), m_curveCmdr(curveCmdr), m_limitToZoom(limitToZoom){}
 
    bool saveCurve(const QString& plotName, const QString& curveName); // Returns whether the file was saved or not.
-   bool savePlot(const QString& plotName); // Returns whether the file was saved or not.
+   bool savePlot(const QString& plotName); // Returns whether the file save was started or not (the save runs in the background).
 
 private:
    SavePlotCurveDialog();
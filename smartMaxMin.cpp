@@ -1,4 +1,4 @@
-/* Copyright 2015 - 2019, 2021 - 2022, 2025 Dan Williams. All Rights Reserved.
+/* Copyright 2015 - 2019, 2021 - 2022, 2025 - 2026 Dan Williams. All Rights Reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of this
  * software and associated documentation files (the "Software"), to deal in the Software
@@ -22,10 +22,18 @@
 #include <assert.h>
 #include "smartMaxMin.h"
 
-smartMaxMin::smartMaxMin(const dubVect *srcVect, unsigned int minSegSize, unsigned int maxSegSize):
-   m_minSegSize(minSegSize),
-   m_maxSegSize(maxSegSize),
+// Number of nodes in one level of the pyramid that are combined into a single node of the level above.
+#define MAXMIN_PYRAMID_FANOUT (16)
+
+// Absolute sample indexes are stored as int. Once scrolling has pushed the start index past this
+// point, the pyramid is rebuilt starting from 0 to avoid overflow.
+#define MAXMIN_PYRAMID_MAX_ABS_START (1 << 30)
+
+smartMaxMin::smartMaxMin(const sampleVect* srcVect, unsigned int leafSize):
+   m_leafSize(leafSize),
    m_srcVect(srcVect),
+   m_absStart(0),
+   m_absEnd(0),
    m_curMax(0.0),
    m_curMin(0.0),
    m_curMaxMinHasRealPoints(false),
@@ -39,6 +47,42 @@ smartMaxMin::~smartMaxMin()
 
 }
 
+void smartMaxMin::copyFrom(const smartMaxMin& src)
+{
+   m_leafSize = src.m_leafSize;
+   m_absStart = src.m_absStart;
+   m_absEnd = src.m_absEnd;
+   m_levels = src.m_levels;
+   m_curMax = src.m_curMax;
+   m_curMin = src.m_curMin;
+   m_curMaxMinHasRealPoints = src.m_curMaxMinHasRealPoints;
+   m_firstRealPointIndex = src.m_firstRealPointIndex;
+   m_lastRealPointIndex = src.m_lastRealPointIndex;
+}
+
+void smartMaxMin::swap(smartMaxMin& other)
+{
+   std::swap(m_leafSize, other.m_leafSize);
+   std::swap(m_absStart, other.m_absStart);
+   std::swap(m_absEnd, other.m_absEnd);
+   m_levels.swap(other.m_levels);
+   std::swap(m_curMax, other.m_curMax);
+   std::swap(m_curMin, other.m_curMin);
+   std::swap(m_curMaxMinHasRealPoints, other.m_curMaxMinHasRealPoints);
+   std::swap(m_firstRealPointIndex, other.m_firstRealPointIndex);
+   std::swap(m_lastRealPointIndex, other.m_lastRealPointIndex);
+}
+
+size_t smartMaxMin::getNumBytes()
+{
+   size_t numBytes = 0;
+   for(size_t i = 0; i < m_levels.size(); ++i)
+   {
+      numBytes += sizeof(tMaxMinSegment) * m_levels[i].nodes.capacity();
+   }
+   return numBytes;
+}
+
 
 void smartMaxMin::updateMaxMin(unsigned int startIndex, unsigned int numPoints)
 {
@@ -49,138 +93,60 @@ void smartMaxMin::updateMaxMin(unsigned int startIndex, unsigned int numPoints)
       return;
    }
 
-   unsigned int newSegStartIndex = startIndex;
-   unsigned int newSegNumPoints = srcVectSize - startIndex;
-   bool overlapFound = false;
+   int oldAbsEnd = m_absEnd;
+   m_absEnd = m_absStart + srcVectSize;
+   resizeLevels();
 
-   unsigned int lastSegEndIndex = 0;
+   int dirtyStart = m_absStart + startIndex;
+   int dirtyEnd = dirtyStart + numPoints;
 
-   // Find and remove any segments that overlap with the new segment.
-   tSegList::iterator iter = m_segList.begin();
-   while(iter != m_segList.end())
+   if(m_absEnd != oldAbsEnd)
    {
-      if(overlapFound == false)
+      // The source vector changed size. Any new points need to be added and the
+      // previous last node might not have been full.
+      int resizeStart = std::min(oldAbsEnd, m_absEnd) - 1;
+      if(resizeStart > dirtyEnd)
       {
-
-         lastSegEndIndex = iter->startIndex + iter->numPoints;
-
-         if( ((int)startIndex >= iter->startIndex) && (startIndex < lastSegEndIndex) )
-         {
-            overlapFound = true;
-            newSegStartIndex = iter->startIndex;
-            m_segList.erase(iter++);
-         }
-         else
-         {
-            ++iter;
-         }
+         recalcRange(resizeStart, m_absEnd);
       }
       else
       {
-         if(iter->startIndex >= (int)(startIndex + numPoints))
-         {
-            newSegNumPoints = iter->startIndex - newSegStartIndex;
-
-            // Overlap is over. Break out of while early.
-            break;
-         }
-         else
-         {
-            // This segment is fully encapsulated by the new points.
-            m_segList.erase(iter++);
-         }
-      }
-
-      // If this is the last segment and we are still overlapping,
-      // set the update size to go to the end of the vector.
-      if(iter == m_segList.end() && overlapFound == true)
-      {
-         newSegNumPoints = srcVectSize - newSegStartIndex;
+         dirtyStart = std::min(dirtyStart, resizeStart);
+         dirtyEnd = m_absEnd;
       }
    }
 
-   // If there is no overlap between the new samples and the old samples, then
-   // the new samples are ahead of the old samples. Check if there is a gap between
-   // the new samples and the old samples.
-   if(overlapFound == false && lastSegEndIndex < startIndex)
-   {
-      // There is a gap between the new samples and the old samples.
-      // It is safe to assume all the samples in the gap are NAN (not-a-number).
-      // Create a new Segment with the max and min set to NAN.
-      tMaxMinSegment newSeg;
-      newSeg.maxValue = NAN;
-      newSeg.minValue = NAN;
-      newSeg.startIndex = lastSegEndIndex;
-      newSeg.numPoints = startIndex - lastSegEndIndex;
-      newSeg.maxIndex = newSeg.startIndex;
-      newSeg.minIndex = newSeg.startIndex;
-      newSeg.realPoints = false;
-      newSeg.firstRealPointIndex = newSeg.startIndex;
-      newSeg.lastRealPointIndex = newSeg.startIndex + newSeg.numPoints - 1;
-      m_segList.push_back(newSeg);
-   }
-
-   int nextSegStartIndex = newSegStartIndex;
-   int pointsRemaining = newSegNumPoints;
-   while(pointsRemaining > 0)
-   {
-      tMaxMinSegment newSeg;
-      unsigned int calcSize = std::min(pointsRemaining, m_maxSegSize);
-
-      calcMaxMinOfSeg(m_srcVect->data(), nextSegStartIndex, calcSize, newSeg);
-      m_segList.push_back(newSeg);
-
-      nextSegStartIndex += calcSize;
-      pointsRemaining -= calcSize;
-   }
-
-   m_segList.sort();
+   recalcRange(dirtyStart, dirtyEnd);
 
-   combineSegments();
    calcTotalMaxMin();
-
-   //debug_verifyAllPointsAreInList();
 }
 
 void smartMaxMin::scrollModeShift(unsigned int shiftAmount)
 {
-   unsigned int numPointsErased = 0;
-   tSegList::iterator iter = m_segList.begin();
-   while(iter != m_segList.end())
-   {
-      unsigned int startIndex = iter->startIndex;
-      unsigned int numPoints = iter->numPoints;
+   unsigned int srcVectSize = m_srcVect->size();
+   int oldAbsEnd = m_absEnd;
 
-      if( (startIndex + numPoints) <= shiftAmount)
-      {
-         // All samples have been shifted out.
-         m_segList.erase(iter++);
-         numPointsErased += numPoints;
-      }
-      else if(startIndex < shiftAmount)
-      {
-         // Part of the segment has been shifted out. Re-calc min/max on the remaining points.
-         calcMaxMinOfSeg(m_srcVect->data(), 0, numPoints + numPointsErased - shiftAmount, *iter);
-         ++iter;
-      }
-      else
-      {
-         // All of the samples in this segment will remain. Just need to shift all the indexes
-         // into the curve data.
-         iter->startIndex -= shiftAmount;
-         iter->maxIndex -= shiftAmount;
-         iter->minIndex -= shiftAmount;
-         iter->firstRealPointIndex -= shiftAmount;
-         iter->lastRealPointIndex  -= shiftAmount;
-
-         ++iter;
-      }
+   if( shiftAmount >= srcVectSize ||
+       (m_absStart + shiftAmount + srcVectSize) >= (unsigned int)MAXMIN_PYRAMID_MAX_ABS_START )
+   {
+      // Everything has been shifted out (or the absolute indexes are getting too large), start over.
+      m_absStart = 0;
+      m_absEnd = srcVectSize;
+      rebuildLevels();
+   }
+   else
+   {
+      // Shift the window of absolute sample indexes. Nodes that have been completely shifted out are
+      // dropped from the front of each level, only the partial nodes at either end need to be recalculated.
+      m_absStart += shiftAmount;
+      m_absEnd = m_absStart + srcVectSize;
+      resizeLevels();
+      recalcRange(m_absStart, m_absStart + 1);
+      recalcRange(std::max(oldAbsEnd - 1, m_absStart), m_absEnd);
    }
 
    // Segments might have changed, update min / max.
    calcTotalMaxMin();
-
-   //debug_verifySegmentsAreContiguous();
 }
 
 void smartMaxMin::getMaxMin(double &retMax, double &retMin, bool& retReal)
@@ -198,152 +164,223 @@ void smartMaxMin::getFirstLastReal(int& firstRealPointIndex, int& lastRealPointI
 
 void smartMaxMin::handleShortenedNumPoints()
 {
-   int srcVectSize = m_srcVect->size();
-   tSegList::iterator iter = m_segList.begin();
-   while(iter != m_segList.end())
-   {
-      if(iter->startIndex >= srcVectSize)
-      {
-         m_segList.erase(iter++);
-      }
-      else
-      {
-         if( (iter->startIndex + iter->numPoints) >= srcVectSize )
-         {
-            calcMaxMinOfSeg(m_srcVect->data(), iter->startIndex, srcVectSize - iter->startIndex, *iter);
-         }
-         iter++;
-      }
-   }
+   m_absEnd = m_absStart + m_srcVect->size();
+   resizeLevels();
+
+   // The last node of each level might now be partial.
+   recalcRange(m_absEnd - 1, m_absEnd);
 
    // Segments might have changed, update min / max.
    calcTotalMaxMin();
 }
 
+// Returns the min / max of the points in the specified range. The nodes of the pyramid are used
+// for all the points they fully cover, only the points at the beginning / end of the range that
+// don't fill a whole level 0 node are looked at individually.
 tMaxMinSegment smartMaxMin::getMinMaxOfSubrange(unsigned int start, unsigned int numPoints)
 {
-   tSegList::iterator iter = m_segList.begin();
-   return getMinMaxOfSubrange(start, numPoints, iter);
+   tMaxMinSegment retVal;
+   const double* srcData = m_srcVect->data();
+
+   int absStart = m_absStart + start;
+   int absEnd = absStart + numPoints;
+   int firstLeaf = (absStart + m_leafSize - 1) / m_leafSize; // First leaf fully in the range.
+   int endLeaf = absEnd / m_leafSize; // 1 past the last leaf fully in the range.
+
+   if(m_levels.size() == 0 || firstLeaf >= endLeaf || absEnd > m_absEnd)
+   {
+      // Range doesn't contain any full nodes, just calculate from the source points.
+      calcMaxMinOfSeg(srcData, start, numPoints, retVal);
+   }
+   else
+   {
+      // Be careful of the order. Needs to be before, then pyramid nodes, then after.
+      tMaxMinSegment nodeSeg = combineNodes(0, firstLeaf, endLeaf);
+      tMaxMinSegment afterSeg;
+      offsetSegIndexes(nodeSeg, -m_absStart);
+
+      calcMaxMinOfSeg(srcData, start, firstLeaf*m_leafSize - absStart, retVal);
+      calcMaxMinOfSeg(srcData, endLeaf*m_leafSize - m_absStart, absEnd - endLeaf*m_leafSize, afterSeg);
+      combineSegments(retVal, nodeSeg);
+      combineSegments(retVal, afterSeg);
+   }
+
+   return retVal;
 }
 
-tMaxMinSegment smartMaxMin::getMinMaxOfSubrange(unsigned int start, unsigned int numPoints, tSegList::iterator& iterInOut)
+// Combine nodes [firstNode, endNode) of the specified level. Uses the level above for any run of
+// nodes that make up a whole node in the level above.
+tMaxMinSegment smartMaxMin::combineNodes(size_t level, int firstNode, int endNode)
 {
    tMaxMinSegment retVal;
-   retVal.startIndex = 0;
-   retVal.numPoints = 0;
+   initEmptySeg(retVal, getNode(level, firstNode).startIndex);
 
-   bool segFound = false;
+   int firstParent = (firstNode + MAXMIN_PYRAMID_FANOUT - 1) / MAXMIN_PYRAMID_FANOUT;
+   int endParent = endNode / MAXMIN_PYRAMID_FANOUT;
+   if((level + 1) < m_levels.size() && firstParent < endParent)
+   {
+      int i;
+      for(i = firstNode; i < firstParent*MAXMIN_PYRAMID_FANOUT; ++i)
+      {
+         combineSegments(retVal, getNode(level, i));
+      }
+      combineSegments(retVal, combineNodes(level + 1, firstParent, endParent));
+      for(i = endParent*MAXMIN_PYRAMID_FANOUT; i < endNode; ++i)
+      {
+         combineSegments(retVal, getNode(level, i));
+      }
+   }
+   else
+   {
+      for(int i = firstNode; i < endNode; ++i)
+      {
+         combineSegments(retVal, getNode(level, i));
+      }
+   }
+   return retVal;
+}
 
-   int stop = start + numPoints;
-   tSegList::iterator iter = iterInOut;
-   if(iter != m_segList.end())
+// Make sure each level has exactly the nodes needed to cover [m_absStart, m_absEnd). Nodes that
+// are added are not initialized, the caller is responsible for calling recalcRange on them.
+void smartMaxMin::resizeLevels()
+{
+   if(m_absEnd <= m_absStart)
    {
-      while(iter != m_segList.end())
+      m_levels.clear();
+      return;
+   }
+
+   int nodeSpan = m_leafSize;
+   size_t level = 0;
+   while(true)
+   {
+      int firstNode = m_absStart / nodeSpan;
+      int lastNode = (m_absEnd - 1) / nodeSpan;
+      size_t numNodes = lastNode - firstNode + 1;
+
+      if(level >= m_levels.size())
+      {
+         tMaxMinLevel newLevel;
+         newLevel.begin = 0;
+         newLevel.firstNode = firstNode;
+         m_levels.push_back(newLevel);
+      }
+
+      tMaxMinLevel& curLevel = m_levels[level];
+      if(firstNode > curLevel.firstNode)
       {
-         int segStop = iter->startIndex + iter->numPoints;
-         if(iter->startIndex >= (int)start)
+         size_t numToDrop = std::min((size_t)(firstNode - curLevel.firstNode), curLevel.nodes.size() - curLevel.begin);
+         curLevel.begin += numToDrop;
+         if(curLevel.begin > (curLevel.nodes.size() / 2))
          {
-            if(segStop <= stop)
-            {
-               // Segment is fully contained in the input range. Add it to the retVal.
-               if(!segFound)
-               {
-                  segFound = true;
-                  retVal = *iter;
-               }
-               else
-               {
-                  retVal.numPoints += iter->numPoints;
-
-                  if(iter->maxValue > retVal.maxValue)
-                  {
-                     retVal.maxValue = iter->maxValue;
-                     retVal.maxIndex = iter->maxIndex;
-                  }
-                  if(iter->minValue < retVal.minValue)
-                  {
-                     retVal.minValue = iter->minValue;
-                     retVal.minIndex = iter->minIndex;
-                  }
-
-                  if(!retVal.realPoints && iter->realPoints)
-                  {
-                     // New segment has first real points.
-                     retVal.realPoints = true;
-                     retVal.firstRealPointIndex = iter->firstRealPointIndex;
-                     retVal.lastRealPointIndex = iter->lastRealPointIndex;
-                  }
-                  else if(iter->realPoints)
-                  {
-                     retVal.lastRealPointIndex = iter->lastRealPointIndex;
-                  }
-               }
-            }
-            else
-            {
-               break;
-            }
+            curLevel.nodes.erase(curLevel.nodes.begin(), curLevel.nodes.begin() + curLevel.begin);
+            curLevel.begin = 0;
          }
-         iterInOut = iter;
-         ++iter;
       }
+      curLevel.firstNode = firstNode;
+      curLevel.nodes.resize(curLevel.begin + numNodes);
+
+      if(numNodes <= 1)
+      {
+         // This is the top level.
+         m_levels.resize(level + 1);
+         break;
+      }
+
+      nodeSpan *= MAXMIN_PYRAMID_FANOUT;
+      ++level;
    }
-   return retVal;
 }
 
-void smartMaxMin::calcTotalMaxMin()
+void smartMaxMin::rebuildLevels()
+{
+   m_levels.clear();
+   resizeLevels();
+   recalcRange(m_absStart, m_absEnd);
+}
+
+// Recalculate the level 0 nodes that cover the absolute sample range [absStart, absEnd), then
+// recalculate their parent nodes all the way up to the top of the pyramid.
+void smartMaxMin::recalcRange(int absStart, int absEnd)
 {
-   tSegList::iterator iter = m_segList.begin();
-   if(iter != m_segList.end())
+   absStart = std::max(absStart, m_absStart);
+   absEnd = std::min(absEnd, m_absEnd);
+   if(absStart >= absEnd || m_levels.size() == 0)
    {
-      double newMax = iter->maxValue;
-      double newMin = iter->minValue;
-      bool maxMinIsRealValue = iter->realPoints;
-      int firstRealPointIndex = iter->firstRealPointIndex;
-      int lastRealPointIndex  = iter->lastRealPointIndex;
+      return;
+   }
 
-      ++iter;
+   const double* srcData = m_srcVect->data();
+   int firstNode = absStart / m_leafSize;
+   int lastNode = (absEnd - 1) / m_leafSize;
+
+   for(int i = firstNode; i <= lastNode; ++i)
+   {
+      int segStart = std::max(i * m_leafSize, m_absStart);
+      int segEnd = std::min((i + 1) * m_leafSize, m_absEnd);
+      tMaxMinSegment& node = getNode(0, i);
+      calcMaxMinOfSeg(srcData, segStart - m_absStart, segEnd - segStart, node);
+      offsetSegIndexes(node, m_absStart);
+   }
+
+   for(size_t level = 1; level < m_levels.size(); ++level)
+   {
+      int firstChild = m_levels[level-1].firstNode;
+      int lastChild = getLastNode(level-1);
 
-      while(iter != m_segList.end())
+      firstNode /= MAXMIN_PYRAMID_FANOUT;
+      lastNode /= MAXMIN_PYRAMID_FANOUT;
+      for(int i = firstNode; i <= lastNode; ++i)
       {
-         // Only update Max/Min if the new segment contains real numbers.
-         if(iter->realPoints)
+         int childStart = std::max(i * MAXMIN_PYRAMID_FANOUT, firstChild);
+         int childStop = std::min((i + 1) * MAXMIN_PYRAMID_FANOUT - 1, lastChild);
+         tMaxMinSegment& node = getNode(level, i);
+         node = getNode(level-1, childStart);
+         for(int child = childStart + 1; child <= childStop; ++child)
          {
-            if(!maxMinIsRealValue)
-            {
-               // Old segment(s) did not contain real numbers. New segment has real numbers. So, use the new segment values.
-               newMax = iter->maxValue;
-               newMin = iter->minValue;
-            }
-            else
-            {
-               if(iter->maxValue > newMax)
-               {
-                  newMax = iter->maxValue;
-               }
-               if(iter->minValue < newMin)
-               {
-                  newMin = iter->minValue;
-               }
-            }
-            maxMinIsRealValue = true;
-
-            // Determine first / last real point index.
-            if(firstRealPointIndex < 0)
-            {
-               firstRealPointIndex = iter->firstRealPointIndex;
-            }
-            lastRealPointIndex = iter->lastRealPointIndex;
+            combineSegments(node, getNode(level-1, child));
          }
-
-         ++iter;
       }
+   }
+}
 
-      m_curMax = newMax;
-      m_curMin = newMin;
-      m_curMaxMinHasRealPoints = maxMinIsRealValue;
-      m_firstRealPointIndex = firstRealPointIndex;
-      m_lastRealPointIndex = lastRealPointIndex;
+void smartMaxMin::calcTotalMaxMin()
+{
+   if(m_levels.size() > 0)
+   {
+      // The top level of the pyramid covers all the points.
+      tMaxMinSegment total = getNode(m_levels.size() - 1, m_levels.back().firstNode);
+      m_curMax = total.maxValue;
+      m_curMin = total.minValue;
+      m_curMaxMinHasRealPoints = total.realPoints;
+      m_firstRealPointIndex = total.realPoints ? total.firstRealPointIndex - m_absStart : -1;
+      m_lastRealPointIndex  = total.realPoints ? total.lastRealPointIndex - m_absStart : -1;
+   }
+}
+
+void smartMaxMin::initEmptySeg(tMaxMinSegment& seg, int startIndex)
+{
+   seg.maxValue = 1;
+   seg.minValue = -1;
+   seg.maxIndex = -1;
+   seg.minIndex = -1;
+   seg.startIndex = startIndex;
+   seg.numPoints = 0;
+   seg.realPoints = false;
+   seg.firstRealPointIndex = -1;
+   seg.lastRealPointIndex  = -1;
+}
+
+// Converts between source vector indexes and absolute sample indexes.
+void smartMaxMin::offsetSegIndexes(tMaxMinSegment& seg, int offset)
+{
+   seg.startIndex += offset;
+   if(seg.realPoints)
+   {
+      seg.maxIndex += offset;
+      seg.minIndex += offset;
+      seg.firstRealPointIndex += offset;
+      seg.lastRealPointIndex  += offset;
    }
 }
 
@@ -448,126 +485,70 @@ void smartMaxMin::combineSegments(tMaxMinSegment& seg1, const tMaxMinSegment& se
    seg1.numPoints += seg2.numPoints;
 }
 
-// Combine small segments.
-void smartMaxMin::combineSegments()
-{
-   // All the segments must be contiguous after this point.
-   //debug_verifySegmentsAreContiguous();
-   //debug_verifyAllPointsAreInList();
 
-   tSegList::iterator cur = m_segList.begin();
-   tSegList::iterator next;
-   while(cur != m_segList.end())
+// Find the parts of the curve where the points are in the range [start, stop]. Whole pyramid nodes
+// that are in range are returned in 'full', individual points that are in range are returned in 'partial'.
+void smartMaxMin::getSegmentsInRange(double start, double stop, tSegList& full, std::vector<unsigned int>& partial)
+{
+   full.clear();
+   partial.clear();
+   if(m_levels.size() > 0)
    {
-      next = cur;
-      ++next;
-
-      if(next != m_segList.end())
-      {
-         // Check if the two segments together are small enough to combine.
-         if( (cur->numPoints + next->numPoints) < m_minSegSize )
-         {
-            // Combine cur and next then erase next.
-            combineSegments(*cur, *next);
-            m_segList.erase(next);
-         }
-         else
-         {
-            // Segments aren't small enough to combine. Move on to the next pair of segments to check.
-            ++cur;
-         }
-      }
-      else
+      size_t topLevel = m_levels.size() - 1;
+      for(int i = m_levels[topLevel].firstNode; i <= getLastNode(topLevel); ++i)
       {
-         // Next segment is the end of the list. Increment cur to exit the loop.
-         ++cur;
+         getSegmentsInRange(topLevel, i, start, stop, full, partial);
       }
    }
-
-
-   //debug_verifySegmentsAreContiguous();
-   //debug_verifyAllPointsAreInList();
 }
 
-void smartMaxMin::debug_verifySegmentsAreContiguous()
+void smartMaxMin::getSegmentsInRange(size_t level, int nodeNum, double start, double stop, tSegList& full, std::vector<unsigned int>& partial)
 {
-   int nextSegExpectedStart = 0;
-   tSegList::iterator iter = m_segList.begin();
-   while(iter != m_segList.end())
+   const tMaxMinSegment& node = getNode(level, nodeNum);
+   if(!node.realPoints || node.maxValue < start || node.minValue > stop)
    {
-      if(nextSegExpectedStart != iter->startIndex)
-      {
-         printf("Gap Between Segments\n");
-      }
-
-      nextSegExpectedStart = iter->startIndex + iter->numPoints;
-
-      ++iter;
+      // No points in range.
+      return;
    }
-}
 
-void smartMaxMin::debug_verifyAllPointsAreInList()
-{
-   unsigned int srcSize = m_srcVect->size();
-   unsigned int nextSegExpectedStart = 0;
-   tSegList::iterator iter = m_segList.begin();
-   while(iter != m_segList.end())
+   if(node.minValue >= start && node.maxValue <= stop)
    {
-      unsigned int startIndex = iter->startIndex;
-      unsigned int numPoints = iter->numPoints;
-      unsigned int endIndex = startIndex + numPoints;
-
-      if(nextSegExpectedStart != startIndex)
+      // The whole node is in range.
+      tMaxMinSegment seg = node;
+      offsetSegIndexes(seg, -m_absStart);
+      if(full.size() > 0 && (full.back().startIndex + full.back().numPoints) == seg.startIndex)
       {
-         printf("Gap Between Segments\n");
+         combineSegments(full.back(), seg); // Contiguous with the previous segment, just extend it.
       }
-
-      nextSegExpectedStart = endIndex;
-
-      ++iter;
-      if(iter == m_segList.end())
+      else
       {
-         if(endIndex != srcSize)
-         {
-            printf("Gap Between Last Segement and End of Samples\n");
-         }
+         full.push_back(seg);
       }
    }
-}
-
-void smartMaxMin::getSegmentsInRange(double start, double stop, tSegList& full, std::vector<unsigned int>& partial)
-{
-   full.clear();
-   partial.clear();
-   tSegList::iterator iter = m_segList.begin();
-   while(iter != m_segList.end())
+   else if(level == 0)
    {
-      if(iter->realPoints)
+      // Only some points are in range. Store off the points that are in range.
+      for(int i = node.firstRealPointIndex; i <= node.lastRealPointIndex; ++i)
       {
-         bool minInRange = (iter->minValue >= start && iter->minValue <= stop);
-         bool maxInRange = (iter->maxValue >= start && iter->maxValue <= stop);
-         bool rangeContainedInThisSeg = (iter->maxValue >= stop && iter->minValue <= start);
-         if(minInRange && maxInRange)
+         double point = (*m_srcVect)[i - m_absStart];
+         if(point >= start && point <= stop)
          {
-            full.push_back(*iter); // The whole segment is in range.
-         }
-         else if(minInRange || maxInRange || rangeContainedInThisSeg)
-         {
-            // Only some points are in range. Store off the points that are in range.
-            for(int i = iter->firstRealPointIndex; i <= iter->lastRealPointIndex; ++i)
-            {
-               double point = (*m_srcVect)[i];
-               if(point >= start && point <= stop)
-               {
-                  partial.push_back(i);
-               }
-            }
+            partial.push_back(i - m_absStart);
          }
       }
-      ++iter;
+   }
+   else
+   {
+      int childStart = std::max(nodeNum * MAXMIN_PYRAMID_FANOUT, m_levels[level-1].firstNode);
+      int childStop = std::min((nodeNum + 1) * MAXMIN_PYRAMID_FANOUT - 1, getLastNode(level-1));
+      for(int child = childStart; child <= childStop; ++child)
+      {
+         getSegmentsInRange(level - 1, child, start, stop, full, partial);
+      }
    }
 }
 
+// Find the max / min of this curve's points at the indexes that were found by another curve's getSegmentsInRange.
 void smartMaxMin::getMaxMinFromSegments(tSegList& fullIn, std::vector<unsigned int>& partial, double &retMax, double &retMin, bool& retReal)
 {
    retReal = false;
@@ -575,82 +556,24 @@ void smartMaxMin::getMaxMinFromSegments(tSegList& fullIn, std::vector<unsigned i
    retMin = 0;
    
    // First deal with the full matching ranges.
-   tSegList::iterator fullIter = fullIn.begin();
-   while(fullIter != fullIn.end())
+   for(size_t segIndex = 0; segIndex < fullIn.size(); ++segIndex)
    {
-      tSegList::iterator thisIter = m_segList.begin();
-      int matchingMinIndex = -1;
-      int matchingMaxIndex = 0;
-      while(thisIter != m_segList.end())
-      {
-         bool startInRange = thisIter->startIndex >= fullIter->startIndex;
-         bool stopInRange  = (thisIter->startIndex+thisIter->numPoints) <= (fullIter->startIndex+fullIter->numPoints);
-
-         if(startInRange && stopInRange)
-         {
-            // The entire input segment is contained within this segment.
-            if(thisIter->realPoints)
-            {
-               if(!retReal)
-               {
-                  retReal = true;
-                  retMax = thisIter->maxValue;
-                  retMin = thisIter->minValue;
-               }
-               else
-               {
-                  retMax = std::max(retMax, thisIter->maxValue);
-                  retMin = std::min(retMin, thisIter->minValue);
-               }
-            }
-
-            if(matchingMinIndex < 0)
-               matchingMinIndex = thisIter->minIndex;
-            matchingMaxIndex = thisIter->maxIndex;
-         }
-         ++thisIter;
-      }
-
-      // Grab points that weren't whole segments.
-      for(int i = fullIter->minIndex; i < matchingMinIndex; ++i)
+      tMaxMinSegment seg = getMinMaxOfSubrange(fullIn[segIndex].startIndex, fullIn[segIndex].numPoints);
+      if(seg.realPoints)
       {
-         double point = (*m_srcVect)[i];
-         if(isDoubleValid(point))
+         if(!retReal)
          {
-            if(!retReal)
-            {
-               retReal = true;
-               retMax = point;
-               retMin = point;
-            }
-            else
-            {
-               retMax = std::max(retMax, point);
-               retMin = std::min(retMin, point);
-            }
+            retReal = true;
+            retMax = seg.maxValue;
+            retMin = seg.minValue;
          }
-      }
-      for(int i = matchingMaxIndex+1; i < fullIter->maxIndex; ++i)
-      {
-         double point = (*m_srcVect)[i];
-         if(isDoubleValid(point))
+         else
          {
-            if(!retReal)
-            {
-               retReal = true;
-               retMax = point;
-               retMin = point;
-            }
-            else
-            {
-               retMax = std::max(retMax, point);
-               retMin = std::min(retMin, point);
-            }
+            retMax = std::max(retMax, seg.maxValue);
+            retMin = std::min(retMin, seg.minValue);
          }
       }
-
-      ++fullIter;
-   } // End while(fullIter != fullIn.end())
+   }
 
    // Account for the parial points.
    size_t numPartial = partial.size();
@@ -675,43 +598,3 @@ void smartMaxMin::getMaxMinFromSegments(tSegList& fullIn, std::vector<unsigned i
    }
 }
 
-
-
-fastMonotonicMaxMin::fastMonotonicMaxMin(smartMaxMin& parent):
-   m_parent(parent),
-   m_parentIter(m_parent.getBeginIter())
-{
-
-}
-
-tMaxMinSegment fastMonotonicMaxMin::getMinMaxInRange(unsigned int start, unsigned int len)
-{
-   tMaxMinSegment seg = m_parent.getMinMaxOfSubrange(start, len, m_parentIter);
-   const double* srcData = m_parent.getSrcVect()->data();
-   tMaxMinSegment retValSeg;
-
-   if(seg.numPoints > 0)
-   {
-      // Got some points from smartMaxMin. Include the samples before and after the points from smartMaxMin.
-      tMaxMinSegment beforeSeg, afterSeg;
-      int beforeSegLen = seg.startIndex - start;
-      int afterSegLen = len - beforeSegLen - seg.numPoints;
-
-      // Get the segments before and after.
-      smartMaxMin::calcMaxMinOfSeg(srcData, start, beforeSegLen, beforeSeg);
-      smartMaxMin::calcMaxMinOfSeg(srcData, seg.startIndex+seg.numPoints, afterSegLen, afterSeg);
-
-      // Combine the segments (Be careful of the order. Needs to be beforeSeg, then seg, then afterSeg).
-      retValSeg = beforeSeg;
-      smartMaxMin::combineSegments(retValSeg, seg);
-      smartMaxMin::combineSegments(retValSeg, afterSeg);
-   }
-   else
-   {
-      // No segments in smartMaxMin were fully contained in the desire range. Manually do the min/max measurement.
-      smartMaxMin::calcMaxMinOfSeg(m_parent.getSrcVect()->data(), start, len, retValSeg);
-   }
-
-   return retValSeg;
-}
-
@@ -1,4 +1,4 @@
-/* Copyright 2015 - 2017, 2019, 2021 - 2022 Dan Williams. All Rights Reserved.
+/* Copyright 2015 - 2017, 2019, 2021 - 2022, 2026 Dan Williams. All Rights Reserved.
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of this
  * software and associated documentation files (the "Software"), to deal in the Software
@@ -19,20 +19,21 @@
 #ifndef SMARTMAXMIN_H
 #define SMARTMAXMIN_H
 
-#include <list>
+#include <vector>
 #include "PlotHelperTypes.h"
+#include "sampleVect.h"
 
 typedef struct MaxMinSegment
 {
+   double maxValue;
+   double minValue;
    int startIndex;
    int numPoints;
    int maxIndex;
-   double maxValue;
    int minIndex;
-   double minValue;
-   bool realPoints; // If true at least 1 of the points in the segment is a real, valid value.
    int firstRealPointIndex;
    int lastRealPointIndex;
+   bool realPoints; // If true at least 1 of the points in the segment is a real, valid value.
 
 
    bool operator>(const struct MaxMinSegment& rhs)
@@ -53,12 +54,25 @@ typedef struct MaxMinSegment
    }
 }tMaxMinSegment;
 
-typedef std::list<tMaxMinSegment> tSegList;
+typedef std::vector<tMaxMinSegment> tSegList;
 
+// One level of the min/max pyramid. Level 0 nodes each cover 'leafSize' source points, each node
+// in the levels above covers MAXMIN_PYRAMID_FANOUT nodes of the level below.
+typedef struct
+{
+   tSegList nodes;
+   size_t begin; // Nodes before 'begin' have been scrolled out. They are removed in bulk to avoid a memmove on every scroll.
+   int firstNode; // Node number of nodes[begin].
+}tMaxMinLevel;
+
+// Keeps track of the min / max of the source vector in a multi-resolution pyramid so that the
+// min / max of any range of points can be found without looking at every point in the range.
+// Node indexes are absolute sample indexes (i.e. source vector index + m_absStart) so that
+// scrolling only has to touch the nodes at the beginning and end of each level.
 class smartMaxMin
 {
 public:
-   smartMaxMin(const dubVect* srcVect, unsigned int minSegSize, unsigned int maxSegSize);
+   smartMaxMin(const sampleVect* srcVect, unsigned int leafSize);
    ~smartMaxMin();
 
    void updateMaxMin(unsigned int startIndex, unsigned int numPoints);
@@ -70,9 +84,13 @@ public:
    void handleShortenedNumPoints();
 
    tMaxMinSegment getMinMaxOfSubrange(unsigned int start, unsigned int numPoints);
-   tMaxMinSegment getMinMaxOfSubrange(unsigned int start, unsigned int numPoints, tSegList::iterator& iterInOut);
-   tSegList::iterator getBeginIter(){return m_segList.begin();}
-   const dubVect* getSrcVect(){return m_srcVect;}
+   const sampleVect* getSrcVect(){return m_srcVect;}
+   size_t getNumBytes();
+
+   // Copy / swap the pyramid of another smartMaxMin. Each keeps its own source vector, which
+   // needs to hold the same samples as the other's.
+   void copyFrom(const smartMaxMin& src);
+   void swap(smartMaxMin& other);
 
    static void calcMaxMinOfSeg(const double* srcPoints, unsigned int startIndex, unsigned int numPoints, tMaxMinSegment& seg);
    static void combineSegments(tMaxMinSegment& seg1, const tMaxMinSegment& seg2); // seg1 is input and the return value (i.e. the combined version)
@@ -85,18 +103,26 @@ private:
    smartMaxMin(smartMaxMin const&);
    void operator=(smartMaxMin const&);
 
-   void calcTotalMaxMin();
+   static void initEmptySeg(tMaxMinSegment& seg, int startIndex);
+   static void offsetSegIndexes(tMaxMinSegment& seg, int offset);
 
-   void combineSegments();
+   tMaxMinSegment& getNode(size_t level, int nodeNum){return m_levels[level].nodes[m_levels[level].begin + (nodeNum - m_levels[level].firstNode)];}
+   int getLastNode(size_t level){return m_levels[level].firstNode + (int)(m_levels[level].nodes.size() - m_levels[level].begin) - 1;}
 
-   void debug_verifySegmentsAreContiguous();
-   void debug_verifyAllPointsAreInList();
+   void resizeLevels();
+   void rebuildLevels();
+   void recalcRange(int absStart, int absEnd);
+   tMaxMinSegment combineNodes(size_t level, int firstNode, int endNode);
+   void getSegmentsInRange(size_t level, int nodeNum, double start, double stop, tSegList& full, std::vector<unsigned int>& partial);
+
+   void calcTotalMaxMin();
 
-   int m_minSegSize;
-   int m_maxSegSize;
+   int m_leafSize;
 
-   const dubVect* m_srcVect;
-   tSegList m_segList;
+   const sampleVect* m_srcVect;
+   int m_absStart; // Absolute sample index of m_srcVect[0]. Scrolling moves this forward.
+   int m_absEnd;
+   std::vector<tMaxMinLevel> m_levels;
    double m_curMax;
    double m_curMin;
    bool m_curMaxMinHasRealPoints;
@@ -104,24 +130,4 @@ private:
    int m_lastRealPointIndex;
 };
 
-
-// This can be used to more quickly determine the min/max of subranges of plot data. This can only be used if
-// the subranges monotonically increasing up through the plot data.
-class fastMonotonicMaxMin
-{
-public:
-   fastMonotonicMaxMin(smartMaxMin& parent);
-
-   tMaxMinSegment getMinMaxInRange(unsigned int start, unsigned int len);
-
-private:
-   fastMonotonicMaxMin();
-   fastMonotonicMaxMin(fastMonotonicMaxMin const&);
-   void operator=(fastMonotonicMaxMin const&);
-
-   smartMaxMin& m_parent;
-   tSegList::iterator m_parentIter;
-
-};
-
 #endif // SMARTMAXMIN_H
@@ -0,0 +1,316 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+// Checks that fusedMathOps gives the same results as the per sample math op loop it replaced
+// (CurveData::doMathOnCurve), then times both on typical op lists.
+// - Every op on its own, and chains that don't fold two linear ops together, must match bit for
+//   bit, including NaN, inf, +/-0 and denormal samples.
+// - Runs of add / multiply / shift are folded into one scale + offset, which can round differently
+//   than applying the ops one at a time (and doesn't overflow / underflow part way through). Those
+//   are checked on finite samples against a rounding error bound instead, and getAffine must
+//   return the same scale + offset.
+//
+// Usage: fusedMathOpsBench [numSamples] (default 10000000)
+#include <QElapsedTimer>
+#include <math.h>
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "fusedMathOps.h"
+
+#define NUM_TIMED_RUNS (5)
+
+static int g_numFailures = 0;
+static std::mt19937 g_rand(12345);
+
+static void check(bool pass, const char* test, const char* what)
+{
+   if(pass == false)
+   {
+      printf("FAIL: %s: %s\n", test, what);
+      ++g_numFailures;
+   }
+}
+
+// The per sample loop doMathOnCurve used before fusedMathOps.
+static void referenceDoMath(double* dataBasePtr, const tMathOpList& mathOp, unsigned int numSamples)
+{
+   for(unsigned int i = 0; i < numSamples; ++i)
+   {
+      double* dataIter = &dataBasePtr[i];
+      for(tMathOpList::const_iterator mathIter = mathOp.begin(); mathIter != mathOp.end(); ++mathIter)
+      {
+         switch(mathIter->op)
+         {
+            case E_ADD:         (*dataIter) += mathIter->num; break;
+            case E_MULTIPLY:    (*dataIter) *= mathIter->num; break;
+            case E_DIVIDE:      (*dataIter) /= mathIter->num; break;
+            case E_SHIFT_UP:    (*dataIter) = ldexp((*dataIter), (int)mathIter->num); break;
+            case E_SHIFT_DOWN:  (*dataIter) = ldexp((*dataIter), -(int)mathIter->num); break;
+            case E_POWER:       (*dataIter) = pow((*dataIter), mathIter->num); break;
+            case E_LOG:         (*dataIter) = log(*dataIter) / mathIter->helperNum; break;
+            case E_ALOG:        (*dataIter) = pow(mathIter->num, *dataIter); break;
+            case E_MOD:
+               (*dataIter) = fmod(*dataIter, mathIter->num);
+               if((*dataIter) < 0)
+                  (*dataIter) += mathIter->num;
+            break;
+            case E_ABS:         (*dataIter) = fabs((*dataIter)); break;
+            case E_ROUND:
+               if(mathIter->num == 0)
+                  (*dataIter) = round((*dataIter));
+               else
+               {
+                  double decimal = pow(10, mathIter->num);
+                  (*dataIter) = round((*dataIter) * decimal) / decimal;
+               }
+            break;
+            case E_ROUND_UP:
+               if(mathIter->num == 0)
+                  (*dataIter) = ceil((*dataIter));
+               else
+               {
+                  double decimal = pow(10, mathIter->num);
+                  (*dataIter) = ceil((*dataIter) * decimal) / decimal;
+               }
+            break;
+            case E_ROUND_DOWN:
+               if(mathIter->num == 0)
+                  (*dataIter) = floor((*dataIter));
+               else
+               {
+                  double decimal = pow(10, mathIter->num);
+                  (*dataIter) = floor((*dataIter) * decimal) / decimal;
+               }
+            break;
+            case E_LIMIT_UPPER: if((*dataIter) > mathIter->num) (*dataIter) = mathIter->num; break;
+            case E_LIMIT_LOWER: if((*dataIter) < mathIter->num) (*dataIter) = mathIter->num; break;
+            case E_SIN:         (*dataIter) = sin((*dataIter)); break;
+            case E_COS:         (*dataIter) = cos((*dataIter)); break;
+            case E_TAN:         (*dataIter) = tan((*dataIter)); break;
+            case E_ASIN:        (*dataIter) = asin((*dataIter)); break;
+            case E_ACOS:        (*dataIter) = acos((*dataIter)); break;
+            case E_ATAN:        (*dataIter) = atan((*dataIter)); break;
+            case E_SIGN:        (*dataIter) = (0.0 < (*dataIter)) - ((*dataIter) < 0.0); break;
+            case E_FLOAT_SIGN_BIT: (*dataIter) = std::signbit((*dataIter)); break;
+            case E_FLOAT_IS_NAN:   (*dataIter) = std::isnan((*dataIter)); break;
+            case E_FLOAT_IS_INF:   (*dataIter) = std::isinf((*dataIter)); break;
+         }
+      }
+   }
+}
+
+static tOperation mathOp(eMathOp op, double num = 0.0)
+{
+   tOperation newOp;
+   newOp.op = op;
+   newOp.num = num;
+   newOp.helperNum = (op == E_LOG) ? log(num) : 0.0; // Same as the math op dialog sets it.
+   return newOp;
+}
+
+// Not a multiple of the block size, so the partial last block is checked too.
+static std::vector<double> testSamples(unsigned int numSamples)
+{
+   static const double specialValues[] = {0.0, -0.0, NAN, INFINITY, -INFINITY, DBL_MIN / 4.0, -DBL_MIN, DBL_MAX, -DBL_MAX, 1.0, -1.0, 0.5, 0.125};
+   size_t numSpecial = sizeof(specialValues) / sizeof(specialValues[0]);
+   std::uniform_real_distribution<double> dist(-1000.0, 1000.0);
+   std::vector<double> samples(numSamples);
+   for(unsigned int i = 0; i < numSamples; ++i)
+   {
+      samples[i] = (i % 7 == 0) ? specialValues[(i / 7) % numSpecial] : dist(g_rand);
+   }
+   return samples;
+}
+
+static bool sameResult(double a, double b)
+{
+   return (std::isnan(a) && std::isnan(b)) || memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+static void checkExact(const char* test, const tMathOpList& ops)
+{
+   std::vector<double> expected = testSamples(3001);
+   std::vector<double> actual = expected;
+   referenceDoMath(expected.data(), ops, (unsigned int)expected.size());
+   fusedMathOps fused;
+   fused.compile(ops);
+   fused.apply(actual.data(), (unsigned int)actual.size());
+
+   size_t numDifferent = 0;
+   for(size_t i = 0; i < expected.size(); ++i)
+      numDifferent += sameResult(expected[i], actual[i]) ? 0 : 1;
+   check(numDifferent == 0, test, "results are not bit identical");
+}
+
+// Folding ops changes the rounding. Each op applied one at a time rounds once, so the difference
+// is bounded by a few ulps of the biggest term along the way.
+static void checkFolded(const char* test, const tMathOpList& ops)
+{
+   std::uniform_real_distribution<double> dist(-1000.0, 1000.0);
+   std::vector<double> expected(3001);
+   for(size_t i = 0; i < expected.size(); ++i)
+      expected[i] = dist(g_rand);
+   std::vector<double> input = expected;
+   std::vector<double> actual = expected;
+   referenceDoMath(expected.data(), ops, (unsigned int)expected.size());
+   fusedMathOps fused;
+   fused.compile(ops);
+   fused.apply(actual.data(), (unsigned int)actual.size());
+
+   tLinear affine;
+   check(fused.getAffine(affine), test, "getAffine didn't see the ops as linear");
+
+   bool withinBound = true;
+   bool affineMatches = true;
+   for(size_t i = 0; i < expected.size(); ++i)
+   {
+      // Largest magnitude any intermediate value reaches, bounded by applying the absolute values.
+      double magnitude = fabs(input[i]);
+      for(tMathOpList::const_iterator iter = ops.begin(); iter != ops.end(); ++iter)
+      {
+         if(iter->op == E_ADD) magnitude += fabs(iter->num);
+         else if(iter->op == E_MULTIPLY) magnitude *= fabs(iter->num);
+         else if(iter->op == E_DIVIDE) magnitude /= fabs(iter->num);
+         magnitude = std::max(magnitude, fabs(input[i]));
+      }
+      double bound = 4.0 * (double)(ops.size() + 1) * DBL_EPSILON * std::max(magnitude, 1.0);
+      withinBound = withinBound && fabs(actual[i] - expected[i]) <= bound;
+      affineMatches = affineMatches && fabs((input[i] * affine.m + affine.b) - expected[i]) <= bound;
+   }
+   check(withinBound, test, "folded result is outside the rounding error bound");
+   check(affineMatches, test, "getAffine result is outside the rounding error bound");
+}
+
+static void checkOps()
+{
+   // Every op on its own.
+   const tOperation singleOps[] = {
+      mathOp(E_ADD, 3.5), mathOp(E_MULTIPLY, -2.5), mathOp(E_MULTIPLY, 0.0), mathOp(E_DIVIDE, 3.0), mathOp(E_DIVIDE, 4.0),
+      mathOp(E_DIVIDE, -0.25), mathOp(E_DIVIDE, 0.0), mathOp(E_SHIFT_UP, 3), mathOp(E_SHIFT_DOWN, 5), mathOp(E_SHIFT_UP, 1100),
+      mathOp(E_SHIFT_DOWN, 1100), mathOp(E_POWER, 2.0), mathOp(E_POWER, 0.5), mathOp(E_LOG, 10.0), mathOp(E_LOG, 2.0),
+      mathOp(E_ALOG, 10.0), mathOp(E_MOD, 7.0), mathOp(E_ABS), mathOp(E_ROUND, 0), mathOp(E_ROUND, 2), mathOp(E_ROUND, -1),
+      mathOp(E_ROUND_UP, 0), mathOp(E_ROUND_UP, 3), mathOp(E_ROUND_DOWN, 0), mathOp(E_ROUND_DOWN, 1),
+      mathOp(E_LIMIT_UPPER, 100.0), mathOp(E_LIMIT_LOWER, -100.0), mathOp(E_SIN), mathOp(E_COS), mathOp(E_TAN),
+      mathOp(E_ASIN), mathOp(E_ACOS), mathOp(E_ATAN), mathOp(E_SIGN), mathOp(E_FLOAT_SIGN_BIT), mathOp(E_FLOAT_IS_NAN),
+      mathOp(E_FLOAT_IS_INF) };
+   for(size_t i = 0; i < sizeof(singleOps) / sizeof(singleOps[0]); ++i)
+   {
+      char test[64];
+      snprintf(test, sizeof(test), "single op %d (%g)", (int)singleOps[i].op, singleOps[i].num);
+      checkExact(test, tMathOpList(1, singleOps[i]));
+   }
+
+   // Chains that don't fold two linear ops together (multiply then add is a single multiply + add).
+   checkExact("no ops", tMathOpList());
+   checkExact("multiply 1", {mathOp(E_MULTIPLY, 1.0)});
+   checkExact("add 0", {mathOp(E_ADD, 0.0)});
+   checkExact("add -0", {mathOp(E_ADD, -0.0)});
+   checkExact("multiply, add", {mathOp(E_MULTIPLY, 2.5), mathOp(E_ADD, 10.0)});
+   checkExact("multiply, add 0", {mathOp(E_MULTIPLY, -2.0), mathOp(E_ADD, 0.0)});
+   checkExact("add, abs, add", {mathOp(E_ADD, -3.0), mathOp(E_ABS), mathOp(E_ADD, 1.0)});
+   checkExact("limits, round", {mathOp(E_LIMIT_UPPER, 500.0), mathOp(E_LIMIT_LOWER, -500.0), mathOp(E_ROUND, 2)});
+   checkExact("divide 3, multiply 3", {mathOp(E_DIVIDE, 3.0), mathOp(E_MULTIPLY, 3.0)}); // Divide isn't folded.
+
+   // Chains that get folded into a single scale + offset.
+   checkFolded("shift up, shift down", {mathOp(E_SHIFT_UP, 4), mathOp(E_SHIFT_DOWN, 2)});
+   checkFolded("multiply 4, divide 8", {mathOp(E_MULTIPLY, 4.0), mathOp(E_DIVIDE, 8.0)});
+   checkFolded("multiply, add, shift", {mathOp(E_MULTIPLY, 3.0), mathOp(E_ADD, -7.0), mathOp(E_SHIFT_DOWN, 2)});
+   checkFolded("add, multiply", {mathOp(E_ADD, 10.0), mathOp(E_MULTIPLY, 0.1)});
+   checkFolded("multiply, add, multiply, add", {mathOp(E_MULTIPLY, 1.7), mathOp(E_ADD, -12.25), mathOp(E_MULTIPLY, -3.3), mathOp(E_ADD, 0.001)});
+   checkFolded("add, multiply, shift, add", {mathOp(E_ADD, 1e6), mathOp(E_MULTIPLY, 1e-3), mathOp(E_SHIFT_UP, 3), mathOp(E_ADD, -8000.0)});
+   checkFolded("add, divide 3, add", {mathOp(E_ADD, 2.0), mathOp(E_DIVIDE, 3.0), mathOp(E_ADD, 5.0)});
+
+   // getAffine only applies to linear ops.
+   fusedMathOps fused;
+   tLinear affine;
+   fused.compile({mathOp(E_MULTIPLY, 2.0), mathOp(E_ABS)});
+   check(!fused.getAffine(affine), "getAffine", "abs was treated as linear");
+   fused.compile(tMathOpList());
+   check(fused.getAffine(affine) && affine.m == 1.0 && affine.b == 0.0, "getAffine", "no ops isn't x * 1 + 0");
+}
+
+typedef struct
+{
+   const char* name;
+   tMathOpList ops;
+}tBenchOps;
+
+// Best of NUM_TIMED_RUNS, in ms.
+static void bench(const tBenchOps& benchOps, const std::vector<double>& input)
+{
+   std::vector<double> samples(input.size());
+   fusedMathOps fused;
+   fused.compile(benchOps.ops);
+   double bestRefMs = -1, bestFusedMs = -1;
+   for(int run = 0; run < NUM_TIMED_RUNS; ++run)
+   {
+      QElapsedTimer timer;
+      memcpy(samples.data(), input.data(), sizeof(double) * input.size());
+      timer.start();
+      referenceDoMath(samples.data(), benchOps.ops, (unsigned int)samples.size());
+      double refMs = (double)timer.nsecsElapsed() / 1e6;
+
+      memcpy(samples.data(), input.data(), sizeof(double) * input.size());
+      timer.start();
+      fused.apply(samples.data(), (unsigned int)samples.size());
+      double fusedMs = (double)timer.nsecsElapsed() / 1e6;
+
+      bestRefMs = (bestRefMs < 0 || refMs < bestRefMs) ? refMs : bestRefMs;
+      bestFusedMs = (bestFusedMs < 0 || fusedMs < bestFusedMs) ? fusedMs : bestFusedMs;
+   }
+   printf("%-36s %10.1f %10.1f\n", benchOps.name, bestRefMs, bestFusedMs);
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned int numSamples = 10000000;
+   if(argc > 1)
+      numSamples = (unsigned int)strtoul(argv[1], NULL, 10);
+
+   checkOps();
+   printf("%s\n", g_numFailures == 0 ? "checks passed" : "checks FAILED");
+
+   const tBenchOps benchOps[] = {
+      {"multiply, add", {mathOp(E_MULTIPLY, 2.5), mathOp(E_ADD, 10.0)}},
+      {"shift down", {mathOp(E_SHIFT_DOWN, 4)}},
+      {"limit upper, limit lower", {mathOp(E_LIMIT_UPPER, 500.0), mathOp(E_LIMIT_LOWER, -500.0)}},
+      {"abs", {mathOp(E_ABS)}},
+      {"round to 2 decimals", {mathOp(E_ROUND, 2)}},
+      {"multiply, add, shift, limits, abs", {mathOp(E_MULTIPLY, 3.0), mathOp(E_ADD, -7.0), mathOp(E_SHIFT_DOWN, 2),
+         mathOp(E_LIMIT_UPPER, 400.0), mathOp(E_LIMIT_LOWER, -400.0), mathOp(E_ABS)}} };
+
+   std::uniform_real_distribution<double> dist(-1000.0, 1000.0);
+   std::vector<double> input(numSamples);
+   for(unsigned int i = 0; i < numSamples; ++i)
+      input[i] = dist(g_rand);
+
+   printf("%u samples, ms (best of %d)\n", numSamples, NUM_TIMED_RUNS);
+   printf("%-36s %10s %10s\n", "ops", "per sample", "fused");
+   for(size_t i = 0; i < sizeof(benchOps) / sizeof(benchOps[0]); ++i)
+   {
+      bench(benchOps[i], input);
+   }
+
+   printf("%s\n", g_numFailures == 0 ? "PASS" : "FAILED");
+   return g_numFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,6 @@
+# Checks fusedMathOps against the per sample math op loop it replaced and times both.
+include ( ../plotterApp.pri )
+
+TARGET = fusedMathOpsBench
+
+SOURCES += fusedMathOpsBench.cpp
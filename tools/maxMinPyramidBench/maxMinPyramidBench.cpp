@@ -0,0 +1,337 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+// Checks smartMaxMin's min / max pyramid against a brute force search of the points through
+// random updates, appends, shrinks and scroll mode shifts (with NaN / inf points and lots of
+// equal values, so the real point handling and the index of the first max / min are checked
+// too). Then compares it to the std::list implementation it replaced: the time to build each
+// from scratch and to draw 2000 pixel columns over half the curve, the same way
+// CurveData::setCurveDataGuiPoints does.
+//
+// Usage: maxMinPyramidBench [numPoints ...] (default 1000000 10000000 100000000)
+// 100M points needs about 2 GB of memory.
+#include <QElapsedTimer>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <random>
+#include <vector>
+#include "smartMaxMin.h"
+#include "listMaxMin.h"
+
+#define NUM_RANDOM_OPS (3000)
+#define NUM_DRAW_COLUMNS (2000)
+#define NUM_TIMED_DRAWS (20)
+#define BENCH_LEAF_SIZE (256) // Same as CurveData.
+#define BENCH_LIST_MIN_SEG_SIZE (250) // Same as CurveData used with the list implementation.
+#define BENCH_LIST_MAX_SEG_SIZE (1000)
+
+static int g_numFailures = 0;
+static std::mt19937 g_rand(12345);
+
+static void check(bool pass, const char* test, const char* what)
+{
+   if(pass == false)
+   {
+      printf("FAIL: %s: %s\n", test, what);
+      ++g_numFailures;
+   }
+}
+
+static unsigned int randInt(unsigned int maxVal) // [0, maxVal]
+{
+   return std::uniform_int_distribution<unsigned int>(0, maxVal)(g_rand);
+}
+
+// Small integers so there are lots of equal values, with some NaN and inf points.
+static double randPoint()
+{
+   unsigned int r = randInt(99);
+   if(r < 5)
+      return NAN;
+   if(r < 7)
+      return (r == 5) ? INFINITY : -INFINITY;
+   return (double)((int)randInt(2000) - 1000);
+}
+
+static void fillRandom(double* points, size_t numPoints)
+{
+   bool allInvalid = randInt(9) == 0; // Sometimes a whole run of points without a real value.
+   for(size_t i = 0; i < numPoints; ++i)
+      points[i] = allInvalid ? NAN : randPoint();
+}
+
+static void checkSeg(const char* test, const tMaxMinSegment& seg, const sampleVect& points, unsigned int start, unsigned int numPoints)
+{
+   // Brute force. The first index of the max / min is expected when there are equal values.
+   bool real = false;
+   double maxVal = 0, minVal = 0;
+   int maxIndex = -1, minIndex = -1, firstReal = -1, lastReal = -1;
+   for(unsigned int i = start; i < start + numPoints; ++i)
+   {
+      double point = points[i];
+      if(!isDoubleValid(point))
+         continue;
+      if(!real || point > maxVal)
+      {
+         maxVal = point;
+         maxIndex = i;
+      }
+      if(!real || point < minVal)
+      {
+         minVal = point;
+         minIndex = i;
+      }
+      if(!real)
+         firstReal = i;
+      lastReal = i;
+      real = true;
+   }
+
+   check(seg.realPoints == real, test, "wrong real points flag");
+   check(seg.numPoints == (int)numPoints, test, "wrong number of points");
+   if(real && seg.realPoints)
+   {
+      check(seg.maxValue == maxVal && seg.minValue == minVal, test, "wrong max / min");
+      check(seg.maxIndex == maxIndex && seg.minIndex == minIndex, test, "wrong max / min index");
+      check(seg.firstRealPointIndex == firstReal && seg.lastRealPointIndex == lastReal, test, "wrong first / last real point");
+   }
+}
+
+static void checkAll(const char* test, smartMaxMin& maxMin, const sampleVect& points)
+{
+   unsigned int numPoints = (unsigned int)points.size();
+   if(numPoints == 0)
+      return;
+
+   tMaxMinSegment total;
+   maxMin.getMaxMin(total.maxValue, total.minValue, total.realPoints);
+   maxMin.getFirstLastReal(total.firstRealPointIndex, total.lastRealPointIndex);
+   tMaxMinSegment brute;
+   smartMaxMin::calcMaxMinOfSeg(points.constData(), 0, numPoints, brute);
+   total.maxIndex = brute.maxIndex; // getMaxMin doesn't return the indexes.
+   total.minIndex = brute.minIndex;
+   total.numPoints = numPoints;
+   checkSeg(test, total, points, 0, numPoints);
+
+   for(int i = 0; i < 20; ++i)
+   {
+      unsigned int start = randInt(numPoints - 1);
+      unsigned int len = randInt(numPoints - start);
+      checkSeg(test, maxMin.getMinMaxOfSubrange(start, len), points, start, len);
+   }
+}
+
+// Random changes to the points, each followed by the smartMaxMin call CurveData makes for that change.
+static void checkRandomOps(unsigned int leafSize)
+{
+   char test[64];
+   snprintf(test, sizeof(test), "random ops, leaf size %u", leafSize);
+
+   sampleVect points;
+   smartMaxMin maxMin(&points, leafSize);
+   for(int op = 0; op < NUM_RANDOM_OPS; ++op)
+   {
+      unsigned int numPoints = (unsigned int)points.size();
+      switch(randInt(3))
+      {
+         case 0: // Update points in place.
+            if(numPoints > 0)
+            {
+               unsigned int start = randInt(numPoints - 1);
+               unsigned int len = randInt(std::min(numPoints - start, 3000u));
+               fillRandom(points.data() + start, len);
+               maxMin.updateMaxMin(start, len);
+            }
+         break;
+         case 1: // Append.
+         {
+            unsigned int len = randInt(numPoints > 40000 ? 10 : 5000);
+            points.resize(numPoints + len);
+            fillRandom(points.data() + numPoints, len);
+            maxMin.updateMaxMin(numPoints, len);
+         }
+         break;
+         case 2: // Shrink (sometimes to nothing).
+         {
+            unsigned int newSize = randInt(20) == 0 ? 0 : randInt(numPoints);
+            points.resize(newSize);
+            maxMin.handleShortenedNumPoints();
+         }
+         break;
+         case 3: // Scroll mode. The new points are filled in after the shift, like CurveData does.
+            if(numPoints > 0)
+            {
+               unsigned int len = randInt(randInt(4) == 0 ? numPoints : std::min(numPoints, 2000u));
+               points.scroll(NULL, len);
+               maxMin.scrollModeShift(len);
+               fillRandom(points.data() + numPoints - len, len);
+               maxMin.updateMaxMin(numPoints - len, len);
+            }
+         break;
+      }
+      checkAll(test, maxMin, points);
+   }
+}
+
+// getSegmentsInRange on the X points, then getMaxMinFromSegments on the Y points, must find the
+// max / min of the Y points whose X points are in range (used for zooming 2D plots).
+static void checkSegmentsInRange(unsigned int leafSize)
+{
+   char test[64];
+   snprintf(test, sizeof(test), "segments in range, leaf size %u", leafSize);
+
+   unsigned int numPoints = 50000;
+   sampleVect xPoints, yPoints;
+   xPoints.resize(numPoints);
+   yPoints.resize(numPoints);
+   for(unsigned int i = 0; i < numPoints; ++i)
+   {
+      xPoints[i] = (i < numPoints / 2) ? (double)i / 10.0 : (double)((int)randInt(2000) - 1000); // Sorted, then random.
+   }
+   fillRandom(yPoints.data(), numPoints);
+
+   smartMaxMin maxMinX(&xPoints, leafSize);
+   smartMaxMin maxMinY(&yPoints, leafSize);
+   maxMinX.updateMaxMin(0, numPoints);
+   maxMinY.updateMaxMin(0, numPoints);
+
+   tSegList full;
+   std::vector<unsigned int> partial;
+   for(int i = 0; i < 200; ++i)
+   {
+      double start = (double)((int)randInt(6000) - 1000);
+      double stop = start + (double)randInt(i < 100 ? 50 : 5000);
+      maxMinX.getSegmentsInRange(start, stop, full, partial);
+      double retMax, retMin;
+      bool retReal;
+      maxMinY.getMaxMinFromSegments(full, partial, retMax, retMin, retReal);
+
+      bool real = false;
+      double maxVal = 0, minVal = 0;
+      for(unsigned int j = 0; j < numPoints; ++j)
+      {
+         if(xPoints[j] >= start && xPoints[j] <= stop && isDoubleValid(yPoints[j]))
+         {
+            maxVal = real ? std::max(maxVal, yPoints[j]) : yPoints[j];
+            minVal = real ? std::min(minVal, yPoints[j]) : yPoints[j];
+            real = true;
+         }
+      }
+      check(retReal == real, test, "wrong real points flag");
+      check(!real || (retMax == maxVal && retMin == minVal), test, "wrong max / min");
+   }
+}
+
+static double elapsedMs(QElapsedTimer& timer)
+{
+   return (double)timer.nsecsElapsed() / 1e6;
+}
+
+static void bench(unsigned int numPoints)
+{
+   dubVect listPoints(numPoints);
+   for(unsigned int i = 0; i < numPoints; ++i)
+   {
+      listPoints[i] = sin((double)i * 0.0001) * 1000.0 + (double)(i % 97);
+   }
+   sampleVect pyramidPoints(listPoints);
+
+   QElapsedTimer timer;
+   timer.start();
+   smartMaxMin pyramid(&pyramidPoints, BENCH_LEAF_SIZE);
+   pyramid.updateMaxMin(0, numPoints);
+   double pyramidBuildMs = elapsedMs(timer);
+
+   timer.start();
+   listMaxMin::smartMaxMin list(&listPoints, BENCH_LIST_MIN_SEG_SIZE, BENCH_LIST_MAX_SEG_SIZE);
+   list.updateMaxMin(0, numPoints);
+   double listBuildMs = elapsedMs(timer);
+
+   // Zoomed in to the middle half of the curve.
+   unsigned int drawStart = numPoints / 4 + 123; // Not lined up with any node / segment boundaries.
+   unsigned int drawLen = numPoints / 2;
+   unsigned int sampPerPixel = std::max(drawLen / NUM_DRAW_COLUMNS, 1u);
+   double pyramidSum = 0.0, listSum = 0.0; // So the queries can't be optimized out.
+   bool sameResults = true;
+
+   timer.start();
+   for(int draw = 0; draw < NUM_TIMED_DRAWS; ++draw)
+   {
+      for(unsigned int i = drawStart; i < drawStart + drawLen; i += sampPerPixel)
+      {
+         tMaxMinSegment seg = pyramid.getMinMaxOfSubrange(i, std::min(sampPerPixel, drawStart + drawLen - i));
+         pyramidSum += seg.maxValue - seg.minValue;
+      }
+   }
+   double pyramidDrawMs = elapsedMs(timer) / NUM_TIMED_DRAWS;
+
+   timer.start();
+   for(int draw = 0; draw < NUM_TIMED_DRAWS; ++draw)
+   {
+      listMaxMin::fastMonotonicMaxMin fastMaxMin(list);
+      for(unsigned int i = drawStart; i < drawStart + drawLen; i += sampPerPixel)
+      {
+         listMaxMin::tMaxMinSegment seg = fastMaxMin.getMinMaxInRange(i, std::min(sampPerPixel, drawStart + drawLen - i));
+         listSum += seg.maxValue - seg.minValue;
+      }
+   }
+   double listDrawMs = elapsedMs(timer) / NUM_TIMED_DRAWS;
+
+   // Both must draw the same thing.
+   listMaxMin::fastMonotonicMaxMin fastMaxMin(list);
+   for(unsigned int i = drawStart; i < drawStart + drawLen; i += sampPerPixel)
+   {
+      unsigned int len = std::min(sampPerPixel, drawStart + drawLen - i);
+      tMaxMinSegment pyramidSeg = pyramid.getMinMaxOfSubrange(i, len);
+      listMaxMin::tMaxMinSegment listSeg = fastMaxMin.getMinMaxInRange(i, len);
+      if(pyramidSeg.maxValue != listSeg.maxValue || pyramidSeg.minValue != listSeg.minValue ||
+         pyramidSeg.maxIndex != listSeg.maxIndex || pyramidSeg.minIndex != listSeg.minIndex)
+      {
+         sameResults = false;
+      }
+   }
+   check(sameResults && pyramidSum == listSum, "benchmark", "pyramid and list drew different points");
+
+   printf("%12u %12.1f %12.1f %12.3f %12.3f\n", numPoints, pyramidBuildMs, listBuildMs, pyramidDrawMs, listDrawMs);
+}
+
+int main(int argc, char *argv[])
+{
+   checkRandomOps(4); // Small leaves make a deep pyramid from few points.
+   checkRandomOps(BENCH_LEAF_SIZE);
+   checkSegmentsInRange(4);
+   checkSegmentsInRange(BENCH_LEAF_SIZE);
+   printf("%s\n", g_numFailures == 0 ? "checks passed" : "checks FAILED");
+
+   std::vector<unsigned int> sizes;
+   for(int i = 1; i < argc; ++i)
+      sizes.push_back((unsigned int)strtoul(argv[i], NULL, 10));
+   if(sizes.size() == 0)
+      sizes = {1000000, 10000000, 100000000};
+
+   printf("Build and draw %d columns over half the curve, ms (draw is the average of %d)\n", NUM_DRAW_COLUMNS, NUM_TIMED_DRAWS);
+   printf("%12s %12s %12s %12s %12s\n", "points", "build pyr", "build list", "draw pyr", "draw list");
+   for(size_t i = 0; i < sizes.size(); ++i)
+   {
+      bench(sizes[i]);
+   }
+
+   printf("%s\n", g_numFailures == 0 ? "PASS" : "FAILED");
+   return g_numFailures == 0 ? 0 : 1;
+}
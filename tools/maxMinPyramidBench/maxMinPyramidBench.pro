@@ -0,0 +1,8 @@
+# Checks the smartMaxMin min / max pyramid against brute force and benchmarks it against the
+# std::list implementation it replaced (listMaxMin.cpp).
+include ( ../plotterApp.pri )
+
+TARGET = maxMinPyramidBench
+
+SOURCES += maxMinPyramidBench.cpp listMaxMin.cpp
+HEADERS += listMaxMin.h
@@ -0,0 +1,156 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+// Saves plots with SavePlotV2, restores them with RestorePlotV2 and checks that every curve
+// comes back with the same name, type and points. Includes plots with no curves and curves
+// with no points, which the plotter can save.
+//
+// Needs a QApplication for the QwtPlot the curves are attached to. On a machine without a
+// display, run with "-platform offscreen".
+#include <QApplication>
+#include <QDir>
+#include <QFile>
+#include <qwt_plot.h>
+#include <math.h>
+#include <stdio.h>
+#include <memory>
+#include <vector>
+#include "CurveData.h"
+#include "saveRestoreCurve.h"
+
+typedef struct
+{
+   const char* curveName;
+   ePlotDim plotDim;
+   size_t numPoints;
+   ePlotDataTypes dataType; // The points are saved in the type the curve stores them in.
+}tTestCurve;
+
+static int g_numFailures = 0;
+
+static void check(bool pass, const QString& plotName, const char* what)
+{
+   if(pass == false)
+   {
+      printf("FAIL: %s: %s\n", plotName.toStdString().c_str(), what);
+      ++g_numFailures;
+   }
+}
+
+static CurveData* createCurve(QwtPlot* plot, const tTestCurve& testCurve)
+{
+   bool is2D = (testCurve.plotDim == E_PLOT_DIM_2D);
+   UnpackPlotMsg plotMsg;
+   plotMsg.m_plotAction = is2D ? E_CREATE_2D_PLOT : E_CREATE_1D_PLOT;
+   plotMsg.m_curveName = testCurve.curveName;
+   plotMsg.m_plotType = is2D ? E_PLOT_TYPE_2D : E_PLOT_TYPE_1D;
+   plotMsg.m_yAxisDataType = testCurve.dataType;
+   plotMsg.m_yAxisValues.resize(testCurve.numPoints);
+   for(size_t i = 0; i < testCurve.numPoints; ++i)
+   {
+      plotMsg.m_yAxisValues[i] = sin((double)i * 0.001) * 1000.0;
+      if(testCurve.dataType != E_FLOAT_64)
+         plotMsg.m_yAxisValues[i] = round(plotMsg.m_yAxisValues[i]); // Values that don't fit the type promote the storage (e.g. int8).
+   }
+   if(is2D)
+   {
+      plotMsg.m_xAxisValues.resize(testCurve.numPoints);
+      for(size_t i = 0; i < testCurve.numPoints; ++i)
+      {
+         plotMsg.m_xAxisValues[i] = (double)i * 0.5 - 7.0;
+      }
+   }
+   return new CurveData(plot, CurveAppearance(Qt::blue, QwtPlotCurve::Lines), &plotMsg);
+}
+
+static void roundTrip(QwtPlot* plot, const QString& path, const QString& plotName, const std::vector<tTestCurve>& testCurves)
+{
+   std::vector<std::unique_ptr<CurveData> > curves;
+   std::vector<std::unique_ptr<CurveSnapshot> > snapshots;
+   std::vector<dubVect> origXPoints(testCurves.size());
+   std::vector<dubVect> origYPoints(testCurves.size());
+   QVector<CurveSnapshot*> plotInfo;
+   for(size_t i = 0; i < testCurves.size(); ++i)
+   {
+      curves.emplace_back(createCurve(plot, testCurves[i]));
+      snapshots.emplace_back(new CurveSnapshot(curves.back().get(), E_SAVE_RESTORE_RAW, false));
+      plotInfo.push_back(snapshots.back().get());
+
+      curves[i]->getOrigYPoints(origYPoints[i]);
+      if(testCurves[i].plotDim == E_PLOT_DIM_2D)
+         curves[i]->getOrigXPoints(origXPoints[i]);
+
+      // The snapshot shares the curve's samples. Changing the curve after the snapshot
+      // was taken must not change what gets saved.
+      if(testCurves[i].numPoints > 0)
+         curves[i]->setPointValue(0, 12345.5);
+   }
+
+   SavePlotV2 savePlot(path, plotName, plotInfo);
+   check(savePlot.fileWritten, plotName, "save failed");
+
+   RestorePlotV2 restorePlot(path);
+   check(restorePlot.isValid, plotName, "restore rejected the file");
+   check(restorePlot.loadAllCurves(), plotName, "loading the curves failed");
+   check(restorePlot.plotName == plotName, plotName, "wrong plot name");
+   check(restorePlot.params.size() == (int)curves.size(), plotName, "wrong number of curves");
+
+   for(int i = 0; i < restorePlot.params.size() && i < (int)curves.size(); ++i)
+   {
+      tSaveRestoreCurveParams& params = restorePlot.params[i];
+
+      check(params.curveName == curves[i]->getCurveTitle(), plotName, "wrong curve name");
+      check(params.plotDim == testCurves[i].plotDim, plotName, "wrong plot dimension");
+      check(params.numPoints == testCurves[i].numPoints, plotName, "wrong number of points");
+      check(params.yOrigPoints == origYPoints[i], plotName, "Y points don't match");
+      check(params.xOrigPoints == origXPoints[i], plotName, "X points don't match");
+   }
+
+   QFile::remove(path);
+}
+
+int main(int argc, char *argv[])
+{
+   QApplication a(argc, argv);
+   QwtPlot plot;
+   QString path = QDir::temp().filePath("plotFileRoundTrip.plot");
+
+   // More points than fit in one chunk, so the multi chunk path is checked too.
+   size_t multiChunkPoints = 2 * PLOT_FILE_V2_CHUNK_POINTS + 5;
+
+   roundTrip(&plot, path, "emptyPlot", {});
+   roundTrip(&plot, path, "zeroPointCurves", {
+         {"empty1d", E_PLOT_DIM_1D, 0, E_FLOAT_64},
+         {"empty2d", E_PLOT_DIM_2D, 0, E_FLOAT_64} });
+   roundTrip(&plot, path, "mixedCurves", {
+         {"empty1d", E_PLOT_DIM_1D, 0, E_FLOAT_64},
+         {"long1d", E_PLOT_DIM_1D, multiChunkPoints, E_FLOAT_64},
+         {"short2d", E_PLOT_DIM_2D, 1000, E_FLOAT_64},
+         {"empty2d", E_PLOT_DIM_2D, 0, E_FLOAT_64} });
+   // Odd sized chunks of small types leave the chunks after them unaligned in the file.
+   roundTrip(&plot, path, "storedTypes", {
+         {"int8", E_PLOT_DIM_1D, 1001, E_CHAR},
+         {"int16", E_PLOT_DIM_1D, multiChunkPoints, E_INT_16},
+         {"uint32", E_PLOT_DIM_2D, 777, E_UINT_32},
+         {"float16", E_PLOT_DIM_1D, 333, E_FLOAT_16},
+         {"float32", E_PLOT_DIM_2D, 1000, E_FLOAT_32},
+         {"int64", E_PLOT_DIM_1D, 99, E_INT_64} });
+
+   printf("%s\n", g_numFailures == 0 ? "PASS" : "FAILED");
+   return g_numFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,6 @@
+# Saves plots with SavePlotV2, restores them with RestorePlotV2 and checks every point comes back unchanged.
+include ( ../plotterApp.pri )
+
+TARGET = plotFileRoundTrip
+
+SOURCES += plotFileRoundTrip.cpp
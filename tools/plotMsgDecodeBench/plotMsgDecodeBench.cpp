@@ -0,0 +1,292 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+// Checks that UnpackPlotMsg decodes every ePlotDataTypes sample exactly the same as the per sample
+// decode it replaced (1D, 2D and interleaved 2D messages), then measures samples / second for each
+// data type with both.
+//
+// Usage: plotMsgDecodeBench [numSamples] (default 1000000)
+#include <QElapsedTimer>
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "PackUnpackPlotMsg.h"
+
+#define NUM_TIMED_RUNS (5)
+
+static const char* DATA_TYPE_NAMES[] =
+{
+   "int8", "uint8", "int16", "uint16", "int32", "uint32", "int64", "uint64",
+   "float32", "float64", "timeStruct64", "timeStruct128", "float16", "timeNanoSec64"
+};
+
+static int g_numFailures = 0;
+
+static void check(bool pass, ePlotDataTypes dataType, const char* what)
+{
+   if(pass == false)
+   {
+      printf("FAIL: %s: %s\n", DATA_TYPE_NAMES[dataType], what);
+      ++g_numFailures;
+   }
+}
+
+// The per sample decode UnpackPlotMsg used before the bulk kernels: a switch on the data type
+// and a bounds checked memcpy for every sample.
+static double readSampleValue(const char* msg, UINT_32 msgSize, UINT_32& readIndex, ePlotDataTypes dataType)
+{
+   UINT_32 sampSize = getPlotDataTypeSize(dataType);
+   if(readIndex + sampSize > msgSize)
+   {
+      throw 0;
+   }
+   const char* src = msg + readIndex;
+   readIndex += sampSize;
+
+   double retVal = 0.0;
+   switch(dataType)
+   {
+      case E_CHAR:   {SCHAR   samp; memcpy(&samp, src, sizeof(samp)); retVal = (double)samp;} break;
+      case E_UCHAR:  {UCHAR   samp; memcpy(&samp, src, sizeof(samp)); retVal = (double)samp;} break;
+      case E_INT_16: {INT_16  samp; memcpy(&samp, src, sizeof(samp)); retVal = (double)samp;} break;
+      case E_UINT_16:{UINT_16 samp; memcpy(&samp, src, sizeof(samp)); retVal = (double)samp;} break;
+      case E_INT_32: {INT_32  samp; memcpy(&samp, src, sizeof(samp)); retVal = (double)samp;} break;
+      case E_UINT_32:{UINT_32 samp; memcpy(&samp, src, sizeof(samp)); retVal = (double)samp;} break;
+      case E_INT_64: {INT_64  samp; memcpy(&samp, src, sizeof(samp)); retVal = (double)samp;} break;
+      case E_UINT_64:{UINT_64 samp; memcpy(&samp, src, sizeof(samp)); retVal = (double)samp;} break;
+      case E_FLOAT_16:{FLOAT_16 samp; memcpy(&samp, src, sizeof(samp)); retVal = (double)samp;} break;
+      case E_FLOAT_32:{FLOAT_32 samp; memcpy(&samp, src, sizeof(samp)); retVal = (double)samp;} break;
+      case E_FLOAT_64:{FLOAT_64 samp; memcpy(&samp, src, sizeof(samp)); retVal = (double)samp;} break;
+      case E_TIME_STRUCT_64:
+      {
+         UINT_32 samp[2]; // Index 0 is seconds, index 1 is nanoseconds.
+         memcpy(&samp, src, sizeof(samp));
+         retVal = (double)((INT_32)samp[0]) + ((double)samp[1] / (double)1000000000.0);
+      }
+      break;
+      case E_TIME_STRUCT_128:
+      {
+         UINT_32 samp[4]; // Index 0 is seconds, index 2 is nanoseconds.
+         memcpy(&samp, src, sizeof(samp));
+         retVal = (double)samp[0] + ((double)samp[2] / (double)1000000000.0);
+      }
+      break;
+      case E_TIME_NANOSEC_64:
+      {
+         INT_64 samp;
+         memcpy(&samp, src, sizeof(samp));
+         retVal = ((double)samp) / 1e9;
+      }
+      break;
+      case E_INVALID_DATA_TYPE:
+      break;
+   }
+   return retVal;
+}
+
+// Random bytes, so every bit pattern of a type can show up (including NaNs and denormals).
+static void fillRandom(std::vector<char>& bytes, unsigned int seed)
+{
+   UINT_32 state = seed * 2654435761u + 1;
+   for(size_t i = 0; i < bytes.size(); ++i)
+   {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      bytes[i] = (char)(state >> 24);
+   }
+}
+
+static bool sameBits(const std::vector<double>& a, const std::vector<double>& b)
+{
+   return a.size() == b.size() && (a.size() == 0 || memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0);
+}
+
+static UnpackPlotMsg* unpack(std::vector<char>& packedMsg)
+{
+   tIncomingMsg inMsg;
+   inMsg.msgPtr = packedMsg.data();
+   inMsg.msgSize = (unsigned int)packedMsg.size();
+   inMsg.ipAddr = 0;
+   return new UnpackPlotMsg(&inMsg);
+}
+
+// Decodes the samples at the end of a packed message one at a time.
+static void referenceDecode(
+   const std::vector<char>& packedMsg, UINT_32 dataStart, UINT_32 numSamp,
+   ePlotDataTypes xType, ePlotDataTypes yType, bool is2D, bool interleaved,
+   std::vector<double>& xVals, std::vector<double>& yVals )
+{
+   const char* msg = packedMsg.data();
+   UINT_32 msgSize = (UINT_32)packedMsg.size();
+   UINT_32 readIndex = dataStart;
+   xVals.resize(is2D ? numSamp : 0);
+   yVals.resize(numSamp);
+   if(is2D == false)
+   {
+      for(UINT_32 i = 0; i < numSamp; ++i)
+         yVals[i] = readSampleValue(msg, msgSize, readIndex, yType);
+   }
+   else if(interleaved == false)
+   {
+      for(UINT_32 i = 0; i < numSamp; ++i)
+         xVals[i] = readSampleValue(msg, msgSize, readIndex, xType);
+      for(UINT_32 i = 0; i < numSamp; ++i)
+         yVals[i] = readSampleValue(msg, msgSize, readIndex, yType);
+   }
+   else
+   {
+      for(UINT_32 i = 0; i < numSamp; ++i)
+      {
+         xVals[i] = readSampleValue(msg, msgSize, readIndex, xType);
+         yVals[i] = readSampleValue(msg, msgSize, readIndex, yType);
+      }
+   }
+}
+
+static void checkDecode(ePlotDataTypes dataType, UINT_32 numSamp)
+{
+   // Pair each type with a type of a different size for the 2D messages, so the interleaved stride
+   // isn't a multiple of either sample size.
+   ePlotDataTypes otherType = (dataType == E_UCHAR) ? E_FLOAT_16 : E_UCHAR;
+   char plotName[] = "plot";
+   char curveName[] = "curve";
+   std::vector<double> refX, refY;
+
+   // 1D
+   {
+      t1dPlot param = {plotName, curveName, numSamp, dataType};
+      std::vector<char> samples(numSamp * getPlotDataTypeSize(dataType));
+      fillRandom(samples, dataType);
+      std::vector<char> packedMsg(getCreatePlot1dMsgSize(&param));
+      UINT_32 dataStart = packCreate1dPlotMsg_withoutData(&param, packedMsg.data());
+      if(samples.size() > 0)
+         memcpy(packedMsg.data() + dataStart, samples.data(), samples.size());
+
+      UnpackPlotMsg* plotMsg = unpack(packedMsg);
+      referenceDecode(packedMsg, dataStart, numSamp, dataType, dataType, false, false, refX, refY);
+      check(plotMsg->m_plotAction == E_CREATE_1D_PLOT, dataType, "1D message rejected");
+      check(sameBits(plotMsg->m_yAxisValues, refY), dataType, "1D samples don't match");
+      delete plotMsg;
+   }
+
+   // 2D, both layouts and both orders of the two types.
+   for(int interleaved = 0; interleaved < 2; ++interleaved)
+   {
+      for(int typeOrder = 0; typeOrder < 2; ++typeOrder)
+      {
+         ePlotDataTypes xType = typeOrder == 0 ? dataType : otherType;
+         ePlotDataTypes yType = typeOrder == 0 ? otherType : dataType;
+         t2dPlot param = {plotName, curveName, numSamp, xType, yType, (char)interleaved};
+         std::vector<char> samples(numSamp * (getPlotDataTypeSize(xType) + getPlotDataTypeSize(yType)));
+         fillRandom(samples, dataType + 100);
+         std::vector<char> packedMsg(getCreatePlot2dMsgSize(&param));
+         UINT_32 dataStart = interleaved ?
+            packCreate2dPlotMsg_Interleaved_withoutData(&param, packedMsg.data()) :
+            packCreate2dPlotMsg_withoutData(&param, packedMsg.data());
+         if(samples.size() > 0)
+            memcpy(packedMsg.data() + dataStart, samples.data(), samples.size());
+
+         UnpackPlotMsg* plotMsg = unpack(packedMsg);
+         referenceDecode(packedMsg, dataStart, numSamp, xType, yType, true, interleaved != 0, refX, refY);
+         check(plotMsg->m_plotAction == E_CREATE_2D_PLOT, dataType, "2D message rejected");
+         check(sameBits(plotMsg->m_xAxisValues, refX), dataType, interleaved ? "interleaved 2D X samples don't match" : "2D X samples don't match");
+         check(sameBits(plotMsg->m_yAxisValues, refY), dataType, interleaved ? "interleaved 2D Y samples don't match" : "2D Y samples don't match");
+         delete plotMsg;
+      }
+   }
+
+   // A message that is one byte short must be rejected, not read past the end.
+   if(numSamp > 0)
+   {
+      t1dPlot param = {plotName, curveName, numSamp, dataType};
+      std::vector<char> packedMsg(getCreatePlot1dMsgSize(&param));
+      packCreate1dPlotMsg_withoutData(&param, packedMsg.data());
+      packedMsg.pop_back();
+      UINT_32 shortSize = (UINT_32)packedMsg.size();
+      memcpy(packedMsg.data() + sizeof(ePlotAction), &shortSize, sizeof(shortSize));
+      UnpackPlotMsg* plotMsg = unpack(packedMsg);
+      check(plotMsg->m_yAxisValues.size() == 0, dataType, "short message was decoded");
+      delete plotMsg;
+   }
+}
+
+// Best of NUM_TIMED_RUNS, in millions of samples per second.
+static void benchDecode(ePlotDataTypes dataType, UINT_32 numSamp)
+{
+   char plotName[] = "plot";
+   char curveName[] = "curve";
+   t1dPlot param = {plotName, curveName, numSamp, dataType};
+   std::vector<char> packedMsg(getCreatePlot1dMsgSize(&param));
+   UINT_32 dataStart = packCreate1dPlotMsg_withoutData(&param, packedMsg.data());
+   std::vector<char> samples(numSamp * getPlotDataTypeSize(dataType));
+   fillRandom(samples, dataType);
+   memcpy(packedMsg.data() + dataStart, samples.data(), samples.size());
+
+   qint64 bestBulkNs = -1;
+   qint64 bestPerSampleNs = -1;
+   for(int run = 0; run < NUM_TIMED_RUNS; ++run)
+   {
+      QElapsedTimer timer;
+      timer.start();
+      UnpackPlotMsg* plotMsg = unpack(packedMsg);
+      qint64 bulkNs = timer.nsecsElapsed();
+
+      // Both decodes allocate their output, so the allocation cost is the same for both.
+      std::vector<double> refX, refY;
+      timer.start();
+      referenceDecode(packedMsg, dataStart, numSamp, dataType, dataType, false, false, refX, refY);
+      qint64 perSampleNs = timer.nsecsElapsed();
+      delete plotMsg;
+
+      if(bestBulkNs < 0 || bulkNs < bestBulkNs)
+         bestBulkNs = bulkNs;
+      if(bestPerSampleNs < 0 || perSampleNs < bestPerSampleNs)
+         bestPerSampleNs = perSampleNs;
+   }
+
+   double bulkRate = (double)numSamp * 1000.0 / (double)std::max(bestBulkNs, (qint64)1);
+   double perSampleRate = (double)numSamp * 1000.0 / (double)std::max(bestPerSampleNs, (qint64)1);
+   printf("%-14s %12.1f %12.1f %8.2fx\n", DATA_TYPE_NAMES[dataType], bulkRate, perSampleRate, bulkRate / perSampleRate);
+}
+
+int main(int argc, char *argv[])
+{
+   UINT_32 numSamp = 1000000;
+   if(argc > 1)
+      numSamp = (UINT_32)strtoul(argv[1], NULL, 10);
+
+   for(int dataType = 0; dataType < E_INVALID_DATA_TYPE; ++dataType)
+   {
+      checkDecode((ePlotDataTypes)dataType, 0);
+      checkDecode((ePlotDataTypes)dataType, 1);
+      checkDecode((ePlotDataTypes)dataType, 1001);
+   }
+
+   printf("1D decode of %u samples, millions of samples / second (best of %d)\n", numSamp, NUM_TIMED_RUNS);
+   printf("%-14s %12s %12s %9s\n", "type", "bulk", "per sample", "speedup");
+   for(int dataType = 0; dataType < E_INVALID_DATA_TYPE; ++dataType)
+   {
+      benchDecode((ePlotDataTypes)dataType, numSamp);
+   }
+
+   printf("%s\n", g_numFailures == 0 ? "PASS" : "FAILED");
+   return g_numFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,6 @@
+# Checks the bulk plot message sample decode against the per sample decode and measures both.
+include ( ../plotterApp.pri )
+
+TARGET = plotMsgDecodeBench
+
+SOURCES += plotMsgDecodeBench.cpp
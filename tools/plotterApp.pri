@@ -0,0 +1,49 @@
+# Builds the plotter's sources (everything but main.cpp) into a tool, so the tool can use
+# CurveData, the save / restore classes, etc. the same way the plotter does.
+PLOTTER_DIR = $$clean_path($$PWD/..)
+
+# Run pre-build python script to generate revDateStamp.h
+system(python $$PLOTTER_DIR/revDateStamp.py)
+
+# QWT and FFTW libraries are in directories labeled 32 or 64. Determine which directory to find the libraries in.
+contains(QT_ARCH, i386) {
+    ARCHDIR = 32
+} else {
+    ARCHDIR = 64
+}
+
+QWTDIR = $$PLOTTER_DIR/../PlotterDependencies/prebuilt/qwt_sources_and_bin/latest6.1_myMods/qwt-6.1
+FFTWDIR = $$PLOTTER_DIR/../PlotterDependencies/prebuilt/fftw-dll
+include ( $${QWTDIR}/qwt.prf )
+
+QT += core gui
+QT += widgets
+
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+SOURCES += $$files($$PLOTTER_DIR/*.cpp)
+SOURCES -= $$PLOTTER_DIR/main.cpp $$PLOTTER_DIR/dllHelper.cpp
+SOURCES += $$PWD/plotterGlobals.cpp
+
+HEADERS += $$files($$PLOTTER_DIR/*.h)
+HEADERS -= $$PLOTTER_DIR/dllHelper.h
+
+FORMS += $$files($$PLOTTER_DIR/*.ui)
+FORMS -= $$PLOTTER_DIR/createfftplot.ui
+
+RESOURCES += $$PLOTTER_DIR/qtResource.qrc
+
+INCLUDEPATH += $$PLOTTER_DIR
+INCLUDEPATH += $$QWTDIR/src
+INCLUDEPATH += $$FFTWDIR
+
+qwtAddLibrary($${QWTDIR}/../lib/$${ARCHDIR}, qwt)
+
+win32 {
+    LIBS += -lws2_32
+    LIBS += -L$$FFTWDIR/$$ARCHDIR -lfftw3-3
+} else {
+    LIBS += -L$$FFTWDIR/$$ARCHDIR -lfftw3
+}
@@ -0,0 +1,29 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+// The plotter's global variables are defined in main.cpp, which the tools don't build.
+// These match the defaults main.cpp uses when there is no ini file.
+#include <stddef.h>
+#include "spectrumAnalyzerModeTypes.h"
+
+bool defaultCursorZoomModeIsZoom = false;
+bool default2dPlotStyleIsLines = false; // true = Lines, false = Dots
+bool inSpectrumAnalyzerMode = false;
+unsigned int g_maxReplotRateHz = 60; // 0 = replot for every new plot message
+size_t g_memoryBudget = 0; // 0 = no limit
+tSpecAnModeParam spectrumAnalyzerParams;
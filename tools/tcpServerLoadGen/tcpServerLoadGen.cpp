@@ -0,0 +1,286 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+// Connects a growing number of clients to the plotter's TCP server and streams data from all of
+// them at once, with the server in thread per client mode and in epoll mode (see
+// socket_server_mode in the ini file). For each run it checks that every byte arrived at the
+// rx callback in order, and that every connect / disconnect was reported. It prints the
+// throughput, the CPU time and the number of context switches the whole process took.
+//
+// Usage: tcpServerLoadGen [maxClients] [kBytesPerClient] (defaults 256 and 1024)
+// Linux only. Thread per client mode needs 2 threads and a rx ring per client, so large
+// client counts need enough memory and a high enough fd limit (ulimit -n).
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+#include <arpa/inet.h>
+#include "TCPThreads.h"
+
+#define LOAD_GEN_BASE_PORT (30000) // Below the Linux ephemeral port range, so the clients don't take the server ports.
+#define LOAD_GEN_NUM_SENDERS (4)
+#define LOAD_GEN_SEND_SIZE (16*1024)
+#define LOAD_GEN_TIMEOUT_SEC (60)
+
+// Everything the server callbacks update. Indexed by the client's local port, so the rx callback
+// doesn't need a lock.
+typedef struct
+{
+   std::atomic<unsigned long long> bytesRxTotal;
+   std::atomic<int> numConnected;
+   std::atomic<int> numDisconnected;
+   std::atomic<int> numBadBytes;
+   std::vector<unsigned long long> bytesRxPerPort; // Only touched by the one thread servicing that client.
+}tServerStats;
+
+static int g_numFailures = 0;
+
+static void check(bool pass, const char* mode, unsigned int numClients, const char* what)
+{
+   if(pass == false)
+   {
+      printf("FAIL: %s, %u clients: %s\n", mode, numClients, what);
+      ++g_numFailures;
+   }
+}
+
+static unsigned short getPort(struct sockaddr_storage* addr)
+{
+   return ntohs(((struct sockaddr_in*)addr)->sin_port);
+}
+
+// Each client sends the byte pattern (port + offset) & 0xFF, so the rx callback can check the
+// data for every client arrived complete and in order.
+static void rxPacketCallback(void* inputPtr, struct sockaddr_storage* client, char* packet, unsigned int size)
+{
+   tServerStats* stats = (tServerStats*)inputPtr;
+   unsigned short port = getPort(client);
+   unsigned long long offset = stats->bytesRxPerPort[port];
+   for(unsigned int i = 0; i < size; ++i)
+   {
+      if((unsigned char)packet[i] != (unsigned char)(port + offset + i))
+      {
+         stats->numBadBytes++;
+         break;
+      }
+   }
+   stats->bytesRxPerPort[port] = offset + size;
+   stats->bytesRxTotal += size;
+}
+
+static void clientConnStartCallback(void* inputPtr, struct sockaddr_storage*)
+{
+   ((tServerStats*)inputPtr)->numConnected++;
+}
+
+static void clientConnEndCallback(void* inputPtr, struct sockaddr_storage*)
+{
+   ((tServerStats*)inputPtr)->numDisconnected++;
+}
+
+static double nowSec()
+{
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Waits for 'done' to return true. Returns false on timeout.
+template <typename tDoneFunc>
+static bool waitFor(tDoneFunc done)
+{
+   double timeout = nowSec() + LOAD_GEN_TIMEOUT_SEC;
+   while(!done())
+   {
+      if(nowSec() > timeout)
+         return false;
+      usleep(1000);
+   }
+   return true;
+}
+
+// In thread per client mode the server starts listening on its accept thread, so the first
+// connection can be refused if it is attempted too soon. Retry for a while.
+static int connectClient(unsigned short serverPort, unsigned short* localPort)
+{
+   struct sockaddr_in addr;
+   memset(&addr, 0, sizeof(addr));
+   addr.sin_family = AF_INET;
+   addr.sin_port = htons(serverPort);
+   addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+   int fd = -1;
+   bool connected = false;
+   for(int attempt = 0; attempt < 1000 && !connected; ++attempt)
+   {
+      fd = socket(AF_INET, SOCK_STREAM, 0);
+      if(fd < 0)
+         return -1;
+      connected = connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0;
+      if(!connected)
+      {
+         bool refused = (errno == ECONNREFUSED);
+         close(fd);
+         if(!refused)
+            return -1;
+         usleep(1000);
+      }
+   }
+   if(!connected)
+      return -1;
+   socklen_t addrLen = sizeof(addr);
+   getsockname(fd, (struct sockaddr*)&addr, &addrLen);
+   *localPort = ntohs(addr.sin_port);
+   return fd;
+}
+
+// Each sender thread round robins LOAD_GEN_SEND_SIZE sends across its share of the clients.
+static void sendThread(std::vector<int>* fds, std::vector<unsigned short>* ports, size_t first, size_t step, unsigned long long bytesPerClient)
+{
+   std::vector<unsigned long long> sent(fds->size(), 0);
+   std::vector<unsigned char> buff(LOAD_GEN_SEND_SIZE);
+   bool anyLeft = true;
+   while(anyLeft)
+   {
+      anyLeft = false;
+      for(size_t i = first; i < fds->size(); i += step)
+      {
+         if(sent[i] >= bytesPerClient)
+            continue;
+         size_t size = (size_t)std::min((unsigned long long)LOAD_GEN_SEND_SIZE, bytesPerClient - sent[i]);
+         for(size_t j = 0; j < size; ++j)
+            buff[j] = (unsigned char)((*ports)[i] + sent[i] + j);
+         ssize_t result = send((*fds)[i], buff.data(), size, MSG_NOSIGNAL);
+         if(result > 0)
+            sent[i] += result;
+         else if(result < 0 && errno != EINTR)
+            sent[i] = bytesPerClient; // Connection is gone, the byte count check will catch it.
+         anyLeft = anyLeft || sent[i] < bytesPerClient;
+      }
+   }
+}
+
+static void runLoad(const char* mode, unsigned int numEventLoops, unsigned int numClients, unsigned long long bytesPerClient, unsigned short port)
+{
+   tServerStats stats;
+   stats.bytesRxTotal = 0;
+   stats.numConnected = 0;
+   stats.numDisconnected = 0;
+   stats.numBadBytes = 0;
+   stats.bytesRxPerPort.assign(65536, 0);
+
+   dServerSocket servSock;
+   dServerSocket_init(&servSock, port, rxPacketCallback, clientConnStartCallback, clientConnEndCallback, &stats, 0, 0);
+   dServerSocket_setEventDriven(&servSock, numEventLoops);
+   dServerSocket_bind(&servSock);
+   if(servSock.socketFd == INVALID_FD || dServerSocket_accept(&servSock) != 0)
+   {
+      check(false, mode, numClients, "server didn't start");
+      return;
+   }
+
+   std::vector<int> fds;
+   std::vector<unsigned short> ports;
+   for(unsigned int i = 0; i < numClients; ++i)
+   {
+      unsigned short localPort = 0;
+      int fd = connectClient(port, &localPort);
+      if(fd < 0)
+         break;
+      fds.push_back(fd);
+      ports.push_back(localPort);
+   }
+   check(fds.size() == numClients, mode, numClients, "not all clients could connect");
+   check(waitFor([&]{return stats.numConnected == (int)fds.size();}), mode, numClients, "server didn't report all connections");
+
+   struct rusage usageStart, usageEnd;
+   getrusage(RUSAGE_SELF, &usageStart);
+   double startTime = nowSec();
+
+   std::vector<std::thread> senders;
+   for(size_t i = 0; i < LOAD_GEN_NUM_SENDERS && i < fds.size(); ++i)
+      senders.push_back(std::thread(sendThread, &fds, &ports, i, (size_t)LOAD_GEN_NUM_SENDERS, bytesPerClient));
+   for(size_t i = 0; i < senders.size(); ++i)
+      senders[i].join();
+
+   unsigned long long expectedBytes = bytesPerClient * fds.size();
+   bool allRx = waitFor([&]{return stats.bytesRxTotal >= expectedBytes;});
+   double elapsed = nowSec() - startTime;
+   getrusage(RUSAGE_SELF, &usageEnd);
+
+   check(allRx && stats.bytesRxTotal == expectedBytes, mode, numClients, "wrong number of bytes received");
+   for(size_t i = 0; i < ports.size(); ++i)
+   {
+      if(stats.bytesRxPerPort[ports[i]] != bytesPerClient)
+      {
+         check(false, mode, numClients, "a client's bytes didn't all arrive");
+         break;
+      }
+   }
+   check(stats.numBadBytes == 0, mode, numClients, "bytes arrived out of order or corrupted");
+
+   for(size_t i = 0; i < fds.size(); ++i)
+      close(fds[i]);
+   check(waitFor([&]{return stats.numDisconnected == (int)fds.size();}), mode, numClients, "server didn't report all disconnections");
+   dServerSocket_killAll(&servSock);
+
+   double cpuSec =
+      (double)(usageEnd.ru_utime.tv_sec - usageStart.ru_utime.tv_sec) + (double)(usageEnd.ru_utime.tv_usec - usageStart.ru_utime.tv_usec) / 1e6 +
+      (double)(usageEnd.ru_stime.tv_sec - usageStart.ru_stime.tv_sec) + (double)(usageEnd.ru_stime.tv_usec - usageStart.ru_stime.tv_usec) / 1e6;
+   long contextSwitches =
+      (usageEnd.ru_nvcsw - usageStart.ru_nvcsw) + (usageEnd.ru_nivcsw - usageStart.ru_nivcsw);
+   printf("%-10s %8u %10.1f %10.3f %14ld\n",
+      mode, numClients, (double)expectedBytes / (1024.0 * 1024.0) / elapsed, cpuSec, contextSwitches);
+}
+
+int main(int argc, char *argv[])
+{
+   unsigned int maxClients = 256;
+   unsigned long long bytesPerClient = 1024 * 1024;
+   if(argc > 1)
+      maxClients = (unsigned int)strtoul(argv[1], NULL, 10);
+   if(argc > 2)
+      bytesPerClient = strtoull(argv[2], NULL, 10) * 1024;
+
+   typedef struct
+   {
+      const char* name;
+      unsigned int numEventLoops;
+   }tServerMode;
+   const tServerMode modes[] = {{"threads", 0}, {"epoll x1", 1}, {"epoll x4", 4}};
+
+   printf("%llu KB per client, %d sender threads\n", bytesPerClient / 1024, LOAD_GEN_NUM_SENDERS);
+   printf("%-10s %8s %10s %10s %14s\n", "mode", "clients", "MB/s", "cpu sec", "ctx switches");
+
+   unsigned short port = LOAD_GEN_BASE_PORT;
+   for(size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m)
+   {
+      for(unsigned int numClients = 1; numClients <= maxClients; numClients *= 4)
+      {
+         runLoad(modes[m].name, modes[m].numEventLoops, numClients, bytesPerClient, port++);
+      }
+   }
+
+   printf("%s\n", g_numFailures == 0 ? "PASS" : "FAILED");
+   return g_numFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,15 @@
+# Streams data to the TCP server from a growing number of clients, in thread per client and
+# epoll mode, and checks it all arrives. Prints throughput, CPU time and context switches.
+# Only needs the server itself (no Qt).
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle qt
+
+PLOTTER_DIR = $$clean_path($$PWD/../..)
+INCLUDEPATH += $$PLOTTER_DIR
+
+TARGET = tcpServerLoadGen
+
+SOURCES += tcpServerLoadGen.cpp
+SOURCES += $$PLOTTER_DIR/TCPThreads.cpp
+LIBS += -lpthread
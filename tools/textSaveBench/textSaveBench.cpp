@@ -0,0 +1,511 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+// Checks that the text save types (CSV, clipboard Excel and the C header types) write exactly the
+// same bytes as the std::stringstream code they replaced, then times both.
+// - NumToText is checked value by value against a stream set up by MainWindow::setDisplayIoMapIp,
+//   for each display type and a range of precisions, including inf / nan, +/-0, denormals and
+//   whole numbers on both sides of the integer fast path limit.
+// - Whole plot CSV / clipboard saves and each curve's C header array are checked against copies of
+//   the old stream based save code. 1D and 2D curves, float and int curves, a curve with no points
+//   and a 2D curve shorter than the others (so the CSV merge has to pad its columns) are included.
+// - The benchmark saves one long 1D curve and one long 2D curve with each text save type.
+//
+// Needs a QApplication for the QwtPlot the curves are attached to. On a machine without a
+// display, run with "-platform offscreen".
+//
+// Usage: textSaveBench [numPoints] (default 2000000 for the 1D curve, half that for the 2D curve)
+#include <QApplication>
+#include <QElapsedTimer>
+#include <qwt_plot.h>
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "CurveData.h"
+#include "mainwindow.h"
+#include "numToText.h"
+#include "saveRestoreCurve.h"
+
+#define NUM_TIMED_RUNS (3)
+
+static const std::string EXCEL_LINE_DELIM = "\r\n";
+static const std::string CSV_CELL_DELIM = ",";
+static const std::string CLIPBOARD_EXCEL_CELL_DELIM = "\t";
+static const std::string C_HEADER_LINE_DELIM = "\r\n";
+
+typedef enum
+{
+   E_VALUES_FRACTIONAL,
+   E_VALUES_WHOLE,
+   E_VALUES_MIXED
+}eTestValues;
+
+typedef struct
+{
+   const char* curveName;
+   ePlotDim plotDim;
+   size_t numPoints;
+   ePlotDataTypes dataType;
+   eTestValues values;
+}tTestCurve;
+
+typedef struct
+{
+   eDisplayPointType displayType;
+   int displayPrecision;
+}tDisplayFormat;
+
+static int g_numFailures = 0;
+
+static void check(bool pass, const std::string& test, const char* what)
+{
+   if(pass == false)
+   {
+      printf("FAIL: %s: %s\n", test.c_str(), what);
+      ++g_numFailures;
+   }
+}
+
+static const char* displayTypeName(eDisplayPointType displayType)
+{
+   return displayType == E_DISPLAY_POINT_FIXED ? "fixed" : displayType == E_DISPLAY_POINT_SCIENTIFIC ? "sci" : "auto";
+}
+
+static std::string formatName(const tDisplayFormat& format)
+{
+   return std::string(displayTypeName(format.displayType)) + "(" + std::to_string(format.displayPrecision) + ")";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Copies of the stream based text save code, before NumToText.
+////////////////////////////////////////////////////////////////////////////////
+
+static bool refIsInt(CurveSnapshot* curve, eSaveRestorePlotCurveType type)
+{
+   ePlotDataTypes dataType = E_FLOAT_64;
+   if(type == E_SAVE_RESTORE_C_HEADER_INT)
+   {
+      dataType = E_INT_64;
+   }
+   else if(type == E_SAVE_RESTORE_C_HEADER_AUTO_TYPE)
+   {
+      ePlotDataTypes xAxis = curve->getPlotDim() == E_PLOT_DIM_1D ? E_INVALID_DATA_TYPE : curve->getLastMsgDataType(E_X_AXIS);
+      ePlotDataTypes yAxis = curve->getLastMsgDataType(E_Y_AXIS);
+      dataType = (xAxis != yAxis && xAxis != E_INVALID_DATA_TYPE) ? E_FLOAT_64 : yAxis;
+   }
+   switch(dataType)
+   {
+      case E_CHAR:
+      case E_UCHAR:
+      case E_INT_16:
+      case E_UINT_16:
+      case E_INT_32:
+      case E_UINT_32:
+      case E_INT_64:
+      case E_UINT_64:
+         return true;
+      default:
+         return false; // Written as float / double.
+   }
+}
+
+// SaveCurve::SaveExcel, not limited to the zoom.
+static std::string refCurveExcel(const tDisplayFormat& format, CurveSnapshot* curve, const std::string& delim, bool& hasData)
+{
+   std::stringstream csvFile;
+   if(curve->getPlotDim() == E_PLOT_DIM_2D)
+   {
+      const double* xPoints = curve->getXPoints();
+      const double* yPoints = curve->getYPoints();
+      unsigned int numPoints = curve->getNumPoints();
+      hasData = (numPoints > 0);
+
+      csvFile << curve->getCurveTitle().toStdString() << " - X Axis" << delim;
+      csvFile << curve->getCurveTitle().toStdString() << " - Y Axis\r\n";
+      for(unsigned int i = 0; i < numPoints; ++i)
+      {
+         MainWindow::setDisplayIoMapipXAxis(csvFile, curve->getPlotDim(), curve->getSampleRate(), format.displayType, format.displayPrecision);
+         csvFile << xPoints[i] << delim;
+         MainWindow::setDisplayIoMapIp(csvFile, format.displayType, format.displayPrecision);
+         csvFile << yPoints[i] << EXCEL_LINE_DELIM;
+      }
+      MainWindow::clearDisplayIoMapIp(csvFile);
+   }
+   else
+   {
+      csvFile << curve->getCurveTitle().toStdString() << EXCEL_LINE_DELIM;
+
+      MainWindow::setDisplayIoMapIp(csvFile, format.displayType, format.displayPrecision);
+      for(unsigned int i = 0; i < curve->getNumPoints(); ++i)
+      {
+         csvFile << curve->getYPoints()[i] << EXCEL_LINE_DELIM;
+      }
+      MainWindow::clearDisplayIoMapIp(csvFile);
+
+      hasData = (curve->getNumPoints() > 0);
+   }
+   return csvFile.str();
+}
+
+// SavePlot::SaveExcel
+static std::string refPlotExcel(const tDisplayFormat& format, QVector<CurveSnapshot*>& plotInfo, eSaveRestorePlotCurveType type)
+{
+   std::string delim = type == E_SAVE_RESTORE_CLIPBOARD_EXCEL ? CLIPBOARD_EXCEL_CELL_DELIM : CSV_CELL_DELIM;
+   QVector<QStringList> curveCsvFiles;
+   QVector<ePlotDim> curvePlotDim;
+   for(int i = 0; i < plotInfo.size(); ++i)
+   {
+      bool hasData = false;
+      std::string curveFile = refCurveExcel(format, plotInfo[i], delim, hasData);
+      if(hasData)
+      {
+         curveCsvFiles.push_back(QString(curveFile.c_str()).split(EXCEL_LINE_DELIM.c_str(), Qt::SkipEmptyParts));
+         curvePlotDim.push_back(plotInfo[i]->getPlotDim());
+      }
+   }
+
+   int maxNumLines = 0;
+   for(int curveIndex = 0; curveIndex < curveCsvFiles.size(); ++curveIndex)
+   {
+      if(curveCsvFiles[curveIndex].size() > maxNumLines)
+      {
+         maxNumLines = curveCsvFiles[curveIndex].size();
+      }
+   }
+
+   QString packed;
+   for(int lineIndex = 0; lineIndex < maxNumLines; ++lineIndex)
+   {
+      int numCurves = curveCsvFiles.size();
+      for(int curveIndex = 0; curveIndex < numCurves; ++curveIndex)
+      {
+         bool lastColumn = (curveIndex >= (numCurves-1));
+         if(curveCsvFiles[curveIndex].size() > lineIndex)
+         {
+            packed.append(curveCsvFiles[curveIndex][lineIndex]);
+         }
+         else if((curvePlotDim[curveIndex] == E_PLOT_DIM_2D) && !lastColumn)
+         {
+            packed.append(delim.c_str());
+         }
+
+         if(!lastColumn)
+         {
+            packed.append(delim.c_str());
+         }
+         else
+         {
+            packed.append(EXCEL_LINE_DELIM.c_str());
+         }
+      }
+   }
+   return packed.toStdString();
+}
+
+// SaveCurve::SaveCHeader, everything after the array declaration line (the declaration and the
+// typedef in packedCurveHead weren't changed).
+static std::string refCurveCHeaderValues(const tDisplayFormat& format, CurveSnapshot* curve, eSaveRestorePlotCurveType type)
+{
+   std::stringstream outFile;
+   static const int MAX_SAMP_PER_LINE = 10;
+   int sampPerLineCount = 0;
+   unsigned int numSamplesToWrite = curve->getNumPoints();
+   bool dataType_isInt = refIsInt(curve, type);
+   const double* yPoints = curve->getYPoints();
+
+   if(curve->getPlotDim() != E_PLOT_DIM_1D)
+   {
+      const double* xPoints = curve->getXPoints();
+      for(unsigned int i = 0; i < numSamplesToWrite; ++i)
+      {
+         if(dataType_isInt)
+         {
+            outFile << "{" << (INT_64)xPoints[i] << "," << (INT_64)yPoints[i] << "}";
+         }
+         else
+         {
+            MainWindow::setDisplayIoMapipXAxis(outFile, curve->getPlotDim(), curve->getSampleRate(), format.displayType, format.displayPrecision);
+            outFile << "{" << xPoints[i] << ",";
+            MainWindow::setDisplayIoMapIp(outFile, format.displayType, format.displayPrecision);
+            outFile << yPoints[i] << "}";
+         }
+         if(i < (numSamplesToWrite-1))
+            outFile << ", ";
+         if(++sampPerLineCount >= MAX_SAMP_PER_LINE)
+         {
+            outFile << C_HEADER_LINE_DELIM;
+            sampPerLineCount = 0;
+         }
+      }
+   }
+   else
+   {
+      if(!dataType_isInt)
+         MainWindow::setDisplayIoMapIp(outFile, format.displayType, format.displayPrecision);
+      for(unsigned int i = 0; i < numSamplesToWrite; ++i)
+      {
+         if(dataType_isInt)
+            outFile << (INT_64)yPoints[i];
+         else
+            outFile << yPoints[i];
+         if(i < (numSamplesToWrite-1))
+            outFile << ", ";
+         if(++sampPerLineCount >= MAX_SAMP_PER_LINE)
+         {
+            outFile << C_HEADER_LINE_DELIM;
+            sampPerLineCount = 0;
+         }
+      }
+   }
+   outFile << "};" << C_HEADER_LINE_DELIM << C_HEADER_LINE_DELIM;
+   return outFile.str();
+}
+
+static std::string refPlotText(const tDisplayFormat& format, QVector<CurveSnapshot*>& plotInfo, eSaveRestorePlotCurveType type)
+{
+   if(type == E_SAVE_RESTORE_CSV || type == E_SAVE_RESTORE_CLIPBOARD_EXCEL)
+      return refPlotExcel(format, plotInfo, type);
+
+   std::string text;
+   for(int i = 0; i < plotInfo.size(); ++i)
+      text += refCurveCHeaderValues(format, plotInfo[i], type);
+   return text;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static void checkNumToText()
+{
+   static const double values[] = {
+      0.0, -0.0, 1.0, -1.0, 7.0, 42.0, 100.0, 999999.0, 1000000.0, 1234567.0, -98765432.0,
+      999999999999999.0, 1e15, -1e15, 1e15 + 2.0, 9007199254740993.0, 1e20, 1e300, DBL_MAX, -DBL_MAX,
+      0.5, -0.5, 1.5, 2.5, 0.1, 0.125, 1.0 / 3.0, -2.0 / 3.0, 3.14159265358979, 123.456, -0.000123456,
+      1e-5, 1e-7, 9.9999995, 99999.95, 0.00049999, 1e-300, DBL_MIN, DBL_MIN / 1024.0, -DBL_MIN / 3.0,
+      INFINITY, -INFINITY, NAN };
+   static const tDisplayFormat formats[] = {
+      {E_DISPLAY_POINT_AUTO, -1}, {E_DISPLAY_POINT_AUTO, 0}, {E_DISPLAY_POINT_AUTO, 1}, {E_DISPLAY_POINT_AUTO, 3},
+      {E_DISPLAY_POINT_AUTO, 6}, {E_DISPLAY_POINT_AUTO, 12}, {E_DISPLAY_POINT_AUTO, 17},
+      {E_DISPLAY_POINT_FIXED, 0}, {E_DISPLAY_POINT_FIXED, 1}, {E_DISPLAY_POINT_FIXED, 5}, {E_DISPLAY_POINT_FIXED, 17},
+      {E_DISPLAY_POINT_SCIENTIFIC, 0}, {E_DISPLAY_POINT_SCIENTIFIC, 3}, {E_DISPLAY_POINT_SCIENTIFIC, 8},
+      {E_DISPLAY_POINT_SCIENTIFIC, 17} };
+
+   std::vector<double> testValues(values, values + sizeof(values) / sizeof(values[0]));
+   srand(1);
+   for(int i = 0; i < 2000; ++i)
+   {
+      double mantissa = (double)rand() / RAND_MAX * 2.0 - 1.0;
+      testValues.push_back(ldexp(mantissa, rand() % 120 - 60));
+      testValues.push_back(round(mantissa * 1e6));
+   }
+
+   for(size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); ++f)
+   {
+      NumToText numToText(formats[f].displayType, formats[f].displayPrecision);
+      std::vector<char> buff(numToText.maxChars());
+      size_t numDifferent = 0;
+      bool fitsMaxChars = true;
+      for(size_t i = 0; i < testValues.size(); ++i)
+      {
+         std::stringstream expected;
+         MainWindow::setDisplayIoMapIp(expected, formats[f].displayType, formats[f].displayPrecision);
+         expected << testValues[i];
+
+         size_t numChars = numToText.write(buff.data(), testValues[i]) - buff.data();
+         fitsMaxChars = fitsMaxChars && numChars <= numToText.maxChars();
+         if(std::string(buff.data(), numChars) != expected.str())
+         {
+            if(numDifferent == 0)
+               printf("   %s: %.17g -> \"%s\" expected \"%s\"\n", formatName(formats[f]).c_str(), testValues[i],
+                      std::string(buff.data(), numChars).c_str(), expected.str().c_str());
+            ++numDifferent;
+         }
+      }
+      check(numDifferent == 0, "NumToText " + formatName(formats[f]), "text doesn't match the stream");
+      check(fitsMaxChars, "NumToText " + formatName(formats[f]), "wrote more than maxChars");
+   }
+}
+
+static double testValue(eTestValues values, size_t i)
+{
+   static const double mixedValues[] = {0.0, 1e15, 123456789012.5, 1e-7, -2.5e300, 0.1, 1.0 / 3.0, -42.0, 5e-324, 99999.95};
+   double val = sin((double)i * 0.001) * 1000.0;
+   switch(values)
+   {
+      case E_VALUES_WHOLE:
+         return round(val);
+      case E_VALUES_MIXED:
+         return (i % 3 == 0) ? mixedValues[(i / 3) % (sizeof(mixedValues) / sizeof(mixedValues[0]))] : val;
+      case E_VALUES_FRACTIONAL:
+      default:
+         return val;
+   }
+}
+
+static CurveData* createCurve(QwtPlot* plot, const tTestCurve& testCurve)
+{
+   bool is2D = (testCurve.plotDim == E_PLOT_DIM_2D);
+   UnpackPlotMsg plotMsg;
+   plotMsg.m_plotAction = is2D ? E_CREATE_2D_PLOT : E_CREATE_1D_PLOT;
+   plotMsg.m_curveName = testCurve.curveName;
+   plotMsg.m_plotType = is2D ? E_PLOT_TYPE_2D : E_PLOT_TYPE_1D;
+   plotMsg.m_yAxisDataType = testCurve.dataType;
+   plotMsg.m_yAxisValues.resize(testCurve.numPoints);
+   for(size_t i = 0; i < testCurve.numPoints; ++i)
+   {
+      plotMsg.m_yAxisValues[i] = testValue(testCurve.values, i);
+   }
+   if(is2D)
+   {
+      plotMsg.m_xAxisDataType = E_FLOAT_64;
+      plotMsg.m_xAxisValues.resize(testCurve.numPoints);
+      for(size_t i = 0; i < testCurve.numPoints; ++i)
+      {
+         plotMsg.m_xAxisValues[i] = (double)i * 0.5 - 7.0;
+      }
+   }
+   return new CurveData(plot, CurveAppearance(Qt::blue, QwtPlotCurve::Lines), &plotMsg);
+}
+
+static void checkSaves(QwtPlot* plot)
+{
+   static const eSaveRestorePlotCurveType textTypes[] = {
+      E_SAVE_RESTORE_CSV, E_SAVE_RESTORE_CLIPBOARD_EXCEL,
+      E_SAVE_RESTORE_C_HEADER_AUTO_TYPE, E_SAVE_RESTORE_C_HEADER_INT, E_SAVE_RESTORE_C_HEADER_FLOAT };
+   static const tDisplayFormat formats[] = {
+      {E_DISPLAY_POINT_AUTO, 6}, {E_DISPLAY_POINT_AUTO, 3}, {E_DISPLAY_POINT_AUTO, 12},
+      {E_DISPLAY_POINT_FIXED, 0}, {E_DISPLAY_POINT_FIXED, 5}, {E_DISPLAY_POINT_SCIENTIFIC, 8} };
+   const std::vector<tTestCurve> testCurves = {
+      {"fractional1d", E_PLOT_DIM_1D, 5000, E_FLOAT_64, E_VALUES_FRACTIONAL},
+      {"int1d", E_PLOT_DIM_1D, 3001, E_INT_16, E_VALUES_WHOLE},
+      {"empty1d", E_PLOT_DIM_1D, 0, E_FLOAT_64, E_VALUES_FRACTIONAL},
+      {"short2d", E_PLOT_DIM_2D, 123, E_FLOAT_64, E_VALUES_WHOLE},
+      {"mixed2d", E_PLOT_DIM_2D, 4000, E_FLOAT_64, E_VALUES_MIXED},
+      {"mixed1d", E_PLOT_DIM_1D, 2000, E_FLOAT_64, E_VALUES_MIXED} };
+
+   std::vector<std::unique_ptr<CurveData> > curves;
+   for(size_t i = 0; i < testCurves.size(); ++i)
+      curves.emplace_back(createCurve(plot, testCurves[i]));
+
+   for(size_t t = 0; t < sizeof(textTypes) / sizeof(textTypes[0]); ++t)
+   {
+      std::vector<std::unique_ptr<CurveSnapshot> > snapshots;
+      QVector<CurveSnapshot*> plotInfo;
+      for(size_t i = 0; i < curves.size(); ++i)
+      {
+         snapshots.emplace_back(new CurveSnapshot(curves[i].get(), textTypes[t], false));
+         plotInfo.push_back(snapshots.back().get());
+      }
+
+      for(size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); ++f)
+      {
+         SaveDisplayFormat displayFormat("textSavePlot", formats[f].displayType, formats[f].displayPrecision);
+         std::string test = "save type " + std::to_string((int)textTypes[t]) + " " + formatName(formats[f]);
+
+         if(textTypes[t] == E_SAVE_RESTORE_CSV || textTypes[t] == E_SAVE_RESTORE_CLIPBOARD_EXCEL)
+         {
+            SavePlot savePlot(&displayFormat, "textSavePlot", plotInfo, textTypes[t]);
+            std::string actual(savePlot.packedCurveData.begin(), savePlot.packedCurveData.end());
+            check(actual == refPlotExcel(formats[f], plotInfo, textTypes[t]), test, "plot text doesn't match the stream based save");
+         }
+         else
+         {
+            for(int i = 0; i < plotInfo.size(); ++i)
+            {
+               SaveCurve saveCurve(&displayFormat, plotInfo[i], textTypes[t]);
+               std::string actual(saveCurve.packedCurveData.begin(), saveCurve.packedCurveData.end());
+               size_t declarationEnd = actual.find(C_HEADER_LINE_DELIM);
+               std::string arraySize = "[" + std::to_string(plotInfo[i]->getNumPoints()) + "]" +
+                                       (plotInfo[i]->getPlotDim() == E_PLOT_DIM_1D ? "" : "[2]") + " = {";
+               bool declarationOk = declarationEnd != std::string::npos && declarationEnd >= arraySize.size() &&
+                                    actual.compare(declarationEnd - arraySize.size(), arraySize.size(), arraySize) == 0;
+               check(declarationOk, test + " " + testCurves[i].curveName, "array declaration is wrong");
+               if(declarationOk)
+               {
+                  check(actual.substr(declarationEnd + C_HEADER_LINE_DELIM.size()) == refCurveCHeaderValues(formats[f], plotInfo[i], textTypes[t]),
+                        test + " " + testCurves[i].curveName, "array values don't match the stream based save");
+               }
+            }
+         }
+      }
+   }
+}
+
+// Best of NUM_TIMED_RUNS, in MB/s of text written.
+static void bench(QwtPlot* plot, const tTestCurve& testCurve)
+{
+   static const eSaveRestorePlotCurveType textTypes[] = {
+      E_SAVE_RESTORE_CSV, E_SAVE_RESTORE_CLIPBOARD_EXCEL,
+      E_SAVE_RESTORE_C_HEADER_AUTO_TYPE, E_SAVE_RESTORE_C_HEADER_INT, E_SAVE_RESTORE_C_HEADER_FLOAT };
+   static const char* textTypeNames[] = {"CSV", "Clipboard Excel", "C header auto", "C header int", "C header float"};
+   const tDisplayFormat format = {E_DISPLAY_POINT_AUTO, 6};
+
+   std::unique_ptr<CurveData> curve(createCurve(plot, testCurve));
+   printf("%s, %u points\n", testCurve.curveName, (unsigned)testCurve.numPoints);
+   for(size_t t = 0; t < sizeof(textTypes) / sizeof(textTypes[0]); ++t)
+   {
+      CurveSnapshot snapshot(curve.get(), textTypes[t], false);
+      QVector<CurveSnapshot*> plotInfo;
+      plotInfo.push_back(&snapshot);
+      SaveDisplayFormat displayFormat("textSavePlot", format.displayType, format.displayPrecision);
+
+      double bestRefSec = -1, bestNewSec = -1;
+      size_t refSize = 0, newSize = 0;
+      for(int run = 0; run < NUM_TIMED_RUNS; ++run)
+      {
+         QElapsedTimer timer;
+         timer.start();
+         refSize = refPlotText(format, plotInfo, textTypes[t]).size();
+         double refSec = (double)timer.nsecsElapsed() / 1e9;
+
+         timer.start();
+         SavePlot savePlot(&displayFormat, "textSavePlot", plotInfo, textTypes[t]);
+         newSize = savePlot.packedCurveData.size();
+         double newSec = (double)timer.nsecsElapsed() / 1e9;
+
+         bestRefSec = (bestRefSec < 0 || refSec < bestRefSec) ? refSec : bestRefSec;
+         bestNewSec = (bestNewSec < 0 || newSec < bestNewSec) ? newSec : bestNewSec;
+      }
+      printf("   %-16s %8.1f %8.1f\n", textTypeNames[t], (double)refSize / 1e6 / bestRefSec, (double)newSize / 1e6 / bestNewSec);
+   }
+}
+
+int main(int argc, char *argv[])
+{
+   QApplication a(argc, argv); // Removes the Qt options (i.e. -platform) from argv.
+   QwtPlot plot;
+
+   size_t numPoints = 2000000;
+   if(argc > 1)
+      numPoints = (size_t)strtoul(argv[1], NULL, 10);
+
+   checkNumToText();
+   checkSaves(&plot);
+   printf("%s\n", g_numFailures == 0 ? "checks passed" : "checks FAILED");
+
+   printf("MB/s of text (best of %d), stream based -> NumToText\n", NUM_TIMED_RUNS);
+   bench(&plot, {"1D", E_PLOT_DIM_1D, numPoints, E_FLOAT_64, E_VALUES_FRACTIONAL});
+   bench(&plot, {"2D", E_PLOT_DIM_2D, numPoints / 2, E_FLOAT_64, E_VALUES_FRACTIONAL});
+
+   printf("%s\n", g_numFailures == 0 ? "PASS" : "FAILED");
+   return g_numFailures == 0 ? 0 : 1;
+}
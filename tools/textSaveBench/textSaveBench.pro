@@ -0,0 +1,6 @@
+# Checks the CSV, clipboard and C header saves write the same text as the stream based code they replaced and times both.
+include ( ../plotterApp.pri )
+
+TARGET = textSaveBench
+
+SOURCES += textSaveBench.cpp
@@ -0,0 +1,15 @@
+# Standalone checks and benchmarks for the plotter. Each one is a console app that
+# exits with a non-zero status if a check fails. Build with the same Qt kit as qwtExample.pro.
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    plotFileRoundTrip \
+    plotMsgDecodeBench \
+    maxMinPyramidBench \
+    fusedMathOpsBench \
+    textSaveBench
+
+# The load generator uses the epoll server mode, which is Linux only.
+linux {
+    SUBDIRS += tcpServerLoadGen
+}
@@ -0,0 +1,432 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#include <math.h>
+#include <float.h>
+#include <limits>
+#include <algorithm>
+#include "typedSampleVect.h"
+#include "PackUnpackPlotMsg.h"
+
+// Number of samples to widen at a time when changing storage types.
+#define TYPED_SAMPLE_VECT_CONVERT_CHUNK (4096)
+
+
+template<typename tStoreType>
+static bool intToStorage(const double* src, unsigned char* dst, size_t count)
+{
+   const double minVal = (double)std::numeric_limits<tStoreType>::min();
+   const double maxVal = (double)std::numeric_limits<tStoreType>::max();
+   tStoreType* dstPtr = (tStoreType*)dst;
+   for(size_t i = 0; i < count; ++i)
+   {
+      double val = src[i];
+      // NAN fails both compares.
+      if(!(val >= minVal && val <= maxVal) || (double)(tStoreType)val != val)
+         return false;
+      dstPtr[i] = (tStoreType)val;
+   }
+   return true;
+}
+
+static bool floatToStorage(const double* src, unsigned char* dst, size_t count)
+{
+   FLOAT_32* dstPtr = (FLOAT_32*)dst;
+   for(size_t i = 0; i < count; ++i)
+   {
+      double val = src[i];
+      if(std::isfinite(val) && (fabs(val) > FLT_MAX || (double)(FLOAT_32)val != val))
+         return false;
+      dstPtr[i] = (FLOAT_32)val;
+   }
+   return true;
+}
+
+template<typename tStoreType>
+static void storageToDouble(const unsigned char* src, double* dst, size_t count)
+{
+   const tStoreType* srcPtr = (const tStoreType*)src;
+   for(size_t i = 0; i < count; ++i)
+   {
+      dst[i] = (double)srcPtr[i];
+   }
+}
+
+static bool convertToStorage(ePlotDataTypes storageType, const double* src, unsigned char* dst, size_t count)
+{
+   switch(storageType)
+   {
+      case E_CHAR:     return intToStorage<SCHAR>  (src, dst, count);
+      case E_UCHAR:    return intToStorage<UCHAR>  (src, dst, count);
+      case E_INT_16:   return intToStorage<INT_16> (src, dst, count);
+      case E_UINT_16:  return intToStorage<UINT_16>(src, dst, count);
+      case E_INT_32:   return intToStorage<INT_32> (src, dst, count);
+      case E_UINT_32:  return intToStorage<UINT_32>(src, dst, count);
+      case E_FLOAT_32: return floatToStorage(src, dst, count);
+      default:
+         memcpy(dst, src, sizeof(double) * count);
+      break;
+   }
+   return true;
+}
+
+static void convertFromStorage(ePlotDataTypes storageType, const unsigned char* src, double* dst, size_t count)
+{
+   switch(storageType)
+   {
+      case E_CHAR:     storageToDouble<SCHAR>   (src, dst, count); break;
+      case E_UCHAR:    storageToDouble<UCHAR>   (src, dst, count); break;
+      case E_INT_16:   storageToDouble<INT_16>  (src, dst, count); break;
+      case E_UINT_16:  storageToDouble<UINT_16> (src, dst, count); break;
+      case E_INT_32:   storageToDouble<INT_32>  (src, dst, count); break;
+      case E_UINT_32:  storageToDouble<UINT_32> (src, dst, count); break;
+      case E_FLOAT_32: storageToDouble<FLOAT_32>(src, dst, count); break;
+      default:
+         memcpy(dst, src, sizeof(double) * count);
+      break;
+   }
+}
+
+// Next bigger storage type to try when a sample doesn't fit in the current one.
+// 8 and 16 bit ints fit exactly in a float (along with NAN), everything else goes to double.
+static ePlotDataTypes getPromotedStorageType(ePlotDataTypes storageType)
+{
+   switch(storageType)
+   {
+      case E_CHAR:
+      case E_UCHAR:
+      case E_INT_16:
+      case E_UINT_16:
+         return E_FLOAT_32;
+      default:
+         return E_FLOAT_64;
+   }
+}
+
+
+typedSampleVect::typedSampleVect():
+   m_start(0),
+   m_size(0),
+   m_type(E_FLOAT_64),
+   m_sampleSize(sizeof(double)),
+   m_shared(NULL)
+{
+}
+
+void typedSampleVect::convertStorageToDouble(ePlotDataTypes storageType, const unsigned char* src, double* dst, size_t count)
+{
+   convertFromStorage(storageType, src, dst, count);
+}
+
+ePlotDataTypes typedSampleVect::getStorageTypeForDataType(ePlotDataTypes dataType)
+{
+   switch(dataType)
+   {
+      case E_CHAR:
+      case E_UCHAR:
+      case E_INT_16:
+      case E_UINT_16:
+      case E_INT_32:
+      case E_UINT_32:
+      case E_FLOAT_32:
+         return dataType;
+      case E_FLOAT_16:
+         return E_FLOAT_32; // No native half float type, float holds every half float value exactly.
+      default:
+         return E_FLOAT_64; // 64 bit ints and time types can't always be stored exactly in anything smaller than a double.
+   }
+}
+
+void typedSampleVect::assign(const dubVect& src, ePlotDataTypes srcDataType)
+{
+   releaseBuff();
+   m_type = getStorageTypeForDataType(srcDataType);
+   m_sampleSize = getPlotDataTypeSize(m_type);
+   assign(src.data(), src.size());
+}
+
+void typedSampleVect::assign(const double* src, size_t count)
+{
+   if(m_shared != NULL)
+   {
+      m_shared->resize(count);
+      set(0, src, count);
+      return;
+   }
+   if(count * m_sampleSize > m_buff.capacity())
+      m_buff.release(); // Nothing needs to be kept, don't have realloc copy the old samples.
+   m_buff.resize(count * m_sampleSize);
+   m_start = 0;
+   m_size = count;
+   set(0, src, count);
+}
+
+double typedSampleVect::get(size_t index) const
+{
+   double retVal;
+   get(index, &retVal, 1);
+   return retVal;
+}
+
+void typedSampleVect::get(size_t index, double* dst, size_t count) const
+{
+   if(count == 0)
+      return;
+   if(m_shared != NULL)
+   {
+      const double* src = m_shared->constData() + index;
+      if(src != dst)
+         memmove(dst, src, sizeof(double) * count);
+   }
+   else
+   {
+      convertFromStorage(m_type, data() + (index * m_sampleSize), dst, count);
+   }
+}
+
+void typedSampleVect::set(size_t index, const double* src, size_t count)
+{
+   if(m_shared != NULL)
+   {
+      double* dst = m_shared->data() + index;
+      if(count > 0 && src != dst)
+         memmove(dst, src, sizeof(double) * count);
+      return;
+   }
+   while(count > 0 && !convertToStorage(m_type, src, data() + (index * m_sampleSize), count))
+   {
+      setStorageType(getPromotedStorageType(m_type));
+   }
+}
+
+void typedSampleVect::clear()
+{
+   if(m_shared != NULL)
+      m_shared->clear();
+   m_start = 0;
+   m_size = 0;
+}
+
+void typedSampleVect::release()
+{
+   if(m_shared != NULL)
+      m_shared->release();
+   releaseBuff();
+}
+
+void typedSampleVect::releaseBuff()
+{
+   m_buff.release();
+   m_start = 0;
+   m_size = 0;
+}
+
+void typedSampleVect::resize(size_t newSize, double fillValue)
+{
+   if(m_shared != NULL)
+   {
+      m_shared->resize(newSize, fillValue);
+      return;
+   }
+   if(newSize > m_size)
+      makeStorable(fillValue);
+
+   if((m_start + newSize) * m_sampleSize > m_buff.size())
+   {
+      moveToBeginning();
+      if(newSize * m_sampleSize > m_buff.size())
+         m_buff.resize(newSize * m_sampleSize);
+   }
+   size_t oldSize = m_size;
+   m_size = newSize;
+   if(newSize > oldSize)
+      fill(oldSize, newSize - oldSize, fillValue);
+}
+
+void typedSampleVect::insertAtBeginning(size_t count, double fillValue)
+{
+   if(m_shared != NULL)
+   {
+      m_shared->insertAtBeginning(count, fillValue);
+      return;
+   }
+   makeStorable(fillValue);
+   if(count <= m_start)
+      m_start -= count;
+   else
+      m_buff.insert(m_start * m_sampleSize, count * m_sampleSize);
+   m_size += count;
+   fill(0, count, fillValue);
+}
+
+void typedSampleVect::eraseFromBeginning(size_t count)
+{
+   if(m_shared != NULL)
+   {
+      m_shared->eraseFromBeginning(count);
+      return;
+   }
+   count = std::min(count, m_size);
+   m_start += count;
+   m_size -= count;
+}
+
+void typedSampleVect::scroll(const double* newSamples, size_t count)
+{
+   if(m_shared != NULL)
+   {
+      m_shared->scroll(newSamples, count);
+      return;
+   }
+   size_t numToKeep = m_size - count;
+   if((m_start + m_size + count) * m_sampleSize > m_buff.size())
+   {
+      // Out of room at the end of the backing buffer. Move the samples that are being kept
+      // to the beginning and make sure there is room for a good number of future scrolls.
+      memmove(m_buff.data(), data() + (count * m_sampleSize), m_sampleSize * numToKeep);
+      m_start = 0;
+      size_t minBuffSize = (m_size + std::max(m_size / 2, count)) * m_sampleSize;
+      if(m_buff.size() < minBuffSize)
+         m_buff.resize(minBuffSize);
+   }
+   else
+   {
+      m_start += count;
+   }
+   if(newSamples != NULL)
+      set(numToKeep, newSamples, count);
+}
+
+void typedSampleVect::rotate(size_t index)
+{
+   if(m_shared != NULL)
+   {
+      if(index > 0 && index < m_shared->size())
+         std::rotate(m_shared->begin(), m_shared->begin() + index, m_shared->end());
+   }
+   else if(index > 0 && index < m_size)
+   {
+      std::rotate(data(), data() + (index * m_sampleSize), data() + (m_size * m_sampleSize));
+   }
+}
+
+void typedSampleVect::snapshot(typedSampleVect& dst) const
+{
+   if(m_shared != NULL)
+   {
+      dst.m_buff.share(m_shared->m_buff);
+      dst.m_start = m_shared->m_start;
+      dst.m_size = m_shared->m_size;
+      dst.m_type = E_FLOAT_64;
+      dst.m_sampleSize = sizeof(double);
+   }
+   else
+   {
+      dst.m_buff = m_buff;
+      dst.m_start = m_start;
+      dst.m_size = m_size;
+      dst.m_type = m_type;
+      dst.m_sampleSize = m_sampleSize;
+   }
+   dst.m_shared = NULL;
+}
+
+void typedSampleVect::copy(const typedSampleVect& src, sampleVect* sharedSamples)
+{
+   m_buff = src.m_buff;
+   m_start = src.m_start;
+   m_size = src.m_size;
+   m_type = src.m_type;
+   m_sampleSize = src.m_sampleSize;
+   m_shared = src.m_shared != NULL ? sharedSamples : NULL;
+}
+
+void typedSampleVect::share(sampleVect* samples)
+{
+   if(m_shared == samples)
+      return;
+   if(m_shared != NULL)
+      unshare();
+
+   samples->resize(m_size);
+   get(0, samples->data(), m_size);
+   releaseBuff();
+   m_shared = samples;
+}
+
+void typedSampleVect::unshare()
+{
+   if(m_shared != NULL)
+   {
+      sampleVect* samples = m_shared;
+      m_shared = NULL;
+      assign(samples->constData(), samples->size());
+   }
+}
+
+void typedSampleVect::setStorageType(ePlotDataTypes newType)
+{
+   if(newType == m_type)
+      return;
+
+   size_t newSampleSize = getPlotDataTypeSize(newType);
+   sampleBuff<unsigned char> newBuff;
+   newBuff.resize(m_size * newSampleSize);
+   double chunk[TYPED_SAMPLE_VECT_CONVERT_CHUNK];
+   for(size_t i = 0; i < m_size; i += TYPED_SAMPLE_VECT_CONVERT_CHUNK)
+   {
+      size_t numToConvert = std::min(m_size - i, (size_t)TYPED_SAMPLE_VECT_CONVERT_CHUNK);
+      get(i, chunk, numToConvert);
+      convertToStorage(newType, chunk, newBuff.data() + (i * newSampleSize), numToConvert); // Can't fail, only ever widening.
+   }
+   m_buff.swap(newBuff);
+   m_start = 0;
+   m_type = newType;
+   m_sampleSize = newSampleSize;
+}
+
+void typedSampleVect::makeStorable(double value)
+{
+   unsigned char sample[sizeof(double)];
+   while(!convertToStorage(m_type, &value, sample, 1))
+   {
+      setStorageType(getPromotedStorageType(m_type));
+   }
+}
+
+void typedSampleVect::fill(size_t index, size_t count, double fillValue)
+{
+   // The caller must have already made sure fillValue can be stored in the current storage type.
+   unsigned char sample[sizeof(double)];
+   convertToStorage(m_type, &fillValue, sample, 1);
+   unsigned char* dst = data() + (index * m_sampleSize);
+   for(size_t i = 0; i < count; ++i)
+   {
+      memcpy(dst, sample, m_sampleSize);
+      dst += m_sampleSize;
+   }
+}
+
+void typedSampleVect::moveToBeginning()
+{
+   if(m_start > 0)
+   {
+      memmove(m_buff.data(), data(), m_sampleSize * m_size);
+      m_start = 0;
+   }
+}
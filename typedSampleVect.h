@@ -0,0 +1,114 @@
+/* Copyright 2026 Dan Williams. All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this
+ * software and associated documentation files (the "Software"), to deal in the Software
+ * without restriction, including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons
+ * to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR
+ * PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE
+ * FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ * OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+#ifndef TYPEDSAMPLEVECT_H
+#define TYPEDSAMPLEVECT_H
+
+#include <string.h>
+#include <vector>
+#include "PlotHelperTypes.h"
+#include "sampleVect.h"
+
+// Curve samples stored in the data type they were sent in (e.g. 2 bytes per sample for E_INT_16)
+// instead of always being widened to double. Reads and writes are done with doubles, the samples are
+// converted on the fly. If a sample is written that can't be stored exactly in the current storage type
+// (e.g. a NAN fill in point or a fractional value), all the samples are promoted to a storage type that
+// can hold it. The storage type never shrinks, except when a new storage type is explicitly assigned.
+// Like sampleVect, the samples are a window into a larger backing buffer so samples can be dropped from
+// the beginning or scrolled in O(number of samples added).
+// When the samples don't need to be transformed (i.e. no math ops) they can be shared with the
+// double sampleVect that would otherwise hold an exact copy. While shared, this is just a view of
+// that sampleVect and nothing is stored here.
+// snapshot() makes a copy that shares the backing buffer (copy on write, see sampleBuff).
+class typedSampleVect
+{
+public:
+   typedSampleVect();
+
+   size_t size() const {return m_shared != NULL ? m_shared->size() : m_size;}
+   bool empty() const {return size() == 0;}
+   ePlotDataTypes getStorageType() const {return m_type;}
+   size_t getSampleSize() const {return m_sampleSize;}
+
+   // Replace all the samples. The storage type is picked from the data type the samples were sent in.
+   void assign(const dubVect& src, ePlotDataTypes srcDataType);
+   // Replace all the samples, keeping the current storage type (it will be promoted if needed).
+   void assign(const double* src, size_t count);
+
+   double get(size_t index) const;
+   void get(size_t index, double* dst, size_t count) const;
+   void set(size_t index, const double* src, size_t count);
+
+   // The samples in the storage type, getSampleSize() bytes each. Not valid while shared.
+   const unsigned char* getStorage() const {return data();}
+
+   // Make 'dst' a copy of the samples without copying them, the backing buffer is shared until either
+   // one is changed. If the samples are shared with a sampleVect, 'dst' shares that sampleVect's
+   // backing buffer instead (stored as double). 'dst' is never shared with a sampleVect.
+   void snapshot(typedSampleVect& dst) const;
+   // Make this a copy of 'src' without copying the samples (copy on write). If 'src' is shared with a
+   // sampleVect, this is shared with 'sharedSamples' instead, which needs to be a copy of that sampleVect.
+   void copy(const typedSampleVect& src, sampleVect* sharedSamples);
+
+   void clear();
+   void release();
+   void resize(size_t newSize, double fillValue = 0.0);
+   void insertAtBeginning(size_t count, double fillValue);
+   void eraseFromBeginning(size_t count);
+   // Drop the 'count' oldest samples and append 'count' new samples to the end (the size doesn't change).
+   void scroll(const double* newSamples, size_t count);
+   // Move the samples at [index, size) to the beginning, the samples at [0, index) end up at the end.
+   void rotate(size_t index);
+
+   // Move the samples into 'samples' and use it as the storage from here on.
+   void share(sampleVect* samples);
+   // Copy the samples back out of the shared sampleVect (the sampleVect is left as is).
+   void unshare();
+   bool isShared() const {return m_shared != NULL;}
+
+   // Spilled samples are kept in a memory mapped temp file instead of RAM (see sampleBuff).
+   // Shared samples are spilled along with the sampleVect they are shared with.
+   bool spill(){return m_shared != NULL ? false : m_buff.spill();}
+   void unspill(){m_buff.unspill();}
+   size_t getResidentBytes() const {return (m_shared != NULL || m_buff.isSpilled()) ? 0 : m_buff.capacity();}
+
+   // Storage type for samples that were sent in 'dataType'.
+   static ePlotDataTypes getStorageTypeForDataType(ePlotDataTypes dataType);
+   // Widen samples stored in 'storageType' to double.
+   static void convertStorageToDouble(ePlotDataTypes storageType, const unsigned char* src, double* dst, size_t count);
+
+private:
+   unsigned char* data() {return m_buff.data() + (m_start * m_sampleSize);}
+   const unsigned char* data() const {return m_buff.data() + (m_start * m_sampleSize);}
+
+   void setStorageType(ePlotDataTypes newType);
+   // Promote the storage type until 'value' can be stored exactly.
+   void makeStorable(double value);
+   void fill(size_t index, size_t count, double fillValue);
+   void moveToBeginning();
+   void releaseBuff();
+
+   sampleBuff<unsigned char> m_buff;
+   size_t m_start;
+   size_t m_size;
+   ePlotDataTypes m_type;
+   size_t m_sampleSize; // When shared, m_type / m_sampleSize are the storage type to use when unshared.
+   sampleVect* m_shared;
+};
+
+#endif